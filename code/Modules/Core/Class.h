@@ -9,7 +9,7 @@
 /// declare an Oryol class with pool allocator (located inside class declaration)
 #define OryolClassPoolAllocDecl(TYPE) \
 private:\
-static Oryol::_priv::poolAllocator<TYPE> allocator;\
+static Oryol::_priv::growablePoolAllocator<TYPE> allocator;\
 protected:\
 virtual void destroy() override {\
     TYPE::allocator.Destroy(this);\
@@ -21,11 +21,11 @@ template<typename... ARGS> static Oryol::Ptr<TYPE> Create(ARGS&&... args) {\
 
 /// implementation-side macro for Oryol class with pool allocator (located in .cc source file)
 #define OryolClassPoolAllocImpl(TYPE) \
-Oryol::_priv::poolAllocator<TYPE> TYPE::allocator;
+Oryol::_priv::growablePoolAllocator<TYPE> TYPE::allocator;
 
 /// implementation-side macro for template classes with pool allocator (located in .cc source file)
 #define OryolTemplClassPoolAllocImpl(TEMPLATE_TYPE, CLASS_TYPE) \
-template<class TEMPLATE_TYPE> Oryol::_priv::poolAllocator<CLASS_TYPE<TEMPLATE_TYPE>> CLASS_TYPE<TEMPLATE_TYPE>::allocator;
+template<class TEMPLATE_TYPE> Oryol::_priv::growablePoolAllocator<CLASS_TYPE<TEMPLATE_TYPE>> CLASS_TYPE<TEMPLATE_TYPE>::allocator;
 
 /// declare an Oryol class without pool allocator (located inside class declaration)
 #define OryolBaseClassDecl(TYPE) \
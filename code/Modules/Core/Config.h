@@ -51,6 +51,11 @@
 /// maximum grow size for dynamic container classes (num elements)
 #define ORYOL_CONTAINER_DEFAULT_MAX_GROW (1<<16)
 
+/// default per-thread magazine size of pool allocators (0 disables magazines)
+#ifndef ORYOL_POOL_MAGAZINE_SIZE
+#define ORYOL_POOL_MAGAZINE_SIZE (32)
+#endif
+
 #ifndef __GNUC__
 #define __attribute__(x)
 #endif
@@ -25,6 +25,12 @@
     
     NOTE: An array growth operation will truncate any spare room
     at the front.
+
+    An array can be constructed with a memory tag, use Memory::Tag::Frame
+    for short-lived arrays which are destroyed before the end of the frame,
+    their memory will then come from the per-thread frame arena. A copy
+    of such an array uses normal memory, but a *move* transfers the
+    frame memory!
     
     For sorting, iterating and sorted insertion, use the standard 
     algorithm stuff!
@@ -41,6 +47,8 @@ template<class TYPE> class Array {
 public:
     /// default constructor
     Array();
+    /// construct with memory tag (e.g. Memory::Tag::Frame for frame-temporary arrays)
+    explicit Array(Memory::Tag allocTag);
     /// copy constructor (truncates to actual size)
     Array(const Array& rhs);
     /// move constructor (same capacity and size)
@@ -151,6 +159,15 @@ maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
     // empty
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE>
+Array<TYPE>::Array(Memory::Tag allocTag) :
+buffer(allocTag),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    // empty
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 Array<TYPE>::Array(const Array& rhs) {
@@ -4,10 +4,19 @@
     @class Oryol::Buffer
     @ingroup Core
     @brief growable memory buffer for raw data
+
+    A Buffer can also be a view on external memory (for instance a
+    memory-mapped file) which is kept alive by a refcounted owner object,
+    see SetView(). The view is released when the Buffer is destroyed or
+    cleared, adding data to a view first copies the content into an
+    allocated buffer. Writing through Data() on a view writes the external
+    memory, so the owner must provide private, writable memory (like a
+    copy-on-write mapping).
 */
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/RefCounted.h"
 
 namespace Oryol {
 
@@ -15,6 +24,8 @@ class Buffer {
 public:
     /// default constructor
     Buffer();
+    /// construct with memory tag (e.g. Memory::Tag::Frame for frame-temporary data)
+    explicit Buffer(Memory::Tag allocTag);
     /// move constructor
     Buffer(Buffer&& rhs);
     /// destructor
@@ -37,6 +48,11 @@ public:
     /// get number of free bytes at back
     int Spare() const;
 
+    /// set memory tag for allocations (default is Memory::Tag::Containers)
+    void SetAllocTag(Memory::Tag tag);
+    /// get memory tag for allocations
+    Memory::Tag GetAllocTag() const;
+
     /// make room for N more bytes
     void Reserve(int numBytes);
     /// add bytes to buffer
@@ -50,6 +66,11 @@ public:
     /// get read/write pointer to content (throws assert if would return nullptr)
     uint8_t* Data();
 
+    /// make the buffer a view on external memory, kept alive by owner
+    void SetView(uint8_t* ptr, int numBytes, const Ptr<RefCounted>& owner);
+    /// return true if the buffer is a view on external memory
+    bool IsView() const;
+
 private:
     /// (re-)allocate buffer
     void alloc(int newCapacity);
@@ -61,6 +82,8 @@ private:
     int size;
     int capacity;
     uint8_t* data;
+    Memory::Tag allocTag;
+    Ptr<RefCounted> viewOwner;
 };
 
 //------------------------------------------------------------------------------
@@ -68,7 +91,18 @@ inline
 Buffer::Buffer() :
 size(0),
 capacity(0),
-data(nullptr) {
+data(nullptr),
+allocTag(Memory::Tag::Containers) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+Buffer::Buffer(Memory::Tag allocTag_) :
+size(0),
+capacity(0),
+data(nullptr),
+allocTag(allocTag_) {
     // empty
 }
 
@@ -77,7 +111,9 @@ inline
 Buffer::Buffer(Buffer&& rhs) :
 size(rhs.size),
 capacity(rhs.capacity),
-data(rhs.data) {
+data(rhs.data),
+allocTag(rhs.allocTag),
+viewOwner(std::move(rhs.viewOwner)) {
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
@@ -95,12 +131,15 @@ Buffer::alloc(int newCapacity) {
     o_assert_dbg(newCapacity > this->capacity);
     o_assert_dbg(newCapacity > this->size);
 
-    uint8_t* newBuf = (uint8_t*) Memory::Alloc(newCapacity);
+    uint8_t* newBuf = (uint8_t*) Memory::Alloc(newCapacity, this->allocTag);
     if (this->size > 0) {
         o_assert_dbg(this->data);
         Memory::Copy(this->data, newBuf, this->size);
     }
-    if (this->data) {
+    if (this->viewOwner) {
+        this->viewOwner = nullptr;
+    }
+    else if (this->data) {
         Memory::Free(this->data);
     }
     this->data = newBuf;
@@ -110,7 +149,10 @@ Buffer::alloc(int newCapacity) {
 //------------------------------------------------------------------------------
 inline void
 Buffer::destroy() {
-    if (this->data) {
+    if (this->viewOwner) {
+        this->viewOwner = nullptr;
+    }
+    else if (this->data) {
         Memory::Free(this->data);
     }
     this->data = nullptr;
@@ -135,6 +177,8 @@ Buffer::operator=(Buffer&& rhs) {
     this->size = rhs.size;
     this->capacity = rhs.capacity;
     this->data = rhs.data;
+    this->allocTag = rhs.allocTag;
+    this->viewOwner = std::move(rhs.viewOwner);
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
@@ -164,6 +208,18 @@ Buffer::Spare() const {
     return this->capacity - this->size;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetAllocTag(Memory::Tag tag) {
+    this->allocTag = tag;
+}
+
+//------------------------------------------------------------------------------
+inline Memory::Tag
+Buffer::GetAllocTag() const {
+    return this->allocTag;
+}
+
 //------------------------------------------------------------------------------
 inline void
 Buffer::Reserve(int numBytes) {
@@ -193,6 +249,10 @@ Buffer::Add(int numBytes) {
 //------------------------------------------------------------------------------
 inline void
 Buffer::Clear() {
+    if (this->viewOwner) {
+        // the view's memory can't be reused
+        this->destroy();
+    }
     this->size = 0;
 }
 
@@ -210,4 +270,21 @@ Buffer::Data() {
     return this->data;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetView(uint8_t* ptr, int numBytes, const Ptr<RefCounted>& owner) {
+    o_assert_dbg(ptr && (numBytes > 0));
+    this->destroy();
+    this->data = ptr;
+    this->size = numBytes;
+    this->capacity = numBytes;
+    this->viewOwner = owner;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+Buffer::IsView() const {
+    return this->viewOwner.isValid();
+}
+
 } // namespace Oryol
@@ -0,0 +1,336 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief open-addressing hash map with Robin Hood probing
+
+    A key-value container with (amortized) O(1) insertion, lookup and
+    removal. Unlike Map there is no sorting and no per-bucket
+    allocation, all elements live in a single flat, power-of-2 sized
+    slot array next to an array of 32-bit hash codes. Collisions are
+    resolved with linear probing and Robin Hood displacement, erase
+    uses backward-shift deletion (the slot table is shared with
+    HashSet, see _priv::robinHoodTable).
+
+    The HASHER template parameter must be a functor returning a
+    uint32_t hash for a key (like the HASHER in HashSet). The hash
+    is scrambled internally (Fibonacci hashing), so simple hash
+    functions like the identity for integers are fine.
+
+    The table grows when it is filled to 7/8. Keys must be unique,
+    use AddUnique() if you're not sure whether a key already exists.
+
+    NOTE: Adding or erasing elements invalidates iterators and
+    pointers returned by Find().
+
+    @see Map, ArrayMap, HashSet, KeyValuePair
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/robinHoodTable.h"
+#include <utility>
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER> class HashMap {
+public:
+    /// default constructor
+    HashMap();
+    /// copy constructor
+    HashMap(const HashMap& rhs);
+    /// move constructor
+    HashMap(HashMap&& rhs);
+
+    /// copy-assignment operator
+    void operator=(const HashMap& rhs);
+    /// move-assignment operator
+    void operator=(HashMap&& rhs);
+
+    /// get number of elements
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots
+    int Capacity() const;
+
+    /// read/write access single element (element must exist)
+    VALUE& operator[](const KEY& key);
+    /// read-only access single element (element must exist)
+    const VALUE& operator[](const KEY& key) const;
+
+    /// make room for at least numElements more elements without rehashing
+    void Reserve(int numElements);
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// find an element, return nullptr if not exists
+    VALUE* Find(const KEY& key);
+    /// find an element, return nullptr if not exists
+    const VALUE* Find(const KEY& key) const;
+    /// add new element (key must not exist)
+    void Add(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move-semantics (key must not exist)
+    void Add(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// add new element with move-semantics, return false if element with key already existed
+    bool AddUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// erase element, does nothing if key not contained
+    void Erase(const KEY& key);
+
+    /// iterator over the occupied slots
+    template<class MAP, class ELM> class iter {
+    public:
+        /// constructor
+        iter(MAP* m, int i) : map(m), index(i) { this->skip(); };
+        /// dereference
+        ELM& operator*() const { return this->map->table.slots[this->index]; };
+        /// member access
+        ELM* operator->() const { return &this->map->table.slots[this->index]; };
+        /// pre-increment
+        iter& operator++() { this->index++; this->skip(); return *this; };
+        /// test inequality
+        bool operator!=(const iter& rhs) const { return this->index != rhs.index; };
+        /// test equality
+        bool operator==(const iter& rhs) const { return this->index == rhs.index; };
+    private:
+        /// skip empty slots
+        void skip() {
+            while ((this->index < this->map->table.capacity) && (0 == this->map->table.hashes[this->index])) {
+                this->index++;
+            }
+        };
+        MAP* map;
+        int index;
+    };
+    typedef iter<HashMap, KeyValuePair<KEY, VALUE>> iterator;
+    typedef iter<const HashMap, const KeyValuePair<KEY, VALUE>> const_iterator;
+
+    /// C++ conform begin
+    iterator begin();
+    /// C++ conform begin
+    const_iterator begin() const;
+    /// C++ conform end
+    iterator end();
+    /// C++ conform end
+    const_iterator end() const;
+
+private:
+    /// get the key of an element
+    struct keyOf {
+        const KEY& operator()(const KeyValuePair<KEY, VALUE>& kvp) const {
+            return kvp.key;
+        };
+    };
+    /// grow the table if adding one more element would exceed the load factor
+    void growIfNeeded();
+
+    static const int MinCapacity = 16;
+
+    _priv::robinHoodTable<KeyValuePair<KEY, VALUE>, KEY, HASHER, keyOf> table;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(const HashMap& rhs) {
+    this->table.copy(rhs.table);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(HashMap&& rhs) {
+    this->table.move(std::move(rhs.table));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(const HashMap& rhs) {
+    if (&rhs != this) {
+        this->table.destroy();
+        this->table.copy(rhs.table);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(HashMap&& rhs) {
+    if (&rhs != this) {
+        this->table.destroy();
+        this->table.move(std::move(rhs.table));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->table.size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return 0 == this->table.size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->table.capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::growIfNeeded() {
+    // max load factor is 7/8
+    const int capacity = this->table.capacity;
+    if (((this->table.size + 1) * 8) > (capacity * 7)) {
+        this->table.rehash(capacity ? capacity * 2 : MinCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int numElements) {
+    o_assert_dbg(numElements >= 0);
+    const int needed = this->table.size + numElements;
+    int newCapacity = this->table.capacity ? this->table.capacity : MinCapacity;
+    while ((needed * 8) > (newCapacity * 7)) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > this->table.capacity) {
+        this->table.rehash(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->table.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    return InvalidIndex != this->table.findSlot(key, this->table.hashOf(key));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) {
+    const int slot = this->table.findSlot(key, this->table.hashOf(key));
+    return (InvalidIndex != slot) ? &this->table.slots[slot].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) const {
+    const int slot = this->table.findSlot(key, this->table.hashOf(key));
+    return (InvalidIndex != slot) ? &this->table.slots[slot].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    const int slot = this->table.findSlot(key, this->table.hashOf(key));
+    o_assert(InvalidIndex != slot);   // not found if this triggers
+    return this->table.slots[slot].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    const int slot = this->table.findSlot(key, this->table.hashOf(key));
+    o_assert_dbg(InvalidIndex != slot);   // not found if this triggers
+    return this->table.slots[slot].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
+    this->Add(KeyValuePair<KEY, VALUE>(kvp));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
+    const uint32_t hash = this->table.hashOf(kvp.key);
+    o_assert_dbg(InvalidIndex == this->table.findSlot(kvp.key, hash));
+    this->growIfNeeded();
+    this->table.insert(hash, std::move(kvp));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->Add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    return this->AddUnique(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    const uint32_t hash = this->table.hashOf(kvp.key);
+    if (InvalidIndex != this->table.findSlot(kvp.key, hash)) {
+        return false;
+    }
+    this->growIfNeeded();
+    this->table.insert(hash, std::move(kvp));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    const int slot = this->table.findSlot(key, this->table.hashOf(key));
+    if (InvalidIndex != slot) {
+        this->table.eraseSlot(slot);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+typename HashMap<KEY, VALUE, HASHER>::iterator
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+typename HashMap<KEY, VALUE, HASHER>::const_iterator
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return const_iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+typename HashMap<KEY, VALUE, HASHER>::iterator
+HashMap<KEY, VALUE, HASHER>::end() {
+    return iterator(this, this->table.capacity);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+typename HashMap<KEY, VALUE, HASHER>::const_iterator
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return const_iterator(this, this->table.capacity);
+}
+
+} // namespace Oryol
@@ -4,18 +4,36 @@
     @class Oryol::HashSet
     @ingroup Core
     @brief a Set using hashing for fast access
-    
-    Implements a hash set with a fixed number of buckets, each
-    bucket is a binary-sorted set.
-    
-    @see Array, ArrayMap, Map, Set
+
+    Implements a growable hash set with open addressing (linear probing
+    with Robin Hood displacement, the slot table is shared with HashMap,
+    see _priv::robinHoodTable). All values live in a single power-of-2
+    sized slot array next to an array of 32-bit hash codes, and the
+    table is rehashed into twice the number of
+    slots when the number of values would exceed the max load factor
+    (default is 0.8, see SetMaxLoadFactor()).
+
+    Use Reserve() before adding many values to prevent repeated
+    rehashing.
+
+    The alloc strategy min-grow value defines the initial number of slots
+    (rounded up to the next power of 2), the max-grow value is ignored
+    since the table always grows by doubling.
+
+    The NUMBUCKETS template parameter is deprecated and ignored, it
+    only exists so that code written for the old fixed-bucket HashSet
+    still compiles.
+
+    @see Array, ArrayMap, HashMap, Map, Set
 */
 #include "Core/Config.h"
-#include "Core/Containers/Set.h"
+#include "Core/Assertion.h"
+#include "Core/Containers/robinHoodTable.h"
+#include <utility>
 
 namespace Oryol {
 
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> class HashSet {
+template<class VALUETYPE, class HASHER, int NUMBUCKETS=0> class HashSet {
 public:
     /// default constructor
     HashSet();
@@ -27,71 +45,89 @@ public:
     void operator=(const HashSet& rhs);
     /// move-assignment operator (same capacity and size)
     void operator=(HashSet&& rhs);
-    
+
     /// set allocation strategy
     void SetAllocStrategy(int minGrow, int maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     /// get min grow value
     int GetMinGrow() const;
     /// get max grow value
     int GetMaxGrow() const;
+    /// set max load factor (0.1 .. 0.95), takes effect on next growth
+    void SetMaxLoadFactor(float loadFactor);
+    /// get max load factor
+    float GetMaxLoadFactor() const;
     /// get number of elements in array
     int Size() const;
     /// return true if empty
     bool Empty() const;
-    
+    /// get number of slots
+    int Capacity() const;
+
+    /// make room for at least numElements more elements without rehashing
+    void Reserve(int numElements);
+    /// remove all elements (keeps capacity)
+    void Clear();
     /// test if an element exists
     bool Contains(const VALUETYPE& val) const;
     /// find element
     const VALUETYPE* Find(const VALUETYPE& val) const;
-    /// add element
+    /// add element (element must not exist)
     void Add(const VALUETYPE& val);
-    /// erase element
+    /// erase element, does nothing if element doesn't exist
     void Erase(const VALUETYPE& val);
-    
+
 private:
-    /// get the bucket for a value
-    const Set<VALUETYPE>& findBucket(const VALUETYPE& val) const;
-    /// get the bucket for a value
-    Set<VALUETYPE>& findBucket(const VALUETYPE& val);
+    /// get the key of a value (the value itself)
+    struct keyOf {
+        const VALUETYPE& operator()(const VALUETYPE& val) const {
+            return val;
+        };
+    };
+    /// test if numElements fit into numSlots with current max load factor
+    bool fits(int numElements, int numSlots) const;
 
-    int size;
-    Set<VALUETYPE> buckets[NUMBUCKETS];
+    _priv::robinHoodTable<VALUETYPE, VALUETYPE, HASHER, keyOf> table;
+    int minGrow;
+    int maxGrow;
+    float maxLoadFactor;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() :
-size(0) {
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW),
+maxLoadFactor(0.8f) {
     // empty
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(const HashSet& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = rhs.buckets[i];
-    };
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow),
+maxLoadFactor(rhs.maxLoadFactor) {
+    this->table.copy(rhs.table);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(HashSet&& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = std::move(rhs.buckets[i]);
-    }
-    rhs.size = 0;
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow),
+maxLoadFactor(rhs.maxLoadFactor) {
+    this->table.move(std::move(rhs.table));
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
     if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = rhs.buckets[i];
-        }
+        this->table.destroy();
+        this->table.copy(rhs.table);
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->maxLoadFactor = rhs.maxLoadFactor;
     }
 }
 
@@ -99,87 +135,130 @@ HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(HashSet&& rhs) {
     if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = std::move(rhs.buckets[i]);
-        }
-        rhs.size = 0;
+        this->table.destroy();
+        this->table.move(std::move(rhs.table));
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->maxLoadFactor = rhs.maxLoadFactor;
     }
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow, int maxGrow) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i].SetAllocStrategy(minGrow, maxGrow);
-    }
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMinGrow() const {
-    return this->buckets[0].GetMinGrow();
+    return this->minGrow;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxGrow() const {
-    return this->buckets[0].GetMaxGrow();
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetMaxLoadFactor(float loadFactor) {
+    o_assert((loadFactor >= 0.1f) && (loadFactor <= 0.95f));
+    this->maxLoadFactor = loadFactor;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> float
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxLoadFactor() const {
+    return this->maxLoadFactor;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Size() const {
-    return this->size;
+    return this->table.size;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Empty() const {
-    return (0 == this->size);
+    return (0 == this->table.size);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Capacity() const {
+    return this->table.capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::fits(int numElements, int numSlots) const {
+    return (numElements < numSlots) && (float(numElements) <= (float(numSlots) * this->maxLoadFactor));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Reserve(int numElements) {
+    o_assert_dbg(numElements >= 0);
+    const int needed = this->table.size + numElements;
+    int newCapacity = this->table.capacity;
+    if (0 == newCapacity) {
+        newCapacity = 1;
+        while (newCapacity < this->minGrow) {
+            newCapacity *= 2;
+        }
+    }
+    while (!this->fits(needed, newCapacity)) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > this->table.capacity) {
+        this->table.rehash(newCapacity);
+    }
 }
-    
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Clear() {
+    this->table.clear();
+}
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Contains(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Contains(val);
+    return InvalidIndex != this->table.findSlot(val, this->table.hashOf(val));
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> const VALUETYPE*
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Find(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Find(val);
+    const int slot = this->table.findSlot(val, this->table.hashOf(val));
+    return (InvalidIndex != slot) ? &this->table.slots[slot] : nullptr;
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Add(const VALUETYPE& val) {
-    this->size++;
-    auto& bucket = this->findBucket(val);
-    bucket.Add(val);
+    const uint32_t hash = this->table.hashOf(val);
+    if (InvalidIndex != this->table.findSlot(val, hash)) {
+        o_error("Trying to insert duplicate element!\n");
+        return;
+    }
+    if ((0 == this->table.capacity) || !this->fits(this->table.size + 1, this->table.capacity)) {
+        this->Reserve(1);
+    }
+    this->table.insert(hash, VALUETYPE(val));
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Erase(const VALUETYPE& val) {
-    o_assert_dbg(this->size > 0);
-    this->size--;
-    auto& bucket = this->findBucket(val);
-    bucket.Erase(val);
+    const int slot = this->table.findSlot(val, this->table.hashOf(val));
+    if (InvalidIndex != slot) {
+        this->table.eraseSlot(slot);
+    }
 };
-    
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) const {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
-}
-
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
-}
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
@@ -0,0 +1,526 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::InlineArray
+    @ingroup Core
+    @brief dynamic array with inline storage for the first NUM elements
+
+    A dynamic array with the same interface as Array, but the first
+    NUM elements are stored inside the array object itself, heap memory
+    is only allocated when the array grows beyond NUM elements. Use this
+    for short-lived arrays which usually only hold a handful of elements
+    (for instance the IO requests of a load group) to avoid a heap
+    allocation per array.
+
+    Once the array has spilled to the heap it behaves exactly like an
+    Array, Trim() moves the elements back into the inline storage
+    if they fit.
+
+    NOTE: Unlike Array, moving an InlineArray which still uses its inline
+    storage moves the elements one by one, and pointers to elements are
+    not stable across a move.
+
+    @see Array, StaticArray
+*/
+#include "Core/Config.h"
+#include "Core/Containers/elementBuffer.h"
+#include <initializer_list>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class TYPE, int NUM> class InlineArray {
+    static_assert(NUM > 0, "InlineArray: NUM must be > 0");
+public:
+    /// default constructor
+    InlineArray();
+    /// construct with memory tag for heap allocations
+    explicit InlineArray(Memory::Tag allocTag);
+    /// copy constructor (truncates to actual size)
+    InlineArray(const InlineArray& rhs);
+    /// move constructor
+    InlineArray(InlineArray&& rhs);
+    /// initialize from initializer list
+    InlineArray(std::initializer_list<TYPE> l);
+    /// destructor
+    ~InlineArray();
+
+    /// copy-assignment operator (truncates to actual size)
+    void operator=(const InlineArray& rhs);
+    /// move-assignment operator
+    void operator=(InlineArray&& rhs);
+
+    /// set allocation strategy (used when growing beyond inline storage)
+    void SetAllocStrategy(int minGrow_, int maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int GetMinGrow() const;
+    /// get max grow value
+    int GetMaxGrow() const;
+    /// get number of elements in array
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity of array
+    int Capacity() const;
+    /// get number of free slots at back of array
+    int Spare() const;
+    /// return true if the elements are in the inline storage
+    bool IsInline() const;
+
+    /// read/write access single element
+    TYPE& operator[](int index);
+    /// read-only access single element
+    const TYPE& operator[](int index) const;
+    /// read/write access to first element
+    TYPE& Front();
+    /// read-only access to first element
+    const TYPE& Front() const;
+    /// read/write access to last element
+    TYPE& Back();
+    /// read-only access to last element
+    const TYPE& Back() const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// trim capacity to size, moves back into inline storage if possible
+    void Trim();
+    /// clear the array (deletes elements, keeps capacity)
+    void Clear();
+
+    /// copy-add element to back of array
+    void Add(const TYPE& elm);
+    /// move-add element to back of array
+    void Add(TYPE&& elm);
+    /// construct-add new element at back of array
+    template<class... ARGS> void Add(ARGS&&... args);
+    /// copy-insert element at index, keep array order
+    void Insert(int index, const TYPE& elm);
+    /// move-insert element at index, keep array order
+    void Insert(int index, TYPE&& elm);
+
+    /// pop the last element
+    TYPE PopBack();
+    /// pop the first element
+    TYPE PopFront();
+    /// erase element at index, keep element ordering
+    void Erase(int index);
+    /// erase element at index, swap-in front or back element (destroys element ordering)
+    void EraseSwap(int index);
+    /// erase element at index, always swap-in from back (destroys element ordering)
+    void EraseSwapBack(int index);
+    /// erase element at index, always swap-in from front (destroys element ordering)
+    void EraseSwapFront(int index);
+
+    /// find element index with slow linear search, return InvalidIndex if not found
+    int FindIndexLinear(const TYPE& elm, int startIndex=0, int endIndex=InvalidIndex) const;
+
+    /// C++ conform begin
+    TYPE* begin();
+    /// C++ conform begin
+    const TYPE* begin() const;
+    /// C++ conform end
+    TYPE* end();
+    /// C++ conform end
+    const TYPE* end() const;
+
+private:
+    /// get pointer to inline storage
+    TYPE* inlineStorage();
+    /// destroy elements and heap memory, and switch back to inline storage
+    void reset();
+    /// copy from other array (this must be reset)
+    void copy(const InlineArray& rhs);
+    /// move from other array (this must be reset)
+    void move(InlineArray&& rhs);
+    /// grow to make room
+    void grow();
+
+    _priv::elementBuffer<TYPE> buffer;
+    int minGrow;
+    int maxGrow;
+    typename std::aligned_storage<sizeof(TYPE), std::alignment_of<TYPE>::value>::type storage[NUM];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::InlineArray() :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::InlineArray(Memory::Tag allocTag) :
+buffer(allocTag),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::InlineArray(const InlineArray& rhs) {
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::InlineArray(InlineArray&& rhs) {
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::InlineArray(std::initializer_list<TYPE> l) :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+    this->Reserve(int(l.size()));
+    for (const auto& elm : l) {
+        this->Add(elm);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM>
+InlineArray<TYPE, NUM>::~InlineArray() {
+    this->buffer.destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::operator=(const InlineArray& rhs) {
+    if (&rhs != this) {
+        this->reset();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::operator=(InlineArray&& rhs) {
+    if (&rhs != this) {
+        this->reset();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::GetMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::GetMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::Size() const {
+    return this->buffer.size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> bool
+InlineArray<TYPE, NUM>::Empty() const {
+    return this->buffer.size() == 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::Capacity() const {
+    return this->buffer.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::Spare() const {
+    return this->buffer.backSpare();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> bool
+InlineArray<TYPE, NUM>::IsInline() const {
+    return this->buffer.borrowed();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE&
+InlineArray<TYPE, NUM>::operator[](int index) {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> const TYPE&
+InlineArray<TYPE, NUM>::operator[](int index) const {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE&
+InlineArray<TYPE, NUM>::Front() {
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> const TYPE&
+InlineArray<TYPE, NUM>::Front() const {
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE&
+InlineArray<TYPE, NUM>::Back() {
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> const TYPE&
+InlineArray<TYPE, NUM>::Back() const {
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Reserve(int numElements) {
+    int newCapacity = this->buffer.size() + numElements;
+    if (newCapacity > this->buffer.capacity()) {
+        this->buffer.alloc(newCapacity, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Trim() {
+    if (this->buffer.borrowed()) {
+        // inline storage can't be trimmed
+        return;
+    }
+    const int curSize = this->buffer.size();
+    if (curSize <= NUM) {
+        // move elements back into inline storage
+        TYPE* dst = this->inlineStorage();
+        for (TYPE& elm : *this) {
+            new(dst++) TYPE(std::move(elm));
+        }
+        this->buffer.destroy();
+        this->buffer.borrow(this->inlineStorage(), NUM, curSize);
+    }
+    else if (curSize < this->buffer.capacity()) {
+        this->buffer.alloc(curSize, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Clear() {
+    this->buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Add(const TYPE& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Add(TYPE&& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> template<class... ARGS> void
+InlineArray<TYPE, NUM>::Add(ARGS&&... args) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.emplaceBack(std::forward<ARGS>(args)...);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Insert(int index, const TYPE& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Insert(int index, TYPE&& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE
+InlineArray<TYPE, NUM>::PopBack() {
+    return this->buffer.popBack();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE
+InlineArray<TYPE, NUM>::PopFront() {
+    return this->buffer.popFront();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::Erase(int index) {
+    this->buffer.erase(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::EraseSwap(int index) {
+    this->buffer.eraseSwap(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::EraseSwapBack(int index) {
+    this->buffer.eraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::EraseSwapFront(int index) {
+    this->buffer.eraseSwapFront(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> int
+InlineArray<TYPE, NUM>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) const {
+    const int size = this->buffer.size();
+    if (size > 0) {
+        o_assert_dbg(startIndex < size);
+        if (InvalidIndex == endIndex) {
+            endIndex = size;
+        }
+        else {
+            o_assert_dbg(endIndex <= size);
+        }
+        o_assert_dbg(startIndex <= endIndex);
+        for (int i = startIndex; i < endIndex; i++) {
+            if (elm == this->buffer[i]) {
+                return i;
+            }
+        }
+    }
+    // fallthrough: not found
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE*
+InlineArray<TYPE, NUM>::begin() {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> const TYPE*
+InlineArray<TYPE, NUM>::begin() const {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE*
+InlineArray<TYPE, NUM>::end() {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> const TYPE*
+InlineArray<TYPE, NUM>::end() const {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> TYPE*
+InlineArray<TYPE, NUM>::inlineStorage() {
+    return reinterpret_cast<TYPE*>(&this->storage[0]);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::reset() {
+    this->buffer.destroy();
+    this->buffer.borrow(this->inlineStorage(), NUM, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::copy(const InlineArray& rhs) {
+    o_assert_dbg(this->buffer.borrowed() && this->buffer.size() == 0);
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    const int num = rhs.Size();
+    if (num > NUM) {
+        this->buffer.alloc(num, 0);
+    }
+    _priv::elementBuffer<TYPE>::copyConstruct(rhs.begin(), this->buffer.buf, num);
+    this->buffer.end = num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::move(InlineArray&& rhs) {
+    o_assert_dbg(this->buffer.borrowed() && this->buffer.size() == 0);
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    if (rhs.buffer.borrowed()) {
+        // rhs is in inline storage, need to move element by element
+        TYPE* dst = this->buffer.buf;
+        for (TYPE& elm : rhs) {
+            new(dst++) TYPE(std::move(elm));
+        }
+        this->buffer.end = rhs.Size();
+        rhs.buffer.clear();
+    }
+    else {
+        // rhs has spilled to the heap, can just take over its buffer
+        this->buffer = std::move(rhs.buffer);
+        rhs.buffer.borrow(rhs.inlineStorage(), NUM, 0);
+    }
+    // NOTE: don't reset minGrow/maxGrow, rhs is empty, but still a valid object!
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUM> void
+InlineArray<TYPE, NUM>::grow() {
+    const int curCapacity = this->buffer.capacity();
+    int growBy = curCapacity >> 1;
+    if (growBy < minGrow) {
+        growBy = minGrow;
+    }
+    else if (growBy > maxGrow) {
+        growBy = maxGrow;
+    }
+    o_assert_dbg(growBy > 0);
+    this->buffer.alloc(curCapacity + growBy, 0);
+}
+
+} // namespace Oryol
@@ -0,0 +1,393 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SoAArray
+    @ingroup Core
+    @brief dynamic structure-of-arrays container
+
+    A dynamic array where each element is made of several fields, but
+    instead of storing the elements as structs, each field lives in its
+    own tightly packed memory stream:
+
+    @code
+    // particles with position and velocity
+    SoAArray<glm::vec4, glm::vec4> particles;
+    particles.Add(glm::vec4(0.0f), glm::vec4(0.0f, 1.0f, 0.0f, 0.0f));
+    glm::vec4* pos = particles.Field<0>();
+    const glm::vec4* vec = particles.Field<1>();
+    for (int i = 0; i < particles.Size(); i++) {
+        pos[i] += vec[i] * dt;
+    }
+    @endcode
+
+    Each stream starts at a StreamAlign-byte aligned address and the
+    capacity is always a multiple of StreamAlign elements, so SIMD loops
+    may safely read and write whole vectors up to Capacity() without a
+    scalar tail loop.
+
+    Interleave() writes elements into an interleaved memory layout
+    (e.g. a vertex buffer), described by a stride and a byte offset
+    per field. With a VertexLayout the stride is layout.ByteSize() and
+    the offsets are layout.ByteOffsetByVertexAttr(attr).
+
+    Fields must be simple value types (like float or glm::vec4) with
+    a trivial destructor, since elements are moved around with memcpy
+    and are never constructed or destructed.
+
+    @see Array
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Oryol {
+
+template<class... TYPES> class SoAArray {
+public:
+    /// number of fields per element
+    static const int NumFields = int(sizeof...(TYPES));
+    /// alignment of field streams in bytes
+    static const int StreamAlign = 16;
+    /// the type of a field
+    template<int FIELD> using FieldType = typename std::tuple_element<FIELD, std::tuple<TYPES...>>::type;
+
+    /// default constructor
+    SoAArray();
+    /// construct with memory tag
+    explicit SoAArray(Memory::Tag allocTag);
+    /// copy constructor (truncates capacity)
+    SoAArray(const SoAArray& rhs);
+    /// move constructor
+    SoAArray(SoAArray&& rhs);
+    /// destructor
+    ~SoAArray();
+
+    /// copy-assignment operator (truncates capacity)
+    void operator=(const SoAArray& rhs);
+    /// move-assignment operator
+    void operator=(SoAArray&& rhs);
+
+    /// get number of elements
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity (always a multiple of StreamAlign)
+    int Capacity() const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// clear the array (keeps capacity)
+    void Clear();
+    /// add a new element, return its index
+    int Add(const TYPES&... fields);
+    /// erase element by copying the last element into its place (destroys ordering)
+    void EraseSwap(int index);
+
+    /// get pointer to a field stream (r/w)
+    template<int FIELD> FieldType<FIELD>* Field();
+    /// get pointer to a field stream (r/o)
+    template<int FIELD> const FieldType<FIELD>* Field() const;
+
+    /// write elements to interleaved memory, fields with InvalidIndex offset are skipped
+    void Interleave(int startIndex, int num, void* dst, int dstSize, int dstStride, const int (&dstOffsets)[sizeof...(TYPES)]) const;
+
+private:
+    /// get byte size of field
+    static int fieldSize(int field);
+    /// (re-)allocate field streams
+    void alloc(int newCapacity);
+    /// free field streams
+    void destroy();
+    /// copy from other array
+    void copy(const SoAArray& rhs);
+    /// move from other array
+    void move(SoAArray&& rhs);
+    /// write fields of an element, recursion end
+    template<int FIELD> void setFields(int index);
+    /// write fields of an element
+    template<int FIELD, class T, class... REST> void setFields(int index, const T& val, const REST&... rest);
+    /// interleave a field stream, recursion end
+    template<int FIELD> typename std::enable_if<(FIELD == sizeof...(TYPES))>::type
+    interleaveFields(int startIndex, int num, uint8_t* dst, int dstStride, const int* dstOffsets) const;
+    /// interleave a field stream
+    template<int FIELD> typename std::enable_if<(FIELD < sizeof...(TYPES))>::type
+    interleaveFields(int startIndex, int num, uint8_t* dst, int dstStride, const int* dstOffsets) const;
+
+    uint8_t* mem;
+    uint8_t* streams[sizeof...(TYPES)];
+    int size;
+    int capacity;
+    Memory::Tag allocTag;
+};
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoAArray<TYPES...>::SoAArray() :
+mem(nullptr),
+size(0),
+capacity(0),
+allocTag(Memory::Tag::Containers) {
+    static_assert(sizeof...(TYPES) > 0, "SoAArray: at least one field required");
+    for (int i = 0; i < NumFields; i++) {
+        this->streams[i] = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoAArray<TYPES...>::SoAArray(Memory::Tag allocTag_) :
+SoAArray() {
+    this->allocTag = allocTag_;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoAArray<TYPES...>::SoAArray(const SoAArray& rhs) :
+SoAArray() {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoAArray<TYPES...>::SoAArray(SoAArray&& rhs) :
+SoAArray() {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoAArray<TYPES...>::~SoAArray() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::operator=(const SoAArray& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::operator=(SoAArray&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoAArray<TYPES...>::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> bool
+SoAArray<TYPES...>::Empty() const {
+    return 0 == this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoAArray<TYPES...>::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::Reserve(int numElements) {
+    const int newCapacity = this->size + numElements;
+    if (newCapacity > this->capacity) {
+        this->alloc(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::Clear() {
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoAArray<TYPES...>::Add(const TYPES&... fields) {
+    if (this->size == this->capacity) {
+        int growBy = this->capacity >> 1;
+        if (growBy < ORYOL_CONTAINER_DEFAULT_MIN_GROW) {
+            growBy = ORYOL_CONTAINER_DEFAULT_MIN_GROW;
+        }
+        else if (growBy > ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+            growBy = ORYOL_CONTAINER_DEFAULT_MAX_GROW;
+        }
+        this->alloc(this->capacity + growBy);
+    }
+    const int index = this->size++;
+    this->setFields<0>(index, fields...);
+    return index;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::EraseSwap(int index) {
+    o_assert_range_dbg(index, this->size);
+    const int last = --this->size;
+    if (index != last) {
+        for (int i = 0; i < NumFields; i++) {
+            const int elmSize = fieldSize(i);
+            std::memcpy(this->streams[i] + index * elmSize, this->streams[i] + last * elmSize, elmSize);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD> typename SoAArray<TYPES...>::template FieldType<FIELD>*
+SoAArray<TYPES...>::Field() {
+    static_assert((FIELD >= 0) && (FIELD < NumFields), "SoAArray: invalid field index");
+    return reinterpret_cast<FieldType<FIELD>*>(this->streams[FIELD]);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD> const typename SoAArray<TYPES...>::template FieldType<FIELD>*
+SoAArray<TYPES...>::Field() const {
+    static_assert((FIELD >= 0) && (FIELD < NumFields), "SoAArray: invalid field index");
+    return reinterpret_cast<const FieldType<FIELD>*>(this->streams[FIELD]);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::Interleave(int startIndex, int num, void* dst, int dstSize, int dstStride, const int (&dstOffsets)[sizeof...(TYPES)]) const {
+    o_assert_dbg(dst && (dstStride > 0));
+    o_assert_dbg((startIndex >= 0) && (num >= 0) && ((startIndex + num) <= this->size));
+    o_assert(num * dstStride <= dstSize);
+    #if ORYOL_DEBUG
+    for (int i = 0; i < NumFields; i++) {
+        o_assert((InvalidIndex == dstOffsets[i]) || ((dstOffsets[i] + fieldSize(i)) <= dstStride));
+    }
+    #endif
+    this->interleaveFields<0>(startIndex, num, (uint8_t*)dst, dstStride, dstOffsets);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoAArray<TYPES...>::fieldSize(int field) {
+    static const int sizes[] = { int(sizeof(TYPES))... };
+    return sizes[field];
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::alloc(int newCapacity) {
+    o_assert_dbg(newCapacity >= this->size);
+    newCapacity = Memory::RoundUp(newCapacity, StreamAlign);
+
+    // all streams go into one allocation, each stream is aligned
+    // because the capacity is a multiple of StreamAlign
+    int numBytes = 0;
+    for (int i = 0; i < NumFields; i++) {
+        numBytes += newCapacity * fieldSize(i);
+    }
+    uint8_t* newMem = (uint8_t*) Memory::Alloc(numBytes + StreamAlign, this->allocTag);
+    uint8_t* ptr = (uint8_t*) ((intptr_t(newMem) + (StreamAlign - 1)) & ~intptr_t(StreamAlign - 1));
+    for (int i = 0; i < NumFields; i++) {
+        const int streamSize = newCapacity * fieldSize(i);
+        if (this->size > 0) {
+            std::memcpy(ptr, this->streams[i], this->size * fieldSize(i));
+        }
+        this->streams[i] = ptr;
+        ptr += streamSize;
+    }
+    if (this->mem) {
+        Memory::Free(this->mem);
+    }
+    this->mem = newMem;
+    this->capacity = newCapacity;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::destroy() {
+    if (this->mem) {
+        Memory::Free(this->mem);
+        this->mem = nullptr;
+    }
+    for (int i = 0; i < NumFields; i++) {
+        this->streams[i] = nullptr;
+    }
+    this->size = 0;
+    this->capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::copy(const SoAArray& rhs) {
+    o_assert_dbg(nullptr == this->mem);
+    if (rhs.size > 0) {
+        this->alloc(rhs.size);
+        for (int i = 0; i < NumFields; i++) {
+            std::memcpy(this->streams[i], rhs.streams[i], rhs.size * fieldSize(i));
+        }
+        this->size = rhs.size;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoAArray<TYPES...>::move(SoAArray&& rhs) {
+    o_assert_dbg(nullptr == this->mem);
+    this->mem = rhs.mem;
+    this->size = rhs.size;
+    this->capacity = rhs.capacity;
+    this->allocTag = rhs.allocTag;
+    for (int i = 0; i < NumFields; i++) {
+        this->streams[i] = rhs.streams[i];
+        rhs.streams[i] = nullptr;
+    }
+    rhs.mem = nullptr;
+    rhs.size = 0;
+    rhs.capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD> void
+SoAArray<TYPES...>::setFields(int /*index*/) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD, class T, class... REST> void
+SoAArray<TYPES...>::setFields(int index, const T& val, const REST&... rest) {
+    static_assert(std::is_trivially_destructible<T>::value, "SoAArray: fields must have a trivial destructor");
+    this->Field<FIELD>()[index] = val;
+    this->setFields<FIELD+1>(index, rest...);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD> typename std::enable_if<(FIELD == sizeof...(TYPES))>::type
+SoAArray<TYPES...>::interleaveFields(int /*startIndex*/, int /*num*/, uint8_t* /*dst*/, int /*dstStride*/, const int* /*dstOffsets*/) const {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int FIELD> typename std::enable_if<(FIELD < sizeof...(TYPES))>::type
+SoAArray<TYPES...>::interleaveFields(int startIndex, int num, uint8_t* dst, int dstStride, const int* dstOffsets) const {
+    if (InvalidIndex != dstOffsets[FIELD]) {
+        // NOTE: the element size is a compile-time constant here, so
+        // the memcpy compiles into a simple load/store
+        typedef FieldType<FIELD> T;
+        const T* src = this->Field<FIELD>() + startIndex;
+        uint8_t* ptr = dst + dstOffsets[FIELD];
+        for (int i = 0; i < num; i++, ptr += dstStride) {
+            std::memcpy(ptr, &src[i], sizeof(T));
+        }
+    }
+    this->interleaveFields<FIELD+1>(startIndex, num, dst, dstStride, dstOffsets);
+}
+
+} // namespace Oryol
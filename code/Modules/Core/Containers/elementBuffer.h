@@ -18,6 +18,12 @@
     
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
+
+    The buffer can also borrow external storage (see InlineArray), in
+    this case the storage is never freed, and the first re-allocation
+    moves the elements into owned heap memory. Moving from a buffer with
+    borrowed storage moves the elements into owned heap memory, the
+    moved-from buffer keeps its (now empty) borrowed storage.
 */
 #include <new>
 #include <utility>
@@ -33,6 +39,8 @@ template<class TYPE> class elementBuffer {
 public:
     /// default constructor
     elementBuffer();
+    /// construct with memory tag for allocations
+    explicit elementBuffer(Memory::Tag allocTag);
     /// copy constructor
     elementBuffer(const elementBuffer& rhs);
     /// move constructor
@@ -71,6 +79,12 @@ public:
     
     /// allocate, grow or shrink the elementBuffer
     void alloc(int capacity, int frontSpare);
+    /// use external storage with numValid already constructed elements (buffer must be empty)
+    void borrow(TYPE* storage, int capacity, int numValid);
+    /// return true if the buffer currently uses borrowed storage
+    bool borrowed() const;
+    /// move content from other buffer (this buffer must be empty)
+    void moveFrom(elementBuffer&& rhs);
     /// destroy all
     void destroy();
     /// destroy element at pointer
@@ -141,6 +155,8 @@ public:
     int cap;            // buffer capacity (num elements)
     int start;          // index of first valid element in buffer
     int end;            // index of one-past-last valid element in buffer
+    Memory::Tag allocTag;   // memory tag for allocations
+    bool isBorrowed;        // true if buf is external storage
 };
 
 //------------------------------------------------------------------------------
@@ -149,18 +165,39 @@ elementBuffer<TYPE>::elementBuffer() :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+allocTag(Memory::Tag::Containers),
+isBorrowed(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+elementBuffer<TYPE>::elementBuffer(Memory::Tag allocTag_) :
+buf(nullptr),
+cap(0),
+start(0),
+end(0),
+allocTag(allocTag_),
+isBorrowed(false)
 {
     // empty
 }
 
 //------------------------------------------------------------------------------
+/**
+    NOTE: a copy never inherits the memory tag, copies of frame-temporary
+    buffers are allocated as normal Containers memory.
+*/
 template<class TYPE>
 elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+allocTag(Memory::Tag::Containers),
+isBorrowed(false)
 {
     if (rhs.buf) {
         this->alloc(rhs.size(), 0);
@@ -172,15 +209,14 @@ end(0)
 //------------------------------------------------------------------------------
 template<class TYPE>
 elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
-buf(rhs.buf),
-cap(rhs.cap),
-start(rhs.start),
-end(rhs.end)
+buf(nullptr),
+cap(0),
+start(0),
+end(0),
+allocTag(rhs.allocTag),
+isBorrowed(false)
 {
-    rhs.buf = nullptr;
-    rhs.cap = 0;
-    rhs.start = InvalidIndex;
-    rhs.end = InvalidIndex;
+    this->moveFrom(std::move(rhs));
 }
 
 //------------------------------------------------------------------------------
@@ -209,14 +245,7 @@ template<class TYPE> void
 elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
     if (&rhs != this) {
         this->destroy();
-        this->buf   = rhs.buf;
-        this->cap   = rhs.cap;
-        this->start = rhs.start;
-        this->end   = rhs.end;
-        rhs.buf   = nullptr;
-        rhs.cap   = 0;
-        rhs.start = 0;
-        rhs.end   = 0;
+        this->moveFrom(std::move(rhs));
     }
 }
 
@@ -306,7 +335,7 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
 
     // allocate new buffer
     const int newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize, this->allocTag);
     TYPE* newElmStart = newBuffer + newStart;
     
     // need to move any elements?
@@ -323,7 +352,7 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     }
     
     // need to free old buffer?
-    if (nullptr != this->buf) {
+    if ((nullptr != this->buf) && !this->isBorrowed) {
         Memory::Free(this->buf);
     }
     
@@ -332,6 +361,54 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     this->cap   = newCapacity;
     this->start = newStart;
     this->end   = newStart + curSize;
+    this->isBorrowed = false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::borrow(TYPE* storage, int newCapacity, int numValid) {
+    o_assert_dbg(nullptr == this->buf);
+    o_assert_dbg(storage && (newCapacity > 0) && (numValid <= newCapacity));
+    this->buf   = storage;
+    this->cap   = newCapacity;
+    this->start = 0;
+    this->end   = numValid;
+    this->isBorrowed = true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+elementBuffer<TYPE>::borrowed() const {
+    return this->isBorrowed;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::moveFrom(elementBuffer&& rhs) {
+    o_assert_dbg(nullptr == this->buf);
+    this->allocTag = rhs.allocTag;
+    if (rhs.isBorrowed) {
+        // borrowed storage can't be taken over, move the
+        // elements into owned memory instead
+        const int num = rhs.size();
+        if (num > 0) {
+            this->alloc(num, 0);
+            for (int i = rhs.start; i < rhs.end; i++) {
+                new(&this->buf[this->end++]) TYPE(std::move(rhs.buf[i]));
+                rhs.buf[i].~TYPE();
+            }
+        }
+    }
+    else {
+        this->buf   = rhs.buf;
+        this->cap   = rhs.cap;
+        this->start = rhs.start;
+        this->end   = rhs.end;
+        rhs.buf   = nullptr;
+        rhs.cap   = 0;
+    }
+    rhs.start = 0;
+    rhs.end   = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -342,12 +419,15 @@ elementBuffer<TYPE>::destroy() {
         for (int i = this->start; i < this->end; i++) {
             this->buf[i].~TYPE();
         }
-        Memory::Free(this->buf);
+        if (!this->isBorrowed) {
+            Memory::Free(this->buf);
+        }
     }
     this->buf = nullptr;
     this->cap = 0;
     this->start = 0;
     this->end = 0;
+    this->isBorrowed = false;
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,280 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::robinHoodTable
+    @ingroup _priv
+    @brief open-addressing slot table shared by HashMap and HashSet
+
+    All elements live in a single flat, power-of-2 sized slot array
+    next to an array of 32-bit hash codes (a hash code of 0 marks an
+    empty slot). Collisions are resolved with linear probing and
+    Robin Hood displacement (an element which is further away from its
+    home slot takes the place of an element which is closer to its
+    home slot), this keeps probe sequences short and allows lookups
+    to terminate early. Erase uses backward-shift deletion, so there
+    are no tombstones.
+
+    The HASHER returns a uint32_t hash for a key, the hash is scrambled
+    internally (Fibonacci hashing). KEYOF returns the key of an element.
+    The table doesn't grow by itself, the owning container decides
+    when to call rehash().
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <utility>
+
+namespace Oryol {
+namespace _priv {
+
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> class robinHoodTable {
+public:
+    /// constructor
+    robinHoodTable();
+    /// destructor
+    ~robinHoodTable();
+    /// no copy-construction (use copy())
+    robinHoodTable(const robinHoodTable& rhs) = delete;
+    /// no copy-assignment (use copy())
+    void operator=(const robinHoodTable& rhs) = delete;
+
+    /// compute the scrambled, non-zero hash code of a key
+    uint32_t hashOf(const KEY& key) const;
+    /// get home slot of a hash code
+    int homeSlot(uint32_t hash) const;
+    /// get distance of slot from its home slot
+    int probeDistance(uint32_t hash, int slot) const;
+    /// find slot index of key, or InvalidIndex
+    int findSlot(const KEY& key, uint32_t hash) const;
+    /// insert a new element (key must not exist, and there must be room)
+    void insert(uint32_t hash, ELEMENT&& elm);
+    /// erase the element in a slot
+    void eraseSlot(int slot);
+    /// reallocate with new capacity (power of 2) and reinsert elements
+    void rehash(int newCapacity);
+    /// destroy elements (keeps capacity)
+    void clear();
+    /// destroy elements and free slot arrays
+    void destroy();
+    /// copy content (table must be empty)
+    void copy(const robinHoodTable& rhs);
+    /// move content (table must be empty)
+    void move(robinHoodTable&& rhs);
+
+    uint32_t* hashes;   // hash codes, 0 for empty slots
+    ELEMENT* slots;     // element slots, points into same allocation as hashes
+    int capacity;       // number of slots, always a power of 2
+    int shift;          // 32 - log2(capacity)
+    int size;           // number of valid elements
+
+private:
+    /// allocate slot arrays
+    void alloc(int newCapacity);
+};
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF>
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::robinHoodTable() :
+hashes(nullptr),
+slots(nullptr),
+capacity(0),
+shift(32),
+size(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF>
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::~robinHoodTable() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> uint32_t
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::hashOf(const KEY& key) const {
+    // Fibonacci hashing spreads the hash bits into the upper bits,
+    // which are used as the home slot index
+    uint32_t h = uint32_t(HASHER()(key)) * 0x9E3779B9;
+    return h ? h : 1;
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> int
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::homeSlot(uint32_t hash) const {
+    return int(hash >> this->shift);
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> int
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::probeDistance(uint32_t hash, int slot) const {
+    return (slot - this->homeSlot(hash)) & (this->capacity - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> int
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::findSlot(const KEY& key, uint32_t hash) const {
+    if (0 == this->size) {
+        return InvalidIndex;
+    }
+    const int mask = this->capacity - 1;
+    int slot = this->homeSlot(hash);
+    for (int dist = 0; ; dist++) {
+        const uint32_t slotHash = this->hashes[slot];
+        if ((0 == slotHash) || (this->probeDistance(slotHash, slot) < dist)) {
+            // an empty slot, or an element closer to its home
+            // means the key can't be in the table
+            return InvalidIndex;
+        }
+        if ((slotHash == hash) && (KEYOF()(this->slots[slot]) == key)) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::insert(uint32_t hash, ELEMENT&& elm) {
+    o_assert_dbg(this->size < this->capacity);
+    const int mask = this->capacity - 1;
+    int slot = this->homeSlot(hash);
+    ELEMENT cur(std::move(elm));
+    for (int dist = 0; ; dist++) {
+        const uint32_t slotHash = this->hashes[slot];
+        if (0 == slotHash) {
+            new(&this->slots[slot]) ELEMENT(std::move(cur));
+            this->hashes[slot] = hash;
+            this->size++;
+            return;
+        }
+        const int slotDist = this->probeDistance(slotHash, slot);
+        if (slotDist < dist) {
+            // Robin Hood: take the slot from the richer element and
+            // continue with the displaced element
+            ELEMENT tmp(std::move(this->slots[slot]));
+            this->slots[slot] = std::move(cur);
+            cur = std::move(tmp);
+            this->hashes[slot] = hash;
+            hash = slotHash;
+            dist = slotDist;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::eraseSlot(int slot) {
+    o_assert_dbg((slot >= 0) && (slot < this->capacity) && this->hashes[slot]);
+    // backward-shift deletion: move following elements which are
+    // not in their home slot one slot back
+    const int mask = this->capacity - 1;
+    int next = (slot + 1) & mask;
+    while ((0 != this->hashes[next]) && (this->probeDistance(this->hashes[next], next) > 0)) {
+        this->slots[slot] = std::move(this->slots[next]);
+        this->hashes[slot] = this->hashes[next];
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    this->slots[slot].~ELEMENT();
+    this->hashes[slot] = 0;
+    this->size--;
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::alloc(int newCapacity) {
+    o_assert_dbg((newCapacity & (newCapacity - 1)) == 0);
+    const int hashesSize = Memory::RoundUp(newCapacity * int(sizeof(uint32_t)), ORYOL_MAX_PLATFORM_ALIGN);
+    uint8_t* ptr = (uint8_t*) Memory::Alloc(hashesSize + newCapacity * int(sizeof(ELEMENT)), Memory::Tag::Containers);
+    this->hashes = (uint32_t*) ptr;
+    this->slots = (ELEMENT*) (ptr + hashesSize);
+    Memory::Clear(this->hashes, newCapacity * sizeof(uint32_t));
+    this->capacity = newCapacity;
+    int log2 = 0;
+    while ((1 << log2) < newCapacity) {
+        log2++;
+    }
+    this->shift = 32 - log2;
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::rehash(int newCapacity) {
+    uint32_t* oldHashes = this->hashes;
+    ELEMENT* oldSlots = this->slots;
+    const int oldCapacity = this->capacity;
+    this->alloc(newCapacity);
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldHashes[i]) {
+            this->insert(oldHashes[i], std::move(oldSlots[i]));
+            oldSlots[i].~ELEMENT();
+        }
+    }
+    if (oldHashes) {
+        Memory::Free(oldHashes);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::clear() {
+    for (int i = 0; i < this->capacity; i++) {
+        if (this->hashes[i]) {
+            this->slots[i].~ELEMENT();
+            this->hashes[i] = 0;
+        }
+    }
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::destroy() {
+    if (this->hashes) {
+        this->clear();
+        Memory::Free(this->hashes);
+    }
+    this->hashes = nullptr;
+    this->slots = nullptr;
+    this->capacity = 0;
+    this->shift = 32;
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::copy(const robinHoodTable& rhs) {
+    o_assert_dbg(nullptr == this->hashes);
+    if (rhs.capacity > 0) {
+        // same capacity means same slot layout
+        this->alloc(rhs.capacity);
+        for (int i = 0; i < rhs.capacity; i++) {
+            if (rhs.hashes[i]) {
+                new(&this->slots[i]) ELEMENT(rhs.slots[i]);
+                this->hashes[i] = rhs.hashes[i];
+            }
+        }
+        this->size = rhs.size;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class ELEMENT, class KEY, class HASHER, class KEYOF> void
+robinHoodTable<ELEMENT, KEY, HASHER, KEYOF>::move(robinHoodTable&& rhs) {
+    o_assert_dbg(nullptr == this->hashes);
+    this->hashes = rhs.hashes;
+    this->slots = rhs.slots;
+    this->capacity = rhs.capacity;
+    this->shift = rhs.shift;
+    this->size = rhs.size;
+    rhs.hashes = nullptr;
+    rhs.slots = nullptr;
+    rhs.capacity = 0;
+    rhs.shift = 32;
+    rhs.size = 0;
+}
+
+} // namespace _priv
+} // namespace Oryol
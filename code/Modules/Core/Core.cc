@@ -5,6 +5,12 @@
 #include "Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Ptr.h"
+#include "Core/Memory/heapAllocator.h"
+#include "Core/Memory/frameAllocator.h"
+#include "Core/Memory/poolMagazines.h"
+#include "Core/String/StringAtom.h"
+#include "Core/logQueue.h"
+#include "Core/Threading/JobSystem.h"
 
 namespace Oryol {
     
@@ -12,16 +18,68 @@ Core::_state* Core::state = nullptr;
 ORYOL_THREADLOCAL_PTR(RunLoop) Core::threadPreRunLoop = nullptr;
 ORYOL_THREADLOCAL_PTR(RunLoop) Core::threadPostRunLoop = nullptr;
 
+// the built-in heaps are created on demand and never destroyed, since
+// memory blocks (e.g. string atom buffers) may outlive Core::Discard()
+static _priv::heapAllocator* heaps[Memory::NumTags] = { };
+static _priv::frameAllocator* frameAlloc = nullptr;
+static int frameArenaSize = CoreSetup().FrameArenaSize;
+
 //------------------------------------------------------------------------------
 void
-Core::Setup() {
+Core::Setup(const CoreSetup& setup) {
     o_assert_dbg(!IsValid());
     o_assert_dbg(nullptr == threadPreRunLoop);
     o_assert_dbg(nullptr == threadPostRunLoop);
+
+    // install allocator backends before anything else is allocated
+    for (int i = 0; i < Memory::NumTags; i++) {
+        const Memory::Tag tag = Memory::Tag(i);
+        Allocator* allocator = setup.GetAllocator(tag);
+        if (!allocator && (Memory::Tag::Frame == tag)) {
+            if (nullptr == frameAlloc) {
+                frameAlloc = Memory::New<_priv::frameAllocator>();
+            }
+            allocator = frameAlloc;
+        }
+        else if (!allocator && setup.UseHeapAllocator) {
+            if (nullptr == heaps[i]) {
+                heaps[i] = Memory::New<_priv::heapAllocator>();
+            }
+            allocator = heaps[i];
+        }
+        Memory::SetAllocator(tag, allocator);
+    }
+
+    frameArenaSize = setup.FrameArenaSize;
+    if (setup.GlobalStringAtoms) {
+        StringAtom::SetGlobalTable(true);
+    }
     state = Memory::New<_state>();
     state->mainThreadId = std::this_thread::get_id();
-    threadPreRunLoop = Memory::New<RunLoop>();
-    threadPostRunLoop = Memory::New<RunLoop>();
+    setupThreadLocals();
+
+    // tracked allocations are processed at the end of each main-thread frame
+    if (setup.MemoryTracking) {
+        Memory::SetTracking(true, setup.MemoryTrackingSampleRate);
+        const int logTopN = setup.MemoryTrackingLogTopN;
+        threadPostRunLoop->Add([logTopN] {
+            Memory::EndTrackingFrame(logTopN);
+        });
+    }
+
+    if (setup.AsyncLog) {
+        Log::SetupAsync(setup.AsyncLogOverflow, setup.AsyncLogDrainThread);
+        Log::SetDeferredFormatting(setup.AsyncLogDeferred);
+        if (!setup.AsyncLogDrainThread) {
+            threadPostRunLoop->Add([] {
+                Log::Flush();
+            });
+        }
+    }
+
+    if (setup.UseJobSystem) {
+        JobSystem::Setup(setup.NumJobWorkers);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -30,13 +88,28 @@ Core::Discard() {
     o_assert(IsValid());
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
-    Memory::Delete<RunLoop>(threadPreRunLoop);
-    Memory::Delete<RunLoop>(threadPostRunLoop);
+    if (JobSystem::IsValid()) {
+        JobSystem::Discard();
+    }
+    if (Log::IsAsync()) {
+        Log::DiscardAsync();
+    }
+    discardThreadLocals();
     Memory::Delete(state);
-    threadPreRunLoop = nullptr;
-    threadPostRunLoop = nullptr;
     state = nullptr;
 
+    // everything tracked which is still alive at this point is a leak
+    if (Memory::IsTracking()) {
+        Memory::DumpTrackingLeaks();
+        Memory::SetTracking(false);
+    }
+
+    // switch back to malloc, memory blocks which are still alive
+    // will be returned to the allocator which served them
+    for (int i = 0; i < Memory::NumTags; i++) {
+        Memory::SetAllocator(Memory::Tag(i), nullptr);
+    }
+
     // do NOT destroy the thread-local string atom table to
     // ensure that string atom data pointers still point to valid data!!!    
 }
@@ -78,8 +151,7 @@ Core::EnterThread() {
     #if ORYOL_HAS_THREADS
     o_assert(nullptr == threadPreRunLoop);
     o_assert(nullptr == threadPostRunLoop);
-    threadPreRunLoop = Memory::New<RunLoop>();
-    threadPostRunLoop = Memory::New<RunLoop>();
+    setupThreadLocals();
     #endif
 }
 
@@ -89,14 +161,37 @@ Core::LeaveThread() {
     #if ORYOL_HAS_THREADS
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
-    Memory::Delete<RunLoop>(threadPreRunLoop);
-    Memory::Delete<RunLoop>(threadPostRunLoop);
-    threadPreRunLoop = nullptr;
-    threadPostRunLoop = nullptr;
+    discardThreadLocals();
+    _priv::logQueue::releaseThread();
 
     // do NOT destroy the thread-local string atom table to
     // ensure that string atom data pointers still point to valid data
     #endif
 }
 
+//------------------------------------------------------------------------------
+void
+Core::setupThreadLocals() {
+    threadPreRunLoop = Memory::New<RunLoop>();
+    threadPostRunLoop = Memory::New<RunLoop>();
+
+    // setup the frame arena, the arena reset must be the first
+    // callback in the PostRunLoop
+    _priv::frameAllocator::setupThread(frameArenaSize);
+    threadPostRunLoop->Add([] {
+        _priv::frameAllocator::reset();
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+Core::discardThreadLocals() {
+    Memory::Delete<RunLoop>(threadPreRunLoop);
+    Memory::Delete<RunLoop>(threadPostRunLoop);
+    threadPreRunLoop = nullptr;
+    threadPostRunLoop = nullptr;
+    _priv::frameAllocator::discardThread();
+    _priv::poolMagazines::discardThread();
+}
+
 } // namespace Oryol
@@ -9,6 +9,7 @@
     @brief Core module facade
 */
 #include "Core/RefCounted.h"
+#include "Core/CoreSetup.h"
 #include "Core/Threading/ThreadLocalPtr.h"
 #include <thread>
 #include "Core/Trace.h"
@@ -20,7 +21,7 @@ class RunLoop;
 class Core {
 public:
     /// setup the Core module
-    static void Setup();
+    static void Setup(const CoreSetup& setup=CoreSetup());
     /// discard the Core module
     static void Discard();
     /// check if Core module has been setup
@@ -39,6 +40,11 @@ public:
     static bool IsMainThread();
 
 private:
+    /// create per-thread runloops and frame arena
+    static void setupThreadLocals();
+    /// destroy per-thread runloops and frame arena
+    static void discardThreadLocals();
+
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPreRunLoop;
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop;
     struct _state {
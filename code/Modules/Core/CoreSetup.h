@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::CoreSetup
+    @ingroup Core
+    @brief Core module setup parameters
+
+    Pass a CoreSetup object to Core::Setup() to configure the allocator
+    backends behind Oryol::Memory. By default, Core::Setup() installs
+    one built-in size-class heap per Memory::Tag, set UseHeapAllocator
+    to false to keep using malloc(), or install custom Allocator objects
+    for specific memory tags. Memory::Tag::Frame always uses the per-thread
+    frame arenas unless a custom allocator is installed for it.
+
+    Set MemoryTracking to true to enable allocation tracking (see
+    Memory::SetTracking()), the tracked allocations are processed at the
+    end of each main-thread frame, and leaks are logged in Core::Discard().
+    Set MemoryTrackingSampleRate to N to only track every Nth allocation,
+    which keeps the overhead low enough for staging builds.
+
+    Set GlobalStringAtoms to true to intern StringAtoms created after
+    Core::Setup() into one process-wide table (see StringAtom::SetGlobalTable()).
+
+    Set AsyncLog to true to switch Log into asynchronous mode (see
+    Log::SetupAsync()), queued messages are printed by a background
+    thread, or at the end of each main-thread frame if AsyncLogDrainThread
+    is false. With AsyncLogDeferred, o_dbg(), o_info() and o_warn() only
+    record their raw arguments, and the formatting happens when the
+    messages are printed (see Log::SetDeferredFormatting()).
+
+    Set UseJobSystem to true to start the work-stealing JobSystem with
+    NumJobWorkers worker threads (0 means one per additional CPU core).
+
+    @see Core, Memory, Allocator
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+
+namespace Oryol {
+
+class Allocator;
+
+class CoreSetup {
+public:
+    /// default constructor
+    CoreSetup();
+
+    /// use the built-in size-class heaps for memory tags without custom allocator
+    bool UseHeapAllocator = true;
+    /// initial size of the per-thread frame arenas (Memory::Tag::Frame)
+    int FrameArenaSize = 256 * 1024;
+    /// enable allocation tracking and leak reporting
+    bool MemoryTracking = false;
+    /// log the N callsites allocating the most bytes each frame (with MemoryTracking)
+    int MemoryTrackingLogTopN = 0;
+    /// only track every Nth allocation of a thread (with MemoryTracking)
+    int MemoryTrackingSampleRate = 1;
+    /// use a process-wide StringAtom table shared by all threads
+    bool GlobalStringAtoms = false;
+    /// queue log messages and print them asynchronously
+    bool AsyncLog = false;
+    /// print queued log messages on a background thread (otherwise in the main-thread PostRunLoop)
+    bool AsyncLogDrainThread = true;
+    /// what to do when a thread's log queue is full
+    Log::OverflowPolicy AsyncLogOverflow = Log::OverflowPolicy::Drop;
+    /// defer formatting of o_dbg/o_info/o_warn messages to the draining thread (with AsyncLog)
+    bool AsyncLogDeferred = false;
+    /// setup the JobSystem
+    bool UseJobSystem = false;
+    /// number of JobSystem worker threads, 0 for one per additional CPU core
+    int NumJobWorkers = 0;
+
+    /// install a custom allocator for a memory tag (must never be destroyed)
+    void SetAllocator(Memory::Tag tag, Allocator* allocator);
+    /// get custom allocator for a memory tag (nullptr if none set)
+    Allocator* GetAllocator(Memory::Tag tag) const;
+
+private:
+    Allocator* allocators[Memory::NumTags];
+};
+
+//------------------------------------------------------------------------------
+inline
+CoreSetup::CoreSetup() {
+    for (int i = 0; i < Memory::NumTags; i++) {
+        this->allocators[i] = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+CoreSetup::SetAllocator(Memory::Tag tag, Allocator* allocator) {
+    o_assert(int(tag) < Memory::NumTags);
+    this->allocators[int(tag)] = allocator;
+}
+
+//------------------------------------------------------------------------------
+inline Allocator*
+CoreSetup::GetAllocator(Memory::Tag tag) const {
+    o_assert(int(tag) < Memory::NumTags);
+    return this->allocators[int(tag)];
+}
+
+} // namespace Oryol
@@ -9,6 +9,7 @@
 #include "Core/StackTrace.h"
 #include "Core/Threading/RWLock.h"
 #include "Core/Containers/Array.h"
+#include "Core/logQueue.h"
 #if ORYOL_WINDOWS
 #include <Windows.h>
 #endif
@@ -28,7 +29,7 @@ namespace Oryol {
 using namespace _priv;
 using namespace std;
 
-Log::Level curLogLevel = Log::Level::Dbg;
+Log::Level Log::curLogLevel = Log::Level::Dbg;
 RWLock lock;
 Array<Ptr<Logger>> loggers;
 
@@ -42,6 +43,17 @@ Log::AddLogger(const Ptr<Logger>& l) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::RemoveLogger(const Ptr<Logger>& l) {
+    lock.LockWrite();
+    const int index = loggers.FindIndexLinear(l);
+    if (InvalidIndex != index) {
+        loggers.Erase(index);
+    }
+    lock.UnlockWrite();
+}
+
 //------------------------------------------------------------------------------
 int
 Log::GetNumLoggers() {
@@ -142,9 +154,104 @@ Log::VError(const char* msg, va_list args) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::SetupAsync(OverflowPolicy policy, bool drainThread) {
+    _priv::logQueue::setup(policy, drainThread, [](Level lvl, const char* msg) {
+        Log::printSync(lvl, "%s", msg);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+Log::DiscardAsync() {
+    _priv::logQueue::discard();
+}
+
+//------------------------------------------------------------------------------
+void
+Log::SetDeferredFormatting(bool b) {
+    _priv::logQueue::setDeferred(b);
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsDeferredFormatting() {
+    return _priv::logQueue::isDeferred();
+}
+
+//------------------------------------------------------------------------------
+void
+Log::SetBinarySink(BinarySinkFunc func) {
+    _priv::logQueue::setBinarySink(func);
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+Log::beginDeferred(Level lvl, const char* fmt, int numArgs, int argsSize, bool& outDeferred) {
+    return _priv::logQueue::beginDeferred(lvl, fmt, numArgs, argsSize, outDeferred);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::endDeferred() {
+    _priv::logQueue::endDeferred();
+}
+
+//------------------------------------------------------------------------------
+void
+Log::print(Level lvl, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    Log::vprint(lvl, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    return _priv::logQueue::isValid();
+}
+
+//------------------------------------------------------------------------------
+int
+Log::Flush() {
+    return _priv::logQueue::drain();
+}
+
+//------------------------------------------------------------------------------
+Log::AsyncStats
+Log::QueryAsyncStats() {
+    return _priv::logQueue::stats();
+}
+
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
+    if (_priv::logQueue::isValid()) {
+        if (Level::Error != lvl) {
+            _priv::logQueue::push(lvl, msg, args);
+            return;
+        }
+        // errors are usually followed by a trap, print them right away,
+        // but after everything which has been queued before
+        _priv::logQueue::drain();
+    }
+    vprintSync(lvl, msg, args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::printSync(Level lvl, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    vprintSync(lvl, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::vprintSync(Level lvl, const char* msg, va_list args) {
     lock.LockRead();
     if (loggers.Empty()) {
         #if ORYOL_ANDROID
@@ -201,6 +308,9 @@ Log::vprint(Level lvl, const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
+    if (_priv::logQueue::isValid()) {
+        _priv::logQueue::drain();
+    }
     lock.LockRead();
     if (loggers.Empty()) {
         char callstack[4096];
@@ -9,11 +9,31 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
-    @see Logger
+    By default, messages are printed synchronously on the calling thread.
+    After Log::SetupAsync(), messages are formatted on the calling
+    thread into a per-thread lock-free queue, and handed to the loggers
+    by a background thread (or by calling Log::Flush(), for instance
+    from the main thread's PostRunLoop). Errors and assert messages are
+    always printed synchronously (after flushing the queued messages),
+    since they are usually followed by a breakpoint.
+
+    The o_dbg(), o_info() and o_warn() macros go through Log::Record(),
+    which checks the log level inline. In async mode with deferred
+    formatting enabled (Log::SetDeferredFormatting()), the calling thread
+    only copies the format string pointer and the raw argument bytes
+    into its queue, and the printf-style formatting happens on the
+    draining thread. A binary sink (Log::SetBinarySink()) receives the
+    drained messages as a compact binary stream instead, which is
+    formatted offline by LogDecoder (or tools/logdecode.py). Since only
+    the pointer is queued, the format string must be a string literal.
+
+    @see Logger, LogDecoder
 */
 #include <cstdarg>
+#include <functional>
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/logArgs.h"
 
 namespace Oryol {
 
@@ -34,8 +54,29 @@ public:
         InvalidLevel
     };
 
+    /// what to do when a thread's async log queue is full
+    enum class OverflowPolicy {
+        Drop,   ///< drop the message (counted in AsyncStats::NumDropped)
+        Block,  ///< wait until the queue has room
+    };
+    /// asynchronous logging statistics
+    struct AsyncStats {
+        /// number of queued messages
+        int64_t NumQueued = 0;
+        /// number of messages dropped because a queue was full
+        int64_t NumDropped = 0;
+        /// number of messages which had to wait for room in a queue
+        int64_t NumBlocked = 0;
+        /// number of per-thread queues (queues of exited threads are reused)
+        int64_t NumQueues = 0;
+    };
+    /// a function which receives binary log stream data
+    typedef std::function<void(const uint8_t* data, int numBytes)> BinarySinkFunc;
+
     /// add a logger object
     static void AddLogger(const Ptr<Logger>& p);
+    /// remove a logger object
+    static void RemoveLogger(const Ptr<Logger>& p);
     /// get number of loggers
     static int GetNumLoggers();
     /// get logger at index
@@ -45,6 +86,12 @@ public:
     static void SetLogLevel(Level l);
     /// get current log level
     static Level GetLogLevel();
+    /// return true if messages of a log level are printed
+    static bool IsLevelEnabled(Level l);
+    /// record a message with deferred formatting if possible (used by o_dbg, o_info, o_warn)
+    template<class... ARGS> static void Record(Level l, const char* fmt, const ARGS&... args);
+    /// compile-time printf format check for Record() (never called)
+    static void CheckFormat(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
     /// print a debug message
     static void Dbg(const char* msg, ...) __attribute__((format(printf, 1, 2)));
     /// print a debug message (with va_list)
@@ -64,17 +111,90 @@ public:
     /// print an assert message
     static void AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func);
 
+    /// switch to asynchronous logging, with or without a background drain thread
+    static void SetupAsync(OverflowPolicy policy=OverflowPolicy::Drop, bool drainThread=true);
+    /// switch back to synchronous logging, prints the queued messages
+    static void DiscardAsync();
+    /// return true if asynchronous logging is enabled
+    static bool IsAsync();
+    /// hand queued messages to the loggers, returns number of messages
+    static int Flush();
+    /// get asynchronous logging statistics
+    static AsyncStats QueryAsyncStats();
+    /// enable or disable deferred formatting of Record() messages (requires async mode)
+    static void SetDeferredFormatting(bool b);
+    /// return true if deferred formatting is enabled
+    static bool IsDeferredFormatting();
+    /// write drained messages to a binary sink instead of the loggers (nullptr to disable)
+    static void SetBinarySink(BinarySinkFunc func);
+
 private:
+    /// Record() implementation for packable arguments
+    template<class... ARGS> static void record(std::true_type, Level l, const char* fmt, const ARGS&... args);
+    /// Record() implementation for arguments which must be formatted right away
+    template<class... ARGS> static void record(std::false_type, Level l, const char* fmt, const ARGS&... args);
+    /// reserve queue room for a deferred message, outDeferred is false if the message must be formatted
+    static uint8_t* beginDeferred(Level l, const char* fmt, int numArgs, int argsSize, bool& outDeferred);
+    /// publish a deferred message
+    static void endDeferred();
+    /// print a message through vprint()
+    static void print(Level l, const char* msg, ...);
     /// generic vprint-style method
     static void vprint(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
+    /// print immediately on the calling thread
+    static void vprintSync(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
+    /// print immediately on the calling thread
+    static void printSync(Level l, const char* msg, ...) __attribute__((format(printf, 2, 3)));
+
+    static Level curLogLevel;
 };
 
-/// shortcut for Log::Dbg()
-#define o_dbg(...) do { Oryol::Log::Dbg(__VA_ARGS__); } while(0)
-/// shortcut for Log::Info()
-#define o_info(...) do { Oryol::Log::Info(__VA_ARGS__); } while(0)
-/// shortcut for Log::Warn()
-#define o_warn(...) do { Oryol::Log::Warn(__VA_ARGS__); } while(0)
+//------------------------------------------------------------------------------
+inline bool
+Log::IsLevelEnabled(Level l) {
+    return curLogLevel >= l;
+}
+
+//------------------------------------------------------------------------------
+inline void
+Log::CheckFormat(const char* /*fmt*/, ...) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class... ARGS> inline void
+Log::Record(Level l, const char* fmt, const ARGS&... args) {
+    static_assert(sizeof...(ARGS) < 256, "too many log message arguments");
+    record(std::integral_constant<bool, _priv::logArgs::supported<ARGS...>::value>(), l, fmt, args...);
+}
+
+//------------------------------------------------------------------------------
+template<class... ARGS> inline void
+Log::record(std::true_type, Level l, const char* fmt, const ARGS&... args) {
+    bool deferred = false;
+    uint8_t* ptr = beginDeferred(l, fmt, int(sizeof...(ARGS)), _priv::logArgs::size(args...), deferred);
+    if (ptr) {
+        ptr = _priv::logArgs::writeTypes<ARGS...>(ptr);
+        _priv::logArgs::write(ptr, args...);
+        endDeferred();
+    }
+    else if (!deferred) {
+        print(l, fmt, args...);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... ARGS> inline void
+Log::record(std::false_type, Level l, const char* fmt, const ARGS&... args) {
+    print(l, fmt, args...);
+}
+
+/// shortcut for Log::Dbg(), with deferred formatting
+#define o_dbg(...) do { if (Oryol::Log::IsLevelEnabled(Oryol::Log::Level::Dbg)) { if (false) { Oryol::Log::CheckFormat(__VA_ARGS__); } Oryol::Log::Record(Oryol::Log::Level::Dbg, "" __VA_ARGS__); } } while(0)
+/// shortcut for Log::Info(), with deferred formatting
+#define o_info(...) do { if (Oryol::Log::IsLevelEnabled(Oryol::Log::Level::Info)) { if (false) { Oryol::Log::CheckFormat(__VA_ARGS__); } Oryol::Log::Record(Oryol::Log::Level::Info, "" __VA_ARGS__); } } while(0)
+/// shortcut for Log::Warn(), with deferred formatting
+#define o_warn(...) do { if (Oryol::Log::IsLevelEnabled(Oryol::Log::Level::Warn)) { if (false) { Oryol::Log::CheckFormat(__VA_ARGS__); } Oryol::Log::Record(Oryol::Log::Level::Warn, "" __VA_ARGS__); } } while(0)
 /// shortcut for Log::Error()
 #define o_error(...) do { Oryol::Log::Error(__VA_ARGS__); ORYOL_TRAP(); } while(0)
 
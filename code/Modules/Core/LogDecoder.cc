@@ -0,0 +1,460 @@
+//------------------------------------------------------------------------------
+//  LogDecoder.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdio>
+#include <cstring>
+#include "LogDecoder.h"
+#include "Core/Assertion.h"
+#include "Core/logArgs.h"
+
+namespace Oryol {
+
+using namespace _priv;
+
+const uint8_t LogDecoder::Magic[LogDecoder::HeaderSize] = { 'O', 'L', 'O', 'G', 1 };
+
+namespace {
+
+/// a decoded argument
+struct argValue {
+    uint8_t type = logArgs::Invalid;
+    uint64_t bits = 0;
+    double f = 0.0;
+    const char* str = nullptr;
+
+    /// get as signed integer
+    int64_t asInt() const {
+        switch (this->type) {
+            case logArgs::F64:  return int64_t(this->f);
+            case logArgs::Str:  return 0;
+            default:            return int64_t(this->bits);
+        }
+    }
+    /// get as double
+    double asDouble() const {
+        switch (this->type) {
+            case logArgs::F64:  return this->f;
+            case logArgs::I32:
+            case logArgs::I64:  return double(int64_t(this->bits));
+            case logArgs::Str:  return 0.0;
+            default:            return double(this->bits);
+        }
+    }
+};
+
+/// reads packed arguments with range checks
+class argReader {
+public:
+    argReader(const uint8_t* types_, int numArgs_, const uint8_t* args_, int argsSize_) :
+        types(types_), numArgs(numArgs_), args(args_), argsSize(argsSize_) { };
+
+    /// read the next argument, return false if none left or data is invalid
+    bool next(argValue& out) {
+        if (this->index >= this->numArgs) {
+            return false;
+        }
+        out = argValue();
+        out.type = this->types[this->index++];
+        const int left = this->argsSize - this->pos;
+        const uint8_t* ptr = this->args + this->pos;
+        switch (out.type) {
+            case logArgs::I32:
+            case logArgs::U32:
+                if (left < 4) {
+                    return false;
+                }
+                else {
+                    uint32_t v;
+                    std::memcpy(&v, ptr, sizeof(v));
+                    out.bits = (logArgs::I32 == out.type) ? uint64_t(int64_t(int32_t(v))) : uint64_t(v);
+                    this->pos += 4;
+                }
+                return true;
+            case logArgs::I64:
+            case logArgs::U64:
+            case logArgs::Ptr:
+                if (left < 8) {
+                    return false;
+                }
+                std::memcpy(&out.bits, ptr, sizeof(out.bits));
+                this->pos += 8;
+                return true;
+            case logArgs::F64:
+                if (left < 8) {
+                    return false;
+                }
+                std::memcpy(&out.f, ptr, sizeof(out.f));
+                this->pos += 8;
+                return true;
+            case logArgs::Str:
+                if (left < 3) {
+                    return false;
+                }
+                else {
+                    uint16_t len;
+                    std::memcpy(&len, ptr, sizeof(len));
+                    if (logArgs::NullStr == len) {
+                        out.str = nullptr;
+                        len = 0;
+                    }
+                    else {
+                        out.str = (const char*) ptr + 2;
+                    }
+                    if ((left < (2 + len + 1)) || (0 != ptr[2 + len])) {
+                        return false;
+                    }
+                    this->pos += 2 + len + 1;
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    const uint8_t* types;
+    int numArgs;
+    const uint8_t* args;
+    int argsSize;
+    int index = 0;
+    int pos = 0;
+};
+
+/// printf one conversion into the output buffer
+template<class T> void
+append(char* buf, int bufSize, int& pos, const char* spec, T val) {
+    const int res = std::snprintf(buf + pos, bufSize - pos, spec, val);
+    if (res > 0) {
+        pos += (res < (bufSize - 1 - pos)) ? res : (bufSize - 1 - pos);
+    }
+}
+
+/// terminate a conversion spec with a length modifier and conversion char
+const char*
+finishSpec(char* spec, int specLen, const char* lengthMod, char conv) {
+    while (*lengthMod) {
+        spec[specLen++] = *lengthMod++;
+    }
+    spec[specLen++] = conv;
+    spec[specLen] = 0;
+    return spec;
+}
+
+/// copy raw characters into the output buffer
+void
+appendRaw(char* buf, int bufSize, int& pos, const char* str, int len) {
+    if (len > (bufSize - 1 - pos)) {
+        len = bufSize - 1 - pos;
+    }
+    std::memcpy(buf + pos, str, len);
+    pos += len;
+}
+
+//------------------------------------------------------------------------------
+inline uint16_t
+get16(const uint8_t* ptr) {
+    uint16_t val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+get32(const uint8_t* ptr) {
+    uint32_t val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+/**
+    Formats like vsnprintf(), but takes the arguments from a packed
+    argument list (see logArgs). Length modifiers in the format string are
+    replaced by the packed argument size, and mismatches between format
+    and argument types never read out of bounds (a string conversion
+    with a non-string argument prints "(?)").
+*/
+int
+LogDecoder::Format(char* buf, int bufSize, const char* fmt, const uint8_t* types, int numArgs, const uint8_t* args, int argsSize) {
+    o_assert_dbg(buf && (bufSize > 0) && fmt);
+    argReader reader(types, numArgs, args, argsSize);
+    int pos = 0;
+    const char* p = fmt;
+    while (*p && (pos < (bufSize - 1))) {
+        if ('%' != *p) {
+            const char* start = p;
+            while (*p && ('%' != *p)) {
+                p++;
+            }
+            appendRaw(buf, bufSize, pos, start, int(p - start));
+            continue;
+        }
+        if ('%' == p[1]) {
+            appendRaw(buf, bufSize, pos, "%", 1);
+            p += 2;
+            continue;
+        }
+
+        // parse a conversion spec, and build a new spec with our own length modifier
+        const char* specStart = p++;
+        char spec[64];
+        int specLen = 0;
+        spec[specLen++] = '%';
+        bool valid = true;
+        while (*p && std::strchr("-+ #0", *p)) {
+            if (specLen < 8) {
+                spec[specLen++] = *p;
+            }
+            p++;
+        }
+        for (int i = 0; i < 2; i++) {
+            // width, and precision
+            if (1 == i) {
+                if ('.' != *p) {
+                    break;
+                }
+                spec[specLen++] = *p++;
+            }
+            if ('*' == *p) {
+                argValue v;
+                if (!reader.next(v)) {
+                    valid = false;
+                    break;
+                }
+                specLen += std::snprintf(spec + specLen, 16, "%d", int(v.asInt()));
+                p++;
+            }
+            else {
+                int numDigits = 0;
+                while ((*p >= '0') && (*p <= '9')) {
+                    if (++numDigits < 8) {
+                        spec[specLen++] = *p;
+                    }
+                    p++;
+                }
+            }
+        }
+        int lengthMod = 0;   // 0: none, 1: h, 2: hh, 3: long
+        while (*p && std::strchr("hljztLq", *p)) {
+            if ('h' == *p) {
+                lengthMod = (1 == lengthMod) ? 2 : 1;
+            }
+            else {
+                lengthMod = 3;
+            }
+            p++;
+        }
+        const char conv = *p;
+        if (conv) {
+            p++;
+        }
+        argValue v;
+        if (valid && conv && std::strchr("diuoxXcfFeEgGaAspn", conv)) {
+            valid = reader.next(v);
+        }
+        else {
+            valid = false;
+        }
+        if (!valid) {
+            // unknown conversion or missing argument, copy the spec as is
+            appendRaw(buf, bufSize, pos, specStart, int(p - specStart));
+            continue;
+        }
+        // integers are truncated to the size the length modifier asks for,
+        // without modifier to int (like the promoted printf argument)
+        const bool arg32 = (logArgs::I32 == v.type) || (logArgs::U32 == v.type);
+        switch (conv) {
+            case 'd':
+            case 'i':
+                {
+                    int64_t i = v.asInt();
+                    if (2 == lengthMod) {
+                        i = int8_t(i);
+                    }
+                    else if (1 == lengthMod) {
+                        i = int16_t(i);
+                    }
+                    else if ((0 == lengthMod) || arg32) {
+                        i = int32_t(i);
+                    }
+                    append(buf, bufSize, pos, finishSpec(spec, specLen, "ll", conv), (long long)i);
+                }
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                {
+                    uint64_t u = uint64_t(v.asInt());
+                    if (2 == lengthMod) {
+                        u = uint8_t(u);
+                    }
+                    else if (1 == lengthMod) {
+                        u = uint16_t(u);
+                    }
+                    else if ((0 == lengthMod) || arg32) {
+                        u = uint32_t(u);
+                    }
+                    append(buf, bufSize, pos, finishSpec(spec, specLen, "ll", conv), (unsigned long long)u);
+                }
+                break;
+            case 'c':
+                append(buf, bufSize, pos, finishSpec(spec, specLen, "", conv), int(v.asInt()));
+                break;
+            case 's':
+                if (logArgs::Str == v.type) {
+                    append(buf, bufSize, pos, finishSpec(spec, specLen, "", conv), v.str ? v.str : "(null)");
+                }
+                else {
+                    append(buf, bufSize, pos, finishSpec(spec, specLen, "", conv), "(?)");
+                }
+                break;
+            case 'p':
+                append(buf, bufSize, pos, finishSpec(spec, specLen, "", conv), (void*) uintptr_t(v.asInt()));
+                break;
+            case 'n':
+                // never write through a recorded pointer
+                break;
+            default:
+                append(buf, bufSize, pos, finishSpec(spec, specLen, "", conv), v.asDouble());
+                break;
+        }
+    }
+    buf[pos] = 0;
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+void
+LogDecoder::Reset() {
+    this->headerDone = false;
+    this->failed = false;
+    this->numMessages = 0;
+    this->formats.Clear();
+    this->pending.Clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+LogDecoder::Decode(const uint8_t* data, int numBytes, const MessageFunc& func) {
+    o_assert_dbg(data || (0 == numBytes));
+    if (this->failed) {
+        return false;
+    }
+    int consumed = 0;
+    if (this->pending.Empty()) {
+        consumed = this->decodeRecords(data, numBytes, func);
+        if ((consumed >= 0) && (consumed < numBytes)) {
+            // keep an incomplete record for the next chunk
+            this->pending.Add(data + consumed, numBytes - consumed);
+        }
+    }
+    else {
+        this->pending.Add(data, numBytes);
+        consumed = this->decodeRecords(this->pending.Data(), this->pending.Size(), func);
+        if (consumed > 0) {
+            Buffer rest;
+            if (consumed < this->pending.Size()) {
+                rest.Add(this->pending.Data() + consumed, this->pending.Size() - consumed);
+            }
+            this->pending = std::move(rest);
+        }
+    }
+    if (consumed < 0) {
+        this->failed = true;
+        this->pending.Clear();
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+LogDecoder::decodeRecords(const uint8_t* data, int numBytes, const MessageFunc& func) {
+    int pos = 0;
+    if (!this->headerDone) {
+        if (numBytes < HeaderSize) {
+            return 0;
+        }
+        if (0 != std::memcmp(data, Magic, HeaderSize)) {
+            return -1;
+        }
+        this->headerDone = true;
+        pos = HeaderSize;
+    }
+    char buf[MaxMessageSize];
+    while (pos < numBytes) {
+        const uint8_t* ptr = data + pos;
+        const int left = numBytes - pos;
+        int recordSize = 0;
+        switch (ptr[0]) {
+            case FormatTag:
+                if (left < 7) {
+                    return pos;
+                }
+                recordSize = 7 + get16(ptr + 5);
+                if (left < recordSize) {
+                    return pos;
+                }
+                else {
+                    const int id = int(get32(ptr + 1));
+                    if (id > this->formats.Size()) {
+                        return -1;
+                    }
+                    const int len = get16(ptr + 5);
+                    String fmt = len > 0 ? String((const char*) ptr + 7, 0, len) : String();
+                    if (id == this->formats.Size()) {
+                        this->formats.Add(std::move(fmt));
+                    }
+                    else {
+                        this->formats[id] = std::move(fmt);
+                    }
+                }
+                break;
+            case TextTag:
+                if (left < 4) {
+                    return pos;
+                }
+                recordSize = 4 + get16(ptr + 2);
+                if (left < recordSize) {
+                    return pos;
+                }
+                else {
+                    const int len = get16(ptr + 2) < (MaxMessageSize - 1) ? get16(ptr + 2) : (MaxMessageSize - 1);
+                    std::memcpy(buf, ptr + 4, len);
+                    buf[len] = 0;
+                    this->numMessages++;
+                    func(Log::Level(ptr[1]), buf);
+                }
+                break;
+            case MessageTag:
+                if (left < 9) {
+                    return pos;
+                }
+                recordSize = 9 + ptr[6] + get16(ptr + 7);
+                if (left < recordSize) {
+                    return pos;
+                }
+                else {
+                    const int id = int(get32(ptr + 2));
+                    if (id >= this->formats.Size()) {
+                        return -1;
+                    }
+                    const int numArgs = ptr[6];
+                    Format(buf, sizeof(buf), this->formats[id].AsCStr(), ptr + 9, numArgs, ptr + 9 + numArgs, get16(ptr + 7));
+                    this->numMessages++;
+                    func(Log::Level(ptr[1]), buf);
+                }
+                break;
+            default:
+                return -1;
+        }
+        pos += recordSize;
+    }
+    return pos;
+}
+
+} // namespace Oryol
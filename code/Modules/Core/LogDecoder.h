@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LogDecoder
+    @ingroup Core
+    @brief decode binary log streams written by Log::SetBinarySink()
+
+    With deferred formatting, o_dbg(), o_info() and o_warn() only record
+    a format string pointer and the raw argument bytes, and a binary sink
+    receives the drained messages as a compact stream. LogDecoder turns
+    such a stream back into text, the stream can be fed in chunks of
+    any size (e.g. as read from a file).
+
+    All values are little-endian, the stream starts with the 5-byte
+    header "OLOG" + Version, followed by records which start with
+    a tag byte:
+
+    - FormatTag: u32 id, u16 length, format string characters
+    - TextTag: u8 level, u16 length, message characters (a message
+      which was formatted on the calling thread)
+    - MessageTag: u8 level, u32 format id, u8 numArgs, u16 argsSize,
+      numArgs argument type bytes, argsSize bytes packed arguments
+
+    The argument packing is described in Core/logArgs.h. Format ids are
+    assigned in order starting at 0, a format record always precedes
+    the first message which uses it.
+
+    The same formatting code is used on the drain thread when no binary
+    sink is set, see LogDecoder::Format(). There is also a standalone
+    Python decoder in tools/logdecode.py.
+
+    @see Log
+*/
+#include "Core/Types.h"
+#include "Core/Log.h"
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include <functional>
+
+namespace Oryol {
+
+class LogDecoder {
+public:
+    /// record tags
+    enum Tag : uint8_t {
+        FormatTag = 1,
+        TextTag,
+        MessageTag,
+    };
+    /// size of the stream header
+    static const int HeaderSize = 5;
+    /// the stream header
+    static const uint8_t Magic[HeaderSize];
+    /// max length of a decoded message including the terminating 0
+    static const int MaxMessageSize = 4096;
+    /// a function which receives decoded messages
+    typedef std::function<void(Log::Level level, const char* msg)> MessageFunc;
+
+    /// decode a chunk of stream data, calls func for each complete message, returns false if stream is malformed
+    bool Decode(const uint8_t* data, int numBytes, const MessageFunc& func);
+    /// reset to the start of a new stream
+    void Reset();
+    /// get number of decoded messages
+    int NumMessages() const;
+
+    /// format packed arguments with a printf-style format string, returns length of the result
+    static int Format(char* buf, int bufSize, const char* fmt, const uint8_t* types, int numArgs, const uint8_t* args, int argsSize);
+
+private:
+    /// decode complete records, returns number of consumed bytes, or -1 if stream is malformed
+    int decodeRecords(const uint8_t* data, int numBytes, const MessageFunc& func);
+
+    bool headerDone = false;
+    bool failed = false;
+    int numMessages = 0;
+    Array<String> formats;
+    Buffer pending;
+};
+
+//------------------------------------------------------------------------------
+inline int
+LogDecoder::NumMessages() const {
+    return this->numMessages;
+}
+
+} // namespace Oryol
@@ -0,0 +1,35 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Allocator
+    @ingroup Core
+    @brief interface for pluggable allocator backends behind Oryol::Memory
+
+    Derive from Allocator and install the object through CoreSetup (or
+    Memory::SetAllocator()) to route all Memory::Alloc() calls for
+    a memory tag through a custom allocator backend. Memory keeps
+    track of the allocator which served a memory block, so an allocator
+    object must stay alive until all of its memory blocks have been
+    freed (in practice: it must never be destroyed while the
+    application is running).
+
+    Allocator implementations must be thread-safe, and must return
+    memory aligned to at least ORYOL_MAX_PLATFORM_ALIGN.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class Allocator {
+public:
+    /// destructor
+    virtual ~Allocator() { };
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) = 0;
+    /// free a chunk of memory, numBytes is the size the chunk was allocated with
+    virtual void Free(void* ptr, int numBytes) = 0;
+    /// re-allocate a chunk of memory (default: alloc, copy, free)
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes);
+};
+
+} // namespace Oryol
@@ -5,16 +5,205 @@
 #include <cstdlib>
 #include <cstring>
 #include "Memory.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/Memory/memorySimd.h"
+#include "Core/Memory/memoryTracker.h"
+#include "Core/String/stringSimd.h"
+#include "Core/Assertion.h"
+#if ORYOL_HAS_ATOMIC
+#include <atomic>
+#endif
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
-    
+
+namespace {
+
+// the header which is placed in front of each allocation
+struct allocHeader {
+    Allocator* allocator;   // nullptr if allocated with malloc
+    int32_t size;           // requested size in bytes (without header)
+    uint32_t tag;           // Memory::Tag
+    uint8_t padding[16 - (sizeof(Allocator*) + 2 * sizeof(int32_t))];
+};
+static_assert(sizeof(allocHeader) == 16, "Memory allocHeader must be 16 bytes!");
+static_assert(sizeof(allocHeader) >= ORYOL_MAX_PLATFORM_ALIGN, "Memory allocHeader breaks alignment!");
+
+// per-tag allocation counters, each on its own cache line
+struct alignas(64) tagCounters {
+    #if ORYOL_HAS_ATOMIC
+    std::atomic<int64_t> numBytes{0};
+    std::atomic<int64_t> numAllocs{0};
+    std::atomic<int64_t> totalAllocs{0};
+    #else
+    int64_t numBytes = 0;
+    int64_t numAllocs = 0;
+    int64_t totalAllocs = 0;
+    #endif
+};
+
+// NOTE: these are constant-initialized before any static constructor runs
+Allocator* allocators[Memory::NumTags];
+tagCounters counters[Memory::NumTags];
+
+//------------------------------------------------------------------------------
+inline void
+countAlloc(uint32_t tag, int numBytes) {
+    #if ORYOL_HAS_ATOMIC
+    counters[tag].numBytes.fetch_add(numBytes, std::memory_order_relaxed);
+    counters[tag].numAllocs.fetch_add(1, std::memory_order_relaxed);
+    counters[tag].totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    #else
+    counters[tag].numBytes += numBytes;
+    counters[tag].numAllocs++;
+    counters[tag].totalAllocs++;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline void
+countFree(uint32_t tag, int numBytes) {
+    #if ORYOL_HAS_ATOMIC
+    counters[tag].numBytes.fetch_sub(numBytes, std::memory_order_relaxed);
+    counters[tag].numAllocs.fetch_sub(1, std::memory_order_relaxed);
+    #else
+    counters[tag].numBytes -= numBytes;
+    counters[tag].numAllocs--;
+    #endif
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void*
+Allocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    void* newPtr = this->Alloc(newNumBytes);
+    Memory::Copy(ptr, newPtr, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+    this->Free(ptr, oldNumBytes);
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+const char*
+Memory::TagToString(Tag tag) {
+    switch (tag) {
+        case Tag::Default:      return "Default";
+        case Tag::Containers:   return "Containers";
+        case Tag::String:       return "String";
+        case Tag::IO:           return "IO";
+        case Tag::Gfx:          return "Gfx";
+        case Tag::Frame:        return "Frame";
+        default:                return "InvalidTag";
+    }
+}
+
+//------------------------------------------------------------------------------
+const char*
+Memory::SimdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2:   return "SSE2";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::NEON:   return "NEON";
+        default:                return "InvalidSimdLevel";
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+Memory::IsSimdLevelSupported(SimdLevel level) {
+    return _priv::memorySimd::isSupported(level);
+}
+
+//------------------------------------------------------------------------------
+Memory::SimdLevel
+Memory::GetSimdLevel() {
+    return _priv::memorySimd::level;
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SetSimdLevel(SimdLevel level) {
+    _priv::memorySimd::select(level);
+    _priv::stringSimd::select(level);
+}
+
+//------------------------------------------------------------------------------
+Memory::Stats
+Memory::QueryStats(Tag tag) {
+    const int i = int(tag);
+    o_assert_range_dbg(i, NumTags);
+    Stats stats;
+    stats.NumBytes = counters[i].numBytes;
+    stats.NumAllocs = counters[i].numAllocs;
+    stats.TotalAllocs = counters[i].totalAllocs;
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SetTracking(bool enabled, int sampleRate) {
+    _priv::memoryTracker::setEnabled(enabled, sampleRate);
+}
+
+//------------------------------------------------------------------------------
+bool
+Memory::IsTracking() {
+    return _priv::memoryTracker::isEnabled();
+}
+
+//------------------------------------------------------------------------------
+Memory::TrackingStats
+Memory::EndTrackingFrame(int logTopN) {
+    return _priv::memoryTracker::endFrame(logTopN);
+}
+
+//------------------------------------------------------------------------------
+int
+Memory::DumpTrackingLeaks() {
+    return _priv::memoryTracker::dumpLeaks();
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SetAllocator(Tag tag, Allocator* allocator) {
+    o_assert_dbg(int(tag) < NumTags);
+    allocators[int(tag)] = allocator;
+}
+
+//------------------------------------------------------------------------------
+Allocator*
+Memory::GetAllocator(Tag tag) {
+    o_assert_dbg(int(tag) < NumTags);
+    return allocators[int(tag)];
+}
+
 //------------------------------------------------------------------------------
 void*
-Memory::Alloc(int numBytes) {
-    void* ptr = std::malloc(numBytes);
+Memory::Alloc(int numBytes, Tag tag) {
+    o_assert_dbg(numBytes >= 0);
+    const uint32_t tagIndex = uint32_t(tag);
+    o_assert_dbg(int(tagIndex) < NumTags);
+    Allocator* allocator = allocators[tagIndex];
+    const int allocSize = numBytes + int(sizeof(allocHeader));
+    allocHeader* hdr;
+    if (allocator) {
+        hdr = (allocHeader*) allocator->Alloc(allocSize);
+    }
+    else {
+        hdr = (allocHeader*) std::malloc(allocSize);
+    }
+    o_assert(hdr);
+    hdr->allocator = allocator;
+    hdr->size = numBytes;
+    hdr->tag = tagIndex;
+    countAlloc(tagIndex, numBytes);
+    void* ptr = hdr + 1;
+    if (_priv::memoryTracker::isEnabled()) {
+        _priv::memoryTracker::recordAlloc(ptr, numBytes, tagIndex);
+    }
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
@@ -29,15 +218,52 @@ Memory::Fill(void* ptr, int numBytes, uint8_t value) {
 
 //------------------------------------------------------------------------------
 void*
-Memory::ReAlloc(void* ptr, int s) {
+Memory::ReAlloc(void* ptr, int numBytes) {
+    if (nullptr == ptr) {
+        return Memory::Alloc(numBytes);
+    }
+    allocHeader* hdr = ((allocHeader*)ptr) - 1;
+    const int oldSize = hdr->size;
+    const uint32_t tagIndex = hdr->tag;
+    const int oldAllocSize = oldSize + int(sizeof(allocHeader));
+    const int newAllocSize = numBytes + int(sizeof(allocHeader));
+    if (_priv::memoryTracker::isEnabled()) {
+        _priv::memoryTracker::recordFree(ptr, oldSize, tagIndex);
+    }
+    if (hdr->allocator) {
+        hdr = (allocHeader*) hdr->allocator->ReAlloc(hdr, oldAllocSize, newAllocSize);
+    }
+    else {
+        hdr = (allocHeader*) std::realloc(hdr, newAllocSize);
+    }
+    o_assert(hdr);
+    hdr->size = numBytes;
+    countFree(tagIndex, oldSize);
+    countAlloc(tagIndex, numBytes);
+    if (_priv::memoryTracker::isEnabled()) {
+        _priv::memoryTracker::recordAlloc(hdr + 1, numBytes, tagIndex);
+    }
     /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+    return hdr + 1;
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+    if (nullptr == p) {
+        return;
+    }
+    allocHeader* hdr = ((allocHeader*)p) - 1;
+    if (_priv::memoryTracker::isEnabled()) {
+        _priv::memoryTracker::recordFree(p, hdr->size, hdr->tag);
+    }
+    countFree(hdr->tag, hdr->size);
+    if (hdr->allocator) {
+        hdr->allocator->Free(hdr, hdr->size + int(sizeof(allocHeader)));
+    }
+    else {
+        std::free(hdr);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -58,6 +284,57 @@ Memory::Clear(void* ptr, int numBytes) {
     std::memset(ptr, 0, numBytes);
 }
 
+//------------------------------------------------------------------------------
+namespace {
+template<int SIZE> void
+copyStridedFixed(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride, int num) {
+    // fixed-size memcpy compiles into plain (vector) loads and stores
+    for (int i = 0; i < num; i++, src += srcStride, dst += dstStride) {
+        std::memcpy(dst, src, SIZE);
+    }
+}
+} // anonymous namespace
+
+void
+Memory::CopyStrided(const void* from, int fromStride, void* to, int toStride, int elmSize, int num) {
+    o_assert_dbg(from && to && (elmSize > 0) && (num >= 0));
+    o_assert_dbg((elmSize <= fromStride) && (elmSize <= toStride));
+    const uint8_t* src = (const uint8_t*) from;
+    uint8_t* dst = (uint8_t*) to;
+    switch (elmSize) {
+        case 4:  copyStridedFixed<4>(src, fromStride, dst, toStride, num); break;
+        case 8:  copyStridedFixed<8>(src, fromStride, dst, toStride, num); break;
+        case 12: copyStridedFixed<12>(src, fromStride, dst, toStride, num); break;
+        case 16: copyStridedFixed<16>(src, fromStride, dst, toStride, num); break;
+        default:
+            for (int i = 0; i < num; i++, src += fromStride, dst += toStride) {
+                std::memcpy(dst, src, elmSize);
+            }
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::CopyStreaming(const void* from, void* to, int numBytes) {
+    o_assert_dbg(from && to && (numBytes >= 0));
+    _priv::memorySimd::funcs.copyStreaming(from, to, numBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::WidenIndices(const uint16_t* from, uint32_t* to, int num) {
+    o_assert_dbg(from && to && (num >= 0));
+    _priv::memorySimd::funcs.widenIndices(from, to, num);
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SwizzleRGBAToBGRA(const void* from, void* to, int numPixels) {
+    o_assert_dbg(from && to && (numPixels >= 0));
+    _priv::memorySimd::funcs.swizzleRGBAToBGRA(from, to, numPixels);
+}
+
 } // namespace Oryol
 
 
@@ -8,9 +8,35 @@
     Lowlevel memory allocation wrapper for Oryol. Standard memory alignment
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
-    
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+
+    Each allocation is associated with a memory Tag which identifies the
+    subsystem the allocation belongs to. An Allocator backend can be
+    installed per Tag (by default Core::Setup() installs one built-in
+    size-class heap per Tag), if no allocator is installed, memory is
+    allocated through malloc(). Memory::Tag::Frame is special: Core
+    installs a per-thread linear arena for it which is reset once per
+    frame, so memory with this tag must not outlive the current frame.
+
+    Every allocation is prefixed with a small header which remembers the
+    allocator, size and tag of the memory block, this is used to route
+    Free() to the right allocator, and to keep per-Tag allocation counters
+    which can be queried with Memory::QueryStats().
+
+    The bulk functions (CopyStreaming(), WidenIndices(), SwizzleRGBAToBGRA())
+    have SSE2, AVX2 and NEON implementations, the best implementation
+    supported by the CPU is selected at startup.
+
+    Allocation tracking can be switched on at runtime with SetTracking()
+    (or CoreSetup::MemoryTracking). Each Alloc() and Free() then records
+    the callstack, size and tag into a lock-free ring buffer, which is
+    processed once per frame by EndTrackingFrame() to get the number of
+    allocations and bytes per frame, the live bytes, and optionally log
+    the callsites which allocated the most bytes in the frame.
+    DumpTrackingLeaks() logs all allocations which are still alive
+    (Core::Discard() calls this when tracking is enabled). Capturing
+    the callstacks makes tracked allocations much slower, pass a sample
+    rate N to SetTracking() to only track every Nth allocation of a
+    thread (for instance to keep tracking enabled in staging builds).
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
@@ -18,12 +44,87 @@
 #include <utility>
 
 namespace Oryol {
+
+class Allocator;
     
 class Memory {
 public:
+    /// memory tags (which subsystem an allocation belongs to)
+    enum class Tag : uint8_t {
+        Default,
+        Containers,
+        String,
+        IO,
+        Gfx,
+        Frame,      ///< frame-temporary memory, see _priv::frameAllocator
+
+        NumTags,
+    };
+    /// number of memory tags
+    static const int NumTags = int(Tag::NumTags);
+    /// convert memory tag to string
+    static const char* TagToString(Tag tag);
+
+    /// per-tag allocation counters
+    struct Stats {
+        /// number of currently allocated bytes
+        int64_t NumBytes = 0;
+        /// number of currently live allocations
+        int64_t NumAllocs = 0;
+        /// overall number of allocations since program start
+        int64_t TotalAllocs = 0;
+    };
+    /// get the allocation counters of a memory tag
+    static Stats QueryStats(Tag tag);
+
+    /// allocation tracking counters, see SetTracking()
+    struct TrackingStats {
+        /// number of tracked allocations in the last frame
+        int64_t FrameAllocs = 0;
+        /// number of bytes allocated in the last frame
+        int64_t FrameBytes = 0;
+        /// number of tracked live allocations
+        int64_t LiveAllocs = 0;
+        /// number of bytes in tracked live allocations
+        int64_t LiveBytes = 0;
+        /// overall number of events dropped because the ring buffer was full
+        int64_t DroppedEvents = 0;
+    };
+    /// enable or disable allocation tracking, only track every sampleRate'th allocation
+    static void SetTracking(bool enabled, int sampleRate=1);
+    /// return true if allocation tracking is enabled
+    static bool IsTracking();
+    /// process tracked allocations of this frame, optionally log top N callsites (main thread only)
+    static TrackingStats EndTrackingFrame(int logTopN=0);
+    /// log tracked live allocations, return their number (main thread only)
+    static int DumpTrackingLeaks();
+
+    /// SIMD instruction sets used by the bulk functions and the string search functions
+    enum class SimdLevel : uint8_t {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON,
+
+        NumSimdLevels,
+    };
+    /// convert SIMD level to string
+    static const char* SimdLevelToString(SimdLevel level);
+    /// return true if a SIMD level is supported by the compiler and CPU
+    static bool IsSimdLevelSupported(SimdLevel level);
+    /// get the SIMD level currently used by the bulk and string search functions
+    static SimdLevel GetSimdLevel();
+    /// override the SIMD level (must be supported), only call from main thread!
+    static void SetSimdLevel(SimdLevel level);
+
+    /// install an allocator for a memory tag (nullptr for malloc), only call from main thread!
+    static void SetAllocator(Tag tag, Allocator* allocator);
+    /// get the allocator installed for a memory tag (nullptr if malloc)
+    static Allocator* GetAllocator(Tag tag);
+
     /// allocate a raw chunk of memory
-    static void* Alloc(int numBytes);
-    /// re-allocate a raw chunk of memory
+    static void* Alloc(int numBytes, Tag tag=Tag::Default);
+    /// re-allocate a raw chunk of memory (keeps the memory tag)
     static void* ReAlloc(void* ptr, int numBytes);
     /// free a raw chunk of memory
     static void Free(void* ptr);
@@ -35,6 +136,14 @@ public:
     static void Move(const void* from, void* to, int numBytes);
     /// fill a chunk of memory with zeros
     static void Clear(void* ptr, int numBytes);
+    /// copy num items of elmSize bytes between strided memory (e.g. gather/scatter vertex components)
+    static void CopyStrided(const void* from, int fromStride, void* to, int toStride, int elmSize, int num);
+    /// copy a big chunk of non-overlapping memory bypassing the CPU cache (e.g. for GPU uploads)
+    static void CopyStreaming(const void* from, void* to, int numBytes);
+    /// widen 16-bit indices to 32-bit indices
+    static void WidenIndices(const uint16_t* from, uint32_t* to, int num);
+    /// swap the R and B channels of RGBA8 pixels (from and to may be identical)
+    static void SwizzleRGBAToBGRA(const void* from, void* to, int numPixels);
     /// align a pointer to size up to ORYOL_MAX_PLATFORM_ALIGN
     static void* Align(void* ptr, int byteSize);
     /// round-up a value to the next multiple of byteSize
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+//  frameAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdlib>
+#include "frameAllocator.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+ORYOL_THREADLOCAL_PTR(frameAllocator::arena) frameAllocator::threadArena = nullptr;
+
+static const int ChunkHeaderSize = 16;
+
+//------------------------------------------------------------------------------
+frameAllocator::chunk*
+frameAllocator::allocChunk(int size) {
+    static_assert(sizeof(chunk) <= ChunkHeaderSize, "frameAllocator::chunk too big");
+    chunk* c = (chunk*) std::malloc(ChunkHeaderSize + size);
+    o_assert(c);
+    c->next = nullptr;
+    c->size = size;
+    c->pos = 0;
+    return c;
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+frameAllocator::chunkData(chunk* c) {
+    return ((uint8_t*)c) + ChunkHeaderSize;
+}
+
+//------------------------------------------------------------------------------
+void
+frameAllocator::setupThread(int arenaSize) {
+    o_assert(nullptr == threadArena);
+    o_assert(arenaSize > 0);
+    arena* a = (arena*) std::malloc(sizeof(arena));
+    new(a) arena();
+    a->primary = allocChunk(Memory::RoundUp(arenaSize, ORYOL_MAX_PLATFORM_ALIGN));
+    a->cur = a->primary;
+    threadArena = a;
+}
+
+//------------------------------------------------------------------------------
+void
+frameAllocator::discardThread() {
+    arena* a = threadArena;
+    o_assert(nullptr != a);
+    chunk* c = a->primary;
+    while (c) {
+        chunk* next = c->next;
+        std::free(c);
+        c = next;
+    }
+    a->~arena();
+    std::free(a);
+    threadArena = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+frameAllocator::hasThreadArena() {
+    return nullptr != threadArena;
+}
+
+//------------------------------------------------------------------------------
+void
+frameAllocator::reset() {
+    arena* a = threadArena;
+    o_assert_dbg(nullptr != a);
+    if (a->primary->next) {
+        // there were overflow chunks, release them and grow the primary
+        // chunk so that this frame's allocations would have fit
+        int newSize = a->primary->size;
+        const int used = numAllocatedBytes();
+        while (newSize < used) {
+            newSize *= 2;
+        }
+        chunk* c = a->primary;
+        while (c) {
+            chunk* next = c->next;
+            std::free(c);
+            c = next;
+        }
+        a->primary = allocChunk(newSize);
+    }
+    a->primary->pos = 0;
+    a->cur = a->primary;
+    a->lastAlloc = nullptr;
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill(chunkData(a->primary), a->primary->size, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+frameAllocator::numAllocatedBytes() {
+    arena* a = threadArena;
+    o_assert_dbg(nullptr != a);
+    int num = 0;
+    for (chunk* c = a->primary; c; c = c->next) {
+        num += c->pos;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+int
+frameAllocator::arenaCapacity() {
+    arena* a = threadArena;
+    o_assert_dbg(nullptr != a);
+    return a->primary->size;
+}
+
+//------------------------------------------------------------------------------
+void*
+frameAllocator::Alloc(int numBytes) {
+    arena* a = threadArena;
+    o_assert2(nullptr != a, "frameAllocator: no frame arena on this thread (call Core::EnterThread())!\n");
+    const int size = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    chunk* c = a->cur;
+    if ((c->pos + size) > c->size) {
+        // doesn't fit, append an overflow chunk
+        chunk* overflow = allocChunk(size > a->primary->size ? size : a->primary->size);
+        c->next = overflow;
+        a->cur = overflow;
+        c = overflow;
+    }
+    uint8_t* ptr = chunkData(c) + c->pos;
+    c->pos += size;
+    a->lastAlloc = ptr;
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void
+frameAllocator::Free(void* /*ptr*/, int /*numBytes*/) {
+    // empty, memory is reclaimed by reset()
+}
+
+//------------------------------------------------------------------------------
+void*
+frameAllocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    arena* a = threadArena;
+    o_assert_dbg(nullptr != a);
+    if (ptr == a->lastAlloc) {
+        // the most recent allocation can grow or shrink in place
+        chunk* c = a->cur;
+        const int oldSize = Memory::RoundUp(oldNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+        const int newSize = Memory::RoundUp(newNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+        if ((c->pos - oldSize + newSize) <= c->size) {
+            c->pos += newSize - oldSize;
+            return ptr;
+        }
+    }
+    return Allocator::ReAlloc(ptr, oldNumBytes, newNumBytes);
+}
+
+} // namespace _priv
+} // namespace Oryol
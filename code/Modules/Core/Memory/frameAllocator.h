@@ -0,0 +1,73 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::frameAllocator
+    @ingroup _priv
+    @brief per-thread linear (bump) allocator for frame-temporary memory
+
+    The frameAllocator is installed by Core for Memory::Tag::Frame. Each
+    thread which has been setup through Core::Setup() or Core::EnterThread()
+    owns a linear memory arena, allocating from it is just a pointer bump,
+    and Free() is a no-op. Core adds a callback to the per-thread
+    PostRunLoop which resets the arena once per frame (the callback is
+    the first one in the PostRunLoop).
+
+    This means that memory allocated with Memory::Tag::Frame is only
+    valid until the PostRunLoop of the current frame starts, any
+    container or memory block using it must be destroyed (or freed)
+    before then.
+
+    If the arena is exhausted during a frame, additional overflow chunks
+    are allocated, and at the next reset the arena is grown so that
+    the peak frame size fits into a single chunk.
+*/
+#include "Core/Types.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+
+namespace Oryol {
+namespace _priv {
+
+class frameAllocator : public Allocator {
+public:
+    /// allocate from the current thread's arena
+    virtual void* Alloc(int numBytes) override;
+    /// free is a no-op
+    virtual void Free(void* ptr, int numBytes) override;
+    /// re-allocate, grows in place if ptr is the most recent allocation
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) override;
+
+    /// setup the arena for the current thread
+    static void setupThread(int arenaSize);
+    /// discard the arena of the current thread
+    static void discardThread();
+    /// test if the current thread has an arena
+    static bool hasThreadArena();
+    /// reset the current thread's arena (called from PostRunLoop)
+    static void reset();
+    /// get number of bytes allocated in current thread's arena since last reset
+    static int numAllocatedBytes();
+    /// get current capacity of the current thread's arena (without overflow chunks)
+    static int arenaCapacity();
+
+private:
+    struct chunk {
+        chunk* next;    // next overflow chunk
+        int size;       // usable size in bytes
+        int pos;        // current bump position
+    };
+    struct arena {
+        chunk* primary = nullptr;
+        chunk* cur = nullptr;
+        uint8_t* lastAlloc = nullptr;
+    };
+    /// allocate a new chunk
+    static chunk* allocChunk(int size);
+    /// get pointer to a chunk's memory
+    static uint8_t* chunkData(chunk* c);
+
+    static ORYOL_THREADLOCAL_PTR(arena) threadArena;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,563 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    @class Oryol::_priv::growablePoolAllocator
+    @ingroup _priv
+
+    Thread-safe pool allocator with placement-new/delete, like
+    poolAllocator, but without the 65536 elements limit. The free-list
+    uses 64-bit tags, the lower 32 bits are the element index, the
+    upper 32 bits are a unique-count to prevent the ABA problem.
+
+    The pool grows by allocating "puddles" of doubling size (256,
+    512, 1024, ... elements), the puddle table has a fixed size, so
+    that puddles never move and the element index can be mapped
+    to an address without locking. Only one thread at a time grows
+    the pool, other threads which find the free-list empty meanwhile
+    wait for the new puddle instead of allocating another one.
+
+    CreateN() and DestroyN() create or destroy a whole batch of objects
+    and pop/push the entire chain of free-list nodes with a
+    single compare-and-swap.
+
+    Create() and Destroy() go through a per-thread "magazine" (see
+    poolMagazines), a small cache of free nodes which is refilled from
+    and flushed to the shared free-list in batches of MagazineSize nodes.
+    This keeps threads from fighting over the free-list head. The default
+    magazine size is ORYOL_POOL_MAGAZINE_SIZE, a size of 0 disables
+    the magazines.
+*/
+#include <atomic>
+#include <utility>
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/poolMagazines.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE> class growablePoolAllocator {
+public:
+    /// constructor
+    growablePoolAllocator();
+    /// destructor
+    ~growablePoolAllocator();
+
+    /// allocate and construct an object of type T
+    template<typename... ARGS> TYPE* Create(ARGS&&... args);
+    /// delete and free an object
+    void Destroy(TYPE* obj);
+    /// allocate and construct a batch of objects (all constructed with the same args)
+    template<typename... ARGS> void CreateN(TYPE** outObjs, int num, const ARGS&... args);
+    /// delete and free a batch of objects
+    void DestroyN(TYPE** objs, int num);
+
+    /// get current number of allocated elements (free and used)
+    uint32_t Capacity() const;
+    /// set the per-thread magazine size (0 disables magazines and flushes them), no other thread may use the pool meanwhile
+    void SetMagazineSize(int size);
+    /// get the per-thread magazine size
+    int MagazineSize() const;
+
+private:
+    enum class nodeState : uint8_t {
+        init, free, used,
+    };
+
+    typedef uint64_t nodeTag;   // [32bit counter] | [32bit elm index]
+    static const nodeTag invalidTag = 0xFFFFFFFFFFFFFFFFULL;
+
+    struct node {
+        nodeTag next;           // tag of next node
+        uint32_t index;         // my own element index
+        nodeState state;        // current state
+        uint8_t padding[16 - (sizeof(nodeTag) + sizeof(uint32_t) + sizeof(nodeState))];
+    };
+
+    /// pop up to num nodes from the free-list, return first node (or nullptr), and number of popped nodes
+    node* popChain(int num, int& outNum);
+    /// push a chain of linked nodes onto the free-list
+    void pushChain(node* first, node* last);
+    /// link an array of free nodes into a chain and push it onto the free-list
+    void pushNodes(void** nodes, int num);
+    /// prepare a node to be pushed onto the free-list
+    void freeNode(node* n);
+    /// refill the current thread's magazine from the free-list
+    void refillMagazine(poolMagazines::magazine* mag);
+    /// flush nodes from a magazine (callback for poolMagazines)
+    static void flushMagazine(void* owner, poolMagazines::magazine* mag);
+    /// allocate a new puddle and add entries to free-list (or wait until another thread did)
+    void allocPuddle();
+    /// map an element index to puddle index and element index in puddle
+    static uint32_t puddleIndex(uint32_t index, uint32_t& outElmIndex);
+    /// get number of elements in a puddle
+    static uint32_t puddleNumElements(uint32_t puddleIndex);
+    /// get node address from a tag
+    node* addressFromTag(nodeTag tag) const;
+    /// build a new tag for a node
+    static nodeTag makeTag(uint32_t index, uint32_t count);
+    /// test if a pointer is owned by this allocator (SLOW)
+    bool isOwned(TYPE* obj) const;
+
+    static const uint32_t FirstPuddleElements = 256;
+    static const uint32_t MaxNumPuddles = 24;
+
+    int32_t elmSize;                        // offset to next element in bytes
+    int magazineSize;                       // per-thread magazine batch size
+    int magazineSlot;                       // poolMagazines slot index, -1 if none
+    uint32_t magazineGeneration;            // poolMagazines slot generation
+
+    #if ORYOL_HAS_ATOMIC
+        std::atomic<uint32_t> uniqueCount;
+        std::atomic<nodeTag> head;          // free-list head
+        std::atomic<uint32_t> numPuddles;   // current number of puddles
+        std::atomic<bool> growing;          // true while a thread allocates a puddle
+    #else
+        uint32_t uniqueCount;
+        nodeTag head;
+        uint32_t numPuddles;
+        bool growing;
+    #endif
+    uint8_t* puddles[MaxNumPuddles];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+growablePoolAllocator<TYPE>::growablePoolAllocator() {
+    static_assert(sizeof(node) == 16, "growablePoolAllocator::node should be 16 bytes!");
+
+    Memory::Clear(this->puddles, sizeof(this->puddles));
+    this->numPuddles = 0;
+    this->growing = false;
+    this->elmSize = Memory::RoundUp(sizeof(node) + sizeof(TYPE), sizeof(node));
+    o_assert((this->elmSize & (sizeof(node) - 1)) == 0);
+    o_assert(this->elmSize >= (int32_t)(2*sizeof(node)));
+    this->uniqueCount = 0;
+    this->head = invalidTag;
+    this->magazineSize = 0;
+    this->magazineSlot = -1;
+    this->magazineGeneration = 0;
+    this->SetMagazineSize(ORYOL_POOL_MAGAZINE_SIZE);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+growablePoolAllocator<TYPE>::~growablePoolAllocator() {
+    if (this->magazineSlot >= 0) {
+        poolMagazines::unregisterOwner(this->magazineSlot);
+        this->magazineSlot = -1;
+    }
+    const uint32_t num = this->numPuddles;
+    for (uint32_t i = 0; i < num; i++) {
+        Memory::Free(this->puddles[i]);
+        this->puddles[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+growablePoolAllocator<TYPE>::puddleIndex(uint32_t index, uint32_t& outElmIndex) {
+    // puddle n starts at element index FirstPuddleElements * (2^n - 1)
+    const uint32_t q = (index / FirstPuddleElements) + 1;
+    #if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanReverse(&bit, q);
+    const uint32_t puddle = bit;
+    #else
+    const uint32_t puddle = 31 - __builtin_clz(q);
+    #endif
+    outElmIndex = index - FirstPuddleElements * ((1 << puddle) - 1);
+    return puddle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+growablePoolAllocator<TYPE>::puddleNumElements(uint32_t puddleIndex) {
+    return FirstPuddleElements << puddleIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename growablePoolAllocator<TYPE>::nodeTag
+growablePoolAllocator<TYPE>::makeTag(uint32_t index, uint32_t count) {
+    return (nodeTag(count) << 32) | index;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename growablePoolAllocator<TYPE>::node*
+growablePoolAllocator<TYPE>::addressFromTag(nodeTag tag) const {
+    uint32_t elmIndex;
+    const uint32_t puddle = puddleIndex(uint32_t(tag & 0xFFFFFFFF), elmIndex);
+    return (node*) (this->puddles[puddle] + elmIndex * this->elmSize);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+growablePoolAllocator<TYPE>::Capacity() const {
+    const uint32_t num = this->numPuddles;
+    return FirstPuddleElements * ((1 << num) - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::SetMagazineSize(int size) {
+    o_assert((size >= 0) && (size <= poolMagazines::MaxMagazineSize));
+    this->magazineSize = size;
+    if ((size > 0) && (this->magazineSlot < 0)) {
+        // NOTE: if all slots are taken, the allocator works without magazines
+        this->magazineSlot = poolMagazines::registerOwner(this, flushMagazine, this->magazineGeneration);
+    }
+    else if ((0 == size) && (this->magazineSlot >= 0)) {
+        poolMagazines::unregisterOwner(this->magazineSlot);
+        this->magazineSlot = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+growablePoolAllocator<TYPE>::MagazineSize() const {
+    return this->magazineSize;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::allocPuddle() {
+
+    // only one thread grows the pool, the others return and retry
+    // popping from the free-list (which the growing thread refills)
+    #if ORYOL_HAS_ATOMIC
+    if (this->growing.exchange(true, std::memory_order_acquire)) {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::yield();
+        #endif
+        return;
+    }
+    if (invalidTag != this->head.load(std::memory_order_relaxed)) {
+        // another thread has just pushed a new puddle
+        this->growing.store(false, std::memory_order_release);
+        return;
+    }
+    const uint32_t newPuddleIndex = this->numPuddles.load(std::memory_order_relaxed);
+    #else
+    const uint32_t newPuddleIndex = this->numPuddles;
+    #endif
+    o_assert(newPuddleIndex < MaxNumPuddles);
+
+    // allocate new puddle
+    const uint32_t numElms = puddleNumElements(newPuddleIndex);
+    const int64_t puddleByteSize64 = int64_t(numElms) * int64_t(this->elmSize);
+    o_assert(puddleByteSize64 <= int64_t(0x7FFFFFFF));
+    const int puddleByteSize = int(puddleByteSize64);
+    uint8_t* puddle = (uint8_t*) Memory::Alloc(puddleByteSize, Memory::Tag::Containers);
+    Memory::Clear(puddle, puddleByteSize);
+    this->puddles[newPuddleIndex] = puddle;
+
+    // link the new elements into a chain and push the entire chain
+    const uint32_t baseIndex = FirstPuddleElements * ((1 << newPuddleIndex) - 1);
+    #if ORYOL_HAS_ATOMIC
+    const uint32_t count = this->uniqueCount.fetch_add(numElms, std::memory_order_relaxed);
+    #else
+    const uint32_t count = this->uniqueCount;
+    this->uniqueCount += numElms;
+    #endif
+    for (uint32_t elmIndex = 0; elmIndex < numElms; elmIndex++) {
+        node* n = (node*) (puddle + elmIndex * this->elmSize);
+        n->index = baseIndex + elmIndex;
+        n->state = nodeState::free;
+        if (elmIndex < (numElms - 1)) {
+            n->next = makeTag(n->index + 1, count + elmIndex + 1);
+        }
+    }
+    node* first = (node*) puddle;
+    node* last = (node*) (puddle + (numElms - 1) * this->elmSize);
+    #if ORYOL_HAS_ATOMIC
+    this->numPuddles.store(newPuddleIndex + 1, std::memory_order_release);
+    this->pushChain(first, last);
+    this->growing.store(false, std::memory_order_release);
+    #else
+    this->numPuddles = newPuddleIndex + 1;
+    this->pushChain(first, last);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::freeNode(node* n) {
+    o_assert((nodeState::init == n->state) || (nodeState::used == n->state));
+    o_assert(invalidTag == n->next);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xAA);
+    #endif
+    n->state = nodeState::free;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Push a chain of nodes which are already linked through their next
+    tags, only the next tag of the last node is modified.
+*/
+template<class TYPE> void
+growablePoolAllocator<TYPE>::pushChain(node* first, node* last) {
+    #if ORYOL_HAS_ATOMIC
+        const nodeTag newHeadTag = makeTag(first->index, ++this->uniqueCount);
+        nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
+        for (;;) {
+            last->next = oldHeadTag;
+            if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
+                break;
+            }
+        }
+    #else
+        last->next = this->head;
+        this->head = makeTag(first->index, ++this->uniqueCount);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::pushNodes(void** nodes, int num) {
+    o_assert_dbg(num > 0);
+    #if ORYOL_HAS_ATOMIC
+    const uint32_t count = this->uniqueCount.fetch_add(num, std::memory_order_relaxed);
+    #else
+    const uint32_t count = this->uniqueCount;
+    this->uniqueCount += num;
+    #endif
+    for (int i = 0; i < (num - 1); i++) {
+        node* n = (node*) nodes[i];
+        n->next = makeTag(((node*)nodes[i + 1])->index, count + i);
+    }
+    this->pushChain((node*)nodes[0], (node*)nodes[num - 1]);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::refillMagazine(poolMagazines::magazine* mag) {
+    o_assert_dbg(0 == mag->num);
+    int num = 0;
+    node* n = this->popChain(this->magazineSize, num);
+    while (nullptr == n) {
+        this->allocPuddle();
+        n = this->popChain(this->magazineSize, num);
+    }
+    // fill in reverse order, so that the first popped node is used first
+    for (int i = num - 1; i >= 0; i--) {
+        node* next = (i > 0) ? this->addressFromTag(n->next) : nullptr;
+        n->next = invalidTag;
+        mag->items[i] = n;
+        n = next;
+    }
+    mag->num = num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::flushMagazine(void* owner, poolMagazines::magazine* mag) {
+    growablePoolAllocator* self = (growablePoolAllocator*) owner;
+    if (mag->num > 0) {
+        self->pushNodes(mag->items, mag->num);
+        mag->num = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Pop a chain of up to num nodes with a single compare-and-swap. The
+    chain may be shorter than num if the free-list runs empty. A change
+    of the free-list head (which always comes with a new unique-count)
+    causes the whole walk to be retried.
+*/
+template<class TYPE>
+typename growablePoolAllocator<TYPE>::node*
+growablePoolAllocator<TYPE>::popChain(int num, int& outNum) {
+    o_assert_dbg(num > 0);
+    for (;;) {
+        #if ORYOL_HAS_ATOMIC
+            nodeTag oldHeadTag = this->head.load(std::memory_order_consume);
+        #else
+            nodeTag oldHeadTag = this->head;
+        #endif
+        if (invalidTag == oldHeadTag) {
+            outNum = 0;
+            return nullptr;
+        }
+        int n = 1;
+        node* last = this->addressFromTag(oldHeadTag);
+        nodeTag newHeadTag = last->next;
+        while ((n < num) && (invalidTag != newHeadTag)) {
+            last = this->addressFromTag(newHeadTag);
+            newHeadTag = last->next;
+            n++;
+        }
+        #if ORYOL_HAS_ATOMIC
+        if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
+        #else
+        this->head = newHeadTag;
+        #endif
+            // terminate the popped chain
+            last->next = invalidTag;
+            outNum = n;
+            return this->addressFromTag(oldHeadTag);
+        #if ORYOL_HAS_ATOMIC
+        }
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+template<typename... ARGS> TYPE*
+growablePoolAllocator<TYPE>::Create(ARGS&&... args) {
+
+    node* n = nullptr;
+    if (this->magazineSlot >= 0) {
+        // pop a node from the thread-local magazine
+        poolMagazines::magazine* mag = poolMagazines::get(this->magazineSlot, this->magazineGeneration);
+        if (0 == mag->num) {
+            this->refillMagazine(mag);
+        }
+        n = (node*) mag->items[--mag->num];
+    }
+    else {
+        // pop a new node from the free-stack
+        int num = 0;
+        n = this->popChain(1, num);
+        while (nullptr == n) {
+            // need to allocate a new puddle
+            this->allocPuddle();
+            n = this->popChain(1, num);
+        }
+    }
+    o_assert(nodeState::free == n->state);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xBB);
+    #endif
+    n->next = invalidTag;
+    n->state = nodeState::used;
+
+    // construct with placement new
+    void* objPtr = (void*) (n + 1);
+    TYPE* obj = new(objPtr) TYPE(std::forward<ARGS>(args)...);
+    o_assert(obj == objPtr);
+    return obj;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+template<typename... ARGS> void
+growablePoolAllocator<TYPE>::CreateN(TYPE** outObjs, int num, const ARGS&... args) {
+    o_assert_dbg(outObjs && (num >= 0));
+    int objIndex = 0;
+    while (objIndex < num) {
+        int numPopped = 0;
+        node* n = this->popChain(num - objIndex, numPopped);
+        if (nullptr == n) {
+            this->allocPuddle();
+            continue;
+        }
+        for (int i = 0; i < numPopped; i++) {
+            o_assert(nodeState::free == n->state);
+            node* next = (i < (numPopped - 1)) ? this->addressFromTag(n->next) : nullptr;
+            #if ORYOL_ALLOCATOR_DEBUG
+            Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xBB);
+            #endif
+            n->next = invalidTag;
+            n->state = nodeState::used;
+            outObjs[objIndex++] = new((void*)(n + 1)) TYPE(args...);
+            n = next;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+growablePoolAllocator<TYPE>::isOwned(TYPE* obj) const {
+    const uint32_t num = this->numPuddles;
+    for (uint32_t i = 0; i < num; i++) {
+        const uint8_t* start = this->puddles[i];
+        const uint8_t* end = this->puddles[i] + puddleNumElements(i) * this->elmSize;
+        const uint8_t* ptr = (uint8_t*) obj;
+        if ((ptr >= start) && (ptr < end)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::Destroy(TYPE* obj) {
+
+    #if ORYOL_ALLOCATOR_DEBUG
+    // make sure this object has been allocated by us
+    o_assert(this->isOwned(obj));
+    #endif
+
+    // call destructor on obj
+    obj->~TYPE();
+
+    node* n = ((node*)obj) - 1;
+    this->freeNode(n);
+    if (this->magazineSlot >= 0) {
+        // push the pool element into the thread-local magazine, if the
+        // magazine is full, flush the older half to the free-stack
+        poolMagazines::magazine* mag = poolMagazines::get(this->magazineSlot, this->magazineGeneration);
+        if (mag->num >= 2 * this->magazineSize) {
+            const int numFlush = mag->num - this->magazineSize;
+            this->pushNodes(mag->items, numFlush);
+            Memory::Move(&mag->items[numFlush], &mag->items[0], this->magazineSize * sizeof(void*));
+            mag->num = this->magazineSize;
+        }
+        mag->items[mag->num++] = n;
+    }
+    else {
+        // push the pool element back on the free-stack
+        this->pushChain(n, n);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+growablePoolAllocator<TYPE>::DestroyN(TYPE** objs, int num) {
+    o_assert_dbg(objs && (num >= 0));
+    if (0 == num) {
+        return;
+    }
+
+    // destroy objects and link their nodes into a chain
+    #if ORYOL_HAS_ATOMIC
+    const uint32_t count = this->uniqueCount.fetch_add(num, std::memory_order_relaxed);
+    #else
+    const uint32_t count = this->uniqueCount;
+    this->uniqueCount += num;
+    #endif
+    node* prev = nullptr;
+    node* first = nullptr;
+    for (int i = 0; i < num; i++) {
+        #if ORYOL_ALLOCATOR_DEBUG
+        o_assert(this->isOwned(objs[i]));
+        #endif
+        objs[i]->~TYPE();
+        node* n = ((node*)objs[i]) - 1;
+        this->freeNode(n);
+        if (prev) {
+            prev->next = makeTag(n->index, count + i);
+        }
+        else {
+            first = n;
+        }
+        prev = n;
+    }
+    this->pushChain(first, prev);
+}
+
+} // namespace _priv
+} // namespace Oryol
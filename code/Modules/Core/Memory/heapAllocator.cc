@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+//  heapAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdlib>
+#include "heapAllocator.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+heapAllocator::heapAllocator() {
+    static_assert(sizeof(span) <= ORYOL_MAX_PLATFORM_ALIGN, "heapAllocator::span header too big");
+}
+
+//------------------------------------------------------------------------------
+heapAllocator::~heapAllocator() {
+    for (auto& info : this->classes) {
+        span* s = info.spans;
+        while (s) {
+            span* next = s->next;
+            std::free(s);
+            s = next;
+        }
+        info.spans = nullptr;
+        info.freeList = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+heapAllocator::allocSpan(sizeClassInfo& info, int blockSize) {
+    // NOTE: must be called with the size-class lock held
+    int numBlocks = MinSpanSize / blockSize;
+    if (numBlocks < 8) {
+        numBlocks = 8;
+    }
+    const int spanSize = ORYOL_MAX_PLATFORM_ALIGN + numBlocks * blockSize;
+    uint8_t* ptr = (uint8_t*) std::malloc(spanSize);
+    o_assert(ptr);
+    span* s = (span*) ptr;
+    s->next = info.spans;
+    info.spans = s;
+
+    // populate free-list back to front, so that blocks are handed
+    // out in ascending address order
+    uint8_t* blocks = ptr + ORYOL_MAX_PLATFORM_ALIGN;
+    for (int i = numBlocks - 1; i >= 0; i--) {
+        freeNode* n = (freeNode*) (blocks + i * blockSize);
+        n->next = info.freeList;
+        info.freeList = n;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+heapAllocator::Alloc(int numBytes) {
+    o_assert_dbg(numBytes > 0);
+    if (numBytes > MaxSmallSize) {
+        return std::malloc(numBytes);
+    }
+    const int c = sizeClass(numBytes);
+    sizeClassInfo& info = this->classes[c];
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(info.lock);
+    #endif
+    if (nullptr == info.freeList) {
+        this->allocSpan(info, sizeClassBlockSize(c));
+    }
+    freeNode* n = info.freeList;
+    info.freeList = n->next;
+    return n;
+}
+
+//------------------------------------------------------------------------------
+void
+heapAllocator::Free(void* ptr, int numBytes) {
+    o_assert_dbg(ptr && (numBytes > 0));
+    if (numBytes > MaxSmallSize) {
+        std::free(ptr);
+        return;
+    }
+    sizeClassInfo& info = this->classes[sizeClass(numBytes)];
+    freeNode* n = (freeNode*) ptr;
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(info.lock);
+    #endif
+    n->next = info.freeList;
+    info.freeList = n;
+}
+
+//------------------------------------------------------------------------------
+void*
+heapAllocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    if ((oldNumBytes <= MaxSmallSize) && (newNumBytes <= MaxSmallSize)) {
+        if (sizeClass(oldNumBytes) == sizeClass(newNumBytes)) {
+            return ptr;
+        }
+    }
+    else if ((oldNumBytes > MaxSmallSize) && (newNumBytes > MaxSmallSize)) {
+        return std::realloc(ptr, newNumBytes);
+    }
+    return Allocator::ReAlloc(ptr, oldNumBytes, newNumBytes);
+}
+
+} // namespace _priv
+} // namespace Oryol
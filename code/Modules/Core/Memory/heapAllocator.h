@@ -0,0 +1,108 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::heapAllocator
+    @ingroup _priv
+    @brief built-in size-class heap for Oryol::Memory
+
+    A simple segregated-fit heap: small allocations are rounded up to
+    one of NumSizeClasses size classes (16-byte steps up to 256 bytes,
+    then 4 steps per power-of-two up to MaxSmallSize), and each size
+    class keeps its own free-list which is refilled by carving up
+    big 'spans' allocated from the system heap. Allocations bigger
+    than MaxSmallSize are forwarded to malloc().
+
+    Each size class has its own lock, and Core creates one heap
+    per Memory::Tag, so that different subsystems don't contend
+    on the same lock (or the libc heap lock) for small allocations.
+    Spans are only released when the heap object is destroyed.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Memory/Allocator.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class heapAllocator : public Allocator {
+public:
+    /// constructor
+    heapAllocator();
+    /// destructor, releases all spans
+    virtual ~heapAllocator();
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr, int numBytes) override;
+    /// re-allocate, stays in place if the size class doesn't change
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) override;
+
+    /// max allocation size handled by the size-class free-lists
+    static const int MaxSmallSize = 32 * 1024;
+    /// number of size classes
+    static const int NumSizeClasses = 16 + (14 - 8 + 1) * 4;
+    /// minimum size of a span in bytes
+    static const int MinSpanSize = 64 * 1024;
+
+    /// get size-class index for an allocation size (must be <= MaxSmallSize)
+    static int sizeClass(int numBytes);
+    /// get the block size of a size class
+    static int sizeClassBlockSize(int sizeClass);
+
+private:
+    struct freeNode {
+        freeNode* next;
+    };
+    struct span {
+        span* next;
+    };
+    struct sizeClassInfo {
+        #if ORYOL_HAS_THREADS
+        std::mutex lock;
+        #endif
+        freeNode* freeList = nullptr;
+        span* spans = nullptr;
+    };
+    /// allocate a new span for a size class, and populate its free-list
+    void allocSpan(sizeClassInfo& info, int blockSize);
+
+    sizeClassInfo classes[NumSizeClasses];
+};
+
+//------------------------------------------------------------------------------
+inline int
+heapAllocator::sizeClass(int n) {
+    if (n <= 256) {
+        return n <= 16 ? 0 : ((n + 15) >> 4) - 1;
+    }
+    else {
+        // find highest bit of (n-1), and pick one of 4 sub-classes
+        const uint32_t v = uint32_t(n - 1);
+        int p = 8;
+        while ((v >> (p + 1)) != 0) {
+            p++;
+        }
+        const int sub = (v >> (p - 2)) & 3;
+        return 16 + (p - 8) * 4 + sub;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int
+heapAllocator::sizeClassBlockSize(int c) {
+    if (c < 16) {
+        return (c + 1) << 4;
+    }
+    else {
+        const int p = 8 + ((c - 16) >> 2);
+        const int sub = (c - 16) & 3;
+        return (1 << p) + (sub + 1) * (1 << (p - 2));
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+//  memorySimd.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "memorySimd.h"
+#include "Core/Assertion.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_MEMORY_SSE2 (1)
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !ORYOL_EMSCRIPTEN
+#define ORYOL_MEMORY_AVX2 (1)
+#define ORYOL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define ORYOL_MEMORY_AVX2 (1)
+#define ORYOL_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ORYOL_MEMORY_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+// copies smaller than this don't benefit from non-temporal stores
+const int StreamingMinBytes = 16 * 1024;
+
+//------------------------------------------------------------------------------
+void
+widenIndicesScalar(const uint16_t* from, uint32_t* to, int num) {
+    for (int i = 0; i < num; i++) {
+        to[i] = from[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+swizzleRGBAToBGRAScalar(const void* from, void* to, int numPixels) {
+    const uint8_t* src = (const uint8_t*) from;
+    uint8_t* dst = (uint8_t*) to;
+    for (int i = 0; i < numPixels; i++, src += 4, dst += 4) {
+        const uint8_t r = src[0];
+        const uint8_t g = src[1];
+        const uint8_t b = src[2];
+        const uint8_t a = src[3];
+        dst[0] = b;
+        dst[1] = g;
+        dst[2] = r;
+        dst[3] = a;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+copyStreamingScalar(const void* from, void* to, int numBytes) {
+    std::memcpy(to, from, numBytes);
+}
+
+#if ORYOL_MEMORY_SSE2
+//------------------------------------------------------------------------------
+void
+widenIndicesSSE2(const uint16_t* from, uint32_t* to, int num) {
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; (i + 8) <= num; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+        _mm_storeu_si128((__m128i*)(to + i), _mm_unpacklo_epi16(v, zero));
+        _mm_storeu_si128((__m128i*)(to + i + 4), _mm_unpackhi_epi16(v, zero));
+    }
+    widenIndicesScalar(from + i, to + i, num - i);
+}
+
+//------------------------------------------------------------------------------
+void
+swizzleRGBAToBGRASSE2(const void* from, void* to, int numPixels) {
+    // no byte shuffle in SSE2, swap R and B with shifts instead
+    const __m128i agMask = _mm_set1_epi32(int(0xFF00FF00));
+    const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+    const uint32_t* src = (const uint32_t*) from;
+    uint32_t* dst = (uint32_t*) to;
+    int i = 0;
+    for (; (i + 4) <= numPixels; i += 4) {
+        const __m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i ag = _mm_and_si128(p, agMask);
+        const __m128i rb = _mm_and_si128(p, rbMask);
+        const __m128i br = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(ag, br));
+    }
+    swizzleRGBAToBGRAScalar(src + i, dst + i, numPixels - i);
+}
+
+//------------------------------------------------------------------------------
+void
+copyStreamingSSE2(const void* from, void* to, int numBytes) {
+    if (numBytes < StreamingMinBytes) {
+        std::memcpy(to, from, numBytes);
+        return;
+    }
+    const uint8_t* src = (const uint8_t*) from;
+    uint8_t* dst = (uint8_t*) to;
+    const int head = int((16 - (intptr_t(dst) & 15)) & 15);
+    std::memcpy(dst, src, head);
+    src += head;
+    dst += head;
+    numBytes -= head;
+    for (; numBytes >= 64; numBytes -= 64, src += 64, dst += 64) {
+        const __m128i v0 = _mm_loadu_si128((const __m128i*)(src + 0));
+        const __m128i v1 = _mm_loadu_si128((const __m128i*)(src + 16));
+        const __m128i v2 = _mm_loadu_si128((const __m128i*)(src + 32));
+        const __m128i v3 = _mm_loadu_si128((const __m128i*)(src + 48));
+        _mm_stream_si128((__m128i*)(dst + 0), v0);
+        _mm_stream_si128((__m128i*)(dst + 16), v1);
+        _mm_stream_si128((__m128i*)(dst + 32), v2);
+        _mm_stream_si128((__m128i*)(dst + 48), v3);
+    }
+    _mm_sfence();
+    std::memcpy(dst, src, numBytes);
+}
+#endif
+
+#if ORYOL_MEMORY_AVX2
+//------------------------------------------------------------------------------
+bool
+cpuHasAVX2() {
+    #if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // AVX2 also needs OS support for saving the YMM registers
+    __cpuid(info, 1);
+    const bool osxsave = 0 != (info[2] & (1<<27));
+    const bool avx = 0 != (info[2] & (1<<28));
+    if (!(osxsave && avx) || ((_xgetbv(0) & 6) != 6)) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return 0 != (info[1] & (1<<5));
+    #else
+    __builtin_cpu_init();
+    return 0 != __builtin_cpu_supports("avx2");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 void
+widenIndicesAVX2(const uint16_t* from, uint32_t* to, int num) {
+    int i = 0;
+    for (; (i + 16) <= num; i += 16) {
+        const __m128i lo = _mm_loadu_si128((const __m128i*)(from + i));
+        const __m128i hi = _mm_loadu_si128((const __m128i*)(from + i + 8));
+        _mm256_storeu_si256((__m256i*)(to + i), _mm256_cvtepu16_epi32(lo));
+        _mm256_storeu_si256((__m256i*)(to + i + 8), _mm256_cvtepu16_epi32(hi));
+    }
+    widenIndicesScalar(from + i, to + i, num - i);
+}
+
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 void
+swizzleRGBAToBGRAAVX2(const void* from, void* to, int numPixels) {
+    // NOTE: the byte shuffle works per 128-bit lane
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const uint32_t* src = (const uint32_t*) from;
+    uint32_t* dst = (uint32_t*) to;
+    int i = 0;
+    for (; (i + 8) <= numPixels; i += 8) {
+        const __m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(p, shuffle));
+    }
+    swizzleRGBAToBGRAScalar(src + i, dst + i, numPixels - i);
+}
+
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 void
+copyStreamingAVX2(const void* from, void* to, int numBytes) {
+    if (numBytes < StreamingMinBytes) {
+        std::memcpy(to, from, numBytes);
+        return;
+    }
+    const uint8_t* src = (const uint8_t*) from;
+    uint8_t* dst = (uint8_t*) to;
+    const int head = int((32 - (intptr_t(dst) & 31)) & 31);
+    std::memcpy(dst, src, head);
+    src += head;
+    dst += head;
+    numBytes -= head;
+    for (; numBytes >= 128; numBytes -= 128, src += 128, dst += 128) {
+        const __m256i v0 = _mm256_loadu_si256((const __m256i*)(src + 0));
+        const __m256i v1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+        const __m256i v2 = _mm256_loadu_si256((const __m256i*)(src + 64));
+        const __m256i v3 = _mm256_loadu_si256((const __m256i*)(src + 96));
+        _mm256_stream_si256((__m256i*)(dst + 0), v0);
+        _mm256_stream_si256((__m256i*)(dst + 32), v1);
+        _mm256_stream_si256((__m256i*)(dst + 64), v2);
+        _mm256_stream_si256((__m256i*)(dst + 96), v3);
+    }
+    _mm_sfence();
+    std::memcpy(dst, src, numBytes);
+}
+#endif
+
+#if ORYOL_MEMORY_NEON
+//------------------------------------------------------------------------------
+void
+widenIndicesNEON(const uint16_t* from, uint32_t* to, int num) {
+    int i = 0;
+    for (; (i + 8) <= num; i += 8) {
+        const uint16x8_t v = vld1q_u16(from + i);
+        vst1q_u32(to + i, vmovl_u16(vget_low_u16(v)));
+        vst1q_u32(to + i + 4, vmovl_u16(vget_high_u16(v)));
+    }
+    widenIndicesScalar(from + i, to + i, num - i);
+}
+
+//------------------------------------------------------------------------------
+void
+swizzleRGBAToBGRANEON(const void* from, void* to, int numPixels) {
+    const uint8_t* src = (const uint8_t*) from;
+    uint8_t* dst = (uint8_t*) to;
+    int i = 0;
+    for (; (i + 16) <= numPixels; i += 16) {
+        // de-interleaving load puts each channel into its own register
+        uint8x16x4_t p = vld4q_u8(src + i * 4);
+        const uint8x16_t r = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = r;
+        vst4q_u8(dst + i * 4, p);
+    }
+    swizzleRGBAToBGRAScalar(src + i * 4, dst + i * 4, numPixels - i);
+}
+#endif
+
+} // anonymous namespace
+
+memorySimd::funcTable memorySimd::funcs = {
+    widenIndicesScalar,
+    swizzleRGBAToBGRAScalar,
+    copyStreamingScalar
+};
+Memory::SimdLevel memorySimd::level = Memory::SimdLevel::Scalar;
+
+namespace {
+// selects the best implementation during static initialization, until
+// then the (constant-initialized) scalar functions are used
+struct autoSelect {
+    autoSelect() {
+        memorySimd::select(memorySimd::bestLevel());
+    };
+} autoSelectInstance;
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+bool
+memorySimd::isSupported(Memory::SimdLevel lvl) {
+    switch (lvl) {
+        case Memory::SimdLevel::Scalar:
+            return true;
+        #if ORYOL_MEMORY_SSE2
+        case Memory::SimdLevel::SSE2:
+            return true;
+        #endif
+        #if ORYOL_MEMORY_AVX2
+        case Memory::SimdLevel::AVX2:
+            return cpuHasAVX2();
+        #endif
+        #if ORYOL_MEMORY_NEON
+        case Memory::SimdLevel::NEON:
+            return true;
+        #endif
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+Memory::SimdLevel
+memorySimd::bestLevel() {
+    if (isSupported(Memory::SimdLevel::AVX2)) {
+        return Memory::SimdLevel::AVX2;
+    }
+    else if (isSupported(Memory::SimdLevel::SSE2)) {
+        return Memory::SimdLevel::SSE2;
+    }
+    else if (isSupported(Memory::SimdLevel::NEON)) {
+        return Memory::SimdLevel::NEON;
+    }
+    else {
+        return Memory::SimdLevel::Scalar;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+memorySimd::select(Memory::SimdLevel lvl) {
+    o_assert(isSupported(lvl));
+    switch (lvl) {
+        #if ORYOL_MEMORY_SSE2
+        case Memory::SimdLevel::SSE2:
+            funcs.widenIndices = widenIndicesSSE2;
+            funcs.swizzleRGBAToBGRA = swizzleRGBAToBGRASSE2;
+            funcs.copyStreaming = copyStreamingSSE2;
+            break;
+        #endif
+        #if ORYOL_MEMORY_AVX2
+        case Memory::SimdLevel::AVX2:
+            funcs.widenIndices = widenIndicesAVX2;
+            funcs.swizzleRGBAToBGRA = swizzleRGBAToBGRAAVX2;
+            funcs.copyStreaming = copyStreamingAVX2;
+            break;
+        #endif
+        #if ORYOL_MEMORY_NEON
+        case Memory::SimdLevel::NEON:
+            // no non-temporal store intrinsics on ARM, memcpy is as good as it gets
+            funcs.widenIndices = widenIndicesNEON;
+            funcs.swizzleRGBAToBGRA = swizzleRGBAToBGRANEON;
+            funcs.copyStreaming = copyStreamingScalar;
+            break;
+        #endif
+        default:
+            funcs.widenIndices = widenIndicesScalar;
+            funcs.swizzleRGBAToBGRA = swizzleRGBAToBGRAScalar;
+            funcs.copyStreaming = copyStreamingScalar;
+            break;
+    }
+    level = lvl;
+}
+
+} // namespace _priv
+} // namespace Oryol
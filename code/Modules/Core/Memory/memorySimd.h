@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::memorySimd
+    @ingroup _priv
+    @brief SIMD implementations of the Memory bulk functions
+
+    Holds a table of function pointers for the Memory bulk functions
+    (index widening, pixel swizzling and streaming copies). The table
+    is initialized to the scalar fallbacks, and switched to the best
+    implementation supported by the CPU (SSE2, AVX2 or NEON) during
+    static initialization.
+*/
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+class memorySimd {
+public:
+    /// the function table
+    struct funcTable {
+        void (*widenIndices)(const uint16_t* from, uint32_t* to, int num);
+        void (*swizzleRGBAToBGRA)(const void* from, void* to, int numPixels);
+        void (*copyStreaming)(const void* from, void* to, int numBytes);
+    };
+    /// the currently selected functions
+    static funcTable funcs;
+    /// the currently selected SIMD level
+    static Memory::SimdLevel level;
+
+    /// return true if a SIMD level is supported by compiler and CPU
+    static bool isSupported(Memory::SimdLevel level);
+    /// get the best supported SIMD level
+    static Memory::SimdLevel bestLevel();
+    /// select the functions for a SIMD level (must be supported)
+    static void select(Memory::SimdLevel level);
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,439 @@
+//------------------------------------------------------------------------------
+//  memoryTracker.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdlib>
+#include <cstring>
+#include "memoryTracker.h"
+#include "Core/Assertion.h"
+#include "Core/StackTrace.h"
+#include "Core/Log.h"
+
+namespace Oryol {
+namespace _priv {
+
+std::atomic<bool> memoryTracker::enabled{false};
+std::atomic<int> memoryTracker::sampleRate{1};
+
+namespace {
+
+// skip StackTrace::Capture(), recordAlloc() and Memory::Alloc() in captured callstacks
+const int SkipFrames = 3;
+
+// an event in the ring buffer
+struct event {
+    std::atomic<uint64_t> seq;
+    void* ptr;
+    int32_t size;
+    uint8_t tag;
+    uint8_t isFree;
+    uint8_t numFrames;
+    void* frames[memoryTracker::MaxFrames];
+};
+
+// allocation statistics of one callsite
+struct callSite {
+    uint64_t hash;
+    void* frames[memoryTracker::MaxFrames];
+    int numFrames;
+    uint32_t tag;
+    int64_t frameAllocs;
+    int64_t frameBytes;
+    int64_t liveAllocs;
+    int64_t liveBytes;
+    int64_t totalAllocs;
+};
+
+// a live allocation
+struct liveAlloc {
+    int32_t site;
+    int32_t size;
+};
+
+//------------------------------------------------------------------------------
+// minimal malloc-backed hash table with linear probing, key 0 is reserved
+// (the tracker can't use the Oryol containers, since these call Memory::Alloc)
+template<class VALUE> class rawTable {
+public:
+    /// find value by key, nullptr if not found
+    VALUE* find(uint64_t key) {
+        if (0 == this->num) {
+            return nullptr;
+        }
+        const uint32_t mask = this->cap - 1;
+        for (uint32_t i = hash(key) & mask; ; i = (i + 1) & mask) {
+            if (this->keys[i] == key) {
+                return &this->values[i];
+            }
+            else if (0 == this->keys[i]) {
+                return nullptr;
+            }
+        }
+    };
+    /// insert or overwrite value
+    void insert(uint64_t key, const VALUE& value) {
+        o_assert_dbg(0 != key);
+        if (((this->num + 1) * 2) > this->cap) {
+            this->grow();
+        }
+        const uint32_t mask = this->cap - 1;
+        for (uint32_t i = hash(key) & mask; ; i = (i + 1) & mask) {
+            if (0 == this->keys[i]) {
+                this->keys[i] = key;
+                this->values[i] = value;
+                this->num++;
+                return;
+            }
+            else if (this->keys[i] == key) {
+                this->values[i] = value;
+                return;
+            }
+        }
+    };
+    /// remove value, return false if not found
+    bool erase(uint64_t key, VALUE& outValue) {
+        VALUE* valuePtr = this->find(key);
+        if (nullptr == valuePtr) {
+            return false;
+        }
+        outValue = *valuePtr;
+        // backward-shift deletion, keeps probe sequences intact
+        const uint32_t mask = this->cap - 1;
+        uint32_t hole = uint32_t(valuePtr - this->values);
+        for (uint32_t i = (hole + 1) & mask; 0 != this->keys[i]; i = (i + 1) & mask) {
+            const uint32_t home = hash(this->keys[i]) & mask;
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                this->keys[hole] = this->keys[i];
+                this->values[hole] = this->values[i];
+                hole = i;
+            }
+        }
+        this->keys[hole] = 0;
+        this->num--;
+        return true;
+    };
+
+private:
+    static uint32_t hash(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        return uint32_t(key);
+    };
+    void grow() {
+        const uint32_t oldCap = this->cap;
+        uint64_t* oldKeys = this->keys;
+        VALUE* oldValues = this->values;
+        this->cap = oldCap ? oldCap * 2 : 1024;
+        this->keys = (uint64_t*) std::calloc(this->cap, sizeof(uint64_t));
+        this->values = (VALUE*) std::malloc(this->cap * sizeof(VALUE));
+        o_assert(this->keys && this->values);
+        this->num = 0;
+        for (uint32_t i = 0; i < oldCap; i++) {
+            if (0 != oldKeys[i]) {
+                this->insert(oldKeys[i], oldValues[i]);
+            }
+        }
+        std::free(oldKeys);
+        std::free(oldValues);
+    };
+
+    uint64_t* keys = nullptr;
+    VALUE* values = nullptr;
+    uint32_t cap = 0;
+    uint32_t num = 0;
+};
+
+// producer state
+#if ORYOL_HAS_THREADS
+thread_local int suspendCount = 0;
+thread_local int sampleCountdown = 0;
+#else
+int suspendCount = 0;
+int sampleCountdown = 0;
+#endif
+std::atomic<event*> ring{nullptr};
+std::atomic<uint64_t> writePos{0};
+std::atomic<int64_t> numDropped{0};
+
+// consumer state, only accessed from the main thread
+uint64_t readPos = 0;
+callSite* sites = nullptr;
+int numSites = 0;
+int maxSites = 0;
+rawTable<int> siteIndices;
+rawTable<liveAlloc> liveAllocs;
+Memory::TrackingStats curStats;
+
+//------------------------------------------------------------------------------
+int
+lookupSite(const event& ev) {
+    // FNV-1a over the callstack and tag
+    uint64_t hash = 14695981039346656037ULL;
+    const uint8_t* bytes = (const uint8_t*) ev.frames;
+    const int numBytes = ev.numFrames * int(sizeof(void*));
+    for (int i = 0; i < numBytes; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    hash = (hash ^ ev.tag) * 1099511628211ULL;
+    if (0 == hash) {
+        hash = 1;
+    }
+    const int* indexPtr = siteIndices.find(hash);
+    if (indexPtr) {
+        return *indexPtr;
+    }
+    if (numSites == maxSites) {
+        maxSites = maxSites ? maxSites * 2 : 256;
+        sites = (callSite*) std::realloc(sites, maxSites * sizeof(callSite));
+        o_assert(sites);
+    }
+    const int index = numSites++;
+    callSite& site = sites[index];
+    std::memset(&site, 0, sizeof(site));
+    site.hash = hash;
+    site.numFrames = ev.numFrames;
+    std::memcpy(site.frames, ev.frames, ev.numFrames * sizeof(void*));
+    site.tag = ev.tag;
+    siteIndices.insert(hash, index);
+    return index;
+}
+
+//------------------------------------------------------------------------------
+void
+processEvent(const event& ev) {
+    const uint64_t key = uint64_t(uintptr_t(ev.ptr));
+    liveAlloc alloc;
+    if (ev.isFree) {
+        if (liveAllocs.erase(key, alloc)) {
+            sites[alloc.site].liveAllocs--;
+            sites[alloc.site].liveBytes -= alloc.size;
+            curStats.LiveAllocs--;
+            curStats.LiveBytes -= alloc.size;
+        }
+        // otherwise this was allocated before tracking was enabled
+    }
+    else {
+        // a stale entry for the same pointer means a free event was dropped
+        if (liveAllocs.erase(key, alloc)) {
+            sites[alloc.site].liveAllocs--;
+            sites[alloc.site].liveBytes -= alloc.size;
+            curStats.LiveAllocs--;
+            curStats.LiveBytes -= alloc.size;
+        }
+        alloc.site = lookupSite(ev);
+        alloc.size = ev.size;
+        liveAllocs.insert(key, alloc);
+        callSite& site = sites[alloc.site];
+        site.frameAllocs++;
+        site.frameBytes += ev.size;
+        site.liveAllocs++;
+        site.liveBytes += ev.size;
+        site.totalAllocs++;
+        curStats.FrameAllocs++;
+        curStats.FrameBytes += ev.size;
+        curStats.LiveAllocs++;
+        curStats.LiveBytes += ev.size;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+drain() {
+    event* r = ring.load(std::memory_order_acquire);
+    if (nullptr == r) {
+        return;
+    }
+    for (;;) {
+        event& ev = r[readPos & (memoryTracker::RingSize - 1)];
+        if (ev.seq.load(std::memory_order_acquire) != (readPos + 1)) {
+            break;
+        }
+        processEvent(ev);
+        ev.seq.store(readPos + memoryTracker::RingSize, std::memory_order_release);
+        readPos++;
+    }
+    curStats.DroppedEvents = numDropped.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+logSite(const callSite& site, int numFrames) {
+    Log::Info("  %lld allocs/frame, %lld bytes/frame, %lld live allocs, %lld live bytes (%s)\n",
+        (long long)site.frameAllocs, (long long)site.frameBytes,
+        (long long)site.liveAllocs, (long long)site.liveBytes,
+        Memory::TagToString(Memory::Tag(site.tag)));
+    char buf[512];
+    for (int i = 0; (i < site.numFrames) && (i < numFrames); i++) {
+        StackTrace::Symbolize(site.frames[i], buf, sizeof(buf));
+        Log::Info("    %s\n", buf);
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::setEnabled(bool b, int rate) {
+    o_assert(rate > 0);
+    sampleRate.store(rate, std::memory_order_relaxed);
+    if (b && (nullptr == ring.load(std::memory_order_relaxed))) {
+        // the ring buffer is never freed, other threads may still
+        // access it after tracking has been disabled
+        event* r = (event*) std::malloc(RingSize * sizeof(event));
+        o_assert(r);
+        for (int i = 0; i < RingSize; i++) {
+            new(&r[i].seq) std::atomic<uint64_t>(uint64_t(i));
+        }
+        ring.store(r, std::memory_order_release);
+    }
+    enabled.store(b, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::recordAlloc(void* ptr, int size, uint32_t tag) {
+    if (suspendCount > 0) {
+        return;
+    }
+    const int rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate > 1) {
+        // the countdown may be left over from a higher sample rate
+        if ((--sampleCountdown > 0) && (sampleCountdown < rate)) {
+            return;
+        }
+        sampleCountdown = rate;
+    }
+    void* frames[MaxFrames + SkipFrames];
+    int numFrames = StackTrace::Capture(frames, MaxFrames + SkipFrames) - SkipFrames;
+    if (numFrames < 0) {
+        numFrames = 0;
+    }
+    push(ptr, size, tag, false, frames + SkipFrames, numFrames);
+}
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::recordFree(void* ptr, int size, uint32_t tag) {
+    push(ptr, size, tag, true, nullptr, 0);
+}
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::suspendThread() {
+    suspendCount++;
+}
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::resumeThread() {
+    o_assert_dbg(suspendCount > 0);
+    suspendCount--;
+}
+
+//------------------------------------------------------------------------------
+void
+memoryTracker::push(void* ptr, int size, uint32_t tag, bool isFree, void** frames, int numFrames) {
+    event* r = ring.load(std::memory_order_acquire);
+    if (nullptr == r) {
+        return;
+    }
+
+    // claim a slot, drop the event if the ring buffer is full
+    uint64_t pos = writePos.load(std::memory_order_relaxed);
+    event* ev;
+    for (;;) {
+        ev = &r[pos & (RingSize - 1)];
+        const int64_t diff = int64_t(ev->seq.load(std::memory_order_acquire) - pos);
+        if (0 == diff) {
+            if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            pos = writePos.load(std::memory_order_relaxed);
+        }
+    }
+    ev->ptr = ptr;
+    ev->size = size;
+    ev->tag = uint8_t(tag);
+    ev->isFree = isFree ? 1 : 0;
+    ev->numFrames = uint8_t(numFrames);
+    if (numFrames > 0) {
+        std::memcpy(ev->frames, frames, numFrames * sizeof(void*));
+    }
+    ev->seq.store(pos + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+Memory::TrackingStats
+memoryTracker::endFrame(int logTopN) {
+    drain();
+    Memory::TrackingStats stats = curStats;
+    if (logTopN > 0) {
+        Log::Info("Memory tracking: %lld allocs/frame, %lld bytes/frame, %lld live allocs, %lld live bytes, %lld dropped events\n",
+            (long long)stats.FrameAllocs, (long long)stats.FrameBytes,
+            (long long)stats.LiveAllocs, (long long)stats.LiveBytes,
+            (long long)stats.DroppedEvents);
+        // simple selection of the callsites with most bytes in this frame
+        const int maxTop = 32;
+        int top[maxTop];
+        int numTop = 0;
+        if (logTopN > maxTop) {
+            logTopN = maxTop;
+        }
+        for (int i = 0; i < numSites; i++) {
+            if (0 == sites[i].frameAllocs) {
+                continue;
+            }
+            int pos = numTop;
+            while ((pos > 0) && (sites[top[pos - 1]].frameBytes < sites[i].frameBytes)) {
+                if (pos < logTopN) {
+                    top[pos] = top[pos - 1];
+                }
+                pos--;
+            }
+            if (pos < logTopN) {
+                top[pos] = i;
+                if (numTop < logTopN) {
+                    numTop++;
+                }
+            }
+        }
+        for (int i = 0; i < numTop; i++) {
+            logSite(sites[top[i]], 2);
+        }
+    }
+
+    // start a new frame
+    for (int i = 0; i < numSites; i++) {
+        sites[i].frameAllocs = 0;
+        sites[i].frameBytes = 0;
+    }
+    curStats.FrameAllocs = 0;
+    curStats.FrameBytes = 0;
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+int
+memoryTracker::dumpLeaks() {
+    drain();
+    if (curStats.LiveAllocs > 0) {
+        Log::Warn("Memory tracking: %lld live allocations (%lld bytes):\n",
+            (long long)curStats.LiveAllocs, (long long)curStats.LiveBytes);
+        for (int i = 0; i < numSites; i++) {
+            if (sites[i].liveAllocs > 0) {
+                logSite(sites[i], MaxFrames);
+            }
+        }
+    }
+    return int(curStats.LiveAllocs);
+}
+
+} // namespace _priv
+} // namespace Oryol
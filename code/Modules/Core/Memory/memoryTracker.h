@@ -0,0 +1,74 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::memoryTracker
+    @ingroup _priv
+    @brief records allocations for Memory::SetTracking()
+
+    When tracking is enabled, Memory::Alloc() and Memory::Free() push
+    an event (pointer, size, tag and the raw callstack) into a lock-free
+    ring buffer, this is the only work done on the allocating thread.
+    The events are processed on the main thread in endFrame(), which
+    groups allocations by callsite and keeps a table of live allocations.
+
+    Capturing the callstack is by far the most expensive part, with a
+    sample rate of N only every Nth allocation of a thread is recorded
+    (the free events of unrecorded allocations are ignored in endFrame()),
+    so that all counters and leak reports cover about 1/N of the
+    allocations.
+
+    All memory used by the tracker comes from malloc(), so the tracker
+    never shows up in its own statistics. If the ring buffer is full,
+    events are dropped and counted, a dropped free event causes a false
+    leak report for its allocation.
+
+    Memory which is intentionally never freed (like the string atom
+    tables) is allocated between suspendThread() and resumeThread(),
+    so that it doesn't show up as a leak.
+*/
+#include "Core/Memory/Memory.h"
+#include <atomic>
+
+namespace Oryol {
+namespace _priv {
+
+class memoryTracker {
+public:
+    /// number of events in the ring buffer
+    static const int RingSize = 1<<16;
+    /// max number of captured stack frames per allocation
+    static const int MaxFrames = 8;
+
+    /// enable or disable tracking, record every sampleRate'th allocation
+    static void setEnabled(bool enabled, int sampleRate);
+    /// return true if tracking is enabled
+    static bool isEnabled();
+    /// record an allocation (call after the allocation)
+    static void recordAlloc(void* ptr, int size, uint32_t tag);
+    /// record a free (call before the memory is freed)
+    static void recordFree(void* ptr, int size, uint32_t tag);
+    /// don't record allocations on the current thread until resumeThread() (nestable)
+    static void suspendThread();
+    /// undo suspendThread()
+    static void resumeThread();
+    /// process recorded events, log top callsites, start new frame
+    static Memory::TrackingStats endFrame(int logTopN);
+    /// log live allocations by callsite, return number of live allocations
+    static int dumpLeaks();
+
+private:
+    /// push an event into the ring buffer
+    static void push(void* ptr, int size, uint32_t tag, bool isFree, void** frames, int numFrames);
+
+    static std::atomic<bool> enabled;
+    static std::atomic<int> sampleRate;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+memoryTracker::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+} // namespace _priv
+} // namespace Oryol
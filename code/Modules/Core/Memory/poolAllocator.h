@@ -141,7 +141,7 @@ poolAllocator<TYPE>::allocPuddle() {
     
     // allocate new puddle
     const uint32_t puddleByteSize = NumPuddleElements * this->elmSize;
-    this->puddles[newPuddleIndex] = (uint8_t*) Memory::Alloc(puddleByteSize);
+    this->puddles[newPuddleIndex] = (uint8_t*) Memory::Alloc(puddleByteSize, Memory::Tag::Containers);
     Memory::Clear(this->puddles[newPuddleIndex], puddleByteSize);
     
     // populate the free stack
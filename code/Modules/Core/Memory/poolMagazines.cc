@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//  poolMagazines.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdlib>
+#include "poolMagazines.h"
+#include "Core/Assertion.h"
+#include "Core/Threading/threadExit.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+ORYOL_THREADLOCAL_PTR(poolMagazines::threadTable) poolMagazines::table = nullptr;
+poolMagazines::threadTable* poolMagazines::allTables = nullptr;
+
+namespace {
+
+struct slot {
+    void* owner;
+    poolMagazines::flushFunc func;
+    uint32_t generation;
+};
+// NOTE: these are constant-initialized before any static constructor runs
+slot slots[poolMagazines::MaxSlots];
+#if ORYOL_HAS_THREADS
+std::mutex slotLock;
+#endif
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int
+poolMagazines::registerOwner(void* owner, flushFunc func, uint32_t& outGeneration) {
+    o_assert_dbg(owner && func);
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(slotLock);
+    #endif
+    for (int i = 0; i < MaxSlots; i++) {
+        if (nullptr == slots[i].owner) {
+            slots[i].owner = owner;
+            slots[i].func = func;
+            outGeneration = ++slots[i].generation;
+            return i;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazines::unregisterOwner(int slotIndex) {
+    o_assert_range_dbg(slotIndex, MaxSlots);
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(slotLock);
+    #endif
+    // flush the magazines of all threads back into the owner
+    slot& s = slots[slotIndex];
+    for (threadTable* t = allTables; t; t = t->next) {
+        magazine* mag = t->mags[slotIndex];
+        if (mag && (mag->generation == s.generation)) {
+            if (mag->num > 0) {
+                s.func(s.owner, mag);
+            }
+            mag->num = 0;
+        }
+    }
+    slots[slotIndex].owner = nullptr;
+    slots[slotIndex].func = nullptr;
+    slots[slotIndex].generation++;
+}
+
+//------------------------------------------------------------------------------
+poolMagazines::threadTable*
+poolMagazines::createThreadTable() {
+    o_assert_dbg(nullptr == table);
+    threadTable* t = (threadTable*) std::calloc(1, sizeof(threadTable));
+    o_assert(t);
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(slotLock);
+        #endif
+        t->next = allTables;
+        if (allTables) {
+            allTables->prev = t;
+        }
+        allTables = t;
+    }
+    table = t;
+    threadExit::add(discardThread);
+    return t;
+}
+
+//------------------------------------------------------------------------------
+poolMagazines::magazine*
+poolMagazines::createMagazine(threadTable* t, int slotIndex) {
+    o_assert_range_dbg(slotIndex, MaxSlots);
+    o_assert_dbg(nullptr == t->mags[slotIndex]);
+    magazine* mag = (magazine*) std::malloc(sizeof(magazine));
+    o_assert(mag);
+    new(mag) magazine();
+    t->mags[slotIndex] = mag;
+    return mag;
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazines::discardThread() {
+    threadTable* t = table;
+    if (nullptr == t) {
+        return;
+    }
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(slotLock);
+        #endif
+        if (t->prev) {
+            t->prev->next = t->next;
+        }
+        else {
+            allTables = t->next;
+        }
+        if (t->next) {
+            t->next->prev = t->prev;
+        }
+        for (int i = 0; i < MaxSlots; i++) {
+            magazine* mag = t->mags[i];
+            if (mag) {
+                if ((mag->num > 0) && slots[i].owner && (slots[i].generation == mag->generation)) {
+                    slots[i].func(slots[i].owner, mag);
+                }
+                std::free(mag);
+            }
+        }
+    }
+    std::free(t);
+    table = nullptr;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,90 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::poolMagazines
+    @ingroup _priv
+    @brief per-thread free-list caches for growablePoolAllocator
+
+    Each growablePoolAllocator with magazines enabled registers itself
+    in one of MaxSlots slots. Each thread owns a table of "magazines"
+    (small arrays of free pool nodes), one per slot. The pool allocator
+    pops from and pushes to the thread's magazine without touching the
+    shared free-list, and only refills or flushes the magazine in batches.
+
+    Slots are recycled with a generation counter, a magazine with
+    an outdated generation belongs to an already destroyed allocator
+    and is silently emptied.
+
+    When a thread calls Core::LeaveThread() (or the main thread calls
+    Core::Discard()), or when it exits, its magazines are flushed back
+    into their allocators. When an allocator unregisters, the magazines
+    of all threads are flushed back into it. If no slot is free, the
+    allocator works without magazines.
+*/
+#include "Core/Types.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+
+namespace Oryol {
+namespace _priv {
+
+class poolMagazines {
+public:
+    /// max number of allocators with magazines
+    static const int MaxSlots = 256;
+    /// max magazine size (a magazine can hold up to 2x this many nodes)
+    static const int MaxMagazineSize = 256;
+
+    /// a per-thread magazine
+    struct magazine {
+        uint32_t generation = 0;
+        int num = 0;
+        void* items[2 * MaxMagazineSize];
+    };
+    /// callback to flush a magazine back into its owner allocator
+    typedef void (*flushFunc)(void* owner, magazine* mag);
+
+    /// register an allocator, return slot index, or -1 if no slots are free
+    static int registerOwner(void* owner, flushFunc func, uint32_t& outGeneration);
+    /// unregister an allocator, flushes the magazines of all threads (no other thread may use the allocator)
+    static void unregisterOwner(int slot);
+    /// get the current thread's magazine for a slot
+    static magazine* get(int slot, uint32_t generation);
+    /// flush and discard all magazines of the current thread
+    static void discardThread();
+
+private:
+    struct threadTable {
+        threadTable* prev;
+        threadTable* next;
+        magazine* mags[MaxSlots];
+    };
+    /// create the current thread's magazine table
+    static threadTable* createThreadTable();
+    /// create a magazine in the current thread's table
+    static magazine* createMagazine(threadTable* table, int slot);
+
+    static ORYOL_THREADLOCAL_PTR(threadTable) table;
+    static threadTable* allTables;
+};
+
+//------------------------------------------------------------------------------
+inline poolMagazines::magazine*
+poolMagazines::get(int slot, uint32_t generation) {
+    threadTable* t = table;
+    if (nullptr == t) {
+        t = createThreadTable();
+    }
+    magazine* mag = t->mags[slot];
+    if (nullptr == mag) {
+        mag = createMagazine(t, slot);
+    }
+    if (mag->generation != generation) {
+        // magazine of a destroyed allocator, drop its content
+        mag->generation = generation;
+        mag->num = 0;
+    }
+    return mag;
+}
+
+} // namespace _priv
+} // namespace Oryol
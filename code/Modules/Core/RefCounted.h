@@ -14,7 +14,7 @@
 #include "Core/Types.h"
 #include "Core/Ptr.h"
 #include "Core/Class.h"
-#include "Core/Memory/poolAllocator.h"
+#include "Core/Memory/growablePoolAllocator.h"
 
 namespace Oryol {
     
@@ -52,7 +52,9 @@ RefCounted::addRef() {
 inline void
 RefCounted::release() {
     #if ORYOL_HAS_ATOMIC
-    if (1 == this->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+    // acq_rel so that all accesses of other threads which released
+    // their reference happen before the object is destroyed
+    if (1 == this->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
     #else
     if (1 == this->refCount--) {
     #endif
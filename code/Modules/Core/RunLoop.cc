@@ -3,19 +3,66 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Time/Clock.h"
 
 namespace Oryol {
 
+namespace {
+
+//------------------------------------------------------------------------------
+bool
+intersects(const Array<StringAtom>& a, const Array<StringAtom>& b) {
+    for (const StringAtom& x : a) {
+        for (const StringAtom& y : b) {
+            if (x == y) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Returns true if a callback with deps 'later' must wait for an earlier
+    callback with deps 'earlier'.
+*/
+bool
+conflicts(const RunLoop::Deps& earlier, const RunLoop::Deps& later) {
+    return intersects(earlier.Writes, later.Reads) ||
+           intersects(earlier.Writes, later.Writes) ||
+           intersects(earlier.Reads, later.Writes);
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 RunLoop::RunLoop() :
-curId(InvalidId)
+curId(InvalidId),
+graphDirty(false),
+pending(nullptr),
+pendingCapacity(0)
 {
     // empty
 }
 
 //------------------------------------------------------------------------------
 RunLoop::~RunLoop() {
-    // empty
+    this->freePending();
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::freePending() {
+    if (this->pending) {
+        for (int i = 0; i < this->pendingCapacity; i++) {
+            this->pending[i].~atomic();
+        }
+        Memory::Free(this->pending);
+        this->pending = nullptr;
+        this->pendingCapacity = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -23,9 +70,22 @@ void
 RunLoop::Run() {
     this->remCallbacks();
     this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
+    if (this->graphDirty) {
+        this->buildGraph();
+    }
+    const int num = this->nodes.Size();
+    for (int i = 0; i < num; ) {
+        if (this->nodes[i].callback->hasDeps) {
+            // a group of consecutive callbacks with Deps
+            int end = i + 1;
+            while ((end < num) && this->nodes[end].callback->hasDeps) {
+                end++;
+            }
+            this->runGroup(i, end);
+            i = end;
+        }
+        else {
+            this->call(i++);
         }
     }
     this->remCallbacks();
@@ -38,6 +98,15 @@ RunLoop::HasCallback(Id id) const {
     return this->callbacks.Contains(id) || this->toAdd.Contains(id);
 }
 
+//------------------------------------------------------------------------------
+Duration
+RunLoop::CallbackDuration(Id id) const {
+    if (this->callbacks.Contains(id)) {
+        return this->callbacks[id].duration;
+    }
+    return Duration();
+}
+
 //------------------------------------------------------------------------------
 /**
  NOTE: the callback function will not be added immediately, but at the
@@ -46,13 +115,25 @@ RunLoop::HasCallback(Id id) const {
 RunLoop::Id
 RunLoop::Add(Func func) {
     Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
+    this->toAdd.Add(newId, item{func, false, false, Deps(), Duration()});
+    return newId;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the callback function will not be added immediately, but at the
+ start or end of the Run function.
+*/
+RunLoop::Id
+RunLoop::Add(Func func, const Deps& deps) {
+    Id newId = ++this->curId;
+    this->toAdd.Add(newId, item{func, false, true, deps, Duration()});
     return newId;
 }
 
 //------------------------------------------------------------------------------
 /**
- NOTE: the callback function not be removed immediately, but at the 
+ NOTE: the callback function not be removed immediately, but at the
  start or end of the Run function.
 */
 void
@@ -69,6 +150,7 @@ RunLoop::addCallbacks() {
         item& item = entry.Value();
         item.valid = true;
         this->callbacks.Add(entry.Key(), item);
+        this->graphDirty = true;
     }
     this->toAdd.Clear();
 }
@@ -79,6 +161,7 @@ RunLoop::remCallbacks() {
     for (Id id : this->toRemove) {
         if (this->callbacks.Contains(id)) {
             this->callbacks.Erase(id);
+            this->graphDirty = true;
         }
         else if (this->toAdd.Contains(id)) {
             this->toAdd.Erase(id);
@@ -87,4 +170,93 @@ RunLoop::remCallbacks() {
     this->toRemove.Clear();
 }
 
+//------------------------------------------------------------------------------
+/**
+ Callbacks are run in id order, so edges only point from earlier to later
+ callbacks of the same group, which keeps the graph acyclic, and the id
+ order a valid order to run a group serially.
+*/
+void
+RunLoop::buildGraph() {
+    this->nodes.Clear();
+    this->successors.Clear();
+    for (auto& entry : this->callbacks) {
+        node n;
+        n.callback = &entry.Value();
+        this->nodes.Add(n);
+    }
+    const int num = this->nodes.Size();
+    for (int i = 0; i < num; i++) {
+        node& n = this->nodes[i];
+        n.firstSuccessor = this->successors.Size();
+        if (n.callback->hasDeps) {
+            for (int k = i + 1; (k < num) && this->nodes[k].callback->hasDeps; k++) {
+                if (conflicts(n.callback->deps, this->nodes[k].callback->deps)) {
+                    this->successors.Add(k);
+                    this->nodes[k].numPredecessors++;
+                }
+            }
+        }
+        n.numSuccessors = this->successors.Size() - n.firstSuccessor;
+    }
+    if (num > this->pendingCapacity) {
+        this->freePending();
+        this->pending = (std::atomic<int>*) Memory::Alloc(sizeof(std::atomic<int>) * num);
+        for (int i = 0; i < num; i++) {
+            new(&this->pending[i]) std::atomic<int>(0);
+        }
+        this->pendingCapacity = num;
+    }
+    this->graphDirty = false;
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::call(int nodeIndex) {
+    item* callback = this->nodes[nodeIndex].callback;
+    if (callback->valid) {
+        const TimePoint start = Clock::Now();
+        callback->func();
+        callback->duration = Clock::Since(start);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::runGroup(int begin, int end) {
+    if (!JobSystem::IsValid() || ((end - begin) == 1)) {
+        for (int i = begin; i < end; i++) {
+            this->call(i);
+        }
+        return;
+    }
+    for (int i = begin; i < end; i++) {
+        this->pending[i].store(this->nodes[i].numPredecessors, std::memory_order_relaxed);
+    }
+    JobSystem::Counter done;
+    for (int i = begin; i < end; i++) {
+        if (0 == this->nodes[i].numPredecessors) {
+            JobSystem::Run([this, i, &done] {
+                this->runJob(i, &done);
+            }, &done);
+        }
+    }
+    JobSystem::Wait(done);
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::runJob(int nodeIndex, JobSystem::Counter* done) {
+    this->call(nodeIndex);
+    const node& n = this->nodes[nodeIndex];
+    for (int i = 0; i < n.numSuccessors; i++) {
+        const int succ = this->successors[n.firstSuccessor + i];
+        if (1 == this->pending[succ].fetch_sub(1, std::memory_order_acq_rel)) {
+            JobSystem::Run([this, succ, done] {
+                this->runJob(succ, done);
+            }, done);
+        }
+    }
+}
+
 } // namespace Oryol
@@ -22,11 +22,29 @@
 
         MyClass myObj;<br>
         Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+
+    Callbacks added with RunLoop::Deps declare which named resources
+    they read and write. Consecutive callbacks with Deps run as jobs on
+    the JobSystem (if it has been setup), callbacks which don't conflict
+    run concurrently, a callback which writes a resource runs after all
+    earlier callbacks which read or write it, and a callback which reads
+    a resource runs after all earlier callbacks which write it. Callbacks
+    without Deps run on the calling thread, after all earlier callbacks
+    and before all later callbacks. Callbacks running as jobs must not
+    add or remove callbacks of their run loop.
+
+    The duration of each callback's last call can be queried with
+    CallbackDuration().
 */
 #include <functional>
+#include <initializer_list>
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/Time/Duration.h"
+#include "Core/Threading/JobSystem.h"
 
 namespace Oryol {
 
@@ -38,6 +56,18 @@ public:
     static const Id InvalidId = 0;
     /// runloop function typedef
     typedef std::function<void()> Func;
+    /// resources read and written by a callback
+    struct Deps {
+        /// default constructor
+        Deps() { }
+        /// construct with read and written resources
+        Deps(std::initializer_list<StringAtom> reads, std::initializer_list<StringAtom> writes) :
+            Reads(reads), Writes(writes) { }
+        /// resources read by the callback
+        Array<StringAtom> Reads;
+        /// resources written by the callback
+        Array<StringAtom> Writes;
+    };
 
     /// constructor
     RunLoop();
@@ -49,26 +79,54 @@ public:
     
     /// add a callback to the run loop, higher priorities run earlier, slow!
     Id Add(Func func);
+    /// add a callback with declared dependencies, may run concurrently with other callbacks, slow!
+    Id Add(Func func, const Deps& deps);
     /// remove a callback, slow!
     void Remove(Id);
     /// test if a callback has been attached, slow!
     bool HasCallback(Id) const;
+    /// get duration of the last call of a callback
+    Duration CallbackDuration(Id) const;
     
 private:
     /// add new callbacks that have been added (called at beginning of Run())
     void addCallbacks();
     /// remove callbacks that have been removed (called at end of Run())
     void remCallbacks();
+    /// rebuild the dependency graph after callbacks have been added or removed
+    void buildGraph();
+    /// call a callback and measure its duration
+    void call(int nodeIndex);
+    /// run callbacks [begin, end) which all have Deps
+    void runGroup(int begin, int end);
+    /// run a callback as job, and start the jobs which depended on it
+    void runJob(int nodeIndex, JobSystem::Counter* done);
+    /// destroy and free the pending-predecessor counters
+    void freePending();
     
     struct item {
         Func func;
         bool valid;
+        bool hasDeps;
+        Deps deps;
+        Duration duration;
+    };
+    struct node {
+        item* callback = nullptr;
+        int numPredecessors = 0;
+        int firstSuccessor = 0;
+        int numSuccessors = 0;
     };
     
     Id curId;
     Map<Id, item> callbacks;
     Map<Id, item> toAdd;
     Set<Id> toRemove;
+    bool graphDirty;
+    Array<node> nodes;
+    Array<int> successors;
+    std::atomic<int>* pending;
+    int pendingCapacity;
 };
     
 } // namespace Oryol
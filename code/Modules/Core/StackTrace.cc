@@ -18,6 +18,7 @@
 #endif
 #if HAVE_STACKWALKER
 #include "Core/windows/StackWalker.h"
+#include <windows.h>
 #endif
 #include <cstdlib>
 #include <cstring>
@@ -76,6 +77,23 @@ StackTrace::Dump(char* buf, int bufSize) {
     std::free(symbols);
 }
 
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** frames, int maxFrames) {
+    return backtrace(frames, maxFrames);
+}
+
+//------------------------------------------------------------------------------
+void
+StackTrace::Symbolize(void* frame, char* buf, int bufSize) {
+    buf[0] = 0;
+    char** symbols = backtrace_symbols(&frame, 1);
+    if (symbols) {
+        appendString(symbols[0], buf, buf + bufSize, false);
+        std::free(symbols);
+    }
+}
+
 //------------------------------------------------------------------------------
 #elif HAVE_STACKWALKER
 class OryolStackWalker : public StackWalker {
@@ -100,6 +118,18 @@ StackTrace::Dump(char* buf, int bufSize) {
     stackWalker.ShowCallstack();
 }
 
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** frames, int maxFrames) {
+    return CaptureStackBackTrace(0, maxFrames, frames, nullptr);
+}
+
+//------------------------------------------------------------------------------
+void
+StackTrace::Symbolize(void* frame, char* buf, int bufSize) {
+    std::snprintf(buf, bufSize, "%p", frame);
+}
+
 //------------------------------------------------------------------------------
 #else
 void
@@ -107,6 +137,18 @@ StackTrace::Dump(char* buf, int bufSize) {
     std::strncpy(buf, "STACK TRACE NOT IMPLEMENTED\n", bufSize);
     buf[bufSize-1] = 0;
 }
+
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** /*frames*/, int /*maxFrames*/) {
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+void
+StackTrace::Symbolize(void* frame, char* buf, int bufSize) {
+    std::snprintf(buf, bufSize, "%p", frame);
+}
 #endif
 
 } // namespace Oryol
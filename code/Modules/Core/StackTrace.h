@@ -12,6 +12,10 @@ class StackTrace {
 public:
     /// write stack trace into buf as human-readable string 
     static void Dump(char* buf, int bufSize);
+    /// capture raw return addresses of the current stack (cheap), return number of frames
+    static int Capture(void** frames, int maxFrames);
+    /// write human-readable name of a captured frame into buf
+    static void Symbolize(void* frame, char* buf, int bufSize);
 };
 
 } // namespace Oryol
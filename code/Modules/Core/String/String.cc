@@ -8,12 +8,9 @@
 
 namespace Oryol {
 
-const char* String::emptyString = "";
-
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
-    const char* cstr = str.AsCStr();
-    this->create(cstr, int(std::strlen(cstr)));
+    this->create(str.AsCStr(), str.Length());
 }
 
 //------------------------------------------------------------------------------
@@ -22,16 +19,13 @@ String::String(const char* str) {
         this->create(str, int(std::strlen(str)));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
-String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
+String::String() {
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -79,8 +73,7 @@ String::Assign(const char* ptr, int startIndex, int endIndex) {
 void
 String::operator=(const StringAtom& str) {
     this->release();
-    const char* cstr = str.AsCStr();
-    this->create(cstr, int(std::strlen(cstr)));
+    this->create(str.AsCStr(), str.Length());
 }
 
 //------------------------------------------------------------------------------
@@ -92,23 +85,22 @@ String::AsStringAtom() const {
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
+    o_assert(this->isHeap());
     o_assert(0 == this->data->refCount);
     this->data->~StringData();
     Memory::Free(this->data);
-    this->data = nullptr;
-    this->strPtr = nullptr;
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
 void
 String::alloc(int len) {
-    o_assert(len > 0);
-    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
+    o_assert(len > InlineCapacity);
+    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1, Memory::Tag::String);
     new(this->data) StringData();
+    this->buf[InlineCapacity] = char(HeapMarker);
     this->addRef();
     this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -116,21 +108,29 @@ void
 String::create(const char* ptr, int len) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+        char* dst;
+        if (len > InlineCapacity) {
+            this->alloc(len);
+            dst = (char*) &(this->data[1]);
+        }
+        else {
+            // short string, store inline
+            this->buf[InlineCapacity] = char(InlineCapacity - len);
+            dst = this->buf;
+        }
+        Memory::Copy(ptr, dst, len);
+        dst[len] = 0;
     }
     else {
         // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(this->isHeap());
     #if ORYOL_HAS_ATOMIC
     this->data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
@@ -141,18 +141,37 @@ String::addRef() {
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (this->isHeap()) {
         #if ORYOL_HAS_ATOMIC
-        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+        // if we're the only owner, no other thread can touch the refcount,
+        // so the atomic read-modify-write can be skipped
+        if ((1 == this->data->refCount.load(std::memory_order_acquire)) ||
+            (1 == this->data->refCount.fetch_sub(1, std::memory_order_acq_rel))) {
+            this->data->refCount.store(0, std::memory_order_relaxed);
         #else
         if (1 == this->data->refCount--) {
         #endif
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
     }
+    this->setEmpty();
+}
+
+//------------------------------------------------------------------------------
+void
+String::copy(const String& rhs) {
+    Memory::Copy(&rhs.buf, &this->buf, sizeof(this->buf));
+    if (this->isHeap()) {
+        this->addRef();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+String::move(String& rhs) {
+    Memory::Copy(&rhs.buf, &this->buf, sizeof(this->buf));
+    rhs.setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -162,30 +181,30 @@ String::release() {
  */
 void
 String::Assign(const String& rhs, int startIndex, int endIndex) {
-    this->release();
     if (EndOfString == endIndex) {
         endIndex = rhs.Length();
     }
     o_assert((startIndex >= 0) && (startIndex < endIndex));
     o_assert(endIndex <= rhs.Length());
-    this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    if (this == &rhs) {
+        // substring of ourselves, need a temporary copy
+        String tmp(rhs, startIndex, endIndex);
+        *this = std::move(tmp);
+    }
+    else {
+        this->release();
+        this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    }
 }
     
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
-        this->addRef();
-    }
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    this->move(rhs);
 }
 
 //------------------------------------------------------------------------------
@@ -207,11 +226,7 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
-            this->addRef();
-        }
+        this->copy(rhs);
     }
 }
 
@@ -220,22 +235,20 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        this->move(rhs);
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
-        return true;
-    }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
+    const int len = this->Length();
+    if (len != rhs.Length()) {
         return false;
     }
+    else if (this->isHeap() && rhs.isHeap() && (this->data == rhs.data)) {
+        return true;
+    }
     else {
         return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
     }
@@ -250,67 +263,25 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
-        return false;
-    }
-    else {
-        return std::strcmp(this->AsCStr(), rhs.AsCStr()) < 0;
-    }
+    return std::strcmp(this->AsCStr(), rhs.AsCStr()) < 0;
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
-        return false;
-    }
-    else {
-        return std::strcmp(this->AsCStr(), rhs.AsCStr()) > 0;
-    }
+    return std::strcmp(this->AsCStr(), rhs.AsCStr()) > 0;
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
-        return true;
-    }
-    else {
-        return std::strcmp(this->AsCStr(), rhs.AsCStr()) <= 0;
-    }
+    return std::strcmp(this->AsCStr(), rhs.AsCStr()) <= 0;
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
-        return true;
-    }
-    else {
-        return std::strcmp(this->AsCStr(), rhs.AsCStr()) >= 0;
-    }
-}
-
-//------------------------------------------------------------------------------
-int
-String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
-    }
-    else {
-        return this->data->length;
-    }
-}
-
-//------------------------------------------------------------------------------
-const char*
-String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
-    }
-    else {
-        return this->strPtr;
-    }
+    return std::strcmp(this->AsCStr(), rhs.AsCStr()) >= 0;
 }
 
 //------------------------------------------------------------------------------
@@ -334,19 +305,20 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int
 String::RefCount() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->isHeap()) {
+        return this->data->refCount;
     }
     else {
-        return this->data->refCount;
+        return this->Empty() ? 0 : 1;
     }
 }
 
 //------------------------------------------------------------------------------
 char
 String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+    const int len = this->Length();
+    if (len > 0) {
+        return this->AsCStr()[len - 1];
     }
     else {
         return 0;
@@ -356,12 +328,7 @@ String::Back() const {
 //------------------------------------------------------------------------------
 char
 String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
-    }
-    else {
-        return 0;
-    }
+    return this->AsCStr()[0];
 }
 
 //------------------------------------------------------------------------------
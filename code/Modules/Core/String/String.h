@@ -5,7 +5,12 @@
     @ingroup Core
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
+    An immutable, shared UTF-8 String class. Short strings (up to
+    String::InlineCapacity bytes) are stored inside the String object
+    itself, creating, copying and destroying them never allocates
+    and never touches an atomic refcount.
+    
+    Longer strings are heap-allocated, memory is only allocated
     when creating or assigning from non-String objects (const char*,
     StringAtoms). When assigning from another string,
     only a pointer to the original string data is copied, and a 
@@ -34,6 +39,9 @@ class StringAtom;
 
 class String {
 public:
+    /// max length of strings which are stored inline without allocation
+    static const int InlineCapacity = 23;
+
     /// default constructor
     String();
     /// construct from C string (allocates!)
@@ -96,8 +104,10 @@ public:
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (inline strings are never shared and return 1, empty strings return 0)
     int RefCount() const;
+    /// return true if the string data is stored inline (no heap allocation)
+    bool IsInline() const;
     
 private:
     /// shared string data header, this is followed by the actual string
@@ -110,7 +120,7 @@ private:
         int length;
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// create inline string or new string data block, numBytes does not include the terminating 0
     void create(const char* ptr, int len);
     /// private alloc function for len
     void alloc(int len);
@@ -120,12 +130,64 @@ private:
     void addRef();
     /// decrement refcount, call destroy if 0
     void release();
-    
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    /// set to empty inline string
+    void setEmpty();
+    /// copy from other string (shares heap data)
+    void copy(const String& rhs);
+    /// take over content from other string
+    void move(String& rhs);
+    /// return true if the string data lives on the heap
+    bool isHeap() const;
+    /// get pointer to the string data
+    const char* ptr() const;
+
+    /// marker in the last inline byte for heap-allocated strings, for
+    /// inline strings the last byte is (InlineCapacity - length), which
+    /// doubles as 0-terminator when the inline buffer is full
+    static const uint8_t HeapMarker = 0xFF;
+    union {
+        StringData* data;
+        char buf[InlineCapacity + 1];
+    };
 };
 
+//------------------------------------------------------------------------------
+inline bool
+String::isHeap() const {
+    return HeapMarker == uint8_t(this->buf[InlineCapacity]);
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+String::ptr() const {
+    return this->isHeap() ? (const char*) &(this->data[1]) : this->buf;
+}
+
+//------------------------------------------------------------------------------
+inline void
+String::setEmpty() {
+    this->buf[0] = 0;
+    this->buf[InlineCapacity] = InlineCapacity;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+String::IsInline() const {
+    return !this->isHeap();
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+String::AsCStr() const {
+    return this->ptr();
+}
+
+//------------------------------------------------------------------------------
+inline int
+String::Length() const {
+    return this->isHeap() ? this->data->length : (InlineCapacity - this->buf[InlineCapacity]);
+}
+
 //------------------------------------------------------------------------------
 bool operator==(const String& s0, const char* s1);
 bool operator!=(const String& s0, const char* s1);
@@ -32,18 +32,39 @@ StringAtom::AsString() const {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+StringAtom::Reserve(int numAtoms) {
+    stringAtomTable::threadLocalPtr()->Reserve(numAtoms);
+}
+
+//------------------------------------------------------------------------------
+void
+StringAtom::SetGlobalTable(bool enabled) {
+    stringAtomGlobalTable::setEnabled(enabled);
+}
+
+//------------------------------------------------------------------------------
+bool
+StringAtom::IsGlobalTable() {
+    return stringAtomGlobalTable::isEnabled();
+}
+
 //------------------------------------------------------------------------------
 void
 StringAtom::copy(const StringAtom& rhs) {
-    // check if rhs is from our thread, if yes the copy is quick,
-    // if no we need to transfer it into this thread's string atom table
+    // check if rhs is from the global table or our thread, if yes the
+    // copy is quick, if no we need to transfer it into the global
+    // table or this thread's string atom table
     if (rhs.data) {
-        if (rhs.data->table == stringAtomTable::threadLocalPtr()) {
+        const bool global = stringAtomGlobalTable::isEnabled();
+        if ((rhs.data->table == stringAtomGlobalTable::ptr()) ||
+            (!global && (rhs.data->table == stringAtomTable::threadLocalPtr()))) {
             this->data = rhs.data;
         }
         else {
             // rhs is from another thread, need to transfer to this thread
-            this->setupFromCString(rhs.data->str);
+            this->setupFromHashedCString(rhs.data->hash, rhs.data->str);
         }
     }
     else {
@@ -57,12 +78,27 @@ void
 StringAtom::setupFromCString(const char* str) {
 
     if ((0 != str) && (str[0] != 0)) {
+        this->setupFromHashedCString(stringAtomTable::HashForString(str), str);
+    }
+    else {
+        // source was a null-ptr or empty string
+        this->data = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+StringAtom::setupFromHashedCString(int32_t hash, const char* str) {
+
+    if ((0 != str) && (str[0] != 0)) {
+        if (stringAtomGlobalTable::isEnabled()) {
+            this->data = stringAtomGlobalTable::ptr()->FindOrAdd(hash, str);
+            return;
+        }
+
         // get my thread-local string atom table
         stringAtomTable* table = stringAtomTable::threadLocalPtr();
         
-        // get hash of string
-        int32_t hash = stringAtomTable::HashForString(str);
-        
         // check if string already exists in table
         this->data = table->Find(hash, str);
         if (0 == this->data) {
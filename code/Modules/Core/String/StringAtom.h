@@ -8,16 +8,54 @@
     A unique string, relatively slow on creation, but fast for comparison.
     String atoms are stored in thread-local stringAtomTables and comparison
     is fastest in the creator thread.
+
+    Alternatively, StringAtom::SetGlobalTable(true) (or
+    CoreSetup::GlobalStringAtoms) switches to a process-wide table which
+    can be accessed concurrently from all threads (lock-free lookup, new
+    strings are added under a per-shard lock). Atoms created while the
+    global table is active are unique across threads, so comparison is
+    always a pointer compare, and copying between threads is free.
+
+    String literals with the _atom suffix have their hash computed at
+    compile time, so creating a StringAtom from them only needs a table
+    lookup (the hash is guaranteed to be folded when the literal is
+    stored in a constexpr StringAtomLiteral, optimizing compilers fold
+    it in any case):
+
+    @code
+    StringAtom name = "Position"_atom;
+    @endcode
     
     @see String
 */
 #include "Core/Types.h"
 #include "Core/String/stringAtomTable.h"
+#include "Core/String/stringAtomGlobalTable.h"
+#include <cstddef>
 
 namespace Oryol {
 
 class String;
 
+//------------------------------------------------------------------------------
+/**
+    @brief a string literal with compile-time hash, see operator"" _atom
+*/
+class StringAtomLiteral {
+public:
+    /// constructor, hash is computed at compile time for string literals
+    constexpr explicit StringAtomLiteral(const char* s) :
+        str(s), hash(stringAtomTable::HashForLiteral(s)) { };
+
+    const char* str;
+    int32_t hash;
+};
+
+/// create a StringAtomLiteral from a string literal (e.g. "Position"_atom)
+constexpr StringAtomLiteral operator"" _atom(const char* str, std::size_t /*len*/) {
+    return StringAtomLiteral(str);
+}
+
 class StringAtom {
 public:
     /// default constructor
@@ -28,6 +66,8 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const uchar* str);
+    /// construct from literal with compile-time hash
+    StringAtom(const StringAtomLiteral& lit);
     /// copy-constructor (fast if rhs was created in same thread)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
@@ -43,6 +83,8 @@ public:
     void operator=(const char* rhs);
     /// assign raw string (slow)
     void operator=(const uchar* rhs);
+    /// assign literal with compile-time hash
+    void operator=(const StringAtomLiteral& rhs);
     /// assign from String object (slow)
     void operator=(const String& rhs);
     
@@ -79,11 +121,20 @@ public:
     /// get String (slow because string object must be constructed)
     String AsString() const;
 
+    /// reserve room for numAtoms new atoms in the current thread's atom table
+    static void Reserve(int numAtoms);
+    /// intern new atoms into the process-wide table instead of thread-local tables
+    static void SetGlobalTable(bool enabled);
+    /// return true if new atoms are interned into the process-wide table
+    static bool IsGlobalTable();
+
 private:
     /// copy content
     void copy(const StringAtom& rhs);
     /// setup from C string
     void setupFromCString(const char* str);
+    /// setup from C string with precomputed hash
+    void setupFromHashedCString(int32_t hash, const char* str);
     
     const stringAtomBuffer::Header* data;
     static const char* emptyString;
@@ -114,6 +165,12 @@ StringAtom::StringAtom(const uchar* rhs) {
     this->setupFromCString((const char*) rhs);
 }
 
+//------------------------------------------------------------------------------
+inline
+StringAtom::StringAtom(const StringAtomLiteral& lit) {
+    this->setupFromHashedCString(lit.hash, lit.str);
+}
+
 //------------------------------------------------------------------------------
 inline
 StringAtom::StringAtom(const StringAtom& rhs) {
@@ -166,6 +223,13 @@ StringAtom::operator=(const uchar* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline void
+StringAtom::operator=(const StringAtomLiteral& rhs) {
+    this->Clear();
+    this->setupFromHashedCString(rhs.hash, rhs.str);
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
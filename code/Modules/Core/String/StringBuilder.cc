@@ -6,12 +6,7 @@
 #include <cstdio>
 #include "StringBuilder.h"
 #include "Core/Memory/Memory.h"
-
-#if ORYOL_WINDOWS
-#define o_strtok strtok_s
-#else
-#define o_strtok strtok_r
-#endif
+#include "Core/String/stringSimd.h"
 
 namespace Oryol {
     
@@ -81,7 +76,7 @@ StringBuilder::ensureRoom(int numBytes) {
         // need to make room
         int growBy = (numBytes < minGrowSize) ? minGrowSize : numBytes;
         const int newCapacity = this->capacity + growBy;
-        char* newBuffer = (char*) Memory::Alloc(newCapacity);
+        char* newBuffer = (char*) Memory::Alloc(newCapacity, Memory::Tag::String);
         if (this->buffer) {
             // copy over old content and free old buffer
             #if ORYOL_WINDOWS
@@ -166,6 +161,17 @@ StringBuilder::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+StringView
+StringBuilder::AsView() const {
+    if (this->buffer) {
+        return StringView(this->buffer, this->size);
+    }
+    else {
+        return StringView();
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 StringBuilder::Append(char c) {
@@ -364,11 +370,17 @@ StringBuilder::SubstituteAll(const char* match, const char* subst) {
 
     int numSubst = 0;
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
         const int matchLen = int(std::strlen(match));
         const int substLen = int(std::strlen(subst));
-        while (nullptr != (ptr = std::strstr(ptr, match))) {
-            this->substituteCommon(ptr, matchLen, substLen, subst);
+        // NOTE: the buffer is 0-terminated and the search isn't bounded,
+        // libc's strstr() is faster than stringSimd here
+        int index = 0;
+        const char* found;
+        while (nullptr != (found = std::strstr(this->buffer + index, match))) {
+            index = int(found - this->buffer);
+            this->substituteCommon(this->buffer + index, matchLen, substLen, subst);
+            // continue searching behind the substitute
+            index += substLen;
             numSubst++;
         }
     }
@@ -415,14 +427,19 @@ StringBuilder::SubstituteFirst(const String& match, const String& subst) {
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    const int index = (const int)std::strcspn(ptr, delims) + startIndex;
-    if (((endIndex != EndOfString) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex >= strLen)) {
+        // unbounded search in a 0-terminated string, libc is fastest
+        if (startIndex >= strLen) {
+            return InvalidIndex;
+        }
+        const int index = int(std::strcspn(str + startIndex, delims)) + startIndex;
+        return (index >= strLen) ? InvalidIndex : index;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int index = _priv::stringSimd::funcs.findFirstOf(str + startIndex, endIndex - startIndex, delims, int(std::strlen(delims)));
+    return (index < 0) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -560,14 +577,19 @@ StringBuilder::FindLastNotOf(int startIndex, int endIndex, const char* delims) c
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    int index = int(std::strspn(ptr, delims)) + startIndex;
-    if (((EndOfString != endIndex) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex >= strLen)) {
+        // unbounded search in a 0-terminated string, libc is fastest
+        if (startIndex >= strLen) {
+            return InvalidIndex;
+        }
+        const int index = int(std::strspn(str + startIndex, delims)) + startIndex;
+        return (index >= strLen) ? InvalidIndex : index;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int index = _priv::stringSimd::funcs.findFirstNotOf(str + startIndex, endIndex - startIndex, delims, int(std::strlen(delims)));
+    return (index < 0) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -607,21 +629,27 @@ StringBuilder::FindFirstNotOf(int startIndex, int endIndex, const char* delims)
 
 //------------------------------------------------------------------------------
 int
-StringBuilder::findSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
-    const char* ptr = str + startIndex;
-    const char* occur = std::strstr(ptr, subStr);
-    if (nullptr == occur) {
-        return InvalidIndex;
-    }
-    else {
-        int index = int(occur - ptr) + startIndex;
-        if ((EndOfString != endIndex) && (index >= endIndex)) {
+StringBuilder::findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr) {
+    // a match must start before endIndex, but may extend beyond it
+    const int subLen = int(std::strlen(subStr));
+    if ((EndOfString == endIndex) || ((endIndex + subLen - 1) >= strLen)) {
+        // unbounded search in a 0-terminated string, libc is fastest
+        if (startIndex > strLen) {
             return InvalidIndex;
         }
-        else {
-            return index;
+        const char* occur = std::strstr(str + startIndex, subStr);
+        if (nullptr == occur) {
+            return InvalidIndex;
         }
+        const int index = int(occur - str);
+        return ((EndOfString != endIndex) && (index >= endIndex)) ? InvalidIndex : index;
+    }
+    const int searchEnd = endIndex + subLen - 1;
+    if (startIndex > searchEnd) {
+        return InvalidIndex;
     }
+    const int index = _priv::stringSimd::funcs.findSubString(str + startIndex, searchEnd - startIndex, subStr, subLen);
+    return (index < 0) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -633,8 +661,9 @@ StringBuilder::findSubString(const char* str, int startIndex, int endIndex, cons
 int
 StringBuilder::FindSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
     o_assert(0 != subStr);
+    o_assert(0 != str);
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
-    return findSubString(str, startIndex, endIndex, subStr);
+    return findSubString(str, int(std::strlen(str)), startIndex, endIndex, subStr);
 }
     
 //------------------------------------------------------------------------------
@@ -649,7 +678,7 @@ StringBuilder::FindSubString(int startIndex, int endIndex, const char* subStr) c
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     if (nullptr != this->buffer) {
         o_assert(startIndex < this->size);
-        return findSubString(this->buffer, startIndex, endIndex, subStr);
+        return findSubString(this->buffer, this->size, startIndex, endIndex, subStr);
     }
     else {
         // no content
@@ -681,12 +710,13 @@ StringBuilder::Tokenize(const char* delims, Array<String>& outTokens) {
     
     outTokens.Clear();
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        const char* token;
-        char* contextPtr = 0;
-        while (0 != (token = o_strtok(ptr, delims, &contextPtr))) {
-            outTokens.Add(token);
-            ptr = 0;
+        // the buffer is 0-terminated, so libc's strspn()/strcspn() can be used
+        int start = int(std::strspn(this->buffer, delims));
+        while ((start < this->size) && (0 != this->buffer[start])) {
+            const int len = int(std::strcspn(this->buffer + start, delims));
+            outTokens.Add(String(this->buffer, start, start + len));
+            start += len;
+            start += int(std::strspn(this->buffer + start, delims));
         }
     }
     this->Clear();
@@ -739,6 +769,28 @@ StringBuilder::Tokenize(const char* delims, char fence, Array<String>& outTokens
     return outTokens.Size();
 }
 
+//------------------------------------------------------------------------------
+/**
+ Tokenize a string view, the resulting tokens are views into the original
+ string data, so the only allocation is growing outTokens.
+*/
+int
+StringBuilder::Tokenize(const StringView& str, const char* delims, Array<StringView>& outTokens) {
+    o_assert(nullptr != delims);
+    outTokens.Clear();
+    const int len = str.Length();
+    int start = 0;
+    while ((start = str.FindFirstNotOf(start, len, delims)) != InvalidIndex) {
+        int end = str.FindFirstOf(start, len, delims);
+        if (InvalidIndex == end) {
+            end = len;
+        }
+        outTokens.Add(str.SubView(start, end));
+        start = end;
+    }
+    return outTokens.Size();
+}
+
 //------------------------------------------------------------------------------
 bool
 StringBuilder::format(int maxLength, bool append, const char* fmt, va_list args) {
@@ -11,6 +11,7 @@
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
 #include "Core/Containers/Array.h"
 
 namespace Oryol {
@@ -48,6 +49,8 @@ public:
     String GetSubString(int startIndex, int endIndex) const;
     /// get content as raw C string
     const char* AsCStr() const;
+    /// get a view on the content (invalidated when the builder is modified)
+    StringView AsView() const;
     
     /// printf-style formatting, max string length must be provided, returns false if resulting string is too long
     bool Format(int maxLength, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
@@ -128,6 +131,8 @@ public:
     int Tokenize(const char* delims, Array<String>& outTokens);
     /// tokenize content, keep string within fence intact, this will clear the builder content
     int Tokenize(const char* delims, char fence, Array<String>& outTokens);
+    /// tokenize a string view without allocating strings, tokens point into str
+    static int Tokenize(const StringView& str, const char* delims, Array<StringView>& outTokens);
     
     /// truncate at index
     void Truncate(int index);
@@ -152,7 +157,7 @@ private:
     /// helper function for FindLastNotOf functions
     static int findLastNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims);
     /// helper function for FindSubString functions
-    static int findSubString(const char* str, int startIndex, int endIndex, const char* subStr);
+    static int findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr);
     /// internal formatting method
     bool format(int maxLength, bool append, const char* fmt, va_list args);
     
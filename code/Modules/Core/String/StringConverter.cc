@@ -5,6 +5,7 @@
 #include "Core/Assertion.h"
 #include "StringConverter.h"
 #include "ConvertUTF.h"
+#include "stringSimd.h"
 #include <cstdlib>
 #include <cstring>
 #include <cwchar>
@@ -112,7 +113,7 @@ StringConverter::WideToUTF8(const wchar_t* wide, int numWideChars) {
         }
         else {
             int dstBufSize = (numWideChars * MaxUTF8Size) + 1;
-            unsigned char* dstBuf = (unsigned char*) Memory::Alloc(dstBufSize);
+            unsigned char* dstBuf = (unsigned char*) Memory::Alloc(dstBufSize, Memory::Tag::String);
             if (0 < StringConverter::WideToUTF8(wide, numWideChars, dstBuf, dstBufSize)) {
                 converted = (char*) dstBuf;
             }
@@ -156,7 +157,7 @@ StringConverter::UTF8ToWide(const unsigned char* src, int srcNumBytes) {
         else {
             // use buffer 
             int bufferSize = (srcNumBytes + 1) * sizeof(wchar_t);
-            wchar_t* dstBuf = (wchar_t*) Memory::Alloc(bufferSize);
+            wchar_t* dstBuf = (wchar_t*) Memory::Alloc(bufferSize, Memory::Tag::String);
             bool success = (0 < StringConverter::UTF8ToWide(src, srcNumBytes, dstBuf, bufferSize));
             if (success) {
                 result = dstBuf;
@@ -181,6 +182,24 @@ StringConverter::UTF8ToWide(const String& src) {
     return UTF8ToWide((uchar*)src.AsCStr(), src.Length());
 }
 
+//------------------------------------------------------------------------------
+/**
+ Rejects overlong encodings, surrogates and code points above U+10FFFF.
+ Runs of ASCII characters are skipped with SIMD instructions where
+ available.
+*/
+bool
+StringConverter::IsValidUTF8(const unsigned char* src, int srcNumBytes) {
+    o_assert((0 != src) && (srcNumBytes >= 0));
+    return _priv::stringSimd::funcs.validateUTF8(src, srcNumBytes);
+}
+
+//------------------------------------------------------------------------------
+bool
+StringConverter::IsValidUTF8(const String& src) {
+    return IsValidUTF8((const unsigned char*)src.AsCStr(), src.Length());
+}
+
 //------------------------------------------------------------------------------
 template<> int8_t
 StringConverter::FromString(const char* str) {
@@ -43,6 +43,10 @@ public:
     static WideString UTF8ToWide(const unsigned char* src);
     /// convert UTF8 string object to wide string object
     static WideString UTF8ToWide(const String& src);
+    /// test if a raw byte range is well-formed UTF-8 (RFC 3629)
+    static bool IsValidUTF8(const unsigned char* src, int srcNumBytes);
+    /// test if a string object is well-formed UTF-8
+    static bool IsValidUTF8(const String& src);
 
 private:
     static const int MaxInternalBufferWChars = 128;
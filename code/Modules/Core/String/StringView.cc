@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//  StringView.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "StringView.h"
+#include "String.h"
+#include "StringAtom.h"
+#include "stringSimd.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+StringView::StringView(const char* str) {
+    if (str) {
+        this->ptr = str;
+        this->len = int(std::strlen(str));
+    }
+    else {
+        this->ptr = "";
+        this->len = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+StringView::StringView(const String& str) :
+ptr(str.AsCStr()),
+len(str.Length()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+StringView::StringView(const StringAtom& str) :
+ptr(str.AsCStr()),
+len(str.Length()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+bool
+StringView::operator==(const StringView& rhs) const {
+    return (this->len == rhs.len) &&
+           ((this->ptr == rhs.ptr) || (0 == std::memcmp(this->ptr, rhs.ptr, this->len)));
+}
+
+//------------------------------------------------------------------------------
+int
+StringView::Compare(const StringView& rhs) const {
+    const int minLen = this->len < rhs.len ? this->len : rhs.len;
+    const int res = std::memcmp(this->ptr, rhs.ptr, minLen);
+    if (0 != res) {
+        return res;
+    }
+    else {
+        return this->len - rhs.len;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+StringView::StartsWith(const StringView& str) const {
+    return (str.len <= this->len) && (0 == std::memcmp(this->ptr, str.ptr, str.len));
+}
+
+//------------------------------------------------------------------------------
+bool
+StringView::EndsWith(const StringView& str) const {
+    return (str.len <= this->len) && (0 == std::memcmp(this->ptr + this->len - str.len, str.ptr, str.len));
+}
+
+//------------------------------------------------------------------------------
+String
+StringView::MakeString() const {
+    if (this->len > 0) {
+        return String(this->ptr, 0, this->len);
+    }
+    else {
+        return String();
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+StringView::FindFirstOf(int startIndex, int endIndex, const char* delims) const {
+    o_assert_dbg(delims);
+    endIndex = this->endIndex(startIndex, endIndex);
+    const int index = _priv::stringSimd::funcs.findFirstOf(this->ptr + startIndex, endIndex - startIndex, delims, int(std::strlen(delims)));
+    return (index < 0) ? InvalidIndex : startIndex + index;
+}
+
+//------------------------------------------------------------------------------
+int
+StringView::FindFirstNotOf(int startIndex, int endIndex, const char* delims) const {
+    o_assert_dbg(delims);
+    endIndex = this->endIndex(startIndex, endIndex);
+    const int index = _priv::stringSimd::funcs.findFirstNotOf(this->ptr + startIndex, endIndex - startIndex, delims, int(std::strlen(delims)));
+    return (index < 0) ? InvalidIndex : startIndex + index;
+}
+
+//------------------------------------------------------------------------------
+int
+StringView::FindLastOf(int startIndex, int endIndex, const char* delims) const {
+    o_assert_dbg(delims);
+    endIndex = this->endIndex(startIndex, endIndex);
+    for (int i = endIndex - 1; i >= startIndex; i--) {
+        if (std::strchr(delims, this->ptr[i]) && (0 != this->ptr[i])) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+int
+StringView::FindSubString(int startIndex, int endIndex, const StringView& subString) const {
+    endIndex = this->endIndex(startIndex, endIndex);
+    const int index = _priv::stringSimd::funcs.findSubString(this->ptr + startIndex, endIndex - startIndex, subString.ptr, subString.len);
+    return (index < 0) ? InvalidIndex : startIndex + index;
+}
+
+} // namespace Oryol
@@ -0,0 +1,187 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::StringView
+    @ingroup Core
+    @brief non-owning view into a range of characters
+
+    A StringView is a pointer and a length into string data owned by
+    someone else (a String, StringAtom, StringBuilder or a string literal),
+    creating, copying and slicing a StringView never allocates. The
+    viewed data is not necessarily 0-terminated, use MakeString() to
+    create an owning String object.
+
+    The viewed data must outlive the StringView, and must not be
+    modified while it is viewed (e.g. a StringBuilder must not be
+    changed while views into its content exist).
+
+    @see String, StringAtom, StringBuilder
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+class String;
+class StringAtom;
+
+class StringView {
+public:
+    /// default constructor (empty view)
+    StringView();
+    /// view on a 0-terminated string
+    StringView(const char* str);
+    /// view on a character range
+    StringView(const char* ptr, int len);
+    /// view on the content of a String
+    StringView(const String& str);
+    /// view on the content of a StringAtom
+    StringView(const StringAtom& str);
+
+    /// equality with other view (compares content)
+    bool operator==(const StringView& rhs) const;
+    /// inequality with other view (compares content)
+    bool operator!=(const StringView& rhs) const;
+    /// less-than (byte-wise lexicographic, same order as std::strcmp)
+    bool operator<(const StringView& rhs) const;
+    /// compare content, returns <0, 0 or >0 like std::strcmp
+    int Compare(const StringView& rhs) const;
+
+    /// pointer to the first character (NOT necessarily 0-terminated)
+    const char* Ptr() const;
+    /// length in bytes
+    int Length() const;
+    /// return true if view is empty
+    bool Empty() const;
+    /// return true if view is not empty
+    bool IsValid() const;
+    /// get character at index
+    char operator[](int index) const;
+    /// get first character (0 if empty)
+    char Front() const;
+    /// get last character (0 if empty)
+    char Back() const;
+
+    /// get a sub-view, endIndex can be EndOfString
+    StringView SubView(int startIndex, int endIndex) const;
+    /// test if view starts with a string
+    bool StartsWith(const StringView& str) const;
+    /// test if view ends with a string
+    bool EndsWith(const StringView& str) const;
+    /// create an owning String from the view (allocates for long strings)
+    String MakeString() const;
+
+    /// find index of first occurrence of delim chars, endIndex can be EndOfString, return InvalidIndex if not found
+    int FindFirstOf(int startIndex, int endIndex, const char* delims) const;
+    /// find index of first character not in delim chars, return InvalidIndex if not found
+    int FindFirstNotOf(int startIndex, int endIndex, const char* delims) const;
+    /// find index of last occurrence of delim chars, return InvalidIndex if not found
+    int FindLastOf(int startIndex, int endIndex, const char* delims) const;
+    /// find index of substring, endIndex can be EndOfString, return InvalidIndex if not found
+    int FindSubString(int startIndex, int endIndex, const StringView& subString) const;
+    /// test if view contains a substring
+    bool Contains(const StringView& subString) const;
+
+private:
+    /// resolve EndOfString and check range
+    int endIndex(int startIndex, int endIndex) const;
+
+    const char* ptr;
+    int len;
+};
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView() :
+ptr(""),
+len(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* ptr_, int len_) :
+ptr(ptr_),
+len(len_) {
+    o_assert_dbg(ptr_ && (len_ >= 0));
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::Ptr() const {
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+inline int
+StringView::Length() const {
+    return this->len;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::Empty() const {
+    return 0 == this->len;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::IsValid() const {
+    return 0 != this->len;
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::operator[](int index) const {
+    o_assert_range_dbg(index, this->len);
+    return this->ptr[index];
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Front() const {
+    return this->len > 0 ? this->ptr[0] : 0;
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Back() const {
+    return this->len > 0 ? this->ptr[this->len - 1] : 0;
+}
+
+//------------------------------------------------------------------------------
+inline int
+StringView::endIndex(int startIndex, int endIndex) const {
+    if (EndOfString == endIndex) {
+        endIndex = this->len;
+    }
+    o_assert_dbg((startIndex >= 0) && (startIndex <= endIndex) && (endIndex <= this->len));
+    return endIndex;
+}
+
+//------------------------------------------------------------------------------
+inline StringView
+StringView::SubView(int startIndex, int endIndex) const {
+    endIndex = this->endIndex(startIndex, endIndex);
+    return StringView(this->ptr + startIndex, endIndex - startIndex);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator!=(const StringView& rhs) const {
+    return !this->operator==(rhs);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator<(const StringView& rhs) const {
+    return this->Compare(rhs) < 0;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::Contains(const StringView& subString) const {
+    return InvalidIndex != this->FindSubString(0, EndOfString, subString);
+}
+
+} // namespace Oryol
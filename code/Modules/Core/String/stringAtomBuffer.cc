@@ -27,14 +27,14 @@ void
 stringAtomBuffer::allocChunk() {
     // need to turn off leak detection for the string atom system, since
     // string atom buffer are never released
-    int8_t* newChunk = (int8_t*) Memory::Alloc(this->chunkSize);
+    int8_t* newChunk = (int8_t*) Memory::Alloc(this->chunkSize, Memory::Tag::String);
     this->chunks.Add(newChunk);
     this->curPointer = newChunk;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32_t hash, const char* str) {
+stringAtomBuffer::AddString(const void* table, int32_t hash, const char* str) {
     o_assert(nullptr != table);
     o_assert(nullptr != str);
     
@@ -10,8 +10,6 @@
 
 namespace Oryol {
 
-class stringAtomTable;
-
 class stringAtomBuffer {
 public:
     // header data for a single entry (string data starts at end of header)
@@ -19,9 +17,9 @@ public:
         // default constructor
         Header() : table(0), hash(0), length(0), str(0) { };
         /// constructor
-        Header(const stringAtomTable* t, int32_t hsh, int len, const char* s) : table(t), hash(hsh), length(len), str(s) { };
+        Header(const void* t, int32_t hsh, int len, const char* s) : table(t), hash(hsh), length(len), str(s) { };
     
-        const stringAtomTable* table;
+        const void* table;      // the owning stringAtomTable or stringAtomGlobalTable
         int32_t hash;
         int length;
         const char* str;
@@ -31,7 +29,7 @@ public:
     ~stringAtomBuffer();
     
     /// add a new string to the buffer, return pointer to start of header
-    const Header* AddString(stringAtomTable* table, int32_t hash, const char* str);
+    const Header* AddString(const void* table, int32_t hash, const char* str);
     
 private:
     /// allocate a new chunk
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//  stringAtomGlobalTable.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "stringAtomGlobalTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/memoryTracker.h"
+#include "Core/Assertion.h"
+#if ORYOL_USE_VLD
+#include "vld.h"
+#endif
+
+namespace Oryol {
+
+std::atomic<bool> stringAtomGlobalTable::enabled{false};
+
+//------------------------------------------------------------------------------
+stringAtomGlobalTable*
+stringAtomGlobalTable::ptr() {
+    // NOTE: like the thread-local tables, the global table is never
+    // destroyed since StringAtoms may still point into it (even
+    // during static destruction)
+    alignas(stringAtomGlobalTable) static uint8_t storage[sizeof(stringAtomGlobalTable)];
+    static stringAtomGlobalTable* table = new(storage) stringAtomGlobalTable();
+    return table;
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomGlobalTable::setEnabled(bool b) {
+    if (b) {
+        // make sure the table exists before other threads need it
+        ptr();
+    }
+    enabled.store(b, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::find(const shard& s, int32_t hash, const char* str) {
+    const bucketArray* arr = s.buckets.load(std::memory_order_acquire);
+    if (nullptr == arr) {
+        return nullptr;
+    }
+    const uint32_t mask = uint32_t(arr->capacity - 1);
+    for (uint32_t i = (uint32_t(hash) >> NumShardBits) & mask; ; i = (i + 1) & mask) {
+        const stringAtomBuffer::Header* head = arr->slots[i].load(std::memory_order_acquire);
+        if (nullptr == head) {
+            return nullptr;
+        }
+        if ((head->hash == hash) && (0 == std::strcmp(head->str, str))) {
+            return head;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::Find(int32_t hash, const char* str) const {
+    return find(this->shards[uint32_t(hash) & (NumShards - 1)], hash, str);
+}
+
+//------------------------------------------------------------------------------
+stringAtomGlobalTable::bucketArray*
+stringAtomGlobalTable::grow(shard& s) {
+    // NOTE: the old bucket array is never released, lock-free readers
+    // may still be probing it
+    const bucketArray* oldArr = s.buckets.load(std::memory_order_relaxed);
+    const int oldCapacity = oldArr ? oldArr->capacity : 0;
+    const int newCapacity = oldCapacity ? oldCapacity * 2 : 64;
+    #if ORYOL_USE_VLD
+    VLDDisable();
+    #endif
+    _priv::memoryTracker::suspendThread();
+    const int allocSize = int(sizeof(bucketArray)) + (newCapacity - 1) * int(sizeof(bucketArray::slots[0]));
+    bucketArray* newArr = (bucketArray*) Memory::Alloc(allocSize, Memory::Tag::String);
+    _priv::memoryTracker::resumeThread();
+    #if ORYOL_USE_VLD
+    VLDEnable();
+    #endif
+    newArr->capacity = newCapacity;
+    for (int i = 0; i < newCapacity; i++) {
+        new(&newArr->slots[i]) std::atomic<const stringAtomBuffer::Header*>(nullptr);
+    }
+    const uint32_t mask = uint32_t(newCapacity - 1);
+    for (int i = 0; i < oldCapacity; i++) {
+        const stringAtomBuffer::Header* head = oldArr->slots[i].load(std::memory_order_relaxed);
+        if (head) {
+            uint32_t slot = (uint32_t(head->hash) >> NumShardBits) & mask;
+            while (newArr->slots[slot].load(std::memory_order_relaxed)) {
+                slot = (slot + 1) & mask;
+            }
+            newArr->slots[slot].store(head, std::memory_order_relaxed);
+        }
+    }
+    s.buckets.store(newArr, std::memory_order_release);
+    return newArr;
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::FindOrAdd(int32_t hash, const char* str) {
+    shard& s = this->shards[uint32_t(hash) & (NumShards - 1)];
+    const stringAtomBuffer::Header* head = find(s, hash, str);
+    if (head) {
+        return head;
+    }
+
+    std::lock_guard<std::mutex> lock(s.lock);
+    // another thread may have added the string in the meantime
+    head = find(s, hash, str);
+    if (head) {
+        return head;
+    }
+    bucketArray* arr = s.buckets.load(std::memory_order_relaxed);
+    if ((nullptr == arr) || (((s.num + 1) * 2) > arr->capacity)) {
+        arr = grow(s);
+    }
+    #if ORYOL_USE_VLD
+    VLDDisable();
+    #endif
+    _priv::memoryTracker::suspendThread();
+    head = s.buffer.AddString(this, hash, str);
+    _priv::memoryTracker::resumeThread();
+    #if ORYOL_USE_VLD
+    VLDEnable();
+    #endif
+    o_assert(nullptr != head);
+
+    // publish the fully written header
+    const uint32_t mask = uint32_t(arr->capacity - 1);
+    uint32_t slot = (uint32_t(hash) >> NumShardBits) & mask;
+    while (arr->slots[slot].load(std::memory_order_relaxed)) {
+        slot = (slot + 1) & mask;
+    }
+    arr->slots[slot].store(head, std::memory_order_release);
+    s.num++;
+    return head;
+}
+
+} // namespace Oryol
@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    A process-wide StringAtom table which can be used from all threads.
+
+    The table is split into shards selected by the string hash, each
+    shard has its own string buffer, open-addressing bucket array and
+    a mutex which is only taken when adding a string. Lookups never
+    lock: bucket arrays are published with release semantics and are
+    never released (a grown shard keeps its old bucket array alive),
+    headers are written before their bucket entry, and since string
+    data is never released, header pointers are stable.
+*/
+#include "Core/Types.h"
+#include "Core/String/stringAtomBuffer.h"
+#include <atomic>
+#include <mutex>
+
+namespace Oryol {
+
+class stringAtomGlobalTable {
+public:
+    /// access to the global table (created on demand)
+    static stringAtomGlobalTable* ptr();
+    /// enable or disable interning new atoms into the global table
+    static void setEnabled(bool b);
+    /// return true if new atoms are interned into the global table
+    static bool isEnabled();
+
+    /// find a matching buffer header (lock-free)
+    const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
+    /// find a matching buffer header, or add the string
+    const stringAtomBuffer::Header* FindOrAdd(int32_t hash, const char* str);
+
+private:
+    /// an open-addressing bucket array
+    struct bucketArray {
+        int capacity;
+        std::atomic<const stringAtomBuffer::Header*> slots[1];
+    };
+    /// a shard with its own lock and string buffer
+    struct alignas(64) shard {
+        std::atomic<bucketArray*> buckets{nullptr};
+        int num = 0;
+        std::mutex lock;
+        stringAtomBuffer buffer;
+    };
+    /// find in a shard
+    static const stringAtomBuffer::Header* find(const shard& s, int32_t hash, const char* str);
+    /// allocate a new, bigger bucket array (shard must be locked)
+    static bucketArray* grow(shard& s);
+
+    static const int NumShardBits = 4;
+    static const int NumShards = 1<<NumShardBits;
+    static std::atomic<bool> enabled;
+    shard shards[NumShards];
+};
+
+//------------------------------------------------------------------------------
+inline bool
+stringAtomGlobalTable::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
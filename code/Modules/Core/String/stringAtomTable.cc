@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include <cstring>
 #include "stringAtomTable.h"
+#include "Core/Memory/memoryTracker.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
@@ -23,7 +24,9 @@ stringAtomTable::threadLocalPtr() {
         #if ORYOL_USE_VLD
         VLDDisable();
         #endif
+        _priv::memoryTracker::suspendThread();
         ptr = Memory::New<stringAtomTable>();
+        _priv::memoryTracker::resumeThread();
         #if ORYOL_USE_VLD
         VLDEnable();
         #endif
@@ -58,6 +61,7 @@ stringAtomTable::Add(int32_t hash, const char* str) {
     #if ORYOL_USE_VLD
     VLDDisable();
     #endif
+    _priv::memoryTracker::suspendThread();
 
     // add new string to the string buffer
     const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
@@ -66,20 +70,30 @@ stringAtomTable::Add(int32_t hash, const char* str) {
     // add new entry to our lookup table
     this->table.Add(Entry(newHeader));
 
+    _priv::memoryTracker::resumeThread();
     #if ORYOL_USE_VLD
     VLDEnable();
     #endif
     return newHeader;
 }
 
+//------------------------------------------------------------------------------
+void
+stringAtomTable::Reserve(int numAtoms) {
+    _priv::memoryTracker::suspendThread();
+    this->table.Reserve(numAtoms);
+    _priv::memoryTracker::resumeThread();
+}
+
 //------------------------------------------------------------------------------
 int32_t
 stringAtomTable::HashForString(const char* str) {
 
     // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
-    const char* p = str;
-    int32_t h = 0;
-    char c;
+    // NOTE: must produce the same result as HashForLiteral()
+    const uint8_t* p = (const uint8_t*) str;
+    uint32_t h = 0;
+    uint8_t c;
     while (0 != (c = *p++))
     {
         h += c;
@@ -89,7 +103,7 @@ stringAtomTable::HashForString(const char* str) {
     h += (h << 3);
     h ^= (h >> 11);
     h += (h << 15);
-    return h;
+    return int32_t(h);
 }
 
 //------------------------------------------------------------------------------
@@ -112,18 +126,6 @@ stringAtomTable::Entry::operator==(const Entry& rhs) const {
     }
 }
 
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
-}
-
 } // namespace Oryol
 
 
@@ -18,14 +18,40 @@ public:
     static stringAtomTable* threadLocalPtr();
     /// compute hash value for string
     static int32_t HashForString(const char* str);
+    /// compute hash value for string at compile time (same result as HashForString)
+    static constexpr int32_t HashForLiteral(const char* str) {
+        return int32_t(hashFinal(hashLiteral(str, 0)));
+    };
     /// find a matching buffer header in the table
     const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
     /// add a string to the atom table
     const stringAtomBuffer::Header* Add(int32_t hash, const char* str);
+    /// reserve room for numAtoms more atoms
+    void Reserve(int numAtoms);
     
 private:
     static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
 
+    /// one-at-a-time hash steps, C++11 constexpr functions must be single expressions
+    static constexpr uint32_t hashStep(uint32_t h) {
+        return h ^ (h >> 6);
+    };
+    static constexpr uint32_t hashChar(uint32_t h, uint8_t c) {
+        return hashStep((h + c) + ((h + c) << 10));
+    };
+    static constexpr uint32_t hashLiteral(const char* str, uint32_t h) {
+        return *str ? hashLiteral(str + 1, hashChar(h, uint8_t(*str))) : h;
+    };
+    static constexpr uint32_t hashFinal2(uint32_t h) {
+        return h + (h << 15);
+    };
+    static constexpr uint32_t hashFinal1(uint32_t h) {
+        return hashFinal2(h ^ (h >> 11));
+    };
+    static constexpr uint32_t hashFinal(uint32_t h) {
+        return hashFinal1(h + (h << 3));
+    };
+
     /// a bucket entry
     struct Entry {
         /// default constructor
@@ -34,8 +60,6 @@ private:
         Entry(const stringAtomBuffer::Header* h) : header(h) { };
         /// equality operator
         bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
         
         const stringAtomBuffer::Header* header;
     };
@@ -47,7 +71,7 @@ private:
         };
     };
     stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+    HashSet<Entry, Hasher> table;
 };
 
 } // namespace Oryol
@@ -0,0 +1,623 @@
+//------------------------------------------------------------------------------
+//  stringSimd.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "stringSimd.h"
+#include "Core/Memory/memorySimd.h"
+#include "Core/Assertion.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_STRING_SSE2 (1)
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !ORYOL_EMSCRIPTEN
+#define ORYOL_STRING_AVX2 (1)
+#define ORYOL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define ORYOL_STRING_AVX2 (1)
+#define ORYOL_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+// delimiter sets up to this size are compared with one vector compare per
+// delimiter, bigger sets use the scalar lookup table
+const int MaxSimdDelims = 8;
+// number of first-character false positives after which the substring
+// search switches from memchr() to the two-character SIMD compare
+const int MaxMemchrMisses = 2;
+
+//------------------------------------------------------------------------------
+inline int
+lowestBit(uint32_t mask) {
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+    #else
+    return __builtin_ctz(mask);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    A 256-bit lookup table for delimiter characters.
+*/
+struct charSet {
+    uint32_t bits[8];
+
+    charSet(const char* delims, int numDelims) {
+        std::memset(this->bits, 0, sizeof(this->bits));
+        for (int i = 0; i < numDelims; i++) {
+            const uint8_t c = uint8_t(delims[i]);
+            this->bits[c >> 5] |= 1U << (c & 31);
+        }
+    };
+    bool contains(char chr) const {
+        const uint8_t c = uint8_t(chr);
+        return 0 != (this->bits[c >> 5] & (1U << (c & 31)));
+    };
+};
+
+//------------------------------------------------------------------------------
+/**
+    Returns the number of bytes of the well-formed UTF-8 sequence at
+    str (RFC 3629: no overlong encodings, no surrogates, nothing
+    above U+10FFFF), or 0 if the sequence is ill-formed or truncated.
+*/
+int
+utf8SequenceLength(const uint8_t* str, int len) {
+    const uint8_t c = str[0];
+    if (c < 0x80) {
+        return 1;
+    }
+    int num;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xBF;
+    if ((c >= 0xC2) && (c <= 0xDF)) {
+        num = 2;
+    }
+    else if ((c >= 0xE0) && (c <= 0xEF)) {
+        num = 3;
+        if (0xE0 == c) {
+            lo = 0xA0;
+        }
+        else if (0xED == c) {
+            hi = 0x9F;
+        }
+    }
+    else if ((c >= 0xF0) && (c <= 0xF4)) {
+        num = 4;
+        if (0xF0 == c) {
+            lo = 0x90;
+        }
+        else if (0xF4 == c) {
+            hi = 0x8F;
+        }
+    }
+    else {
+        return 0;
+    }
+    if (num > len) {
+        return 0;
+    }
+    if ((str[1] < lo) || (str[1] > hi)) {
+        return 0;
+    }
+    for (int i = 2; i < num; i++) {
+        if ((str[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Substring search for short strings (shorter than one SIMD block),
+    which only tests the first and last character of each candidate
+    position without calling any functions.
+*/
+inline int
+findSubStringShort(const char* str, int len, const char* subStr, int subLen) {
+    const char first = subStr[0];
+    const char last = subStr[subLen - 1];
+    const int lastStart = len - subLen;
+    for (int i = 0; i <= lastStart; i++) {
+        if ((str[i] == first) && (str[i + subLen - 1] == last)) {
+            int k = 1;
+            while ((k < (subLen - 1)) && (str[i + k] == subStr[k])) {
+                k++;
+            }
+            if (k >= (subLen - 1)) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int
+findSubStringScalar(const char* str, int len, const char* subStr, int subLen) {
+    if (0 == subLen) {
+        return 0;
+    }
+    if (subLen > len) {
+        return -1;
+    }
+    if (len < 64) {
+        return findSubStringShort(str, len, subStr, subLen);
+    }
+    // memchr() for the first character is vectorized in most libcs,
+    // and much faster than a byte loop on longer strings
+    const char* ptr = str;
+    const char* end = str + (len - subLen) + 1;
+    while (nullptr != (ptr = (const char*) std::memchr(ptr, subStr[0], end - ptr))) {
+        if (0 == std::memcmp(ptr + 1, subStr + 1, subLen - 1)) {
+            return int(ptr - str);
+        }
+        ptr++;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Start of the SIMD substring search on long strings: as long as the
+    first character of the substring is rare, the libc's memchr() is
+    faster than comparing the first and last character, so this tries
+    memchr() until it hits MaxMemchrMisses false positives. Returns true
+    if the search is finished (outPos is the match or -1), otherwise
+    the SIMD search must continue at outPos.
+*/
+inline bool
+findSubStringMemchr(const char* str, int len, const char* subStr, int subLen, int& outPos) {
+    const int numCandidates = len - subLen + 1;
+    int i = 0;
+    for (int misses = 0; misses < MaxMemchrMisses; misses++) {
+        const char* ptr = (const char*) std::memchr(str + i, subStr[0], numCandidates - i);
+        if (nullptr == ptr) {
+            outPos = -1;
+            return true;
+        }
+        if (0 == std::memcmp(ptr + 1, subStr + 1, subLen - 1)) {
+            outPos = int(ptr - str);
+            return true;
+        }
+        i = int(ptr - str) + 1;
+    }
+    outPos = i;
+    return false;
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstOfScalar(const char* str, int len, const char* delims, int numDelims) {
+    const charSet set(delims, numDelims);
+    for (int i = 0; i < len; i++) {
+        if (set.contains(str[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstNotOfScalar(const char* str, int len, const char* delims, int numDelims) {
+    const charSet set(delims, numDelims);
+    for (int i = 0; i < len; i++) {
+        if (!set.contains(str[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+bool
+validateUTF8Scalar(const uint8_t* str, int len) {
+    int i = 0;
+    while (i < len) {
+        const int num = utf8SequenceLength(str + i, len - i);
+        if (0 == num) {
+            return false;
+        }
+        i += num;
+    }
+    return true;
+}
+
+#if ORYOL_STRING_SSE2
+//------------------------------------------------------------------------------
+/**
+    Load a block of up to 16 bytes [str, str+len) without reading outside
+    of [str-lookBack, str+len). If len is less than 16, the block ends at
+    str+len when there are enough bytes before str, otherwise the bytes are
+    copied into a local buffer. Returns the number of bits the movemask
+    of the block must be shifted down so that bit 0 belongs to str[0].
+*/
+inline int
+loadShortSSE2(const char* str, int len, int lookBack, __m128i& outBlock) {
+    if (len >= 16) {
+        outBlock = _mm_loadu_si128((const __m128i*)str);
+        return 0;
+    }
+    else if (lookBack >= (16 - len)) {
+        outBlock = _mm_loadu_si128((const __m128i*)(str + len - 16));
+        return 16 - len;
+    }
+    else {
+        char buf[16] = { 0 };
+        std::memcpy(buf, str, len);
+        outBlock = _mm_loadu_si128((const __m128i*)buf);
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Substring search with at most 16 candidate positions, which only
+    needs a single block compare against the first character.
+*/
+inline int
+findSubStringShortSSE2(const char* str, int len, const char* subStr, int subLen, int lookBack) {
+    __m128i block;
+    const int shift = loadShortSSE2(str, len, lookBack, block);
+    const int numCandidates = len - subLen + 1;
+    uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(subStr[0])))) >> shift;
+    mask &= (1U << numCandidates) - 1;
+    while (mask) {
+        const int pos = lowestBit(mask);
+        if (0 == std::memcmp(str + pos + 1, subStr + 1, subLen - 1)) {
+            return pos;
+        }
+        mask &= mask - 1;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int
+findSubStringImplSSE2(const char* str, int len, const char* subStr, int subLen, int lookBack) {
+    if (0 == subLen) {
+        return 0;
+    }
+    if (subLen > len) {
+        return -1;
+    }
+    if ((len - subLen + 1) <= 16) {
+        return findSubStringShortSSE2(str, len, subStr, subLen, lookBack);
+    }
+    // compare the first and last character of the substring against
+    // 16 candidate positions at once, and only memcmp the candidates
+    // where both match
+    const __m128i first = _mm_set1_epi8(subStr[0]);
+    const __m128i last = _mm_set1_epi8(subStr[subLen - 1]);
+    int i = 0;
+    for (; (i + subLen - 1 + 32) <= len; i += 32) {
+        // 2 blocks per iteration, with a single branch for the common 'no candidate' case
+        const char* ptr = str + i;
+        const __m128i eq0 = _mm_and_si128(
+            _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)ptr)),
+            _mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i*)(ptr + subLen - 1))));
+        const __m128i eq1 = _mm_and_si128(
+            _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)(ptr + 16))),
+            _mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i*)(ptr + 16 + subLen - 1))));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(eq0)) | (uint32_t(_mm_movemask_epi8(eq1)) << 16);
+        while (mask) {
+            const int pos = i + lowestBit(mask);
+            if (0 == std::memcmp(str + pos, subStr, subLen)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; (i + subLen - 1 + 16) <= len; i += 16) {
+        const __m128i blockFirst = _mm_loadu_si128((const __m128i*)(str + i));
+        const __m128i blockLast = _mm_loadu_si128((const __m128i*)(str + i + subLen - 1));
+        const __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(eq));
+        while (mask) {
+            const int pos = i + lowestBit(mask);
+            if (0 == std::memcmp(str + pos, subStr, subLen)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    // less than 16 candidates left
+    if ((i + subLen) > len) {
+        return -1;
+    }
+    const int res = findSubStringShortSSE2(str + i, len - i, subStr, subLen, lookBack + i);
+    return (res < 0) ? -1 : i + res;
+}
+
+//------------------------------------------------------------------------------
+int
+findSubStringSSE2(const char* str, int len, const char* subStr, int subLen) {
+    if ((0 == subLen) || ((len - subLen + 1) <= 16)) {
+        return findSubStringImplSSE2(str, len, subStr, subLen, 0);
+    }
+    int i;
+    if (findSubStringMemchr(str, len, subStr, subLen, i)) {
+        return i;
+    }
+    const int res = findSubStringImplSSE2(str + i, len - i, subStr, subLen, i);
+    return (res < 0) ? -1 : i + res;
+}
+
+//------------------------------------------------------------------------------
+template<bool NOT> int
+findDelimSSE2(const char* str, int len, const char* delims, int numDelims, int lookBack) {
+    if ((0 == numDelims) || (numDelims > MaxSimdDelims)) {
+        return NOT ? findFirstNotOfScalar(str, len, delims, numDelims) : findFirstOfScalar(str, len, delims, numDelims);
+    }
+    __m128i d[MaxSimdDelims];
+    for (int k = 0; k < numDelims; k++) {
+        d[k] = _mm_set1_epi8(delims[k]);
+    }
+    int i = 0;
+    for (; (i + 16) <= len; i += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i eq = _mm_cmpeq_epi8(block, d[0]);
+        for (int k = 1; k < numDelims; k++) {
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, d[k]));
+        }
+        uint32_t mask = uint32_t(_mm_movemask_epi8(eq));
+        if (NOT) {
+            mask = ~mask & 0xFFFF;
+        }
+        if (mask) {
+            return i + lowestBit(mask);
+        }
+    }
+    // less than 16 bytes left
+    if (i < len) {
+        __m128i block;
+        const int shift = loadShortSSE2(str + i, len - i, lookBack + i, block);
+        __m128i eq = _mm_cmpeq_epi8(block, d[0]);
+        for (int k = 1; k < numDelims; k++) {
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, d[k]));
+        }
+        uint32_t mask = uint32_t(_mm_movemask_epi8(eq));
+        if (NOT) {
+            mask = ~mask & 0xFFFF;
+        }
+        mask = (mask >> shift) & ((1U << (len - i)) - 1);
+        if (mask) {
+            return i + lowestBit(mask);
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstOfSSE2(const char* str, int len, const char* delims, int numDelims) {
+    return findDelimSSE2<false>(str, len, delims, numDelims, 0);
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstNotOfSSE2(const char* str, int len, const char* delims, int numDelims) {
+    return findDelimSSE2<true>(str, len, delims, numDelims, 0);
+}
+
+//------------------------------------------------------------------------------
+bool
+validateUTF8SSE2(const uint8_t* str, int len) {
+    // skip ASCII 16 bytes at a time, and validate multi-byte
+    // sequences one by one starting at the first non-ASCII byte
+    int i = 0;
+    while (i < len) {
+        if ((i + 16) <= len) {
+            const __m128i block = _mm_loadu_si128((const __m128i*)(str + i));
+            const uint32_t mask = uint32_t(_mm_movemask_epi8(block));
+            if (0 == mask) {
+                i += 16;
+                continue;
+            }
+            i += lowestBit(mask);
+        }
+        const int num = utf8SequenceLength(str + i, len - i);
+        if (0 == num) {
+            return false;
+        }
+        i += num;
+    }
+    return true;
+}
+#endif
+
+#if ORYOL_STRING_AVX2
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 int
+findSubStringLongAVX2(const char* str, int len, const char* subStr, int subLen, int lookBack) {
+    const __m256i first = _mm256_set1_epi8(subStr[0]);
+    const __m256i last = _mm256_set1_epi8(subStr[subLen - 1]);
+    int i = 0;
+    for (; (i + subLen - 1 + 64) <= len; i += 64) {
+        // 2 blocks per iteration, with a single branch for the common 'no candidate' case
+        const char* ptr = str + i;
+        const __m256i eq0 = _mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*)ptr)),
+            _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i*)(ptr + subLen - 1))));
+        const __m256i eq1 = _mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*)(ptr + 32))),
+            _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i*)(ptr + 32 + subLen - 1))));
+        if (_mm256_testz_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq0, eq1))) {
+            continue;
+        }
+        uint64_t mask = uint64_t(uint32_t(_mm256_movemask_epi8(eq0))) | (uint64_t(uint32_t(_mm256_movemask_epi8(eq1))) << 32);
+        while (mask) {
+            const uint32_t lo = uint32_t(mask);
+            const int bit = lo ? lowestBit(lo) : 32 + lowestBit(uint32_t(mask >> 32));
+            const int pos = i + bit;
+            if (0 == std::memcmp(str + pos, subStr, subLen)) {
+                _mm256_zeroupper();
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    _mm256_zeroupper();
+    const int res = findSubStringImplSSE2(str + i, len - i, subStr, subLen, lookBack + i);
+    return (res < 0) ? -1 : i + res;
+}
+
+//------------------------------------------------------------------------------
+int
+findSubStringAVX2(const char* str, int len, const char* subStr, int subLen) {
+    // NOTE: short strings go to the SSE2 version before any YMM register
+    // is touched (this function itself isn't compiled for AVX2, so that
+    // the short path has no AVX2 prologue), and the tail is handed over
+    // after a vzeroupper, to avoid the AVX-SSE transition penalty
+    if ((0 == subLen) || ((len - subLen + 1) < 64)) {
+        return findSubStringImplSSE2(str, len, subStr, subLen, 0);
+    }
+    int i;
+    if (findSubStringMemchr(str, len, subStr, subLen, i)) {
+        return i;
+    }
+    const int res = findSubStringLongAVX2(str + i, len - i, subStr, subLen, i);
+    return (res < 0) ? -1 : i + res;
+}
+
+//------------------------------------------------------------------------------
+template<bool NOT> ORYOL_TARGET_AVX2 int
+findDelimLongAVX2(const char* str, int len, const char* delims, int numDelims) {
+    __m256i d[MaxSimdDelims];
+    for (int k = 0; k < numDelims; k++) {
+        d[k] = _mm256_set1_epi8(delims[k]);
+    }
+    int i = 0;
+    for (; (i + 32) <= len; i += 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)(str + i));
+        __m256i eq = _mm256_cmpeq_epi8(block, d[0]);
+        for (int k = 1; k < numDelims; k++) {
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, d[k]));
+        }
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(eq));
+        if (NOT) {
+            mask = ~mask;
+        }
+        if (mask) {
+            _mm256_zeroupper();
+            return i + lowestBit(mask);
+        }
+    }
+    _mm256_zeroupper();
+    const int res = findDelimSSE2<NOT>(str + i, len - i, delims, numDelims, i);
+    return (res < 0) ? -1 : i + res;
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstOfAVX2(const char* str, int len, const char* delims, int numDelims) {
+    if ((len < 32) || (0 == numDelims) || (numDelims > MaxSimdDelims)) {
+        return findDelimSSE2<false>(str, len, delims, numDelims, 0);
+    }
+    return findDelimLongAVX2<false>(str, len, delims, numDelims);
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstNotOfAVX2(const char* str, int len, const char* delims, int numDelims) {
+    if ((len < 32) || (0 == numDelims) || (numDelims > MaxSimdDelims)) {
+        return findDelimSSE2<true>(str, len, delims, numDelims, 0);
+    }
+    return findDelimLongAVX2<true>(str, len, delims, numDelims);
+}
+
+//------------------------------------------------------------------------------
+ORYOL_TARGET_AVX2 bool
+validateUTF8AVX2(const uint8_t* str, int len) {
+    if (len < 32) {
+        return validateUTF8SSE2(str, len);
+    }
+    int i = 0;
+    while (i < len) {
+        if ((i + 32) <= len) {
+            const __m256i block = _mm256_loadu_si256((const __m256i*)(str + i));
+            const uint32_t mask = uint32_t(_mm256_movemask_epi8(block));
+            if (0 == mask) {
+                i += 32;
+                continue;
+            }
+            i += lowestBit(mask);
+        }
+        const int num = utf8SequenceLength(str + i, len - i);
+        if (0 == num) {
+            return false;
+        }
+        i += num;
+    }
+    return true;
+}
+#endif
+
+} // anonymous namespace
+
+// constant-initialized, so that string functions called during static
+// initialization work before the best SIMD level has been selected
+stringSimd::funcTable stringSimd::funcs = {
+    findSubStringScalar,
+    findFirstOfScalar,
+    findFirstNotOfScalar,
+    validateUTF8Scalar,
+};
+
+namespace {
+struct autoSelect {
+    autoSelect() {
+        stringSimd::select(memorySimd::bestLevel());
+    };
+} autoSelectInstance;
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+stringSimd::select(Memory::SimdLevel lvl) {
+    o_assert(memorySimd::isSupported(lvl));
+    switch (lvl) {
+        #if ORYOL_STRING_SSE2
+        case Memory::SimdLevel::SSE2:
+            funcs.findSubString = findSubStringSSE2;
+            funcs.findFirstOf = findFirstOfSSE2;
+            funcs.findFirstNotOf = findFirstNotOfSSE2;
+            funcs.validateUTF8 = validateUTF8SSE2;
+            break;
+        #endif
+        #if ORYOL_STRING_AVX2
+        case Memory::SimdLevel::AVX2:
+            funcs.findSubString = findSubStringAVX2;
+            funcs.findFirstOf = findFirstOfAVX2;
+            funcs.findFirstNotOf = findFirstNotOfAVX2;
+            funcs.validateUTF8 = validateUTF8AVX2;
+            break;
+        #endif
+        default:
+            // NOTE: no NEON versions yet (NEON has no movemask, which
+            // all the search loops depend on)
+            funcs.findSubString = findSubStringScalar;
+            funcs.findFirstOf = findFirstOfScalar;
+            funcs.findFirstNotOf = findFirstNotOfScalar;
+            funcs.validateUTF8 = validateUTF8Scalar;
+            break;
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
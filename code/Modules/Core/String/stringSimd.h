@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::stringSimd
+    @ingroup _priv
+    @brief SIMD implementations of the string search functions
+
+    Holds a table of function pointers for the hot string search functions
+    used by StringBuilder, StringView and StringConverter (substring search,
+    delimiter search and UTF-8 validation). All functions work on a pointer
+    and length, never read past the end of the range, and return a
+    relative index, or -1 if nothing was found.
+
+    Like _priv::memorySimd, the table is initialized to the scalar
+    fallbacks and switched to the best supported implementation during
+    static initialization, Memory::SetSimdLevel() selects both tables.
+*/
+#include "Core/Types.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+class stringSimd {
+public:
+    /// the function table
+    struct funcTable {
+        int (*findSubString)(const char* str, int len, const char* subStr, int subLen);
+        int (*findFirstOf)(const char* str, int len, const char* delims, int numDelims);
+        int (*findFirstNotOf)(const char* str, int len, const char* delims, int numDelims);
+        bool (*validateUTF8)(const uint8_t* str, int len);
+    };
+    /// the currently selected functions
+    static funcTable funcs;
+
+    /// select the functions for a SIMD level (must be supported)
+    static void select(Memory::SimdLevel level);
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,549 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Core.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/cpuPause.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#endif
+
+namespace Oryol {
+
+struct JobSystem::job {
+    JobFunc func;
+    Counter* counter = nullptr;
+    job* next = nullptr;
+};
+
+namespace {
+
+// capacity of the per-thread deques, jobs which don't fit are run right away
+const int DequeSize = 4096;
+// number of times an idle worker looks for work before going to sleep
+const int NumIdleSpins = 64;
+
+//------------------------------------------------------------------------------
+/**
+    A fixed-size Chase-Lev work-stealing deque. Only the owning thread
+    calls push() and pop() at the bottom end, any thread may call steal()
+    at the top end.
+*/
+class jobDeque {
+public:
+    /// push a job at the bottom (owner only), returns false if full
+    bool push(JobSystem::job* j);
+    /// pop a job from the bottom (owner only)
+    JobSystem::job* pop();
+    /// steal a job from the top (any thread)
+    JobSystem::job* steal();
+    /// return true if the deque looks empty
+    bool empty() const;
+
+private:
+    std::atomic<int64_t> top{0};
+    uint8_t pad0[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom{0};
+    uint8_t pad1[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<JobSystem::job*> slots[DequeSize];
+};
+
+//------------------------------------------------------------------------------
+bool
+jobDeque::push(JobSystem::job* j) {
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    const int64_t t = this->top.load(std::memory_order_acquire);
+    if ((b - t) >= DequeSize) {
+        return false;
+    }
+    this->slots[b & (DequeSize - 1)].store(j, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+JobSystem::job*
+jobDeque::pop() {
+    const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    JobSystem::job* j = this->slots[b & (DequeSize - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // the last job, race against thieves for it
+        if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            j = nullptr;
+        }
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+JobSystem::job*
+jobDeque::steal() {
+    int64_t t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    JobSystem::job* j = this->slots[t & (DequeSize - 1)].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // lost the race against the owner or another thief
+        return nullptr;
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+bool
+jobDeque::empty() const {
+    return this->top.load(std::memory_order_acquire) >= this->bottom.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+struct workerState {
+    jobDeque deque;
+    uint32_t rand = 0;
+};
+
+std::atomic<bool> valid{false};
+int numWorkers = 0;
+workerState** workers = nullptr;
+ORYOL_THREADLOCAL_PTR(workerState) threadWorker = nullptr;
+std::atomic<uint32_t> externalRand{0};
+
+#if ORYOL_HAS_THREADS
+std::thread* threads = nullptr;
+std::atomic<bool> stopRequested{false};
+
+// jobs pushed by threads which don't own a deque
+std::mutex injectMutex;
+JobSystem::job* injectHead = nullptr;
+JobSystem::job* injectTail = nullptr;
+std::atomic<int> numInjected{0};
+
+// sleeping idle workers
+std::mutex sleepMutex;
+std::condition_variable sleepCond;
+std::atomic<int> numSleeping{0};
+#endif
+
+//------------------------------------------------------------------------------
+uint32_t
+nextRand(uint32_t& state) {
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+//------------------------------------------------------------------------------
+bool
+hasWork() {
+    #if ORYOL_HAS_THREADS
+    if (numInjected.load() > 0) {
+        return true;
+    }
+    #endif
+    for (int i = 0; i <= numWorkers; i++) {
+        if (!workers[i]->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+wakeWorker() {
+    #if ORYOL_HAS_THREADS
+    // a worker going to sleep increments numSleeping and then checks for
+    // work (both sequentially consistent), and the pushing thread checks
+    // numSleeping after publishing the job, so one of them sees the other
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (numSleeping.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCond.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+parallelRange(const JobSystem::RangeFunc& func, int begin, int end, int grainSize, JobSystem::Counter& counter) {
+    // split off the upper half as a new job until the rest is small enough,
+    // so that thieves steal big ranges and split them further themselves
+    while ((end - begin) > grainSize) {
+        const int mid = begin + (end - begin) / 2;
+        JobSystem::Run([&func, mid, end, grainSize, &counter] {
+            parallelRange(func, mid, end, grainSize, counter);
+        }, &counter);
+        end = mid;
+    }
+    func(begin, end);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+JobSystem::Counter::~Counter() {
+    o_assert_dbg(0 == this->count.load(std::memory_order_relaxed));
+    // a finishing job may still be about to release the lock
+    while (this->locked.load(std::memory_order_acquire)) {
+        _priv::cpuPause();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Counter::increment() {
+    this->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Counter::decrement() {
+    int c = this->count.load(std::memory_order_relaxed);
+    while (c > 1) {
+        if (this->count.compare_exchange_weak(c, c - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    // possibly the last job, the transition to zero happens with the
+    // lock held so that RunAfter() can't add a continuation which is
+    // never started
+    this->lock();
+    job* cont = nullptr;
+    if (1 == this->count.fetch_sub(1, std::memory_order_acq_rel)) {
+        cont = this->continuations;
+        this->continuations = nullptr;
+    }
+    this->unlock();
+    // NOTE: the counter may have been destroyed from here on
+    while (cont) {
+        job* next = cont->next;
+        cont->next = nullptr;
+        JobSystem::push(cont);
+        cont = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Counter::lock() {
+    while (this->locked.exchange(true, std::memory_order_acquire)) {
+        while (this->locked.load(std::memory_order_relaxed)) {
+            _priv::cpuPause();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Counter::unlock() {
+    this->locked.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(int num) {
+    o_assert(!IsValid());
+    #if ORYOL_HAS_THREADS
+    if (num <= 0) {
+        const int numCores = int(std::thread::hardware_concurrency());
+        num = numCores > 1 ? numCores - 1 : 1;
+    }
+    #else
+    num = 0;
+    #endif
+    numWorkers = num;
+
+    // worker 0 is the calling thread
+    workers = (workerState**) Memory::Alloc(sizeof(workerState*) * (numWorkers + 1));
+    for (int i = 0; i <= numWorkers; i++) {
+        workers[i] = Memory::New<workerState>();
+        workers[i]->rand = 0x9E3779B9 * uint32_t(i + 1);
+    }
+    threadWorker = workers[0];
+    valid = true;
+
+    #if ORYOL_HAS_THREADS
+    stopRequested = false;
+    threads = (std::thread*) Memory::Alloc(sizeof(std::thread) * numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        new(&threads[i]) std::thread(workerFunc, i + 1);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(IsValid());
+    o_assert(threadWorker == workers[0]);
+
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopRequested = true;
+        sleepCond.notify_all();
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        threads[i].join();
+        threads[i].~thread();
+    }
+    Memory::Free(threads);
+    threads = nullptr;
+    #endif
+
+    // run jobs which are still pending, those may create new jobs
+    while (RunPending()) {
+        // empty
+    }
+
+    valid = false;
+    threadWorker = nullptr;
+    for (int i = 0; i <= numWorkers; i++) {
+        Memory::Delete(workers[i]);
+    }
+    Memory::Free(workers);
+    workers = nullptr;
+    numWorkers = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return valid.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::NumWorkers() {
+    return numWorkers;
+}
+
+//------------------------------------------------------------------------------
+JobSystem::job*
+JobSystem::createJob(JobFunc&& func, Counter* counter) {
+    job* j = Memory::New<job>();
+    j->func = std::move(func);
+    j->counter = counter;
+    if (counter) {
+        counter->increment();
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Run(JobFunc func, Counter* counter) {
+    o_assert_dbg(func);
+    push(createJob(std::move(func), counter));
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::RunAfter(Counter& dependency, JobFunc func, Counter* counter) {
+    o_assert_dbg(func);
+    job* j = createJob(std::move(func), counter);
+    dependency.lock();
+    if (dependency.count.load(std::memory_order_acquire) > 0) {
+        // started by the last job of the dependency
+        j->next = dependency.continuations;
+        dependency.continuations = j;
+        dependency.unlock();
+    }
+    else {
+        dependency.unlock();
+        push(j);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::push(job* j) {
+    if (!IsValid()) {
+        execute(j);
+        return;
+    }
+    workerState* w = threadWorker;
+    if (w) {
+        if (!w->deque.push(j)) {
+            // deque is full, don't wait for room
+            execute(j);
+            return;
+        }
+    }
+    else {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(injectMutex);
+        if (injectTail) {
+            injectTail->next = j;
+        }
+        else {
+            injectHead = j;
+        }
+        injectTail = j;
+        numInjected++;
+        #endif
+    }
+    wakeWorker();
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(job* j) {
+    j->func();
+    Counter* counter = j->counter;
+    Memory::Delete(j);
+    if (counter) {
+        counter->decrement();
+    }
+}
+
+//------------------------------------------------------------------------------
+JobSystem::job*
+JobSystem::find() {
+    workerState* w = threadWorker;
+    if (w) {
+        job* j = w->deque.pop();
+        if (j) {
+            return j;
+        }
+    }
+    #if ORYOL_HAS_THREADS
+    if (numInjected.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        job* j = injectHead;
+        if (j) {
+            injectHead = j->next;
+            if (nullptr == injectHead) {
+                injectTail = nullptr;
+            }
+            j->next = nullptr;
+            numInjected--;
+            return j;
+        }
+    }
+    #endif
+    // try to steal, starting at a random victim
+    const int num = numWorkers + 1;
+    const uint32_t start = w ? nextRand(w->rand) : externalRand++;
+    for (int i = 0; i < num; i++) {
+        workerState* victim = workers[(start + i) % num];
+        if (victim != w) {
+            job* j = victim->deque.steal();
+            if (j) {
+                return j;
+            }
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::RunPending() {
+    if (!IsValid()) {
+        return false;
+    }
+    job* j = find();
+    if (j) {
+        execute(j);
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(Counter& counter) {
+    int idle = 0;
+    while (!counter.IsDone()) {
+        if (RunPending()) {
+            idle = 0;
+        }
+        else if (idle++ < NumIdleSpins) {
+            _priv::cpuPause();
+        }
+        else {
+            #if ORYOL_HAS_THREADS
+            std::this_thread::yield();
+            #endif
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::ParallelFor(int begin, int end, int grainSize, const RangeFunc& func) {
+    o_assert_dbg(begin <= end);
+    const int num = end - begin;
+    if (num <= 0) {
+        return;
+    }
+    if (grainSize <= 0) {
+        // a few chunks per thread for load balancing
+        grainSize = num / ((numWorkers + 1) * 4);
+        if (grainSize < 1) {
+            grainSize = 1;
+        }
+    }
+    if (!IsValid() || (num <= grainSize)) {
+        func(begin, end);
+        return;
+    }
+    Counter counter;
+    parallelRange(func, begin, end, grainSize, counter);
+    Wait(counter);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerFunc(int index) {
+    #if ORYOL_HAS_THREADS
+    Core::EnterThread();
+    threadWorker = workers[index];
+    int idle = 0;
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        job* j = find();
+        if (j) {
+            execute(j);
+            idle = 0;
+        }
+        else if (idle++ < NumIdleSpins) {
+            _priv::cpuPause();
+        }
+        else {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            numSleeping.fetch_add(1);
+            if (!hasWork() && !stopRequested.load()) {
+                // the timeout is only a safety net
+                sleepCond.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            numSleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+    threadWorker = nullptr;
+    Core::LeaveThread();
+    #endif
+}
+
+} // namespace Oryol
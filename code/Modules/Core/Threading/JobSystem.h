@@ -0,0 +1,137 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief work-stealing job scheduler
+
+    The JobSystem runs small jobs (std::function objects) on a pool of
+    worker threads. Each worker thread, and the thread which called
+    JobSystem::Setup() (usually the main thread), owns a work-stealing
+    deque: jobs are pushed to and popped from the bottom of the calling
+    thread's deque (so recently created, cache-warm jobs run first), idle
+    workers steal from the top of other threads' deques. Jobs created on
+    other threads go through a shared queue. Idle workers spin for a short
+    while and then go to sleep until new jobs are pushed.
+
+    A JobSystem::Counter counts unfinished jobs. Pass a counter to Run()
+    to wait for a group of jobs with Wait(), and to RunAfter() to start
+    a job only when all jobs of the counter have finished (this is how
+    job graphs are built). Waiting never blocks the waiting thread idle,
+    instead it runs pending jobs until the counter is done, so it is
+    safe (and efficient) to wait from within a job.
+
+    ParallelFor() splits an index range into chunks which are processed
+    in parallel, the calling thread helps and returns when all chunks
+    are done.
+
+    Worker threads call Core::EnterThread() and Core::LeaveThread(), so
+    thread-local RunLoops, frame arenas and string atom tables work in
+    jobs. Note that the per-thread RunLoops of worker threads are never
+    run.
+
+    Without JobSystem::Setup() (or on platforms without threads), jobs
+    are executed immediately on the calling thread.
+
+    @see Core, CoreSetup
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include <atomic>
+#include <functional>
+
+namespace Oryol {
+
+class JobSystem {
+public:
+    /// a job object (opaque)
+    struct job;
+    /// a job function
+    typedef std::function<void()> JobFunc;
+    /// a ParallelFor function, called with a [begin, end) index range
+    typedef std::function<void(int begin, int end)> RangeFunc;
+
+    /// counts unfinished jobs, must outlive the jobs it counts
+    class Counter {
+    public:
+        /// constructor
+        Counter();
+        /// destructor
+        ~Counter();
+        /// return true if all counted jobs have finished
+        bool IsDone() const;
+        /// get number of unfinished jobs
+        int Value() const;
+    private:
+        friend class JobSystem;
+        Counter(const Counter& rhs) = delete;
+        void operator=(const Counter& rhs) = delete;
+
+        /// count a new job
+        void increment();
+        /// a counted job has finished
+        void decrement();
+        /// lock the continuation list
+        void lock();
+        /// unlock the continuation list
+        void unlock();
+
+        std::atomic<int> count{0};
+        std::atomic<bool> locked{false};
+        job* continuations = nullptr;
+    };
+
+    /// setup the job system, numWorkers=0 creates one worker per additional CPU core
+    static void Setup(int numWorkers=0);
+    /// discard the job system, runs pending jobs and stops the worker threads
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get number of worker threads
+    static int NumWorkers();
+
+    /// run a job, the optional counter is decremented when the job has finished
+    static void Run(JobFunc func, Counter* counter=nullptr);
+    /// run a job after all jobs counted by dependency have finished
+    static void RunAfter(Counter& dependency, JobFunc func, Counter* counter=nullptr);
+    /// call func for chunks of [begin, end) in parallel, returns when all chunks are done
+    static void ParallelFor(int begin, int end, int grainSize, const RangeFunc& func);
+    /// wait until all jobs of a counter have finished, runs pending jobs while waiting
+    static void Wait(Counter& counter);
+    /// run one pending job on the calling thread, returns false if there was none
+    static bool RunPending();
+
+private:
+    /// create a job object
+    static job* createJob(JobFunc&& func, Counter* counter);
+    /// push a runnable job, or run it right away
+    static void push(job* j);
+    /// run and destroy a job
+    static void execute(job* j);
+    /// find a job for the calling thread
+    static job* find();
+    /// the worker thread function
+    static void workerFunc(int index);
+};
+
+//------------------------------------------------------------------------------
+inline
+JobSystem::Counter::Counter() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline bool
+JobSystem::Counter::IsDone() const {
+    // the last decrement happens with the lock held, the counter is
+    // only done (and may be destroyed) after that lock has been released
+    return (0 == this->count.load(std::memory_order_acquire)) && !this->locked.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+inline int
+JobSystem::Counter::Value() const {
+    return this->count.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//  RWLock.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "RWLock.h"
+#include "Core/Threading/cpuPause.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+
+#if ORYOL_HAS_ATOMIC
+namespace {
+
+// number of attempts with exponential pause-backoff (1, 2, 4 .. 512 pause instructions),
+// followed by attempts which yield the time slice, before parking the thread
+const int NumPauseSpins = 10;
+const int NumYieldSpins = 4;
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockWriteSlow() {
+    bool waiting = false;
+    for (int spin = 0; ; ) {
+        uint32_t s = this->state.load(std::memory_order_relaxed);
+        if (0 == (s & (WriteLocked | ReaderMask))) {
+            const uint32_t newState = (s | WriteLocked) - (waiting ? WaiterInc : 0);
+            if (this->state.compare_exchange_weak(s, newState, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        else if (!waiting) {
+            // register as waiting writer, this keeps new readers out
+            if (this->state.compare_exchange_weak(s, s + WaiterInc, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                waiting = true;
+            }
+        }
+        else {
+            this->wait(spin++, WriteLocked | ReaderMask);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::lockReadSlow() {
+    for (int spin = 0; ; ) {
+        uint32_t s = this->state.load(std::memory_order_relaxed);
+        if (0 == (s & (WriteLocked | WaiterMask))) {
+            // only contention with other readers, retry right away
+            if (this->state.compare_exchange_weak(s, s + ReaderInc, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        else {
+            this->wait(spin++, WriteLocked | WaiterMask);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Spins or parks until none of the state bits in mask are set. The
+    condition may already be false again when this returns, the caller
+    must retry.
+*/
+void
+RWLock::wait(int spin, uint32_t mask) {
+    if (spin < NumPauseSpins) {
+        for (int i = 0; i < (1<<spin); i++) {
+            _priv::cpuPause();
+        }
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    if (spin < (NumPauseSpins + NumYieldSpins)) {
+        std::this_thread::yield();
+        return;
+    }
+    // park until the state changes, the unlocking thread checks numParked
+    // after changing the state, and the state is checked here after
+    // incrementing numParked (both sequentially consistent), so one of
+    // them sees the other's change and the wakeup can't get lost
+    std::unique_lock<std::mutex> lock(this->parkMutex);
+    this->numParked.fetch_add(1);
+    while (0 != (this->state.load() & mask)) {
+        this->parkCond.wait(lock);
+    }
+    this->numParked.fetch_sub(1);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+RWLock::wake() {
+    #if ORYOL_HAS_THREADS
+    // take the mutex, so that a thread between checking the state
+    // and waiting on the condition variable doesn't miss the notify
+    std::lock_guard<std::mutex> lock(this->parkMutex);
+    this->parkCond.notify_all();
+    #endif
+}
+#endif
+
+} // namespace Oryol
@@ -4,12 +4,27 @@
     @class Oryol::RWLock
     @ingroup Core
     @brief single-write / multiple-reader lock
+
+    An adaptive, writer-preferring reader/writer lock. Uncontended
+    locking and unlocking is a single atomic operation. Under contention,
+    a thread first spins for a short while (with a CPU pause instruction
+    and exponential backoff, then by yielding its time slice), and finally
+    parks on a condition variable until the lock is released.
+
+    A writer which waits for the lock blocks new readers, so a steady
+    stream of readers can't starve writers. As a consequence, read locks
+    are not recursive: a thread which already holds a read lock must not
+    lock it again for reading (it would deadlock if a writer is waiting).
 */
 #include "Core/Config.h"
 #include "Core/Types.h"
 #if ORYOL_HAS_ATOMIC
 #include <atomic>
 #endif
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#include <condition_variable>
+#endif
 
 namespace Oryol {
 
@@ -26,8 +41,30 @@ public:
     
 private:
 #if ORYOL_HAS_ATOMIC
-    std::atomic<bool> writeLock{false};
-    std::atomic<int> readCount{0};
+    /// state bits: write-locked flag, number of waiting writers, number of readers
+    static const uint32_t WriteLocked = 1;
+    static const uint32_t WaiterInc = 1<<1;
+    static const uint32_t WaiterMask = 0x7FFF<<1;
+    static const uint32_t ReaderInc = 1<<16;
+    static const uint32_t ReaderMask = 0xFFFFu<<16;
+
+    /// contended LockWrite
+    void lockWriteSlow();
+    /// contended LockRead
+    void lockReadSlow();
+    /// spin or park until a state condition is true, spin is the number of previous attempts
+    void wait(int spin, uint32_t mask);
+    /// wake up parked threads
+    void wake();
+    /// wake up parked threads (if any)
+    void wakeIfParked();
+
+    std::atomic<uint32_t> state{0};
+    #if ORYOL_HAS_THREADS
+    std::atomic<int> numParked{0};
+    std::mutex parkMutex;
+    std::condition_variable parkCond;
+    #endif
 #endif
 };
 
@@ -35,13 +72,9 @@ private:
 inline void
 RWLock::LockWrite() {
 #if ORYOL_HAS_ATOMIC
-    /// acquire the write-lock
-    while (std::atomic_exchange_explicit(&this->writeLock, true, std::memory_order_acquire)) {
-        // spinning...
-    }
-    /// spin until no-one's reading anymore
-    while (this->readCount > 0) {
-        // spinning...
+    uint32_t expected = 0;
+    if (!this->state.compare_exchange_weak(expected, WriteLocked, std::memory_order_acquire, std::memory_order_relaxed)) {
+        this->lockWriteSlow();
     }
 #endif
 }
@@ -50,7 +83,10 @@ RWLock::LockWrite() {
 inline void
 RWLock::UnlockWrite() {
 #if ORYOL_HAS_ATOMIC
-    std::atomic_store_explicit(&this->writeLock, false, std::memory_order_release);
+    // NOTE: sequentially consistent, so that wakeIfParked() can't miss
+    // a thread which is about to park
+    this->state.fetch_and(~WriteLocked);
+    this->wakeIfParked();
 #endif
 }
 
@@ -58,12 +94,11 @@ RWLock::UnlockWrite() {
 inline void
 RWLock::LockRead() {
 #if ORYOL_HAS_ATOMIC
-    /// spin until no one is writing anymore
-    while (this->writeLock) {
-        // spinning...
+    uint32_t s = this->state.load(std::memory_order_relaxed);
+    if ((0 != (s & (WriteLocked | WaiterMask))) ||
+        !this->state.compare_exchange_weak(s, s + ReaderInc, std::memory_order_acquire, std::memory_order_relaxed)) {
+        this->lockReadSlow();
     }
-    /// increment the read-count
-    ++this->readCount;
 #endif
 }
 
@@ -71,10 +106,26 @@ RWLock::LockRead() {
 inline void
 RWLock::UnlockRead() {
 #if ORYOL_HAS_ATOMIC
-    --this->readCount;
+    const uint32_t s = this->state.fetch_sub(ReaderInc);
+    if (((s & ReaderMask) == ReaderInc) && (0 != (s & WaiterMask))) {
+        // the last reader is gone, and a writer is waiting
+        this->wakeIfParked();
+    }
 #endif
 }
 
+#if ORYOL_HAS_ATOMIC
+//------------------------------------------------------------------------------
+inline void
+RWLock::wakeIfParked() {
+    #if ORYOL_HAS_THREADS
+    if (this->numParked.load() > 0) {
+        this->wake();
+    }
+    #endif
+}
+#endif
+
 //------------------------------------------------------------------------------
 class ScopedReadLock {
 private:
@@ -0,0 +1,27 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file Core/Threading/cpuPause.h
+    @brief private spin-wait helper, do not use
+*/
+#include "Core/Config.h"
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+/// hint to the CPU that the calling thread is in a spin-wait loop
+inline void
+cpuPause() {
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+    #elif (defined(__arm__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,118 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::mpscQueue
+    @ingroup _priv
+    @brief lock-free multi-producer single-consumer queue
+
+    Any number of threads can Enqueue() concurrently, but only one thread
+    at a time may Dequeue(). Enqueue() is wait-free (a single atomic
+    exchange), Dequeue() never blocks, but may briefly miss an element
+    whose producer hasn't finished linking it in yet, so a consumer which
+    goes to sleep on an empty queue must be woken by the producers
+    (see ioWorker for an example).
+
+    Uses the node-based algorithm from Dmitry Vyukov, each element
+    costs one allocation.
+*/
+#include "Core/Types.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <utility>
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE> class mpscQueue {
+public:
+    /// constructor
+    mpscQueue();
+    /// destructor, destroys remaining elements
+    ~mpscQueue();
+
+    /// enqueue an element (any thread)
+    void Enqueue(const TYPE& elm);
+    /// enqueue an element with move semantics (any thread)
+    void Enqueue(TYPE&& elm);
+    /// dequeue an element, return false if queue is empty (consumer thread only)
+    bool Dequeue(TYPE& outElm);
+    /// test if the queue is empty (consumer thread only)
+    bool Empty() const;
+
+private:
+    struct node {
+        std::atomic<node*> next{nullptr};
+        TYPE value;
+    };
+    /// link a new node in
+    void push(node* n);
+
+    std::atomic<node*> head;    // last enqueued node, written by producers
+    node* tail;                 // stub node, the next node is the queue front
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpscQueue<TYPE>::mpscQueue() {
+    node* stub = Memory::New<node>();
+    this->head.store(stub, std::memory_order_relaxed);
+    this->tail = stub;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpscQueue<TYPE>::~mpscQueue() {
+    node* n = this->tail;
+    while (n) {
+        node* next = n->next.load(std::memory_order_relaxed);
+        Memory::Delete(n);
+        n = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+mpscQueue<TYPE>::push(node* n) {
+    node* prev = this->head.exchange(n, std::memory_order_acq_rel);
+    prev->next.store(n, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+mpscQueue<TYPE>::Enqueue(const TYPE& elm) {
+    node* n = Memory::New<node>();
+    n->value = elm;
+    this->push(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+mpscQueue<TYPE>::Enqueue(TYPE&& elm) {
+    node* n = Memory::New<node>();
+    n->value = std::move(elm);
+    this->push(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscQueue<TYPE>::Dequeue(TYPE& outElm) {
+    node* next = this->tail->next.load(std::memory_order_acquire);
+    if (nullptr == next) {
+        return false;
+    }
+    // the dequeued node becomes the new stub node
+    outElm = std::move(next->value);
+    next->value = TYPE();
+    Memory::Delete(this->tail);
+    this->tail = next;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscQueue<TYPE>::Empty() const {
+    return nullptr == this->tail->next.load(std::memory_order_acquire);
+}
+
+} // namespace _priv
+} // namespace Oryol
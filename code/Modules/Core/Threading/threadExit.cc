@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+//  threadExit.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "threadExit.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+#if ORYOL_HAS_THREADS
+namespace {
+
+// the destructor of a thread_local object runs on thread exit
+struct exitFuncs {
+    int num = 0;
+    threadExit::func funcs[threadExit::MaxFuncs];
+    ~exitFuncs() {
+        for (int i = this->num - 1; i >= 0; i--) {
+            this->funcs[i]();
+        }
+    }
+};
+thread_local exitFuncs threadFuncs;
+
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+void
+threadExit::add(func f) {
+    o_assert_dbg(f);
+    #if ORYOL_HAS_THREADS
+    exitFuncs& funcs = threadFuncs;
+    for (int i = 0; i < funcs.num; i++) {
+        if (funcs.funcs[i] == f) {
+            return;
+        }
+    }
+    o_assert(funcs.num < MaxFuncs);
+    funcs.funcs[funcs.num++] = f;
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
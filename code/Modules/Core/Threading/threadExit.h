@@ -0,0 +1,30 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::threadExit
+    @ingroup _priv
+    @brief call cleanup functions when a thread exits
+
+    Per-thread state which is created lazily (pool magazines, log rings)
+    registers a cleanup function here, the cleanup function is called
+    when the thread exits, even if the thread never calls
+    Core::LeaveThread(). The cleanup functions must tolerate being
+    called after the state has already been released.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class threadExit {
+public:
+    /// max number of cleanup functions per thread
+    static const int MaxFuncs = 8;
+    /// a cleanup function
+    typedef void (*func)();
+    /// call func when the current thread exits (adding the same func twice is a no-op)
+    static void add(func f);
+};
+
+} // namespace _priv
+} // namespace Oryol
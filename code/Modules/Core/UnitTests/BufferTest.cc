@@ -85,3 +85,58 @@ TEST(BufferTest) {
     CHECK(buf2.Capacity() == 21);
     CHECK(buf2.Spare() == 21);
 }
+
+namespace {
+class viewOwner : public RefCounted {
+    OryolClassDecl(viewOwner);
+public:
+    viewOwner(int* destroyed) : numDestroyed(destroyed) { };
+    ~viewOwner() { (*this->numDestroyed)++; };
+    uint8_t bytes[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    int* numDestroyed;
+};
+}
+
+TEST(BufferViewTest) {
+    int numDestroyed = 0;
+    Buffer buf;
+    {
+        Ptr<viewOwner> owner = viewOwner::Create(&numDestroyed);
+        buf.SetView(owner->bytes, 8, owner);
+    }
+    CHECK(0 == numDestroyed);
+    CHECK(buf.IsView());
+    CHECK(buf.Size() == 8);
+    CHECK(buf.Capacity() == 8);
+    CHECK(buf.Data()[7] == 8);
+
+    // moving keeps the view alive
+    Buffer buf1(std::move(buf));
+    CHECK(!buf.IsView());
+    CHECK(buf.Empty());
+    CHECK(buf1.IsView());
+    CHECK(0 == numDestroyed);
+
+    // adding data copies the content and releases the view
+    buf1.Add(3)[0] = 9;
+    CHECK(1 == numDestroyed);
+    CHECK(!buf1.IsView());
+    CHECK(buf1.Size() == 11);
+    CHECK(buf1.Data()[0] == 1);
+    CHECK(buf1.Data()[7] == 8);
+    CHECK(buf1.Data()[8] == 9);
+
+    // clearing releases the view
+    Ptr<viewOwner> owner = viewOwner::Create(&numDestroyed);
+    Buffer buf2;
+    buf2.SetView(owner->bytes, 4, owner);
+    owner = nullptr;
+    CHECK(1 == numDestroyed);
+    buf2.Clear();
+    CHECK(2 == numDestroyed);
+    CHECK(!buf2.IsView());
+    CHECK(buf2.Empty());
+    CHECK(buf2.Capacity() == 0);
+    buf2.Add(buf1.Data(), 2);
+    CHECK(buf2.Data()[1] == 2);
+}
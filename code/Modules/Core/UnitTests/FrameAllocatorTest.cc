@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//  FrameAllocatorTest.cc
+//  Test the per-thread frame arena allocator.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/frameAllocator.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocator) {
+    frameAllocator::setupThread(1024);
+    CHECK(frameAllocator::hasThreadArena());
+    CHECK(frameAllocator::arenaCapacity() == 1024);
+    CHECK(frameAllocator::numAllocatedBytes() == 0);
+
+    frameAllocator frameAlloc;
+    uint8_t* p0 = (uint8_t*) frameAlloc.Alloc(10);
+    uint8_t* p1 = (uint8_t*) frameAlloc.Alloc(32);
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK((intptr_t(p1) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(p1 == p0 + 16);
+    CHECK(frameAllocator::numAllocatedBytes() == 48);
+
+    // the most recent allocation grows in place
+    CHECK(frameAlloc.ReAlloc(p1, 32, 256) == p1);
+    CHECK(frameAllocator::numAllocatedBytes() == 272);
+    // any other allocation is copied
+    p0[0] = 0x23;
+    uint8_t* p2 = (uint8_t*) frameAlloc.ReAlloc(p0, 10, 20);
+    CHECK(p2 != p0);
+    CHECK(p2[0] == 0x23);
+    frameAlloc.Free(p2, 20);
+
+    // overflow into a new chunk, and grow the arena on reset
+    void* p3 = frameAlloc.Alloc(2000);
+    CHECK(p3);
+    CHECK(frameAllocator::numAllocatedBytes() > 1024);
+    frameAllocator::reset();
+    CHECK(frameAllocator::numAllocatedBytes() == 0);
+    CHECK(frameAllocator::arenaCapacity() >= 2000);
+
+    frameAllocator::discardThread();
+    CHECK(!frameAllocator::hasThreadArena());
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorRunLoop) {
+    CoreSetup setup;
+    setup.FrameArenaSize = 4096;
+    Core::Setup(setup);
+    CHECK(frameAllocator::hasThreadArena());
+    CHECK(frameAllocator::arenaCapacity() == 4096);
+    CHECK(nullptr != Memory::GetAllocator(Memory::Tag::Frame));
+
+    for (int frame = 0; frame < 4; frame++) {
+        const Memory::Stats before = Memory::QueryStats(Memory::Tag::Frame);
+        {
+            Array<int> arr(Memory::Tag::Frame);
+            for (int i = 0; i < 100; i++) {
+                arr.Add(i);
+            }
+            CHECK(arr.Size() == 100);
+            CHECK(arr[99] == 99);
+
+            // a moved array keeps the frame memory, a copy doesn't
+            Array<int> moved(std::move(arr));
+            CHECK(moved[50] == 50);
+            Array<int> copied(moved);
+            CHECK(copied[50] == 50);
+
+            Buffer buf(Memory::Tag::Frame);
+            CHECK(buf.GetAllocTag() == Memory::Tag::Frame);
+            buf.Add((const uint8_t*)"Bla", 4);
+            CHECK(buf.Size() == 4);
+            CHECK(Memory::QueryStats(Memory::Tag::Frame).NumAllocs > before.NumAllocs);
+        }
+        CHECK(frameAllocator::numAllocatedBytes() > 0);
+        CHECK(Memory::QueryStats(Memory::Tag::Frame).NumAllocs == before.NumAllocs);
+        CHECK(Memory::QueryStats(Memory::Tag::Frame).NumBytes == before.NumBytes);
+
+        // end of frame resets the frame arena
+        Core::PreRunLoop()->Run();
+        Core::PostRunLoop()->Run();
+        CHECK(frameAllocator::numAllocatedBytes() == 0);
+    }
+    Core::Discard();
+    CHECK(!frameAllocator::hasThreadArena());
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorBenchmark) {
+    Core::Setup();
+    const int numFrames = 256;
+    const int numAllocsPerFrame = 1024;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::system_clock::now();
+        for (int frame = 0; frame < numFrames; frame++) {
+            for (int i = 0; i < numAllocsPerFrame; i++) {
+                void* p = Memory::Alloc(16 + ((i * 7) & 255), Memory::Tag::Frame);
+                Memory::Free(p);
+            }
+            Core::PostRunLoop()->Run();
+        }
+        std::chrono::duration<double> frameDur = std::chrono::system_clock::now() - start;
+
+        start = std::chrono::system_clock::now();
+        for (int frame = 0; frame < numFrames; frame++) {
+            for (int i = 0; i < numAllocsPerFrame; i++) {
+                void* p = Memory::Alloc(16 + ((i * 7) & 255), Memory::Tag::Default);
+                Memory::Free(p);
+            }
+            Core::PostRunLoop()->Run();
+        }
+        std::chrono::duration<double> defaultDur = std::chrono::system_clock::now() - start;
+        Log::Info("run %d: %d alloc/free pairs: frame arena %f sec, default heap %f sec\n",
+            run, numFrames * numAllocsPerFrame, frameDur.count(), defaultDur.count());
+    }
+    Core::Discard();
+}
@@ -0,0 +1,266 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality and performance.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/ArrayMap.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+struct HashMapIntHasher {
+    uint32_t operator()(int val) const {
+        return uint32_t(val);
+    };
+};
+
+struct HashMapStringHasher {
+    uint32_t operator()(const String& str) const {
+        // FNV-1a
+        uint32_t h = 2166136261U;
+        for (const char* p = str.AsCStr(); *p; p++) {
+            h = (h ^ uint8_t(*p)) * 16777619U;
+        }
+        return h;
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+    HashMap<int, int, HashMapIntHasher> map;
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(nullptr == map.Find(1));
+
+    // add and lookup, this will also grow the table a few times
+    for (int i = 0; i < 1000; i++) {
+        map.Add(i * 3, i);
+    }
+    CHECK(map.Size() == 1000);
+    CHECK(!map.Empty());
+    CHECK(map.Capacity() == 2048);
+    bool allFound = true;
+    for (int i = 0; i < 1000; i++) {
+        if (!map.Contains(i * 3) || (map[i * 3] != i) || (*map.Find(i * 3) != i)) {
+            allFound = false;
+        }
+        if (map.Contains(i * 3 + 1)) {
+            allFound = false;
+        }
+    }
+    CHECK(allFound);
+    CHECK(!map.AddUnique(3, 123));
+    CHECK(map[3] == 1);
+    CHECK(map.AddUnique(4, 123));
+    CHECK(map[4] == 123);
+    map.Erase(4);
+    CHECK(!map.Contains(4));
+    map.Erase(4);
+    CHECK(map.Size() == 1000);
+
+    // write access
+    map[6] = 12;
+    *map.Find(9) = 13;
+    CHECK(map[6] == 12);
+    CHECK(map[9] == 13);
+    map[6] = 2;
+    map[9] = 3;
+
+    // iteration
+    int num = 0;
+    int64_t keySum = 0;
+    for (const auto& kvp : map) {
+        CHECK(kvp.Key() == kvp.Value() * 3);
+        keySum += kvp.Key();
+        num++;
+    }
+    CHECK(num == 1000);
+    CHECK(keySum == 3 * (999 * 1000 / 2));
+
+    // copy construct and assign
+    HashMap<int, int, HashMapIntHasher> map1(map);
+    CHECK(map1.Size() == 1000);
+    CHECK(map1[300] == 100);
+    HashMap<int, int, HashMapIntHasher> map2;
+    map2.Add(1, 2);
+    map2 = map;
+    CHECK(map2.Size() == 1000);
+    CHECK(!map2.Contains(1));
+    CHECK(map2[300] == 100);
+
+    // move construct and assign
+    HashMap<int, int, HashMapIntHasher> map3(std::move(map1));
+    CHECK(map1.Empty());
+    CHECK(map1.Capacity() == 0);
+    CHECK(map3.Size() == 1000);
+    CHECK(map3[300] == 100);
+    HashMap<int, int, HashMapIntHasher> map4;
+    map4 = std::move(map3);
+    CHECK(map3.Empty());
+    CHECK(map4.Size() == 1000);
+    CHECK(map4[300] == 100);
+
+    // erase every other element, the rest must still be found
+    for (int i = 0; i < 1000; i += 2) {
+        map.Erase(i * 3);
+    }
+    CHECK(map.Size() == 500);
+    allFound = true;
+    for (int i = 0; i < 1000; i++) {
+        if (map.Contains(i * 3) != ((i & 1) == 1)) {
+            allFound = false;
+        }
+    }
+    CHECK(allFound);
+
+    // clear keeps capacity
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 2048);
+    CHECK(!map.Contains(3));
+
+    // reserve
+    HashMap<int, int, HashMapIntHasher> map5;
+    map5.Reserve(1000);
+    const int capacity = map5.Capacity();
+    CHECK(capacity >= 1000);
+    for (int i = 0; i < 1000; i++) {
+        map5.Add(i, i);
+    }
+    CHECK(map5.Capacity() == capacity);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapCollisionTest) {
+    // keys which all map to the same hash
+    struct badHasher {
+        uint32_t operator()(int /*val*/) const {
+            return 1;
+        };
+    };
+    HashMap<int, int, badHasher> map;
+    for (int i = 0; i < 100; i++) {
+        map.Add(i, i);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        map.Erase(i);
+    }
+    bool allFound = true;
+    for (int i = 0; i < 100; i++) {
+        if (map.Contains(i) != ((i % 3) != 0)) {
+            allFound = false;
+        }
+    }
+    CHECK(allFound);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStringTest) {
+    HashMap<String, String, HashMapStringHasher> map;
+    map.Add("One", "Eins");
+    map.Add("Two", "Zwei");
+    map.Add(KeyValuePair<String, String>("Three", "Drei"));
+    CHECK(map.Size() == 3);
+    CHECK(map["One"] == "Eins");
+    CHECK(map["Two"] == "Zwei");
+    CHECK(map["Three"] == "Drei");
+    CHECK(!map.Contains("Four"));
+    map.Erase("Two");
+    CHECK(map.Size() == 2);
+    CHECK(!map.Contains("Two"));
+    CHECK(map["Three"] == "Drei");
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+    for (int num = 1000; num <= 1000000; num *= 10) {
+
+        // keys are looked up in pseudo-random order, Map is filled
+        // in bulk mode (otherwise insertion is O(N^2)), and ArrayMap
+        // (which has no bulk mode) is skipped for big sizes
+        Array<int> lookupKeys;
+        lookupKeys.Reserve(num);
+        uint32_t rnd = 12345;
+        for (int i = 0; i < num; i++) {
+            rnd = rnd * 1664525 + 1013904223;
+            lookupKeys.Add(int(rnd % uint32_t(num)) * 7);
+        }
+
+        HashMap<int, int, HashMapIntHasher> hashMap;
+        auto start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            hashMap.Add(i * 7, i);
+        }
+        std::chrono::duration<double> hashMapAdd = std::chrono::system_clock::now() - start;
+        int64_t sum = 0;
+        start = std::chrono::system_clock::now();
+        for (int key : lookupKeys) {
+            sum += *hashMap.Find(key);
+        }
+        std::chrono::duration<double> hashMapFind = std::chrono::system_clock::now() - start;
+
+        Map<int, int> map;
+        start = std::chrono::system_clock::now();
+        map.BeginBulk();
+        for (int i = 0; i < num; i++) {
+            map.AddBulk(i * 7, i);
+        }
+        map.EndBulk();
+        std::chrono::duration<double> mapAdd = std::chrono::system_clock::now() - start;
+        int64_t mapSum = 0;
+        start = std::chrono::system_clock::now();
+        for (int key : lookupKeys) {
+            mapSum += map[key];
+        }
+        std::chrono::duration<double> mapFind = std::chrono::system_clock::now() - start;
+        CHECK(sum == mapSum);
+
+        std::chrono::duration<double> arrayMapAdd(0.0);
+        std::chrono::duration<double> arrayMapFind(0.0);
+        if (num <= 10000) {
+            ArrayMap<int, int> arrayMap;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < num; i++) {
+                arrayMap.Add(i * 7, i);
+            }
+            arrayMapAdd = std::chrono::system_clock::now() - start;
+            int64_t arrayMapSum = 0;
+            start = std::chrono::system_clock::now();
+            for (int key : lookupKeys) {
+                arrayMapSum += arrayMap[key];
+            }
+            arrayMapFind = std::chrono::system_clock::now() - start;
+            CHECK(sum == arrayMapSum);
+        }
+
+        HashSet<int, HashMapIntHasher> hashSet;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            hashSet.Add(i * 7);
+        }
+        std::chrono::duration<double> hashSetAdd = std::chrono::system_clock::now() - start;
+        int numFound = 0;
+        start = std::chrono::system_clock::now();
+        for (int key : lookupKeys) {
+            numFound += hashSet.Contains(key) ? 1 : 0;
+        }
+        std::chrono::duration<double> hashSetFind = std::chrono::system_clock::now() - start;
+        CHECK(numFound == num);
+
+        Log::Info("%d entries (add/find sec): HashMap %f/%f, Map %f/%f, ArrayMap %f/%f, HashSet %f/%f\n",
+            num,
+            hashMapAdd.count(), hashMapFind.count(),
+            mapAdd.count(), mapFind.count(),
+            arrayMapAdd.count(), arrayMapFind.count(),
+            hashSetAdd.count(), hashSetFind.count());
+    }
+}
@@ -16,7 +16,7 @@ struct IntHasher {
 
 TEST(HashSetTest) {
     
-    HashSet<int, IntHasher, 4> hashSet;
+    HashSet<int, IntHasher> hashSet;
     CHECK(hashSet.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
     CHECK(hashSet.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     CHECK(hashSet.Size() == 0);
@@ -45,7 +45,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet.Contains(123));
     
     // copy-construction
-    HashSet<int, IntHasher, 4> hashSet1(hashSet);
+    HashSet<int, IntHasher> hashSet1(hashSet);
     CHECK(hashSet1.Size() == 8);
     CHECK(!hashSet1.Empty());
     CHECK(hashSet1.Contains(1));
@@ -59,7 +59,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet1.Contains(123));
     
     // copy-assignment
-    HashSet<int, IntHasher, 4> hashSet2;
+    HashSet<int, IntHasher> hashSet2;
     hashSet2 = hashSet;
     CHECK(hashSet2.Size() == 8);
     CHECK(!hashSet2.Empty());
@@ -74,7 +74,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet2.Contains(123));
     
     // move-construction
-    HashSet<int, IntHasher, 4> hashSet3(std::move(hashSet2));
+    HashSet<int, IntHasher> hashSet3(std::move(hashSet2));
     CHECK(hashSet2.Size() == 0);
     CHECK(hashSet2.Empty());
     CHECK(hashSet3.Size() == 8);
@@ -90,7 +90,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet3.Contains(123));
     
     // move-assignment
-    HashSet<int, IntHasher, 4> hashSet4;
+    HashSet<int, IntHasher> hashSet4;
     hashSet4 = std::move(hashSet3);
     CHECK(hashSet3.Size() == 0);
     CHECK(hashSet3.Empty());
@@ -137,3 +137,60 @@ TEST(HashSetTest) {
     CHECK(hashSet4.Size() == 0);
     CHECK(!hashSet4.Contains(10));
 }
+
+TEST(HashSetGrowTest) {
+    HashSet<int, IntHasher> hashSet;
+    CHECK(hashSet.Capacity() == 0);
+    CHECK(hashSet.GetMaxLoadFactor() == 0.8f);
+
+    // the table must grow and rehash while adding values
+    for (int i = 0; i < 10000; i++) {
+        hashSet.Add(i * 1024);
+    }
+    CHECK(hashSet.Size() == 10000);
+    CHECK(hashSet.Capacity() == 16384);
+    bool allFound = true;
+    for (int i = 0; i < 10000; i++) {
+        if (!hashSet.Contains(i * 1024) || hashSet.Contains(i * 1024 + 1)) {
+            allFound = false;
+        }
+    }
+    CHECK(allFound);
+    CHECK(*hashSet.Find(2048) == 2048);
+    CHECK(nullptr == hashSet.Find(2049));
+
+    // erasing a non-existing element does nothing
+    hashSet.Erase(1);
+    CHECK(hashSet.Size() == 10000);
+    for (int i = 0; i < 10000; i += 2) {
+        hashSet.Erase(i * 1024);
+    }
+    CHECK(hashSet.Size() == 5000);
+    allFound = true;
+    for (int i = 0; i < 10000; i++) {
+        if (hashSet.Contains(i * 1024) != ((i & 1) == 1)) {
+            allFound = false;
+        }
+    }
+    CHECK(allFound);
+    hashSet.Clear();
+    CHECK(hashSet.Empty());
+    CHECK(hashSet.Capacity() == 16384);
+
+    // reserving up front prevents rehashing
+    HashSet<int, IntHasher> hashSet1;
+    hashSet1.SetMaxLoadFactor(0.5f);
+    hashSet1.Reserve(1000);
+    CHECK(hashSet1.Capacity() == 2048);
+    for (int i = 0; i < 1024; i++) {
+        hashSet1.Add(i);
+    }
+    CHECK(hashSet1.Capacity() == 2048);
+    hashSet1.Add(1024);
+    CHECK(hashSet1.Capacity() == 4096);
+
+    // the deprecated NUMBUCKETS parameter is still accepted
+    HashSet<int, IntHasher, 64> hashSet2;
+    hashSet2.Add(1);
+    CHECK(hashSet2.Contains(1));
+}
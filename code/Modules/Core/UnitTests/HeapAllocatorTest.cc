@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+//  HeapAllocatorTest.cc
+//  Test the built-in size-class heap and pluggable allocators.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/heapAllocator.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+// a custom allocator which counts calls and forwards to malloc
+class countingAllocator : public Allocator {
+public:
+    virtual void* Alloc(int numBytes) override {
+        this->numAllocs++;
+        return std::malloc(numBytes);
+    };
+    virtual void Free(void* ptr, int numBytes) override {
+        this->numFrees++;
+        std::free(ptr);
+    };
+    int numAllocs = 0;
+    int numFrees = 0;
+};
+
+//------------------------------------------------------------------------------
+TEST(HeapAllocatorSizeClasses) {
+    CHECK(heapAllocator::sizeClass(1) == 0);
+    CHECK(heapAllocator::sizeClass(16) == 0);
+    CHECK(heapAllocator::sizeClass(17) == 1);
+    CHECK(heapAllocator::sizeClass(256) == 15);
+    CHECK(heapAllocator::sizeClass(257) == 16);
+    CHECK(heapAllocator::sizeClassBlockSize(16) == 320);
+    CHECK(heapAllocator::sizeClass(heapAllocator::MaxSmallSize) == heapAllocator::NumSizeClasses - 1);
+    CHECK(heapAllocator::sizeClassBlockSize(heapAllocator::NumSizeClasses - 1) == heapAllocator::MaxSmallSize);
+
+    // each size must fit into its size class, and not into the previous one
+    for (int size = 1; size <= heapAllocator::MaxSmallSize; size++) {
+        const int c = heapAllocator::sizeClass(size);
+        CHECK(size <= heapAllocator::sizeClassBlockSize(c));
+        if (c > 0) {
+            CHECK(size > heapAllocator::sizeClassBlockSize(c - 1));
+        }
+        CHECK((heapAllocator::sizeClassBlockSize(c) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(HeapAllocator) {
+    heapAllocator heap;
+
+    // freed blocks are recycled
+    void* p0 = heap.Alloc(24);
+    CHECK(p0);
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    heap.Free(p0, 24);
+    void* p1 = heap.Alloc(32);
+    CHECK(p0 == p1);
+    heap.Free(p1, 32);
+
+    // big allocations go through malloc
+    uint8_t* big = (uint8_t*) heap.Alloc(heapAllocator::MaxSmallSize + 1);
+    CHECK(big);
+    big[heapAllocator::MaxSmallSize] = 0x12;
+    heap.Free(big, heapAllocator::MaxSmallSize + 1);
+
+    // realloc within same size class stays in place
+    uint8_t* p2 = (uint8_t*) heap.Alloc(100);
+    for (int i = 0; i < 100; i++) {
+        p2[i] = uint8_t(i);
+    }
+    CHECK(heap.ReAlloc(p2, 100, 110) == p2);
+    uint8_t* p3 = (uint8_t*) heap.ReAlloc(p2, 110, 1000);
+    bool contentOk = true;
+    for (int i = 0; i < 100; i++) {
+        if (p3[i] != uint8_t(i)) {
+            contentOk = false;
+        }
+    }
+    CHECK(contentOk);
+    heap.Free(p3, 1000);
+
+    // many allocations of different sizes must not overlap
+    Array<uint8_t*> ptrs;
+    for (int i = 0; i < 4096; i++) {
+        const int size = 1 + ((i * 37) % 2048);
+        uint8_t* p = (uint8_t*) heap.Alloc(size);
+        Memory::Fill(p, size, uint8_t(i));
+        ptrs.Add(p);
+    }
+    bool noOverlap = true;
+    for (int i = 0; i < 4096; i++) {
+        const int size = 1 + ((i * 37) % 2048);
+        for (int j = 0; j < size; j++) {
+            if (ptrs[i][j] != uint8_t(i)) {
+                noOverlap = false;
+            }
+        }
+        heap.Free(ptrs[i], size);
+    }
+    CHECK(noOverlap);
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryAllocatorBackends) {
+    // Core::Setup() installs the built-in heaps by default
+    Core::Setup();
+    for (int i = 0; i < Memory::NumTags; i++) {
+        CHECK(nullptr != Memory::GetAllocator(Memory::Tag(i)));
+    }
+    String str("Some string which is allocated from the string heap");
+    Array<int> arr;
+    arr.Add(1);
+    Core::Discard();
+    for (int i = 0; i < Memory::NumTags; i++) {
+        CHECK(nullptr == Memory::GetAllocator(Memory::Tag(i)));
+    }
+    // memory blocks outliving Core must still be valid and freed properly
+    CHECK(str == "Some string which is allocated from the string heap");
+    CHECK(arr[0] == 1);
+    str.Clear();
+    arr.Clear();
+
+    // install a custom allocator for one tag, and malloc for the rest
+    static countingAllocator allocator;
+    CoreSetup setup;
+    setup.UseHeapAllocator = false;
+    setup.SetAllocator(Memory::Tag::IO, &allocator);
+    Core::Setup(setup);
+    CHECK(&allocator == Memory::GetAllocator(Memory::Tag::IO));
+    CHECK(nullptr == Memory::GetAllocator(Memory::Tag::Default));
+    void* p = Memory::Alloc(128, Memory::Tag::IO);
+    CHECK(allocator.numAllocs == 1);
+    p = Memory::ReAlloc(p, 256);
+    CHECK(allocator.numAllocs == 2);
+    CHECK(allocator.numFrees == 1);
+    Memory::Free(p);
+    CHECK(allocator.numFrees == 2);
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTagStats) {
+    const Memory::Stats before = Memory::QueryStats(Memory::Tag::Gfx);
+    void* p0 = Memory::Alloc(100, Memory::Tag::Gfx);
+    void* p1 = Memory::Alloc(28, Memory::Tag::Gfx);
+    Memory::Stats cur = Memory::QueryStats(Memory::Tag::Gfx);
+    CHECK(cur.NumBytes == before.NumBytes + 128);
+    CHECK(cur.NumAllocs == before.NumAllocs + 2);
+    CHECK(cur.TotalAllocs == before.TotalAllocs + 2);
+    p0 = Memory::ReAlloc(p0, 200);
+    cur = Memory::QueryStats(Memory::Tag::Gfx);
+    CHECK(cur.NumBytes == before.NumBytes + 228);
+    CHECK(cur.NumAllocs == before.NumAllocs + 2);
+    Memory::Free(p0);
+    Memory::Free(p1);
+    cur = Memory::QueryStats(Memory::Tag::Gfx);
+    CHECK(cur.NumBytes == before.NumBytes);
+    CHECK(cur.NumAllocs == before.NumAllocs);
+    CHECK(0 == std::strcmp("Gfx", Memory::TagToString(Memory::Tag::Gfx)));
+}
+
+//------------------------------------------------------------------------------
+TEST(HeapAllocatorBenchmark) {
+    const int numLive = 4096;
+    const int numRounds = 64;
+    static void* ptrs[numLive];
+    heapAllocator heap;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::system_clock::now();
+        for (int r = 0; r < numRounds; r++) {
+            for (int i = 0; i < numLive; i++) {
+                ptrs[i] = heap.Alloc(16 + ((i * 7) & 511));
+            }
+            for (int i = 0; i < numLive; i++) {
+                heap.Free(ptrs[i], 16 + ((i * 7) & 511));
+            }
+        }
+        std::chrono::duration<double> heapDur = std::chrono::system_clock::now() - start;
+
+        start = std::chrono::system_clock::now();
+        for (int r = 0; r < numRounds; r++) {
+            for (int i = 0; i < numLive; i++) {
+                ptrs[i] = std::malloc(16 + ((i * 7) & 511));
+            }
+            for (int i = 0; i < numLive; i++) {
+                std::free(ptrs[i]);
+            }
+        }
+        std::chrono::duration<double> mallocDur = std::chrono::system_clock::now() - start;
+        Log::Info("run %d: %d alloc/free pairs: heapAllocator %f sec, malloc %f sec\n",
+            run, numLive * numRounds, heapDur.count(), mallocDur.count());
+    }
+}
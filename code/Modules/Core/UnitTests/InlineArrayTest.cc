@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+//  InlineArrayTest.cc
+//  Test InlineArray class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/InlineArray.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+static int64_t
+numContainerAllocs() {
+    return Memory::QueryStats(Memory::Tag::Containers).TotalAllocs;
+}
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayTest) {
+    const int64_t allocsAtStart = numContainerAllocs();
+
+    InlineArray<int, 4> array0;
+    CHECK(array0.Size() == 0);
+    CHECK(array0.Empty());
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0.IsInline());
+
+    // filling the inline storage doesn't allocate
+    array0.Add(0);
+    array0.Add(1);
+    array0.Add(2);
+    array0.Add(3);
+    CHECK(array0.Size() == 4);
+    CHECK(array0.Spare() == 0);
+    CHECK(array0.IsInline());
+    CHECK(numContainerAllocs() == allocsAtStart);
+    CHECK(array0.Front() == 0);
+    CHECK(array0.Back() == 3);
+
+    // growing beyond spills to the heap
+    array0.Add(4);
+    CHECK(array0.Size() == 5);
+    CHECK(!array0.IsInline());
+    CHECK(array0.Capacity() > 4);
+    CHECK(numContainerAllocs() == allocsAtStart + 1);
+    for (int i = 0; i < 5; i++) {
+        CHECK(array0[i] == i);
+    }
+    CHECK(array0.FindIndexLinear(3) == 3);
+    CHECK(array0.FindIndexLinear(5) == InvalidIndex);
+
+    // trim moves back into inline storage
+    CHECK(array0.PopBack() == 4);
+    array0.Trim();
+    CHECK(array0.IsInline());
+    CHECK(array0.Size() == 4);
+    CHECK(array0.Capacity() == 4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(array0[i] == i);
+    }
+
+    // insert and erase in inline storage
+    CHECK(array0.PopFront() == 0);
+    array0.Insert(0, 10);
+    CHECK(array0.IsInline());
+    CHECK(array0[0] == 10);
+    CHECK(array0[1] == 1);
+    array0.Erase(1);
+    CHECK(array0.Size() == 3);
+    CHECK(array0[0] == 10);
+    CHECK(array0[1] == 2);
+    CHECK(array0[2] == 3);
+    array0.EraseSwap(0);
+    CHECK(array0.Size() == 2);
+    array0.Clear();
+    CHECK(array0.Empty());
+    CHECK(array0.IsInline());
+
+    // reserve
+    InlineArray<int, 4> array1;
+    array1.Reserve(3);
+    CHECK(array1.IsInline());
+    array1.Reserve(16);
+    CHECK(!array1.IsInline());
+    CHECK(array1.Capacity() == 16);
+
+    // initializer list and iteration
+    InlineArray<int, 4> array2({ 1, 2, 3 });
+    CHECK(array2.Size() == 3);
+    CHECK(array2.IsInline());
+    int sum = 0;
+    for (int i : array2) {
+        sum += i;
+    }
+    CHECK(sum == 6);
+}
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayCopyMoveTest) {
+
+    // copy and move in inline storage (uses non-POD elements)
+    InlineArray<String, 2> array0;
+    array0.Add("One");
+    array0.Add("Two");
+    InlineArray<String, 2> array1(array0);
+    CHECK(array1.IsInline());
+    CHECK(array1.Size() == 2);
+    CHECK(array1[0] == "One");
+    CHECK(array1[1] == "Two");
+    InlineArray<String, 2> array2(std::move(array1));
+    CHECK(array1.Empty());
+    CHECK(array1.IsInline());
+    CHECK(array2.IsInline());
+    CHECK(array2[0] == "One");
+    CHECK(array2[1] == "Two");
+
+    // copy and move of spilled arrays
+    array0.Add("Three");
+    CHECK(!array0.IsInline());
+    array1 = array0;
+    CHECK(!array1.IsInline());
+    CHECK(array1.Size() == 3);
+    CHECK(array1.Capacity() == 3);
+    CHECK(array1[2] == "Three");
+    const String* elms = array1.begin();
+    array2 = std::move(array1);
+    CHECK(array2.begin() == elms);
+    CHECK(array2.Size() == 3);
+    CHECK(array2[0] == "One");
+    CHECK(array2[2] == "Three");
+    CHECK(array1.Empty());
+    CHECK(array1.IsInline());
+    CHECK(array1.Capacity() == 2);
+
+    // a moved-from array is still usable
+    array1.Add("Four");
+    CHECK(array1.Size() == 1);
+    CHECK(array1[0] == "Four");
+
+    // assigning a small array to a spilled one switches to inline storage
+    array2 = array1;
+    CHECK(array2.IsInline());
+    CHECK(array2.Size() == 1);
+    CHECK(array2[0] == "Four");
+}
+
+//------------------------------------------------------------------------------
+TEST(InlineArrayAllocBenchmark) {
+    // build many short-lived, small arrays, this is the typical
+    // use case for InlineArray (e.g. the IO requests of a load group)
+    const int numArrays = 100000;
+    const int maxElements = 6;
+
+    int64_t arraySum = 0;
+    int64_t allocs = numContainerAllocs();
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < numArrays; i++) {
+        Array<int> array;
+        const int num = (i % maxElements) + 1;
+        for (int j = 0; j < num; j++) {
+            array.Add(j);
+        }
+        for (int val : array) {
+            arraySum += val;
+        }
+    }
+    std::chrono::duration<double> arrayDur = std::chrono::system_clock::now() - start;
+    const int64_t arrayAllocs = numContainerAllocs() - allocs;
+
+    int64_t inlineArraySum = 0;
+    allocs = numContainerAllocs();
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numArrays; i++) {
+        InlineArray<int, 4> array;
+        const int num = (i % maxElements) + 1;
+        for (int j = 0; j < num; j++) {
+            array.Add(j);
+        }
+        for (int val : array) {
+            inlineArraySum += val;
+        }
+    }
+    std::chrono::duration<double> inlineArrayDur = std::chrono::system_clock::now() - start;
+    const int64_t inlineArrayAllocs = numContainerAllocs() - allocs;
+
+    CHECK(arraySum == inlineArraySum);
+    CHECK(inlineArrayAllocs < arrayAllocs);
+    Log::Info("%d arrays with 1..%d elements: Array %d allocs %f sec, InlineArray<4> %d allocs %f sec\n",
+        numArrays, maxElements,
+        int(arrayAllocs), arrayDur.count(),
+        int(inlineArrayAllocs), inlineArrayDur.count());
+}
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test the work-stealing JobSystem.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Log.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+    // without setup, jobs run right away
+    CHECK(!JobSystem::IsValid());
+    int value = 0;
+    JobSystem::Counter counter;
+    JobSystem::Run([&value] { value = 1; }, &counter);
+    CHECK(1 == value);
+    CHECK(counter.IsDone());
+    JobSystem::ParallelFor(0, 100, 10, [&value](int begin, int end) { value += end - begin; });
+    CHECK(101 == value);
+
+    JobSystem::Setup(3);
+    CHECK(JobSystem::IsValid());
+    CHECK(3 == JobSystem::NumWorkers());
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+
+    // many small jobs, worker threads must have their thread-locals
+    std::atomic<int> sum{0};
+    std::atomic<int> numNoRunLoop{0};
+    for (int i = 0; i < 10000; i++) {
+        JobSystem::Run([&sum, &numNoRunLoop, mainThreadId, i] {
+            sum += i;
+            if ((std::this_thread::get_id() != mainThreadId) && (nullptr == Core::PreRunLoop())) {
+                numNoRunLoop++;
+            }
+        }, &counter);
+    }
+    JobSystem::Wait(counter);
+    CHECK(counter.IsDone());
+    CHECK(0 == counter.Value());
+    CHECK(sum == (9999 * 10000) / 2);
+    CHECK(0 == numNoRunLoop);
+
+    // ParallelFor must visit each index exactly once
+    const int num = 100000;
+    std::vector<std::atomic<int>> visits(num);
+    for (auto& v : visits) {
+        v = 0;
+    }
+    JobSystem::ParallelFor(0, num, 0, [&visits](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    int numBad = 0;
+    for (auto& v : visits) {
+        if (1 != v) {
+            numBad++;
+        }
+    }
+    CHECK(0 == numBad);
+
+    // a job graph: a -> (b, c) -> d
+    std::atomic<int> step{0};
+    std::atomic<int> numOrderErrors{0};
+    JobSystem::Counter a, bc, d;
+    JobSystem::Run([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        step = 1;
+    }, &a);
+    for (int i = 0; i < 2; i++) {
+        JobSystem::RunAfter(a, [&] {
+            if (step.load() < 1) {
+                numOrderErrors++;
+            }
+            step++;
+        }, &bc);
+    }
+    JobSystem::RunAfter(bc, [&] {
+        if (3 != step.load()) {
+            numOrderErrors++;
+        }
+        step = 4;
+    }, &d);
+    JobSystem::Wait(d);
+    CHECK(a.IsDone() && bc.IsDone());
+    CHECK(4 == step);
+    CHECK(0 == numOrderErrors);
+
+    // RunAfter on a finished counter runs the job
+    JobSystem::RunAfter(a, [&step] { step = 5; }, &d);
+    JobSystem::Wait(d);
+    CHECK(5 == step);
+
+    // waiting inside jobs (nested ParallelFor)
+    std::atomic<int64_t> nestedSum{0};
+    JobSystem::ParallelFor(0, 64, 1, [&nestedSum](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            JobSystem::ParallelFor(0, 1000, 100, [&nestedSum](int b, int e) {
+                int64_t s = 0;
+                for (int k = b; k < e; k++) {
+                    s += k;
+                }
+                nestedSum += s;
+            });
+        }
+    });
+    CHECK(nestedSum == int64_t(64) * ((999 * 1000) / 2));
+
+    // jobs created on threads which aren't part of the job system
+    std::atomic<int> numExternal{0};
+    JobSystem::Counter external;
+    std::thread thread([&] {
+        for (int i = 0; i < 1000; i++) {
+            JobSystem::Run([&numExternal] { numExternal++; }, &external);
+        }
+    });
+    thread.join();
+    JobSystem::Wait(external);
+    CHECK(1000 == numExternal);
+
+    // pending jobs are run in Discard()
+    std::atomic<int> numPending{0};
+    for (int i = 0; i < 100; i++) {
+        JobSystem::Run([&numPending] { numPending++; });
+    }
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+    CHECK(100 == numPending);
+}
+
+//------------------------------------------------------------------------------
+static double
+parallelWork(std::vector<float>& values) {
+    auto start = std::chrono::steady_clock::now();
+    JobSystem::ParallelFor(0, int(values.size()), 0, [&values](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float v = float(i);
+            for (int k = 0; k < 32; k++) {
+                v = std::sqrt(v + 1.0f);
+            }
+            values[i] = v;
+        }
+    });
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemBenchmark) {
+    std::vector<float> values(1<<20);
+    const double serialTime = parallelWork(values);
+    Log::Info("ParallelFor %d items, serial: %f sec\n", int(values.size()), serialTime);
+    for (int numWorkers = 1; numWorkers <= 8; numWorkers *= 2) {
+        JobSystem::Setup(numWorkers);
+        const double time = parallelWork(values);
+
+        // job overhead: many tiny jobs
+        const int numJobs = 100000;
+        std::atomic<int> count{0};
+        JobSystem::Counter counter;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numJobs; i++) {
+            JobSystem::Run([&count] { count++; }, &counter);
+        }
+        JobSystem::Wait(counter);
+        std::chrono::duration<double> jobTime = std::chrono::steady_clock::now() - start;
+        JobSystem::Discard();
+
+        CHECK(numJobs == count);
+        Log::Info("%d workers: ParallelFor %f sec (%.2fx), %d empty jobs %f sec (%.3f us/job)\n",
+            numWorkers, time, serialTime / time, numJobs, jobTime.count(), (jobTime.count() * 1000000.0) / numJobs);
+    }
+}
@@ -6,6 +6,17 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
 #include "Core/Logger.h"
+#include "Core/LogDecoder.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/String/String.h"
+#include "Core/String/StringBuilder.h"
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 using namespace Oryol;
 
@@ -54,4 +65,338 @@ TEST(LogTest) {
     test_log();
 }
 
+//------------------------------------------------------------------------------
+class CollectLogger : public Logger {
+    OryolClassDecl(CollectLogger);
+public:
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        StringBuilder str;
+        str.AppendFormatVAList(8192, msg, args);
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->messages.Add(str.GetString());
+    };
+    std::mutex mutex;
+    Array<String> messages;
+};
+
+//------------------------------------------------------------------------------
+class FileLogger : public Logger {
+    OryolClassDecl(FileLogger);
+public:
+    FileLogger() {
+        this->file = std::tmpfile();
+    };
+    ~FileLogger() {
+        if (this->file) {
+            std::fclose(this->file);
+        }
+    };
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        // write-through like a console
+        if (this->file) {
+            std::vfprintf(this->file, msg, args);
+            std::fflush(this->file);
+        }
+    };
+    FILE* file = nullptr;
+};
+
+//------------------------------------------------------------------------------
+// temporarily replace all loggers
+static Array<Ptr<Logger>> replaceLoggers(const Ptr<Logger>& logger) {
+    Array<Ptr<Logger>> oldLoggers;
+    while (Log::GetNumLoggers() > 0) {
+        oldLoggers.Add(Log::GetLogger(0));
+        Log::RemoveLogger(Log::GetLogger(0));
+    }
+    Log::AddLogger(logger);
+    return oldLoggers;
+}
+
+static void restoreLoggers(const Ptr<Logger>& logger, const Array<Ptr<Logger>>& oldLoggers) {
+    Log::RemoveLogger(logger);
+    for (const auto& l : oldLoggers) {
+        Log::AddLogger(l);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(LogAsyncTest) {
+    Ptr<CollectLogger> logger = CollectLogger::Create();
+    Array<Ptr<Logger>> oldLoggers = replaceLoggers(logger);
+    CHECK(Log::GetNumLoggers() == 1);
+    CHECK(!Log::IsAsync());
+    CHECK(Log::Flush() == 0);
+
+    // without drain thread, messages wait for Log::Flush()
+    Log::SetupAsync(Log::OverflowPolicy::Drop, false);
+    CHECK(Log::IsAsync());
+    const Log::AsyncStats stats0 = Log::QueryAsyncStats();
+    Log::Info("msg %d\n", 1);
+    Log::Warn("msg %d\n", 2);
+    Log::Dbg("msg %s\n", "3");
+    CHECK(logger->messages.Empty());
+    CHECK(Log::Flush() == 3);
+    CHECK(logger->messages.Size() == 3);
+    CHECK(logger->messages[0] == "msg 1\n");
+    CHECK(logger->messages[1] == "msg 2\n");
+    CHECK(logger->messages[2] == "msg 3\n");
+    const Log::AsyncStats stats1 = Log::QueryAsyncStats();
+    CHECK((stats1.NumQueued - stats0.NumQueued) == 3);
+
+    // errors are printed immediately, after the queued messages
+    logger->messages.Clear();
+    Log::Info("before error\n");
+    Log::Error("error\n");
+    CHECK(logger->messages.Size() == 2);
+    CHECK(logger->messages[0] == "before error\n");
+    CHECK(logger->messages[1] == "error\n");
+
+    // overflowing the queue drops messages
+    logger->messages.Clear();
+    const int num = 10000;
+    for (int i = 0; i < num; i++) {
+        Log::Info("overflow message number %d, with some padding to fill up the queue faster\n", i);
+    }
+    Log::Flush();
+    const Log::AsyncStats stats2 = Log::QueryAsyncStats();
+    CHECK((stats2.NumDropped - stats1.NumDropped) > 0);
+    CHECK((logger->messages.Size() + (stats2.NumDropped - stats1.NumDropped)) == num);
+    CHECK(logger->messages[0] == "overflow message number 0, with some padding to fill up the queue faster\n");
+
+    // overlong messages are truncated
+    logger->messages.Clear();
+    static char longStr[6000];
+    std::memset(longStr, 'x', sizeof(longStr) - 1);
+    Log::Info("%s", longStr);
+    Log::Flush();
+    CHECK(logger->messages.Size() == 1);
+    CHECK(logger->messages[0].Length() == 4095);
+    Log::DiscardAsync();
+
+    // multiple threads with drain thread, blocking when the queue is full,
+    // messages of each thread must arrive in order
+    logger->messages.Clear();
+    Log::SetupAsync(Log::OverflowPolicy::Block, true);
+    const int numThreads = 4;
+    const int numPerThread = 5000;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t] {
+            for (int i = 0; i < numPerThread; i++) {
+                Log::Info("%d %d\n", t, i);
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    Log::DiscardAsync();
+    CHECK(!Log::IsAsync());
+    const Log::AsyncStats stats3 = Log::QueryAsyncStats();
+    CHECK(stats3.NumDropped == stats2.NumDropped);
+    CHECK(logger->messages.Size() == numThreads * numPerThread);
+    int next[numThreads] = { };
+    bool ordered = true;
+    for (const String& msg : logger->messages) {
+        int t = 0, i = 0;
+        if ((2 != std::sscanf(msg.AsCStr(), "%d %d", &t, &i)) || (t < 0) || (t >= numThreads) || (next[t] != i)) {
+            ordered = false;
+            break;
+        }
+        next[t]++;
+    }
+    CHECK(ordered);
+
+    // threads which exit without Core::LeaveThread() release their queue
+    logger->messages.Clear();
+    Log::SetupAsync(Log::OverflowPolicy::Drop, false);
+    const int64_t numQueues = Log::QueryAsyncStats().NumQueues;
+    for (int t = 0; t < 16; t++) {
+        std::thread thread([t] {
+            Log::Info("thread %d\n", t);
+        });
+        thread.join();
+    }
+    CHECK(Log::Flush() == 16);
+    CHECK(Log::QueryAsyncStats().NumQueues == numQueues);
+    Log::DiscardAsync();
+
+    restoreLoggers(logger, oldLoggers);
+}
+
+//------------------------------------------------------------------------------
+enum class testEnum {
+    Zero,
+    One,
+    Two,
+};
+
+// log messages with deferred formatting, and the expected output
+static void deferredMessages(Array<String>& expected) {
+    char buf[256];
+    const char* str = "Bla";
+    const char* nullStr = nullptr;
+    const int64_t big = -1234567890123ll;
+    const size_t size = 4000000000u;
+    int local = 0;
+    void* ptr = &local;
+
+    o_info("no args\n");
+    expected.Add("no args\n");
+    o_info("%d %i %u %x %X %o\n", -12, 34, 56u, 0xbeef, -1, 8);
+    std::snprintf(buf, sizeof(buf), "%d %i %u %x %X %o\n", -12, 34, 56u, 0xbeef, -1, 8);
+    expected.Add(buf);
+    o_warn("%lld %llx %zu %hhd %hu\n", (long long)big, (unsigned long long)big, size, 300, 70000);
+    std::snprintf(buf, sizeof(buf), "%lld %llx %zu %hhd %hu\n", (long long)big, (unsigned long long)big, size, 300, 70000);
+    expected.Add(buf);
+    o_dbg("%f %.2f %8.3e %g %c%c\n", 0.1, 3.14159f, 12345.678, 0.5, 'o', 'k');
+    std::snprintf(buf, sizeof(buf), "%f %.2f %8.3e %g %c%c\n", 0.1, 3.14159f, 12345.678, 0.5, 'o', 'k');
+    expected.Add(buf);
+    o_info("'%s' '%5s' '%-5s|' '%.2s' '%s' %d%%\n", str, str, str, str, nullStr, 100);
+    std::snprintf(buf, sizeof(buf), "'%s' '%5s' '%-5s|' '%.2s' '%s' %d%%\n", str, str, str, str, "(null)", 100);
+    expected.Add(buf);
+    o_info("%*d|%-*d|%.*f %p %d\n", 6, 42, 4, 7, 3, 2.5, ptr, int(testEnum::Two));
+    std::snprintf(buf, sizeof(buf), "%*d|%-*d|%.*f %p %d\n", 6, 42, 4, 7, 3, 2.5, ptr, int(testEnum::Two));
+    expected.Add(buf);
+    o_info("%s %d\n", String("string object").AsCStr(), int(testEnum::One));
+    expected.Add("string object 1\n");
+    // long double can't be deferred, formatted on the calling thread instead
+    o_info("%.1Lf\n", 1.5L);
+    expected.Add("1.5\n");
+    // messages without deferred formatting are recorded as text
+    Log::Info("text %d\n", 7);
+    expected.Add("text 7\n");
+}
+
+//------------------------------------------------------------------------------
+TEST(LogDeferredTest) {
+    Ptr<CollectLogger> logger = CollectLogger::Create();
+    Array<Ptr<Logger>> oldLoggers = replaceLoggers(logger);
+    CHECK(!Log::IsDeferredFormatting());
+
+    // without async mode, o_info() etc. print immediately
+    o_info("immediate %d\n", 1);
+    CHECK(logger->messages.Size() == 1);
+    CHECK(logger->messages[0] == "immediate 1\n");
+    logger->messages.Clear();
+
+    // deferred formatting on the draining thread
+    Log::SetupAsync(Log::OverflowPolicy::Drop, false);
+    Log::SetDeferredFormatting(true);
+    CHECK(Log::IsDeferredFormatting());
+    const Log::AsyncStats stats0 = Log::QueryAsyncStats();
+    Array<String> expected;
+    deferredMessages(expected);
+    CHECK(logger->messages.Empty());
+    CHECK(Log::Flush() == expected.Size());
+    CHECK(logger->messages.Size() == expected.Size());
+    for (int i = 0; i < expected.Size(); i++) {
+        CHECK(logger->messages[i] == expected[i]);
+    }
+    const Log::AsyncStats stats1 = Log::QueryAsyncStats();
+    CHECK((stats1.NumQueued - stats0.NumQueued) == expected.Size());
+
+    // disabled levels are filtered before anything is recorded
+    Log::SetLogLevel(Log::Level::Warn);
+    o_info("filtered %d\n", 1);
+    o_dbg("filtered %d\n", 2);
+    Log::SetLogLevel(Log::Level::Dbg);
+    CHECK(Log::QueryAsyncStats().NumQueued == stats1.NumQueued);
+
+    // binary sink, decoded in small chunks
+    Buffer stream;
+    Log::SetBinarySink([&stream](const uint8_t* data, int numBytes) {
+        stream.Add(data, numBytes);
+    });
+    logger->messages.Clear();
+    expected.Clear();
+    deferredMessages(expected);
+    const int numRepeats = 100;
+    int textSize = 0;
+    for (int i = 0; i < numRepeats; i++) {
+        char buf[128];
+        o_info("repeated message %d of %d with a long format string\n", i, numRepeats);
+        textSize += std::snprintf(buf, sizeof(buf), "repeated message %d of %d with a long format string\n", i, numRepeats);
+        expected.Add(buf);
+    }
+    CHECK(Log::Flush() == expected.Size());
+    Log::SetBinarySink(nullptr);
+    CHECK(logger->messages.Empty());
+    // format strings are only written once
+    CHECK(stream.Size() < textSize / 2);
+
+    LogDecoder decoder;
+    Array<String> decoded;
+    bool ok = true;
+    for (int pos = 0; pos < stream.Size(); pos += 7) {
+        const int chunkSize = (stream.Size() - pos) < 7 ? (stream.Size() - pos) : 7;
+        ok &= decoder.Decode(stream.Data() + pos, chunkSize, [&decoded](Log::Level l, const char* msg) {
+            decoded.Add(msg);
+        });
+    }
+    CHECK(ok);
+    CHECK(decoder.NumMessages() == expected.Size());
+    CHECK(decoded.Size() == expected.Size());
+    for (int i = 0; i < decoded.Size(); i++) {
+        CHECK(decoded[i] == expected[i]);
+    }
+
+    // a corrupted stream is detected
+    decoder.Reset();
+    Buffer corrupted;
+    corrupted.Add(stream.Data(), LogDecoder::HeaderSize);
+    const uint8_t garbage[4] = { 0xFF, 1, 2, 3 };
+    corrupted.Add(garbage, sizeof(garbage));
+    CHECK(!decoder.Decode(corrupted.Data(), corrupted.Size(), [](Log::Level, const char*) { }));
+
+    Log::DiscardAsync();
+    CHECK(!Log::IsDeferredFormatting());
+    restoreLoggers(logger, oldLoggers);
+}
+
+//------------------------------------------------------------------------------
+TEST(LogAsyncBenchmark) {
+    Ptr<FileLogger> logger = FileLogger::Create();
+    Array<Ptr<Logger>> oldLoggers = replaceLoggers(logger);
+
+    // log in bursts like a frame-based app would, with a pause
+    // between the bursts in which the drain thread can catch up
+    const int numBursts = 40;
+    const int burstSize = 250;
+    const int num = numBursts * burstSize;
+    double* latency = new double[num];
+    const char* modes[3] = { "sync", "async", "deferred" };
+    char results[3][256];
+    for (int mode = 0; mode < 3; mode++) {
+        if (mode > 0) {
+            Log::SetupAsync(Log::OverflowPolicy::Block, true);
+            Log::SetDeferredFormatting(2 == mode);
+        }
+        double total = 0.0;
+        for (int i = 0; i < num; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            o_info("frame %d: loaded '%s' (%d bytes) in %f ms\n", i, "textures/terrain/grass.dds", i * 17, i * 0.01);
+            std::chrono::duration<double, std::micro> d = std::chrono::high_resolution_clock::now() - start;
+            latency[i] = d.count();
+            total += d.count();
+            if ((i % burstSize) == (burstSize - 1)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+        if (mode > 0) {
+            Log::DiscardAsync();
+        }
+        std::sort(latency, latency + num);
+        std::snprintf(results[mode], sizeof(results[mode]),
+            "%s log: %d messages, per call mean %.3f us, median %.3f us, p99 %.3f us, max %.3f us\n",
+            modes[mode], num, total / num, latency[num / 2], latency[num * 99 / 100], latency[num - 1]);
+    }
+    delete[] latency;
+    restoreLoggers(logger, oldLoggers);
+    for (int mode = 0; mode < 3; mode++) {
+        Log::Info("%s", results[mode]);
+    }
+}
+
 
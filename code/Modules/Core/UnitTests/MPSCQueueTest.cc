@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//  MPSCQueueTest.cc
+//  Test the lock-free multi-producer single-consumer queue.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/mpscQueue.h"
+#include "Core/Ptr.h"
+#include "Core/RefCounted.h"
+#include <thread>
+#include <vector>
+
+using namespace Oryol;
+using namespace _priv;
+
+class mpscTestObj : public RefCounted {
+    OryolClassDecl(mpscTestObj);
+public:
+    int value = 0;
+};
+
+//------------------------------------------------------------------------------
+TEST(MPSCQueueTest) {
+    // single-threaded FIFO behaviour
+    mpscQueue<int> queue;
+    CHECK(queue.Empty());
+    int value = 0;
+    CHECK(!queue.Dequeue(value));
+    for (int i = 0; i < 10; i++) {
+        queue.Enqueue(i);
+    }
+    CHECK(!queue.Empty());
+    for (int i = 0; i < 10; i++) {
+        CHECK(queue.Dequeue(value));
+        CHECK(i == value);
+    }
+    CHECK(queue.Empty());
+
+    // remaining elements are released in the destructor
+    Ptr<mpscTestObj> obj = mpscTestObj::Create();
+    {
+        mpscQueue<Ptr<mpscTestObj>> ptrQueue;
+        ptrQueue.Enqueue(obj);
+        ptrQueue.Enqueue(obj);
+        CHECK(3 == obj->GetRefCount());
+        Ptr<mpscTestObj> out;
+        CHECK(ptrQueue.Dequeue(out));
+        out = nullptr;
+        CHECK(2 == obj->GetRefCount());
+    }
+    CHECK(1 == obj->GetRefCount());
+
+    // many producers, one consumer, per-producer order must be kept
+    const int numProducers = 4;
+    const int numItems = 100000;
+    mpscQueue<int> mtQueue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; p++) {
+        producers.emplace_back([&mtQueue, p, numItems] {
+            for (int i = 0; i < numItems; i++) {
+                mtQueue.Enqueue((p << 24) | i);
+            }
+        });
+    }
+    int next[numProducers] = { };
+    int numReceived = 0;
+    int numOrderErrors = 0;
+    while (numReceived < numProducers * numItems) {
+        if (mtQueue.Dequeue(value)) {
+            const int p = value >> 24;
+            const int i = value & 0xFFFFFF;
+            if (next[p] != i) {
+                numOrderErrors++;
+            }
+            next[p] = i + 1;
+            numReceived++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    CHECK(0 == numOrderErrors);
+    CHECK(mtQueue.Empty());
+}
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+//  MemorySimdTest.cc
+//  Test the Memory bulk functions with all supported SIMD levels.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MemorySimdLevelTest) {
+    CHECK(Memory::IsSimdLevelSupported(Memory::SimdLevel::Scalar));
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+    CHECK(Memory::IsSimdLevelSupported(best));
+    Log::Info("Memory SIMD level: %s\n", Memory::SimdLevelToString(best));
+    Memory::SetSimdLevel(Memory::SimdLevel::Scalar);
+    CHECK(Memory::GetSimdLevel() == Memory::SimdLevel::Scalar);
+    Memory::SetSimdLevel(best);
+    CHECK(Memory::GetSimdLevel() == best);
+}
+
+//------------------------------------------------------------------------------
+TEST(MemorySimdFunctionsTest) {
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+    const int maxNum = 4099;
+    uint16_t* indices16 = (uint16_t*) Memory::Alloc(maxNum * sizeof(uint16_t) + 2);
+    uint32_t* indices32 = (uint32_t*) Memory::Alloc((maxNum + 2) * sizeof(uint32_t));
+    uint8_t* src = (uint8_t*) Memory::Alloc(maxNum * 4 + 4);
+    uint8_t* dst = (uint8_t*) Memory::Alloc(maxNum * 4 + 4);
+    for (int i = 0; i < maxNum + 1; i++) {
+        indices16[i] = uint16_t(i * 17);
+    }
+    for (int i = 0; i < maxNum * 4 + 4; i++) {
+        src[i] = uint8_t(i * 7);
+    }
+
+    for (int l = 0; l < int(Memory::SimdLevel::NumSimdLevels); l++) {
+        const Memory::SimdLevel level = Memory::SimdLevel(l);
+        if (!Memory::IsSimdLevelSupported(level)) {
+            continue;
+        }
+        Memory::SetSimdLevel(level);
+
+        // odd sizes and unaligned pointers to cover the scalar tail paths
+        const int sizes[] = { 0, 1, 7, 8, 15, 16, 33, 4095, 4099 };
+        for (int num : sizes) {
+            for (int offset = 0; offset < 2; offset++) {
+
+                // index widening
+                Memory::Fill(indices32, (maxNum + 2) * sizeof(uint32_t), 0xFF);
+                Memory::WidenIndices(indices16 + offset, indices32 + offset, num);
+                bool widenValid = true;
+                for (int i = 0; i < num; i++) {
+                    if (indices32[i + offset] != indices16[i + offset]) {
+                        widenValid = false;
+                    }
+                }
+                if (indices32[num + offset] != 0xFFFFFFFF) {
+                    widenValid = false;
+                }
+                CHECK(widenValid);
+
+                // pixel swizzle
+                Memory::Fill(dst, maxNum * 4 + 4, 0xFF);
+                Memory::SwizzleRGBAToBGRA(src + offset, dst + offset, num);
+                bool swizzleValid = true;
+                for (int i = 0; i < num; i++) {
+                    const uint8_t* s = src + offset + i * 4;
+                    const uint8_t* d = dst + offset + i * 4;
+                    if ((d[0] != s[2]) || (d[1] != s[1]) || (d[2] != s[0]) || (d[3] != s[3])) {
+                        swizzleValid = false;
+                    }
+                }
+                if (dst[offset + num * 4] != 0xFF) {
+                    swizzleValid = false;
+                }
+                CHECK(swizzleValid);
+
+                // streaming copy
+                Memory::Fill(dst, maxNum * 4 + 4, 0xFF);
+                Memory::CopyStreaming(src + offset, dst + 1 - offset, num * 4);
+                bool copyValid = true;
+                for (int i = 0; i < num * 4; i++) {
+                    if (dst[i + 1 - offset] != src[i + offset]) {
+                        copyValid = false;
+                    }
+                }
+                CHECK(copyValid);
+            }
+        }
+
+        // in-place swizzle, twice yields the original
+        Memory::Copy(src, dst, maxNum * 4);
+        Memory::SwizzleRGBAToBGRA(dst, dst, maxNum);
+        CHECK((dst[0] == src[2]) && (dst[2] == src[0]));
+        Memory::SwizzleRGBAToBGRA(dst, dst, maxNum);
+        bool inPlaceValid = true;
+        for (int i = 0; i < maxNum * 4; i++) {
+            if (dst[i] != src[i]) {
+                inPlaceValid = false;
+            }
+        }
+        CHECK(inPlaceValid);
+
+        // a big streaming copy
+        const int bigSize = 1024 * 1024 + 3;
+        uint8_t* bigSrc = (uint8_t*) Memory::Alloc(bigSize);
+        uint8_t* bigDst = (uint8_t*) Memory::Alloc(bigSize + 1);
+        for (int i = 0; i < bigSize; i++) {
+            bigSrc[i] = uint8_t(i ^ (i >> 8));
+        }
+        Memory::CopyStreaming(bigSrc, bigDst + 1, bigSize);
+        CHECK(0 == std::memcmp(bigSrc, bigDst + 1, bigSize));
+        Memory::Free(bigSrc);
+        Memory::Free(bigDst);
+    }
+    Memory::SetSimdLevel(best);
+    Memory::Free(indices16);
+    Memory::Free(indices32);
+    Memory::Free(src);
+    Memory::Free(dst);
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryCopyStridedTest) {
+    // gather a float3 position from 32-byte vertices, and scatter it back
+    struct vertex {
+        float pos[3];
+        float uv[2];
+        uint8_t color[4];
+        float pad[2];
+    };
+    static_assert(sizeof(vertex) == 32, "unexpected vertex size");
+    const int num = 100;
+    vertex vertices[num];
+    for (int i = 0; i < num; i++) {
+        vertices[i].pos[0] = float(i);
+        vertices[i].pos[1] = float(i * 2);
+        vertices[i].pos[2] = float(i * 3);
+        vertices[i].color[0] = uint8_t(i);
+    }
+    float positions[num * 3];
+    Memory::CopyStrided(&vertices[0].pos, sizeof(vertex), positions, 3 * sizeof(float), 3 * sizeof(float), num);
+    bool gatherValid = true;
+    for (int i = 0; i < num; i++) {
+        if ((positions[i * 3] != float(i)) || (positions[i * 3 + 1] != float(i * 2)) || (positions[i * 3 + 2] != float(i * 3))) {
+            gatherValid = false;
+        }
+    }
+    CHECK(gatherValid);
+
+    uint8_t colors[num * 4];
+    Memory::CopyStrided(&vertices[0].color, sizeof(vertex), colors, 4, 4, num);
+    CHECK(colors[40] == 10);
+
+    for (int i = 0; i < num * 3; i++) {
+        positions[i] = -positions[i];
+    }
+    Memory::CopyStrided(positions, 3 * sizeof(float), &vertices[0].pos, sizeof(vertex), 3 * sizeof(float), num);
+    CHECK(vertices[10].pos[0] == -10.0f);
+    CHECK(vertices[10].pos[2] == -30.0f);
+    CHECK(vertices[10].color[0] == 10);
+
+    // odd element size
+    uint8_t bytes[num * 5];
+    Memory::CopyStrided(&vertices[0].pos, sizeof(vertex), bytes, 5, 5, num);
+    CHECK(0 == std::memcmp(&bytes[5 * 7], &vertices[7].pos, 5));
+}
+
+//------------------------------------------------------------------------------
+TEST(MemorySimdBenchmark) {
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+    const int maxBytes = 64 * 1024 * 1024;
+    uint8_t* src = (uint8_t*) Memory::Alloc(maxBytes);
+    uint8_t* dst = (uint8_t*) Memory::Alloc(maxBytes);
+    Memory::Fill(src, maxBytes, 0x12);
+    Memory::Fill(dst, maxBytes, 0x34);
+
+    for (int numBytes = 64; numBytes <= maxBytes; numBytes *= 16) {
+        // process about 256 MB per measurement
+        const int numIters = (256 * 1024 * 1024) / numBytes;
+        for (int l = 0; l < int(Memory::SimdLevel::NumSimdLevels); l++) {
+            const Memory::SimdLevel level = Memory::SimdLevel(l);
+            if (!Memory::IsSimdLevelSupported(level)) {
+                continue;
+            }
+            Memory::SetSimdLevel(level);
+
+            auto start = std::chrono::system_clock::now();
+            for (int i = 0; i < numIters; i++) {
+                Memory::WidenIndices((const uint16_t*)src, (uint32_t*)dst, numBytes / 4);
+            }
+            std::chrono::duration<double> widenDur = std::chrono::system_clock::now() - start;
+
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numIters; i++) {
+                Memory::SwizzleRGBAToBGRA(src, dst, numBytes / 4);
+            }
+            std::chrono::duration<double> swizzleDur = std::chrono::system_clock::now() - start;
+
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numIters; i++) {
+                Memory::CopyStreaming(src, dst, numBytes);
+            }
+            std::chrono::duration<double> streamDur = std::chrono::system_clock::now() - start;
+
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numIters; i++) {
+                Memory::Copy(src, dst, numBytes);
+            }
+            std::chrono::duration<double> copyDur = std::chrono::system_clock::now() - start;
+
+            Log::Info("%d bytes x %d, %s (sec): widen %f, swizzle %f, stream copy %f, copy %f\n",
+                numBytes, numIters, Memory::SimdLevelToString(level),
+                widenDur.count(), swizzleDur.count(), streamDur.count(), copyDur.count());
+        }
+    }
+    Memory::SetSimdLevel(best);
+    CHECK(dst[0] == 0x12);
+    Memory::Free(src);
+    Memory::Free(dst);
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//  MemoryTrackerTest.cc
+//  Test Memory allocation tracking.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/StringBuilder.h"
+#include <chrono>
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerTest) {
+    CHECK(!Memory::IsTracking());
+    Memory::SetTracking(true);
+    CHECK(Memory::IsTracking());
+    const Memory::TrackingStats start = Memory::EndTrackingFrame();
+
+    // allocations from the same callsite
+    void* ptrs[10];
+    for (int i = 0; i < 10; i++) {
+        ptrs[i] = Memory::Alloc(100, Memory::Tag::Gfx);
+    }
+    for (int i = 0; i < 4; i++) {
+        Memory::Free(ptrs[i]);
+    }
+    Memory::TrackingStats stats = Memory::EndTrackingFrame(4);
+    CHECK(stats.FrameAllocs == 10);
+    CHECK(stats.FrameBytes == 1000);
+    CHECK((stats.LiveAllocs - start.LiveAllocs) == 6);
+    CHECK((stats.LiveBytes - start.LiveBytes) == 600);
+    CHECK(stats.DroppedEvents == start.DroppedEvents);
+
+    // ReAlloc is tracked as free + alloc
+    ptrs[4] = Memory::ReAlloc(ptrs[4], 200);
+    const int numLive = Memory::DumpTrackingLeaks();
+    stats = Memory::EndTrackingFrame();
+    CHECK(stats.FrameAllocs == 1);
+    CHECK(stats.FrameBytes == 200);
+    CHECK((stats.LiveBytes - start.LiveBytes) == 700);
+    CHECK(numLive == stats.LiveAllocs);
+
+    // frees of untracked allocations are ignored
+    Memory::SetTracking(false);
+    void* untracked = Memory::Alloc(64);
+    Memory::SetTracking(true);
+    Memory::Free(untracked);
+    for (int i = 4; i < 10; i++) {
+        Memory::Free(ptrs[i]);
+    }
+    stats = Memory::EndTrackingFrame();
+    CHECK(stats.FrameAllocs == 0);
+    CHECK(stats.LiveAllocs == start.LiveAllocs);
+    CHECK(stats.LiveBytes == start.LiveBytes);
+
+    // with a sample rate, only every Nth allocation is tracked
+    Memory::SetTracking(true, 4);
+    void* sampled[100];
+    for (int i = 0; i < 100; i++) {
+        sampled[i] = Memory::Alloc(16);
+    }
+    stats = Memory::EndTrackingFrame();
+    CHECK(stats.FrameAllocs == 25);
+    CHECK(stats.FrameBytes == 400);
+    for (int i = 0; i < 100; i++) {
+        Memory::Free(sampled[i]);
+    }
+    stats = Memory::EndTrackingFrame();
+    CHECK(stats.LiveAllocs == start.LiveAllocs);
+    Memory::SetTracking(true);
+
+    // overflowing the ring buffer drops events, but doesn't block
+    const int numOverflow = 70000;
+    void** many = (void**) Memory::Alloc(numOverflow * sizeof(void*));
+    for (int i = 0; i < numOverflow; i++) {
+        many[i] = Memory::Alloc(8);
+    }
+    for (int i = 0; i < numOverflow; i++) {
+        Memory::Free(many[i]);
+    }
+    Memory::Free(many);
+    stats = Memory::EndTrackingFrame();
+    CHECK(stats.DroppedEvents > start.DroppedEvents);
+    Memory::SetTracking(false);
+    CHECK(!Memory::IsTracking());
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerStringAtomTest) {
+    // string atom tables are never freed, and are not reported as leaks
+    Memory::SetTracking(true);
+    const Memory::TrackingStats start = Memory::EndTrackingFrame();
+    std::thread thread([] {
+        StringBuilder strBuilder;
+        for (int i = 0; i < 1000; i++) {
+            strBuilder.Format(64, "MemoryTrackerStringAtomTest_%d", i);
+            StringAtom atom(strBuilder.AsCStr());
+        }
+    });
+    thread.join();
+    const Memory::TrackingStats stats = Memory::EndTrackingFrame();
+    CHECK(stats.LiveAllocs == start.LiveAllocs);
+    CHECK(stats.LiveBytes == start.LiveBytes);
+    Memory::SetTracking(false);
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerBenchmark) {
+    const int num = 100000;
+    void** ptrs = (void**) Memory::Alloc(num * sizeof(void*));
+    // untracked, all allocations tracked, every 64th allocation tracked
+    const int sampleRates[3] = { 0, 1, 64 };
+    double dur[3];
+    for (int tracking = 0; tracking < 3; tracking++) {
+        Memory::SetTracking(0 != tracking, tracking ? sampleRates[tracking] : 1);
+        auto start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            ptrs[i] = Memory::Alloc(32 + (i & 255));
+            // drain once in a while, like a real frame would
+            if ((i & 16383) == 16383) {
+                for (int j = i - 16383; j <= i; j++) {
+                    Memory::Free(ptrs[j]);
+                }
+                if (tracking) {
+                    Memory::EndTrackingFrame();
+                }
+            }
+        }
+        for (int j = num - (num & 16383); j < num; j++) {
+            Memory::Free(ptrs[j]);
+        }
+        if (tracking) {
+            Memory::EndTrackingFrame();
+        }
+        std::chrono::duration<double> d = std::chrono::system_clock::now() - start;
+        dur[tracking] = d.count();
+    }
+    Memory::SetTracking(false);
+    Memory::Free(ptrs);
+    Log::Info("%d alloc/free (sec): untracked %f, tracked %f, tracked 1/64 %f\n", num, dur[0], dur[1], dur[2]);
+    CHECK(dur[0] > 0.0);
+}
@@ -9,6 +9,10 @@
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
 #include "Core/Memory/poolAllocator.h"
+#include "Core/Memory/growablePoolAllocator.h"
+#include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -28,3 +32,273 @@ TEST(PoolAllocator) {
     CHECK(obj == obj1);
     allocatorOne.Destroy(obj1);
 }
+
+struct poolObj {
+    poolObj() : value(0) { };
+    poolObj(int v) : value(v) { };
+    int value;
+    uint8_t payload[40];
+};
+
+TEST(GrowablePoolAllocator) {
+
+    growablePoolAllocator<poolObj> allocator;
+    CHECK(allocator.Capacity() == 0);
+
+    // allocating and releasing the same object twice should return the same pointer
+    poolObj* obj = allocator.Create(1);
+    CHECK(0 != obj);
+    CHECK(obj->value == 1);
+    CHECK(allocator.Capacity() == 256);
+    allocator.Destroy(obj);
+    poolObj* obj1 = allocator.Create();
+    CHECK(obj == obj1);
+    allocator.Destroy(obj1);
+
+    // grow beyond the 65536 elements limit of poolAllocator
+    const int num = 100000;
+    static poolObj* objs[num];
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.Capacity() >= uint32_t(num));
+    bool allValid = true;
+    for (int i = 0; i < num; i++) {
+        if (objs[i]->value != i) {
+            allValid = false;
+        }
+    }
+    CHECK(allValid);
+    allocator.DestroyN(objs, num);
+
+    // batch creation must reuse the freed elements, and never
+    // hand out an element twice
+    const uint32_t capacity = allocator.Capacity();
+    allocator.CreateN(objs, num, 0);
+    CHECK(allocator.Capacity() == capacity);
+    for (int i = 0; i < num; i++) {
+        objs[i]->value = i;
+    }
+    allValid = true;
+    for (int i = 0; i < num; i++) {
+        if (objs[i]->value != i) {
+            allValid = false;
+        }
+    }
+    CHECK(allValid);
+    allocator.DestroyN(objs, num);
+}
+
+template<class ALLOCATOR> double poolChurn(ALLOCATOR& allocator, int numThreads) {
+    const int numRounds = 256;
+    const int numLive = 4096;
+    auto start = std::chrono::system_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&allocator]() {
+            std::vector<poolObj*> objs(numLive);
+            for (int r = 0; r < numRounds; r++) {
+                for (int i = 0; i < numLive; i++) {
+                    objs[i] = allocator.Create(i);
+                }
+                for (int i = 0; i < numLive; i++) {
+                    allocator.Destroy(objs[i]);
+                }
+            }
+            poolMagazines::discardThread();
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    return dur.count();
+}
+
+double poolChurnBatched(growablePoolAllocator<poolObj>& allocator, int numThreads) {
+    const int numRounds = 256;
+    const int numLive = 4096;
+    auto start = std::chrono::system_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&allocator]() {
+            std::vector<poolObj*> objs(numLive);
+            for (int r = 0; r < numRounds; r++) {
+                allocator.CreateN(&objs[0], numLive, 0);
+                allocator.DestroyN(&objs[0], numLive);
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    return dur.count();
+}
+
+TEST(PoolAllocatorChurnBenchmark) {
+    for (int numThreads = 1; numThreads <= 4; numThreads *= 2) {
+        poolAllocator<poolObj> pool;
+        growablePoolAllocator<poolObj> growablePool;
+        const double poolDur = poolChurn(pool, numThreads);
+        const double growableDur = poolChurn(growablePool, numThreads);
+        const double batchedDur = poolChurnBatched(growablePool, numThreads);
+        Log::Info("%d threads: poolAllocator %f sec, growablePoolAllocator %f sec, CreateN/DestroyN %f sec\n",
+            numThreads, poolDur, growableDur, batchedDur);
+    }
+}
+
+TEST(PoolAllocatorMagazines) {
+    growablePoolAllocator<poolObj> allocator;
+    CHECK(allocator.MagazineSize() == ORYOL_POOL_MAGAZINE_SIZE);
+    allocator.SetMagazineSize(4);
+
+    // the most recently destroyed object is reused first
+    poolObj* obj0 = allocator.Create(1);
+    allocator.Destroy(obj0);
+    poolObj* obj1 = allocator.Create(2);
+    CHECK(obj0 == obj1);
+    CHECK(obj1->value == 2);
+    allocator.Destroy(obj1);
+
+    // objects destroyed on another thread end up in that thread's
+    // magazine and must be flushed back to the pool
+    const int num = 1000;
+    static poolObj* objs[num];
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    std::thread thread([&allocator]() {
+        for (int i = 0; i < num; i++) {
+            allocator.Destroy(objs[i]);
+        }
+        poolMagazines::discardThread();
+    });
+    thread.join();
+    const uint32_t capacity = allocator.Capacity();
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.Capacity() == capacity);
+    bool allValid = true;
+    for (int i = 0; i < num; i++) {
+        if (objs[i]->value != i) {
+            allValid = false;
+        }
+    }
+    CHECK(allValid);
+    for (int i = 0; i < num; i++) {
+        allocator.Destroy(objs[i]);
+    }
+    poolMagazines::discardThread();
+}
+
+TEST(PoolAllocatorMagazineRelease) {
+    growablePoolAllocator<poolObj> allocator;
+    allocator.SetMagazineSize(4);
+
+    // magazines are flushed when a thread exits without discardThread(),
+    // (the number of objects fills the first 2 puddles exactly, so that
+    // any stranded node would cause a new puddle to be allocated)
+    const int num = 768;
+    static poolObj* objs[num];
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    const uint32_t capacity = allocator.Capacity();
+    CHECK(capacity == uint32_t(num));
+    std::thread thread0([&allocator]() {
+        for (int i = 0; i < num; i++) {
+            allocator.Destroy(objs[i]);
+        }
+    });
+    thread0.join();
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.Capacity() == capacity);
+
+    // disabling magazines flushes the magazines of running threads
+    std::atomic<int> step{0};
+    std::thread thread1([&allocator, &step]() {
+        for (int i = 0; i < num; i++) {
+            allocator.Destroy(objs[i]);
+        }
+        step = 1;
+        while (step != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (step != 1) {
+        std::this_thread::yield();
+    }
+    allocator.SetMagazineSize(0);
+    for (int i = 0; i < num; i++) {
+        objs[i] = allocator.Create(i);
+    }
+    CHECK(allocator.Capacity() == capacity);
+    step = 2;
+    thread1.join();
+    for (int i = 0; i < num; i++) {
+        allocator.Destroy(objs[i]);
+    }
+    poolMagazines::discardThread();
+}
+
+struct bigPoolObj {
+    bigPoolObj(int v) : value(v) { };
+    int value;
+    uint8_t payload[32 * 1024];
+};
+
+TEST(PoolAllocatorConcurrentGrow) {
+    // threads which find the free-list empty at the same time must
+    // not all allocate a new puddle (4 magazines of 64 fill the
+    // first puddle exactly, the big objects make allocating a puddle
+    // slow enough for the threads to overlap)
+    const int numThreads = 4;
+    for (int round = 0; round < 16; round++) {
+        growablePoolAllocator<bigPoolObj> allocator;
+        allocator.SetMagazineSize(64);
+        std::atomic<int> numReady{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.push_back(std::thread([&allocator, &numReady, i]() {
+                numReady++;
+                while (numReady != numThreads) {
+                    // spin until all threads are running
+                }
+                bigPoolObj* obj = allocator.Create(i);
+                allocator.Destroy(obj);
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(allocator.Capacity() == 256);
+    }
+}
+
+TEST(PoolAllocatorMagazineScalingBenchmark) {
+    int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 2) {
+        maxThreads = 2;
+    }
+    else if (maxThreads > 16) {
+        maxThreads = 16;
+    }
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        growablePoolAllocator<poolObj> noMagazines;
+        noMagazines.SetMagazineSize(0);
+        const double noMagDur = poolChurn(noMagazines, numThreads);
+        double magDur[3];
+        const int magSizes[3] = { 8, 32, 128 };
+        for (int i = 0; i < 3; i++) {
+            growablePoolAllocator<poolObj> magazines;
+            magazines.SetMagazineSize(magSizes[i]);
+            magDur[i] = poolChurn(magazines, numThreads);
+        }
+        Log::Info("%d threads: no magazines %f sec, magazine size 8: %f sec, 32: %f sec, 128: %f sec\n",
+            numThreads, noMagDur, magDur[0], magDur[1], magDur[2]);
+    }
+}
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//  RWLockTest.cc
+//  Test RWLock under contention.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/RWLock.h"
+#include "Core/Log.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(RWLockTest) {
+    RWLock lock;
+
+    // uncontended
+    lock.LockRead();
+    lock.LockRead();
+    lock.UnlockRead();
+    lock.UnlockRead();
+    lock.LockWrite();
+    lock.UnlockWrite();
+    {
+        ScopedWriteLock writeLock(lock);
+    }
+    {
+        ScopedReadLock readLock(lock);
+    }
+
+    // writers update two values, readers must never see them differ
+    const int numThreads = 4;
+    const int numIters = 20000;
+    int64_t a = 0;
+    int64_t b = 0;
+    std::atomic<int> numTorn{0};
+    std::thread threads[numThreads * 2];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&] {
+            for (int i = 0; i < numIters; i++) {
+                lock.LockWrite();
+                a++;
+                b++;
+                lock.UnlockWrite();
+            }
+        });
+        threads[numThreads + t] = std::thread([&] {
+            for (int i = 0; i < numIters; i++) {
+                lock.LockRead();
+                if (a != b) {
+                    numTorn++;
+                }
+                lock.UnlockRead();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    CHECK(a == numThreads * numIters);
+    CHECK(b == numThreads * numIters);
+    CHECK(numTorn == 0);
+
+    // a waiting writer keeps new readers out
+    std::atomic<int> step{0};
+    lock.LockRead();
+    std::thread writer([&] {
+        step = 1;
+        lock.LockWrite();
+        step = 2;
+        lock.UnlockWrite();
+    });
+    while (step < 1) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<bool> readerDone{false};
+    std::thread reader([&] {
+        lock.LockRead();
+        // the writer must have been first
+        CHECK(2 == step);
+        lock.UnlockRead();
+        readerDone = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(!readerDone);
+    CHECK(1 == step);
+    lock.UnlockRead();
+    writer.join();
+    reader.join();
+    CHECK(readerDone);
+}
+
+//------------------------------------------------------------------------------
+TEST(RWLockParkTest) {
+    // a writer waiting for a long read must not burn CPU time
+    RWLock lock;
+    lock.LockRead();
+    std::atomic<bool> locked{false};
+    std::thread writer([&] {
+        lock.LockWrite();
+        locked = true;
+        lock.UnlockWrite();
+    });
+    const std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    CHECK(!locked);
+    lock.UnlockRead();
+    writer.join();
+    CHECK(locked);
+    Log::Info("writer waiting %.3f sec for a reader used %.3f sec CPU time\n", wall.count(), cpu);
+    CHECK(cpu < (wall.count() * 0.5));
+}
+
+//------------------------------------------------------------------------------
+template<class LOCK, class READ, class WRITE> double
+contentionRun(LOCK& lock, int numThreads, int numIters, int writeEvery, READ lockRead, WRITE lockWrite) {
+    volatile int64_t value = 0;
+    std::thread threads[16];
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&, t] {
+            int64_t sum = 0;
+            for (int i = 0; i < numIters; i++) {
+                if (0 == ((i + t) % writeEvery)) {
+                    lockWrite(lock, true);
+                    value = value + 1;
+                    lockWrite(lock, false);
+                }
+                else {
+                    lockRead(lock, true);
+                    sum += value;
+                    lockRead(lock, false);
+                }
+            }
+            (void)sum;
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+//------------------------------------------------------------------------------
+TEST(RWLockBenchmark) {
+    const int numIters = 200000;
+    const int writeEvery[2] = { 100, 4 };
+    for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+        for (int w = 0; w < 2; w++) {
+            RWLock rwLock;
+            const double rwTime = contentionRun(rwLock, numThreads, numIters, writeEvery[w],
+                [](RWLock& l, bool lock) { lock ? l.LockRead() : l.UnlockRead(); },
+                [](RWLock& l, bool lock) { lock ? l.LockWrite() : l.UnlockWrite(); });
+            std::mutex mutex;
+            const double mutexTime = contentionRun(mutex, numThreads, numIters, writeEvery[w],
+                [](std::mutex& m, bool lock) { lock ? m.lock() : m.unlock(); },
+                [](std::mutex& m, bool lock) { lock ? m.lock() : m.unlock(); });
+            Log::Info("%d threads x %d ops, 1/%d writes (sec): RWLock %f, std::mutex %f\n",
+                numThreads, numIters, writeEvery[w], rwTime, mutexTime);
+            CHECK(rwTime > 0.0);
+        }
+    }
+}
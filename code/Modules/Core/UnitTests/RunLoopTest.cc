@@ -5,6 +5,10 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RunLoop.h"
+#include "Core/Threading/JobSystem.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 using namespace Oryol;
 
@@ -29,3 +33,68 @@ TEST(RunLoopTest) {
     CHECK(x == 2);
     CHECK(y == 4);
 }
+
+TEST(RunLoopDepsTest) {
+    // without JobSystem, callbacks with Deps run in id order
+    RunLoop runLoop;
+    Array<int> order;
+    runLoop.Add([&order] { order.Add(0); }, RunLoop::Deps({ "a" }, { }));
+    runLoop.Add([&order] { order.Add(1); });
+    auto id2 = runLoop.Add([&order] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        order.Add(2);
+    }, RunLoop::Deps({ }, { "b" }));
+    runLoop.Run();
+    CHECK(order.Size() == 3);
+    CHECK(order[0] == 0 && order[1] == 1 && order[2] == 2);
+    CHECK(runLoop.CallbackDuration(id2).AsMilliSeconds() >= 1.0);
+    CHECK(runLoop.CallbackDuration(RunLoop::InvalidId).AsSeconds() == 0.0);
+
+    JobSystem::Setup(3);
+    const std::thread::id mainThreadId = std::this_thread::get_id();
+    RunLoop parLoop;
+    std::atomic<int> x{0};
+    std::atomic<int> numErrors{0};
+    std::atomic<int> numReaders{0};
+    // writer, then two readers (concurrent), then another writer
+    parLoop.Add([&] {
+        if (0 != x) {
+            numErrors++;
+        }
+        x = 1;
+    }, RunLoop::Deps({ }, { "x" }));
+    auto reader = [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (1 != x) {
+            numErrors++;
+        }
+        numReaders++;
+    };
+    auto idReader0 = parLoop.Add(reader, RunLoop::Deps({ "x" }, { }));
+    parLoop.Add(reader, RunLoop::Deps({ "x" }, { }));
+    parLoop.Add([&] {
+        if (2 != numReaders) {
+            numErrors++;
+        }
+        x = 2;
+    }, RunLoop::Deps({ "y" }, { "x" }));
+    // callbacks without Deps run on the calling thread, after all earlier callbacks
+    parLoop.Add([&] {
+        if ((2 != x) || (std::this_thread::get_id() != mainThreadId)) {
+            numErrors++;
+        }
+        x = 0;
+        numReaders = 0;
+    });
+    auto start = std::chrono::steady_clock::now();
+    parLoop.Run();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    CHECK(0 == numErrors);
+    CHECK(0 == x);
+    // the readers sleep in parallel
+    CHECK(d.count() < 0.09);
+    CHECK(parLoop.CallbackDuration(idReader0).AsMilliSeconds() >= 40.0);
+    parLoop.Run();
+    CHECK(0 == numErrors);
+    JobSystem::Discard();
+}
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//  SoAArrayTest.cc
+//  Test SoAArray class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SoAArray.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+struct soaVec4 {
+    float x, y, z, w;
+};
+
+//------------------------------------------------------------------------------
+TEST(SoAArrayTest) {
+    SoAArray<soaVec4, int, uint8_t> array0;
+    CHECK(array0.NumFields == 3);
+    CHECK(array0.Size() == 0);
+    CHECK(array0.Empty());
+    CHECK(array0.Capacity() == 0);
+
+    for (int i = 0; i < 100; i++) {
+        const float f = float(i);
+        CHECK(array0.Add(soaVec4{ f, f + 1.0f, f + 2.0f, f + 3.0f }, i * 2, uint8_t(i)) == i);
+    }
+    CHECK(array0.Size() == 100);
+    CHECK(!array0.Empty());
+    CHECK((array0.Capacity() % SoAArray<soaVec4>::StreamAlign) == 0);
+
+    // each stream must be aligned
+    CHECK((intptr_t(array0.Field<0>()) & (SoAArray<soaVec4>::StreamAlign - 1)) == 0);
+    CHECK((intptr_t(array0.Field<1>()) & (SoAArray<soaVec4>::StreamAlign - 1)) == 0);
+    CHECK((intptr_t(array0.Field<2>()) & (SoAArray<soaVec4>::StreamAlign - 1)) == 0);
+
+    bool allValid = true;
+    const soaVec4* vecs = array0.Field<0>();
+    const int* ints = array0.Field<1>();
+    const uint8_t* bytes = array0.Field<2>();
+    for (int i = 0; i < 100; i++) {
+        if ((vecs[i].x != float(i)) || (vecs[i].w != float(i) + 3.0f) || (ints[i] != i * 2) || (bytes[i] != uint8_t(i))) {
+            allValid = false;
+        }
+    }
+    CHECK(allValid);
+
+    // erase-swap
+    array0.EraseSwap(10);
+    CHECK(array0.Size() == 99);
+    CHECK(array0.Field<1>()[10] == 99 * 2);
+    CHECK(array0.Field<2>()[10] == 99);
+    array0.EraseSwap(98);
+    CHECK(array0.Size() == 98);
+    CHECK(array0.Field<1>()[97] == 97 * 2);
+
+    // copy and move
+    SoAArray<soaVec4, int, uint8_t> array1(array0);
+    CHECK(array1.Size() == 98);
+    CHECK(array1.Capacity() == 112);
+    CHECK(array1.Field<1>()[10] == 99 * 2);
+    CHECK(array1.Field<0>()[20].y == 21.0f);
+    SoAArray<soaVec4, int, uint8_t> array2(std::move(array1));
+    CHECK(array1.Empty());
+    CHECK(array1.Capacity() == 0);
+    CHECK(array2.Size() == 98);
+    CHECK(array2.Field<1>()[10] == 99 * 2);
+    array1 = array2;
+    CHECK(array1.Size() == 98);
+    CHECK(array1.Field<2>()[50] == 50);
+
+    // reserve and clear
+    SoAArray<float> array3;
+    array3.Reserve(10);
+    CHECK(array3.Capacity() == 16);
+    array3.Add(1.0f);
+    array3.Reserve(16);
+    CHECK(array3.Capacity() == 32);
+    array3.Clear();
+    CHECK(array3.Empty());
+    CHECK(array3.Capacity() == 32);
+}
+
+//------------------------------------------------------------------------------
+TEST(SoAArrayInterleaveTest) {
+    SoAArray<soaVec4, int, float> array;
+    for (int i = 0; i < 8; i++) {
+        const float f = float(i);
+        array.Add(soaVec4{ f, f, f, 1.0f }, i, f * 0.5f);
+    }
+
+    // interleave into a 'vertex' with a float4 and float,
+    // and skip the int field
+    struct vertex {
+        float f;
+        soaVec4 v;
+    };
+    vertex vertices[4] = { };
+    const int offsets[3] = { 4, InvalidIndex, 0 };
+    array.Interleave(2, 4, vertices, sizeof(vertices), sizeof(vertex), offsets);
+    bool allValid = true;
+    for (int i = 0; i < 4; i++) {
+        const float f = float(i + 2);
+        if ((vertices[i].f != f * 0.5f) || (vertices[i].v.x != f) || (vertices[i].v.w != 1.0f)) {
+            allValid = false;
+        }
+    }
+    CHECK(allValid);
+}
+
+//------------------------------------------------------------------------------
+TEST(SoAArrayBenchmark) {
+    // particle update with AoS and SoA data
+    const int numParticles = 1000000;
+    const int numFrames = 10;
+    const float dt = 1.0f / 60.0f;
+
+    struct particle {
+        float px, py, pz, pw;
+        float vx, vy, vz, vw;
+    };
+    particle* aos = (particle*) Memory::Alloc(numParticles * sizeof(particle));
+    SoAArray<float, float, float, float, float, float> soa;
+    soa.Reserve(numParticles);
+    for (int i = 0; i < numParticles; i++) {
+        const float v = float(i & 255) * 0.01f;
+        aos[i] = particle{ 0.0f, 0.0f, 0.0f, 1.0f, v, 2.0f, -v, 0.0f };
+        soa.Add(0.0f, 0.0f, 0.0f, v, 2.0f, -v);
+    }
+
+    auto start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (int i = 0; i < numParticles; i++) {
+            particle& p = aos[i];
+            p.vy -= dt;
+            p.px += p.vx * dt;
+            p.py += p.vy * dt;
+            p.pz += p.vz * dt;
+        }
+    }
+    std::chrono::duration<double> aosDur = std::chrono::system_clock::now() - start;
+
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        float* px = soa.Field<0>();
+        float* py = soa.Field<1>();
+        float* pz = soa.Field<2>();
+        const float* vx = soa.Field<3>();
+        float* vy = soa.Field<4>();
+        const float* vz = soa.Field<5>();
+        const int num = soa.Size();
+        for (int i = 0; i < num; i++) {
+            vy[i] -= dt;
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pz[i] += vz[i] * dt;
+        }
+    }
+    std::chrono::duration<double> soaDur = std::chrono::system_clock::now() - start;
+
+    CHECK(aos[numParticles - 1].px == soa.Field<0>()[numParticles - 1]);
+    CHECK(aos[numParticles - 1].py == soa.Field<1>()[numParticles - 1]);
+    Log::Info("%d particles x %d frames: AoS %f sec, SoA %f sec\n", numParticles, numFrames, aosDur.count(), soaDur.count());
+    Memory::Free(aos);
+}
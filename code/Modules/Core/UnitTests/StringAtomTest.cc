@@ -9,6 +9,7 @@
 #include "Core/Core.h"
 
 #include <cstring>
+#include <cstdio>
 #include <thread>
 #include <array>
 
@@ -81,6 +82,99 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// test the process-wide string atom table
+TEST(StringAtomGlobalTable) {
+    StringAtom localAtom("GLOBAL_BLOB");
+    StringAtom::SetGlobalTable(true);
+    CHECK(StringAtom::IsGlobalTable());
+
+    // atoms created in different threads must be identical
+    const int numThreads = 4;
+    const int numStrings = 2000;
+    static StringAtom atoms[numThreads][numStrings];
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t] {
+            char buf[32];
+            for (int i = 0; i < numStrings; i++) {
+                // each thread goes through the strings in a different order
+                const int index = (t & 1) ? (numStrings - 1 - i) : i;
+                std::snprintf(buf, sizeof(buf), "global_%d", index);
+                atoms[t][index] = StringAtom(buf);
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    bool allIdentical = true;
+    for (int i = 0; i < numStrings; i++) {
+        for (int t = 1; t < numThreads; t++) {
+            if (atoms[0][i].AsCStr() != atoms[t][i].AsCStr()) {
+                allIdentical = false;
+            }
+        }
+    }
+    CHECK(allIdentical);
+    CHECK(atoms[1][123] == "global_123");
+    CHECK(atoms[2][123] != atoms[2][124]);
+    CHECK(atoms[3][1999].Length() == 11);
+
+    // atoms from the thread-local table still compare equal
+    StringAtom globalAtom("GLOBAL_BLOB");
+    CHECK(globalAtom == localAtom);
+    CHECK(globalAtom.AsCStr() != localAtom.AsCStr());
+    // ...and a copy is moved into the global table
+    StringAtom copiedAtom(localAtom);
+    CHECK(copiedAtom.AsCStr() == globalAtom.AsCStr());
+
+    StringAtom::SetGlobalTable(false);
+    CHECK(!StringAtom::IsGlobalTable());
+    // global atoms can be copied without a transfer
+    StringAtom copiedGlobalAtom(globalAtom);
+    CHECK(copiedGlobalAtom.AsCStr() == globalAtom.AsCStr());
+    for (int t = 0; t < numThreads; t++) {
+        for (int i = 0; i < numStrings; i++) {
+            atoms[t][i].Clear();
+        }
+    }
+}
+
+// test concurrent string atom creation, thread-local vs global table
+TEST(StringAtomMultiThreadedPerformance) {
+    const int numThreads = 4;
+    const int numUniqueStrings = 1024;  // must be 2^N
+    const int numStringAtoms = 1000000;
+    static char uniqueStrings[numUniqueStrings][32];
+    for (int i = 0; i < numUniqueStrings; i++) {
+        std::snprintf(uniqueStrings[i], sizeof(uniqueStrings[i]), "perf_atom_%d", i);
+    }
+    for (int global = 0; global < 2; global++) {
+        StringAtom::SetGlobalTable(0 != global);
+        chrono::time_point<chrono::system_clock> start, end;
+        start = chrono::system_clock::now();
+        std::thread threads[numThreads];
+        for (int t = 0; t < numThreads; t++) {
+            threads[t] = std::thread([] {
+                Oryol::Core::EnterThread();
+                StringAtom atom;
+                for (int i = 0; i < numStringAtoms; i++) {
+                    atom = uniqueStrings[i & (numUniqueStrings - 1)];
+                }
+                Oryol::Core::LeaveThread();
+            });
+        }
+        for (int t = 0; t < numThreads; t++) {
+            threads[t].join();
+        }
+        end = chrono::system_clock::now();
+        chrono::duration<double> dur = end - start;
+        Log::Info("%d threads x %d StringAtoms created (%s table): %f sec\n",
+            numThreads, numStringAtoms, global ? "global" : "thread-local", dur.count());
+    }
+    StringAtom::SetGlobalTable(false);
+}
 #endif
 
 // test string atom creation performance
@@ -109,4 +203,41 @@ TEST(StringAtomPerformance) {
         chrono::duration<double> dur = end - start;
         Log::Info("run %d: %dx StringAtoms created: %f sec\n", i, numStringAtoms, dur.count());
     }
+}
+
+// test string atom literals with compile-time hash
+TEST(StringAtomLiteral) {
+    static_assert("Position"_atom.hash != 0, "hash must be computed at compile time");
+    constexpr StringAtomLiteral lit = "Position"_atom;
+    CHECK(lit.hash == stringAtomTable::HashForString("Position"));
+    CHECK("\xC3\xA4\xFF"_atom.hash == stringAtomTable::HashForString("\xC3\xA4\xFF"));
+    CHECK(""_atom.hash == stringAtomTable::HashForString(""));
+
+    StringAtom atom0 = "Position"_atom;
+    StringAtom atom1("Position");
+    CHECK(atom0 == atom1);
+    CHECK(atom0.AsCStr() == atom1.AsCStr());
+    CHECK(atom0.Length() == 8);
+    atom1 = "Normal"_atom;
+    CHECK(atom1 == "Normal");
+    CHECK(atom0 != atom1);
+    StringAtom atom2 = ""_atom;
+    CHECK(!atom2.IsValid());
+
+    // compare creation from literals with and without compile-time hash
+    // (only meaningful in optimized builds)
+    const int numStringAtoms = 1000000;
+    chrono::time_point<chrono::system_clock> start = chrono::system_clock::now();
+    for (int i = 0; i < numStringAtoms; i++) {
+        atom0 = "uniform_model_view_projection";
+    }
+    chrono::duration<double> strDur = chrono::system_clock::now() - start;
+    start = chrono::system_clock::now();
+    for (int i = 0; i < numStringAtoms; i++) {
+        atom1 = "uniform_model_view_projection"_atom;
+    }
+    chrono::duration<double> litDur = chrono::system_clock::now() - start;
+    CHECK(atom0 == atom1);
+    Log::Info("%dx StringAtoms created: from string %f sec, from _atom literal %f sec\n",
+        numStringAtoms, strDur.count(), litDur.count());
 }
\ No newline at end of file
@@ -129,6 +129,10 @@ TEST(StringBuilderTest) {
     builder.Set(" One Two Three Four ");
     CHECK(builder.SubstituteAll(" ", "XXX") == 5);
     CHECK(builder.GetString() == "XXXOneXXXTwoXXXThreeXXXFourXXX");
+    // substitutes are not searched again
+    builder.Set("aXa");
+    CHECK(builder.SubstituteAll("a", "aa") == 2);
+    CHECK(builder.GetString() == "aaXaa");
 
     // test tokenize
     Array<String> tokens;
@@ -0,0 +1,332 @@
+//------------------------------------------------------------------------------
+//  StringSimdTest.cc
+//  Test the string search functions with all supported SIMD levels.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/StringView.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/String/StringConverter.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static int
+refFindSubString(const char* str, int len, const char* subStr) {
+    const int subLen = int(std::strlen(subStr));
+    for (int i = 0; i <= (len - subLen); i++) {
+        if (0 == std::memcmp(str + i, subStr, subLen)) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+static int
+refFindFirstOf(const char* str, int len, const char* delims, bool isNot) {
+    for (int i = 0; i < len; i++) {
+        const bool isDelim = nullptr != std::strchr(delims, str[i]);
+        if (isDelim != isNot) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSimdSearchTest) {
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+
+    // a small alphabet creates lots of partial matches
+    const int maxLen = 300;
+    char* buf = (char*) Memory::Alloc(maxLen + 1);
+    uint32_t rnd = 12345;
+    for (int i = 0; i < maxLen; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        buf[i] = "aabbc"[(rnd >> 16) % 5];
+    }
+    buf[maxLen] = 0;
+    const char* subStrs[] = { "a", "c", "abc", "cab", "bbcaa", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "x" };
+    const char* delims[] = { "c", "bc", "x", "xyz/\\:.c", "abcdefghijkl", "" };
+    const int lengths[] = { 0, 1, 2, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 200, 300 };
+
+    for (int l = 0; l < int(Memory::SimdLevel::NumSimdLevels); l++) {
+        const Memory::SimdLevel level = Memory::SimdLevel(l);
+        if (!Memory::IsSimdLevelSupported(level)) {
+            continue;
+        }
+        Memory::SetSimdLevel(level);
+        bool subStrValid = true;
+        bool delimValid = true;
+        for (int len : lengths) {
+            for (int offset = 0; offset < 3; offset++) {
+                if ((offset + len) > maxLen) {
+                    continue;
+                }
+                const char* str = buf + offset;
+                const StringView view(str, len);
+                for (const char* subStr : subStrs) {
+                    if (view.FindSubString(0, EndOfString, subStr) != refFindSubString(str, len, subStr)) {
+                        subStrValid = false;
+                    }
+                    // a bounded search in a 0-terminated buffer, a match may
+                    // start before the end index and reach beyond it
+                    const int subLen = int(std::strlen(subStr));
+                    const int boundedLen = ((len + subLen - 1) < (maxLen - offset)) ? (len + subLen - 1) : (maxLen - offset);
+                    const int refIndex = (len > 0) ? refFindSubString(str, boundedLen, subStr) : InvalidIndex;
+                    const int index = StringBuilder::FindSubString(buf, offset, offset + len, subStr);
+                    if (index != ((InvalidIndex == refIndex) ? InvalidIndex : (offset + refIndex))) {
+                        subStrValid = false;
+                    }
+                }
+                for (const char* delim : delims) {
+                    if (view.FindFirstOf(0, EndOfString, delim) != refFindFirstOf(str, len, delim, false)) {
+                        delimValid = false;
+                    }
+                    if (view.FindFirstNotOf(0, EndOfString, delim) != refFindFirstOf(str, len, delim, true)) {
+                        delimValid = false;
+                    }
+                    const int refIndex = refFindFirstOf(str, len, delim, false);
+                    const int index = StringBuilder::FindFirstOf(buf, offset, offset + len, delim);
+                    if (index != ((InvalidIndex == refIndex) ? InvalidIndex : (offset + refIndex))) {
+                        delimValid = false;
+                    }
+                }
+            }
+        }
+        CHECK(subStrValid);
+        CHECK(delimValid);
+
+        // StringBuilder and tokenizing go through the same functions
+        StringBuilder builder("/path/to/some/asset/file.txt,another/path/to/file.png");
+        CHECK(builder.FindSubString(0, EndOfString, "file.png") == 45);
+        CHECK(builder.FindSubString(0, 43, "to/file") == 42);
+        CHECK(builder.FindSubString(0, 42, "to/file") == InvalidIndex);
+        CHECK(builder.FindFirstOf(0, EndOfString, ",.") == 24);
+        CHECK(builder.FindFirstOf(25, EndOfString, ",.") == 28);
+        CHECK(builder.FindFirstOf(30, EndOfString, ",.") == 49);
+        CHECK(builder.FindFirstNotOf(0, EndOfString, "/path") == 7);
+        CHECK(builder.SubstituteAll("path", "p") == 2);
+        CHECK(builder.GetString() == "/p/to/some/asset/file.txt,another/p/to/file.png");
+        Array<String> tokens;
+        CHECK(builder.Tokenize("/,", tokens) == 9);
+        CHECK(tokens[0] == "p");
+        CHECK(tokens[4] == "file.txt");
+        CHECK(tokens[8] == "file.png");
+    }
+    Memory::SetSimdLevel(best);
+    Memory::Free(buf);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSimdUTF8Test) {
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+    const char* valid[] = {
+        "",
+        "Hello World",
+        "H\xc3\xa4llo W\xc3\xb6rld",    // 2-byte sequences
+        "\xe2\x82\xac",                 // euro sign
+        "\xef\xbf\xbf",                 // U+FFFF
+        "\xf0\x9d\x84\x9e",             // U+1D11E, musical G clef
+        "\xf4\x8f\xbf\xbf",             // U+10FFFF
+    };
+    const char* invalid[] = {
+        "\x80",                         // lone continuation byte
+        "\xc0\x80",                     // overlong NUL
+        "\xc1\xbf",                     // overlong
+        "\xe0\x9f\xbf",                 // overlong 3-byte
+        "\xed\xa0\x80",                 // surrogate
+        "\xf0\x8f\xbf\xbf",             // overlong 4-byte
+        "\xf4\x90\x80\x80",             // above U+10FFFF
+        "\xf5\x80\x80\x80",             // invalid lead byte
+        "\xe2\x82",                     // truncated
+        "\xe2\x28\xa1",                 // bad continuation byte
+    };
+
+    for (int l = 0; l < int(Memory::SimdLevel::NumSimdLevels); l++) {
+        const Memory::SimdLevel level = Memory::SimdLevel(l);
+        if (!Memory::IsSimdLevelSupported(level)) {
+            continue;
+        }
+        Memory::SetSimdLevel(level);
+
+        // put the test sequences behind ASCII runs of different length,
+        // so that they end up at all positions inside a SIMD block
+        bool allValid = true;
+        char buf[128];
+        for (int prefix = 0; prefix < 70; prefix++) {
+            std::memset(buf, 'x', prefix);
+            for (const char* seq : valid) {
+                const int seqLen = int(std::strlen(seq));
+                std::memcpy(buf + prefix, seq, seqLen);
+                std::memset(buf + prefix + seqLen, 'y', 40);
+                if (!StringConverter::IsValidUTF8((const unsigned char*)buf, prefix + seqLen + 40)) {
+                    allValid = false;
+                }
+                // truncating a single multi-byte sequence makes it invalid
+                if ((uint8_t(seq[0]) >= 0x80) && StringConverter::IsValidUTF8((const unsigned char*)buf, prefix + seqLen - 1)) {
+                    allValid = false;
+                }
+            }
+            for (const char* seq : invalid) {
+                const int seqLen = int(std::strlen(seq));
+                std::memcpy(buf + prefix, seq, seqLen);
+                std::memset(buf + prefix + seqLen, 'y', 40);
+                if (StringConverter::IsValidUTF8((const unsigned char*)buf, prefix + seqLen + 40)) {
+                    allValid = false;
+                }
+            }
+        }
+        CHECK(allValid);
+        CHECK(StringConverter::IsValidUTF8(StringConverter::WideToUTF8(L"Hällo Wörld €")));
+    }
+    Memory::SetSimdLevel(best);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringSimdBenchmark) {
+    const Memory::SimdLevel best = Memory::GetSimdLevel();
+    const int maxLen = 1024 * 1024;
+    const int bytesPerRun = 8 * 1024 * 1024;
+
+    // an asset-path like haystack, with the needles at the very end,
+    // and the same with a 2-byte UTF-8 character every 64 bytes
+    char* str = (char*) Memory::Alloc(maxLen + 1);
+    char* utf8 = (char*) Memory::Alloc(maxLen + 1);
+    const char* pattern = "root:textures/terrain/grass_diffuse_01.dds;";
+    const int patternLen = int(std::strlen(pattern));
+    for (int i = 0; i < maxLen; i++) {
+        str[i] = pattern[i % patternLen];
+        utf8[i] = ((i & 63) == 62) ? '\xc3' : (((i & 63) == 63) ? '\xa4' : str[i]);
+    }
+    str[maxLen] = 0;
+    utf8[maxLen] = 0;
+    // one needle with a rare, and one with a frequent first character
+    const char* tail = "grass_#needle";
+    const char* needle = "#needle";
+    const char* needle2 = "grass_#";
+    const int tailLen = int(std::strlen(tail));
+    const char* delims = "#?";
+
+    const int sizes[] = { 16, 256, 4096, 65536, maxLen };
+    for (int size : sizes) {
+        const int numRuns = bytesPerRun / size;
+        const char* volatile haystack = str;
+        int res = 0;
+        std::chrono::time_point<std::chrono::system_clock> start;
+
+        // a bounded StringBuilder search for the needle inside the full
+        // string which has no match before the end index, the old code
+        // ran strstr()/strcspn() to the 0-terminator and checked the index
+        // afterwards, this caps the number of old runs to keep it short
+        if (size < maxLen) {
+            std::memcpy(str + maxLen - tailLen, tail, tailLen);
+            const StringBuilder builder(str);
+            const int endIndex = size;
+            const int oldRuns = (numRuns < 64) ? numRuns : 64;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < oldRuns; i++) {
+                const int index = int(std::strstr(haystack, needle) - str);
+                res += (index >= endIndex) ? InvalidIndex : index;
+            }
+            std::chrono::duration<double> oldSubStrDur = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < oldRuns; i++) {
+                const int index = int(std::strcspn(haystack, delims));
+                res += (index >= endIndex) ? InvalidIndex : index;
+            }
+            std::chrono::duration<double> oldDelimDur = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += builder.FindSubString(0, endIndex, needle);
+            }
+            std::chrono::duration<double> subStrDur = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += builder.FindFirstOf(0, endIndex, delims);
+            }
+            std::chrono::duration<double> delimDur = std::chrono::system_clock::now() - start;
+            Log::Info("%7d bytes: bounded FindSubString old %.3f / new %.3f GB/s, FindFirstOf old %.3f / new %.3f GB/s\n", size,
+                double(oldRuns) * size / oldSubStrDur.count() / 1.0e9,
+                double(numRuns) * size / subStrDur.count() / 1.0e9,
+                double(oldRuns) * size / oldDelimDur.count() / 1.0e9,
+                double(numRuns) * size / delimDur.count() / 1.0e9);
+            for (int i = maxLen - tailLen; i < maxLen; i++) {
+                str[i] = pattern[i % patternLen];
+            }
+        }
+
+        char saved[16];
+        std::memcpy(saved, str + size - tailLen, tailLen + 1);
+        std::memcpy(str + size - tailLen, tail, tailLen);
+        str[size] = 0;
+        const StringView view(str, size);
+
+        // libc strstr() and strcspn(), which unbounded StringBuilder
+        // searches use, the volatile haystack keeps the compiler from
+        // hoisting the pure libc calls out of the loop
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < numRuns; i++) {
+            res += int(std::strstr(haystack, needle) - str);
+        }
+        std::chrono::duration<double> strstrDur = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < numRuns; i++) {
+            res += int(std::strstr(haystack, needle2) - str);
+        }
+        std::chrono::duration<double> strstrDur2 = std::chrono::system_clock::now() - start;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < numRuns; i++) {
+            res += int(std::strcspn(haystack, delims));
+        }
+        std::chrono::duration<double> strcspnDur = std::chrono::system_clock::now() - start;
+        Log::Info("%7d bytes: libc   strstr %.3f / %.3f GB/s, strcspn %.3f GB/s\n", size,
+            bytesPerRun / strstrDur.count() / 1.0e9,
+            bytesPerRun / strstrDur2.count() / 1.0e9,
+            bytesPerRun / strcspnDur.count() / 1.0e9);
+
+        for (int l = 0; l < int(Memory::SimdLevel::NumSimdLevels); l++) {
+            const Memory::SimdLevel level = Memory::SimdLevel(l);
+            if (!Memory::IsSimdLevelSupported(level)) {
+                continue;
+            }
+            Memory::SetSimdLevel(level);
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += view.FindSubString(0, EndOfString, needle);
+            }
+            std::chrono::duration<double> subStrDur = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += view.FindSubString(0, EndOfString, needle2);
+            }
+            std::chrono::duration<double> subStrDur2 = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += view.FindFirstOf(0, EndOfString, delims);
+            }
+            std::chrono::duration<double> delimDur = std::chrono::system_clock::now() - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numRuns; i++) {
+                res += StringConverter::IsValidUTF8((const unsigned char*)utf8, size) ? 1 : 0;
+            }
+            std::chrono::duration<double> utf8Dur = std::chrono::system_clock::now() - start;
+            Log::Info("%7d bytes: %-6s FindSubString %.3f / %.3f GB/s, FindFirstOf %.3f GB/s, IsValidUTF8 %.3f GB/s\n",
+                size, Memory::SimdLevelToString(level),
+                bytesPerRun / subStrDur.count() / 1.0e9,
+                bytesPerRun / subStrDur2.count() / 1.0e9,
+                bytesPerRun / delimDur.count() / 1.0e9,
+                bytesPerRun / utf8Dur.count() / 1.0e9);
+        }
+        CHECK(res != 0);
+        std::memcpy(str + size - tailLen, saved, tailLen + 1);
+    }
+    Memory::SetSimdLevel(best);
+    Memory::Free(str);
+    Memory::Free(utf8);
+}
@@ -6,6 +6,7 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Memory/Memory.h"
 
 #include <cstring>
 
@@ -64,13 +65,13 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment (short strings are stored inline and not shared)
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
-    CHECK(str0.RefCount() == 2);
-    CHECK(str2.RefCount() == 2);
-    CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
+    CHECK(str0.AsCStr() != str2.AsCStr());
     str2.Clear();
     CHECK(str0 == "Bla");
     CHECK(str2.Empty());
@@ -151,3 +152,79 @@ TEST(StringTest) {
     CHECK(nullString.AsCStr() != nullptr);
     CHECK(nullString.AsCStr()[0] == 0);    
 }
+
+//------------------------------------------------------------------------------
+static int64_t numStringAllocs() {
+    return Memory::QueryStats(Memory::Tag::String).TotalAllocs;
+}
+
+TEST(StringSSOTest) {
+    CHECK(sizeof(String) == (String::InlineCapacity + 1));
+
+    // short strings never allocate
+    const char* shortStr = "01234567890123456789012";
+    const char* longStr = "012345678901234567890123";
+    CHECK(int(std::strlen(shortStr)) == String::InlineCapacity);
+    int64_t allocs = numStringAllocs();
+    String str0(shortStr);
+    CHECK(str0.IsInline());
+    CHECK(str0.Length() == String::InlineCapacity);
+    CHECK(str0 == shortStr);
+    CHECK(str0.Back() == '2');
+    String str1(str0);
+    String str2;
+    str2 = str1;
+    String str3(std::move(str2));
+    CHECK(str2.Empty());
+    CHECK(str2.IsInline());
+    CHECK(str3 == str0);
+    CHECK(str3.AsCStr() != str0.AsCStr());
+    String str4("Bla");
+    str4 = "Blub";
+    String str5(str0, 1, 5);
+    CHECK(str5 == "1234");
+    CHECK(numStringAllocs() == allocs);
+
+    // long strings allocate once, and are shared when copied
+    String str6(longStr);
+    CHECK(!str6.IsInline());
+    CHECK(str6.Length() == String::InlineCapacity + 1);
+    CHECK(str6 == longStr);
+    CHECK(str6.Back() == '3');
+    CHECK(numStringAllocs() == (allocs + 1));
+    String str7(str6);
+    String str8;
+    str8 = str7;
+    CHECK(str6.RefCount() == 3);
+    CHECK(str8.AsCStr() == str6.AsCStr());
+    String str9(std::move(str8));
+    CHECK(str8.Empty());
+    CHECK(str9.RefCount() == 3);
+    CHECK(numStringAllocs() == (allocs + 1));
+    str7.Clear();
+    str9.Clear();
+    CHECK(str6.RefCount() == 1);
+
+    // a long string becomes inline when assigned a substring
+    str6.Assign(str6, 0, 3);
+    CHECK(str6 == "012");
+    CHECK(str6.IsInline());
+    CHECK(str6.RefCount() == 1);
+
+    // inline and heap strings compare by content
+    String str10(longStr, 0, String::InlineCapacity);
+    String str11(String(longStr), 0, String::InlineCapacity);
+    CHECK(str10 == str0);
+    CHECK(str11 == str10);
+    CHECK(String(longStr) > str0);
+    CHECK(str0 < String(longStr));
+
+    // StringAtom conversion
+    StringAtom atom(longStr);
+    String str12(atom);
+    CHECK(str12 == atom);
+    CHECK(str12.AsStringAtom() == atom);
+    str12 = StringAtom("Bla");
+    CHECK(str12 == "Bla");
+    CHECK(str12.IsInline());
+}
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//  StringViewTest.cc
+//  Test StringView class and view-based tokenizing.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/StringView.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Memory/Memory.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(StringViewTest) {
+    StringView empty;
+    CHECK(empty.Empty());
+    CHECK(!empty.IsValid());
+    CHECK(empty.Length() == 0);
+    CHECK(empty.Front() == 0);
+    CHECK(empty.Back() == 0);
+    CHECK(empty == StringView(""));
+    CHECK(empty == StringView((const char*)nullptr));
+    CHECK(empty.MakeString().Empty());
+
+    const char* cstr = "Hello World, this is a long string";
+    StringView view(cstr);
+    CHECK(view.IsValid());
+    CHECK(view.Length() == 34);
+    CHECK(view.Ptr() == cstr);
+    CHECK(view[4] == 'o');
+    CHECK(view.Front() == 'H');
+    CHECK(view.Back() == 'g');
+    CHECK(view.StartsWith("Hello"));
+    CHECK(!view.StartsWith("World"));
+    CHECK(view.EndsWith("string"));
+    CHECK(view.Contains("this"));
+    CHECK(!view.Contains("that"));
+
+    // sub-views are not 0-terminated
+    StringView world = view.SubView(6, 11);
+    CHECK(world.Length() == 5);
+    CHECK(world == "World");
+    CHECK(world != "World,");
+    CHECK(world != "Worl");
+    CHECK(world.Ptr() == cstr + 6);
+    CHECK(world.MakeString() == "World");
+    CHECK(view.SubView(13, EndOfString) == "this is a long string");
+
+    // ordering matches strcmp
+    CHECK(StringView("abc") < StringView("abd"));
+    CHECK(StringView("ab") < StringView("abc"));
+    CHECK(!(StringView("abc") < StringView("ab")));
+    CHECK(StringView("abc").Compare("abc") == 0);
+    CHECK(StringView("a") < StringView("\xFF"));
+
+    // find functions respect the view range
+    CHECK(view.FindFirstOf(0, EndOfString, ",") == 11);
+    CHECK(world.FindFirstOf(0, EndOfString, ",") == InvalidIndex);
+    CHECK(view.FindFirstOf(0, 5, "o") == 4);
+    CHECK(view.FindFirstOf(0, 4, "o") == InvalidIndex);
+    CHECK(view.FindFirstNotOf(0, EndOfString, "Hel") == 4);
+    CHECK(view.FindLastOf(0, EndOfString, "o") == 24);
+    CHECK(view.FindLastOf(0, 7, "o") == 4);
+    CHECK(view.FindSubString(0, EndOfString, "is") == 15);
+    CHECK(view.FindSubString(16, EndOfString, "is") == 18);
+    CHECK(view.FindSubString(0, 16, "is") == InvalidIndex);
+    CHECK(world.FindSubString(0, EndOfString, "World,") == InvalidIndex);
+
+    // views on Strings and StringAtoms
+    String str(cstr);
+    StringAtom atom(cstr);
+    CHECK(StringView(str) == view);
+    CHECK(StringView(str).Ptr() == str.AsCStr());
+    CHECK(StringView(atom) == view);
+    CHECK(StringView(atom).Ptr() == atom.AsCStr());
+}
+
+//------------------------------------------------------------------------------
+TEST(StringViewTokenizeTest) {
+    StringBuilder builder("  one two,,three four,  ");
+    Array<StringView> tokens;
+    tokens.Reserve(8);
+    const int64_t allocs = Memory::QueryStats(Memory::Tag::String).TotalAllocs;
+    const int num = StringBuilder::Tokenize(builder.AsView(), " ,", tokens);
+    CHECK(Memory::QueryStats(Memory::Tag::String).TotalAllocs == allocs);
+    CHECK(num == 4);
+    CHECK(tokens[0] == "one");
+    CHECK(tokens[1] == "two");
+    CHECK(tokens[2] == "three");
+    CHECK(tokens[3] == "four");
+    // the builder content is not destroyed
+    CHECK(builder.GetString() == "  one two,,three four,  ");
+
+    CHECK(StringBuilder::Tokenize("", " ", tokens) == 0);
+    CHECK(StringBuilder::Tokenize("   ", " ", tokens) == 0);
+    CHECK(StringBuilder::Tokenize("single", " ", tokens) == 1);
+    CHECK(tokens[0] == "single");
+
+    // tokenize a sub-view
+    StringView sub = StringView("a b c d").SubView(0, 3);
+    CHECK(StringBuilder::Tokenize(sub, " ", tokens) == 2);
+    CHECK(tokens[1] == "b");
+}
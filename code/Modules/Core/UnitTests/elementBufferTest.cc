@@ -564,3 +564,31 @@ TEST(elementBufferTest) {
     CHECK(buf5.popBack() == 3);
     CHECK(buf5.size() == 0);
 }
+
+//------------------------------------------------------------------------------
+TEST(elementBufferBorrowedMoveTest) {
+    // moving from borrowed storage moves the elements into owned memory
+    int storage[4];
+    elementBuffer<int> buf;
+    buf.borrow(storage, 4, 0);
+    buf.pushBack(1);
+    buf.pushBack(2);
+    buf.pushBack(3);
+    elementBuffer<int> buf1(std::move(buf));
+    CHECK(!buf1.borrowed());
+    CHECK(buf1.size() == 3);
+    CHECK(&buf1[0] != &storage[0]);
+    CHECK((buf1[0] == 1) && (buf1[1] == 2) && (buf1[2] == 3));
+    CHECK(buf.borrowed());
+    CHECK(buf.size() == 0);
+    CHECK(buf.capacity() == 4);
+
+    buf.pushBack(4);
+    elementBuffer<int> buf2;
+    buf2 = std::move(buf);
+    CHECK(!buf2.borrowed());
+    CHECK(buf2.size() == 1);
+    CHECK(buf2[0] == 4);
+    CHECK(buf.borrowed());
+    CHECK(buf.size() == 0);
+}
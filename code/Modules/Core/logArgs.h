@@ -0,0 +1,200 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::logArgs
+    @ingroup _priv
+    @brief compile-time packing of log message arguments
+
+    Used by Log::Record() to store the arguments of an o_dbg(), o_info()
+    or o_warn() call as raw bytes, so that formatting can be deferred.
+    The packed form is one type byte per argument, followed by the
+    argument values:
+
+    - I32, U32: 4 bytes (also chars, shorts, bools and small enums)
+    - I64, U64: 8 bytes
+    - F64: 8 bytes (floats are promoted to double like in a printf call)
+    - Ptr: 8 bytes (any non-string pointer)
+    - Str: 16-bit length, the characters and a terminating 0, a
+      length of NullStr marks a nullptr string
+
+    Argument types which can't be packed (e.g. long double or structs)
+    make supported<...>::value false, Log::Record() then formats the
+    message right away.
+*/
+#include "Core/Types.h"
+#include <cstring>
+#include <type_traits>
+
+namespace Oryol {
+namespace _priv {
+
+class logArgs {
+public:
+    /// argument type codes
+    enum Type : uint8_t {
+        Invalid = 0,
+        I32,
+        U32,
+        I64,
+        U64,
+        F64,
+        Str,
+        Ptr,
+    };
+    /// max length of a packed string argument
+    static const int MaxStrLen = 0xFFFE;
+    /// length marker for a nullptr string
+    static const uint16_t NullStr = 0xFFFF;
+
+    /// the type code of a (decayed) argument type
+    template<class T, class ENABLE=void> struct typeOf {
+        static const uint8_t value = Invalid;
+    };
+    /// true if all argument types can be packed
+    template<class... ARGS> struct supported;
+
+    /// get the packed size of a list of arguments
+    static int size() { return 0; }
+    /// get the packed size of a list of arguments
+    template<class T, class... ARGS> static int size(const T& arg, const ARGS&... args);
+    /// write the type codes of a list of arguments, return pointer past the written data
+    template<class... ARGS> static uint8_t* writeTypes(uint8_t* ptr);
+    /// write a list of arguments, return pointer past the written data
+    static uint8_t* write(uint8_t* ptr) { return ptr; }
+    /// write a list of arguments, return pointer past the written data
+    template<class T, class... ARGS> static uint8_t* write(uint8_t* ptr, const T& arg, const ARGS&... args);
+
+private:
+    /// size and write functions per type code
+    template<uint8_t TYPE> struct codec;
+    /// shortcut for the type code of an argument
+    template<class T> struct code : typeOf<typename std::decay<T>::type> { };
+};
+
+//------------------------------------------------------------------------------
+template<class T> struct logArgs::typeOf<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    static const uint8_t value = (sizeof(T) <= 4) ?
+        (std::is_signed<T>::value ? I32 : U32) :
+        (std::is_signed<T>::value ? I64 : U64);
+};
+template<class T> struct logArgs::typeOf<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    static const uint8_t value = (sizeof(T) <= 4) ? I32 : I64;
+};
+template<> struct logArgs::typeOf<float> {
+    static const uint8_t value = F64;
+};
+template<> struct logArgs::typeOf<double> {
+    static const uint8_t value = F64;
+};
+template<class T> struct logArgs::typeOf<T*> {
+    static const uint8_t value = Ptr;
+};
+template<> struct logArgs::typeOf<char*> {
+    static const uint8_t value = Str;
+};
+template<> struct logArgs::typeOf<const char*> {
+    static const uint8_t value = Str;
+};
+
+//------------------------------------------------------------------------------
+template<> struct logArgs::supported<> {
+    static const bool value = true;
+};
+template<class T, class... ARGS> struct logArgs::supported<T, ARGS...> {
+    static const bool value = (code<T>::value != Invalid) && supported<ARGS...>::value;
+};
+
+//------------------------------------------------------------------------------
+template<> struct logArgs::codec<logArgs::I32> {
+    template<class T> static int size(const T&) { return 4; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const int32_t v = static_cast<int32_t>(val);
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::U32> {
+    template<class T> static int size(const T&) { return 4; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const uint32_t v = static_cast<uint32_t>(val);
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::I64> {
+    template<class T> static int size(const T&) { return 8; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const int64_t v = static_cast<int64_t>(val);
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::U64> {
+    template<class T> static int size(const T&) { return 8; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const uint64_t v = static_cast<uint64_t>(val);
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::F64> {
+    template<class T> static int size(const T&) { return 8; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const double v = static_cast<double>(val);
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::Ptr> {
+    template<class T> static int size(const T&) { return 8; }
+    template<class T> static uint8_t* write(uint8_t* ptr, const T& val) {
+        const uint64_t v = uint64_t(uintptr_t(val));
+        std::memcpy(ptr, &v, sizeof(v));
+        return ptr + sizeof(v);
+    }
+};
+template<> struct logArgs::codec<logArgs::Str> {
+    static int length(const char* str) {
+        if (nullptr == str) {
+            return 0;
+        }
+        const int len = int(std::strlen(str));
+        return len < MaxStrLen ? len : MaxStrLen;
+    }
+    static int size(const char* str) {
+        return 2 + length(str) + 1;
+    }
+    static uint8_t* write(uint8_t* ptr, const char* str) {
+        const int len = length(str);
+        const uint16_t len16 = str ? uint16_t(len) : uint16_t(NullStr);
+        std::memcpy(ptr, &len16, sizeof(len16));
+        std::memcpy(ptr + 2, str ? str : "", len);
+        ptr[2 + len] = 0;
+        return ptr + 2 + len + 1;
+    }
+};
+
+//------------------------------------------------------------------------------
+template<class T, class... ARGS> inline int
+logArgs::size(const T& arg, const ARGS&... args) {
+    return codec<code<T>::value>::size(arg) + size(args...);
+}
+
+//------------------------------------------------------------------------------
+template<class... ARGS> inline uint8_t*
+logArgs::writeTypes(uint8_t* ptr) {
+    // the extra 0 avoids a zero-sized array for messages without arguments
+    const uint8_t types[] = { code<ARGS>::value..., 0 };
+    std::memcpy(ptr, types, sizeof...(ARGS));
+    return ptr + sizeof...(ARGS);
+}
+
+//------------------------------------------------------------------------------
+template<class T, class... ARGS> inline uint8_t*
+logArgs::write(uint8_t* ptr, const T& arg, const ARGS&... args) {
+    ptr = codec<code<T>::value>::write(ptr, arg);
+    return write(ptr, args...);
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,560 @@
+//------------------------------------------------------------------------------
+//  logQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "logQueue.h"
+#include "Core/Assertion.h"
+#include "Core/LogDecoder.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/threadExit.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+/// a message record in a ring, followed by the 0-terminated message,
+/// or a deferredHeader, the argument types and the packed arguments
+struct recordHeader {
+    uint64_t seq;
+    uint32_t size;      // size of the whole record, including header and padding
+    uint16_t level;     // Log::Level
+    uint16_t kind;      // TextRecord, DeferredRecord or PadRecord (wrap-around)
+};
+static_assert(sizeof(recordHeader) == 16, "unexpected recordHeader size");
+
+/// payload header of a deferred record
+struct deferredHeader {
+    uint64_t fmt;       // the format string pointer
+    uint16_t argsSize;  // size of the packed arguments
+    uint8_t numArgs;
+};
+static_assert(sizeof(deferredHeader) == 16, "unexpected deferredHeader size");
+
+/// a per-thread ring buffer
+struct logQueue::ring {
+    // written by the producer thread
+    alignas(64) std::atomic<uint32_t> writePos{0};
+    std::atomic<int64_t> numQueued{0};
+    uint32_t pendingWritePos = 0;
+    // written by the draining thread
+    alignas(64) std::atomic<uint32_t> readPos{0};
+    uint32_t drainEnd = 0;
+    // list of all rings, and owner flag for reuse
+    alignas(64) ring* next = nullptr;
+    std::atomic<bool> owned{true};
+    uint8_t data[RingSize];
+};
+
+namespace {
+
+enum : uint16_t {
+    TextRecord,
+    DeferredRecord,
+    PadRecord,
+};
+const uint32_t RingMask = logQueue::RingSize - 1;
+static_assert((logQueue::RingSize & (logQueue::RingSize - 1)) == 0, "RingSize must be 2^N");
+static_assert(logQueue::RingSize >= (4 * logQueue::MaxMessageSize), "RingSize too small");
+
+std::atomic<logQueue::ring*> rings{nullptr};
+std::atomic<uint64_t> sequence{0};
+std::atomic<int64_t> numDropped{0};
+std::atomic<int64_t> numBlocked{0};
+Log::OverflowPolicy overflowPolicy = Log::OverflowPolicy::Drop;
+logQueue::printFunc printFn = nullptr;
+
+// binary sink state, only accessed by the draining thread
+struct fmtHasher {
+    uint32_t operator()(const char* fmt) const {
+        const uint64_t p = uint64_t(uintptr_t(fmt));
+        return uint32_t(p >> 3) ^ uint32_t(p >> 32);
+    }
+};
+const int SinkBufferSize = 16 * 1024;
+Log::BinarySinkFunc sinkFunc;
+HashMap<const char*, uint32_t, fmtHasher> sinkFormats;
+uint8_t sinkBuffer[SinkBufferSize];
+int sinkBufferPos = 0;
+
+#if ORYOL_HAS_THREADS
+std::mutex drainLock;
+std::atomic<std::thread::id> drainingThread{std::thread::id()};
+std::thread* drainThread = nullptr;
+std::mutex wakeupLock;
+std::condition_variable wakeupCond;
+std::atomic<bool> wakeupPending{false};
+std::atomic<bool> stopRequested{false};
+// the drain thread also wakes up periodically, in case a wakeup was missed
+const int DrainIntervalMs = 10;
+#else
+bool draining = false;
+#endif
+
+// the calling thread's ring
+ORYOL_THREADLOCAL_PTR(logQueue::ring) threadRing = nullptr;
+
+//------------------------------------------------------------------------------
+inline int
+recordSize(int msgLen) {
+    return (int(sizeof(recordHeader)) + msgLen + 1 + 15) & ~15;
+}
+
+//------------------------------------------------------------------------------
+inline uint8_t*
+put16(uint8_t* ptr, uint16_t val) {
+    std::memcpy(ptr, &val, sizeof(val));
+    return ptr + sizeof(val);
+}
+
+//------------------------------------------------------------------------------
+inline uint8_t*
+put32(uint8_t* ptr, uint32_t val) {
+    std::memcpy(ptr, &val, sizeof(val));
+    return ptr + sizeof(val);
+}
+
+} // anonymous namespace
+
+std::atomic<bool> logQueue::valid{false};
+std::atomic<bool> logQueue::deferred{false};
+
+//------------------------------------------------------------------------------
+void
+logQueue::setup(Log::OverflowPolicy policy, bool useDrainThread, printFunc func) {
+    o_assert(!isValid());
+    o_assert(func);
+    overflowPolicy = policy;
+    printFn = func;
+    valid.store(true, std::memory_order_release);
+    #if ORYOL_HAS_THREADS
+    if (useDrainThread) {
+        stopRequested.store(false, std::memory_order_relaxed);
+        drainThread = new std::thread(threadFunc);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    NOTE: other threads should have stopped logging, messages which
+    are pushed while async mode is being switched off are only printed
+    when it is switched on again.
+*/
+void
+logQueue::discard() {
+    o_assert(isValid());
+    deferred.store(false, std::memory_order_relaxed);
+    valid.store(false, std::memory_order_release);
+    #if ORYOL_HAS_THREADS
+    if (drainThread) {
+        stopRequested.store(true, std::memory_order_release);
+        wakeupPending.store(true, std::memory_order_release);
+        wakeupCond.notify_one();
+        drainThread->join();
+        delete drainThread;
+        drainThread = nullptr;
+    }
+    #endif
+    drain();
+}
+
+//------------------------------------------------------------------------------
+logQueue::ring*
+logQueue::claimRing() {
+    // first try to reuse a released ring
+    for (ring* r = rings.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (!r->owned.load(std::memory_order_relaxed) &&
+            r->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return r;
+        }
+    }
+
+    // create a new ring (with 64 bytes alignment) and add it to the list,
+    // rings are never freed since the draining thread may still access them
+    void* raw = std::malloc(sizeof(ring) + 64);
+    o_assert(raw);
+    ring* r = new((void*)((uintptr_t(raw) + 63) & ~uintptr_t(63))) ring;
+    r->next = rings.load(std::memory_order_relaxed);
+    while (!rings.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        // retry
+    }
+    return r;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::releaseThread() {
+    if (threadRing) {
+        threadRing->owned.store(false, std::memory_order_release);
+        threadRing = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+logQueue::isDrainingThread() {
+    #if ORYOL_HAS_THREADS
+    return drainingThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    #else
+    return draining;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::wakeup() {
+    #if ORYOL_HAS_THREADS
+    // only one notify per drain cycle
+    if (!wakeupPending.load(std::memory_order_relaxed) && !wakeupPending.exchange(true)) {
+        wakeupCond.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+logQueue::reserve(ring* r, int size, uint32_t& outNewWritePos) {
+    bool blocked = false;
+    for (;;) {
+        const uint32_t writePos = r->writePos.load(std::memory_order_relaxed);
+        const uint32_t readPos = r->readPos.load(std::memory_order_acquire);
+        const uint32_t offset = writePos & RingMask;
+        const uint32_t contiguous = RingSize - offset;
+        // a record never wraps around, instead a padding record
+        // fills the rest of the ring
+        const uint32_t needed = (uint32_t(size) <= contiguous) ? size : (contiguous + size);
+        if ((RingSize - (writePos - readPos)) >= needed) {
+            uint32_t pos = writePos;
+            if (uint32_t(size) > contiguous) {
+                recordHeader* pad = (recordHeader*) &r->data[offset];
+                pad->size = contiguous;
+                pad->kind = PadRecord;
+                pos += contiguous;
+            }
+            outNewWritePos = writePos + needed;
+            return &r->data[pos & RingMask];
+        }
+
+        // the ring is full
+        if ((Log::OverflowPolicy::Drop == overflowPolicy) || isDrainingThread()) {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (!blocked) {
+            blocked = true;
+            numBlocked.fetch_add(1, std::memory_order_relaxed);
+        }
+        #if ORYOL_HAS_THREADS
+        if (drainThread) {
+            wakeup();
+            std::this_thread::yield();
+            continue;
+        }
+        #endif
+        // no drain thread, make room ourselves
+        drain();
+    }
+}
+
+//------------------------------------------------------------------------------
+logQueue::ring*
+logQueue::localRing() {
+    ring* r = threadRing;
+    if (nullptr == r) {
+        r = threadRing = claimRing();
+        threadExit::add(releaseThread);
+    }
+    return r;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::commit(ring* r, uint32_t newWritePos) {
+    r->writePos.store(newWritePos, std::memory_order_release);
+    r->numQueued.store(r->numQueued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    wakeup();
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::push(Log::Level level, const char* msg, va_list args) {
+    ring* r = localRing();
+    char buf[MaxMessageSize];
+    int len = std::vsnprintf(buf, sizeof(buf), msg, args);
+    if (len < 0) {
+        return;
+    }
+    if (len >= MaxMessageSize) {
+        len = MaxMessageSize - 1;
+    }
+    const int size = recordSize(len);
+    uint32_t newWritePos = 0;
+    uint8_t* ptr = reserve(r, size, newWritePos);
+    if (ptr) {
+        recordHeader* head = (recordHeader*) ptr;
+        head->seq = sequence.fetch_add(1, std::memory_order_relaxed);
+        head->size = size;
+        head->level = uint16_t(level);
+        head->kind = TextRecord;
+        std::memcpy(ptr + sizeof(recordHeader), buf, len);
+        ptr[sizeof(recordHeader) + len] = 0;
+        commit(r, newWritePos);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::setDeferred(bool b) {
+    o_assert(!b || isValid());
+    deferred.store(b, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+logQueue::beginDeferred(Log::Level level, const char* fmt, int numArgs, int argsSize, bool& outDeferred) {
+    const int payloadSize = int(sizeof(deferredHeader)) + numArgs + argsSize;
+    if (!isDeferred() || (Log::Level::Error == level) || (payloadSize > MaxMessageSize)) {
+        // format on the calling thread instead
+        outDeferred = false;
+        return nullptr;
+    }
+    outDeferred = true;
+    ring* r = localRing();
+    const int size = (int(sizeof(recordHeader)) + payloadSize + 15) & ~15;
+    uint8_t* ptr = reserve(r, size, r->pendingWritePos);
+    if (nullptr == ptr) {
+        return nullptr;
+    }
+    recordHeader* head = (recordHeader*) ptr;
+    head->seq = sequence.fetch_add(1, std::memory_order_relaxed);
+    head->size = size;
+    head->level = uint16_t(level);
+    head->kind = DeferredRecord;
+    deferredHeader* def = (deferredHeader*) (ptr + sizeof(recordHeader));
+    def->fmt = uint64_t(uintptr_t(fmt));
+    def->argsSize = uint16_t(argsSize);
+    def->numArgs = uint8_t(numArgs);
+    return ptr + sizeof(recordHeader) + sizeof(deferredHeader);
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::endDeferred() {
+    ring* r = threadRing;
+    commit(r, r->pendingWritePos);
+}
+
+//------------------------------------------------------------------------------
+const uint8_t*
+logQueue::peek(ring* r) {
+    uint32_t readPos = r->readPos.load(std::memory_order_relaxed);
+    while (readPos != r->drainEnd) {
+        const recordHeader* head = (const recordHeader*) &r->data[readPos & RingMask];
+        if (PadRecord != head->kind) {
+            return (const uint8_t*) head;
+        }
+        readPos += head->size;
+        r->readPos.store(readPos, std::memory_order_release);
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+int
+logQueue::drain() {
+    if (isDrainingThread() || (nullptr == printFn)) {
+        // a logger called Log::Error() or Log::Flush() while printing a drained message
+        return 0;
+    }
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(drainLock);
+    drainingThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    #else
+    draining = true;
+    #endif
+
+    // messages queued after this point are left for the next drain
+    ring* first = rings.load(std::memory_order_acquire);
+    for (ring* r = first; r; r = r->next) {
+        r->drainEnd = r->writePos.load(std::memory_order_acquire);
+    }
+
+    // merge the rings by sequence number
+    int num = 0;
+    for (;;) {
+        ring* oldestRing = nullptr;
+        const recordHeader* oldest = nullptr;
+        for (ring* r = first; r; r = r->next) {
+            const recordHeader* head = (const recordHeader*) peek(r);
+            if (head && ((nullptr == oldest) || (head->seq < oldest->seq))) {
+                oldestRing = r;
+                oldest = head;
+            }
+        }
+        if (nullptr == oldest) {
+            break;
+        }
+        output((const uint8_t*) oldest);
+        oldestRing->readPos.store(oldestRing->readPos.load(std::memory_order_relaxed) + oldest->size, std::memory_order_release);
+        num++;
+    }
+    flushSink();
+
+    #if ORYOL_HAS_THREADS
+    drainingThread.store(std::thread::id(), std::memory_order_relaxed);
+    #else
+    draining = false;
+    #endif
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::output(const uint8_t* record) {
+    const recordHeader* head = (const recordHeader*) record;
+    const Log::Level level = Log::Level(head->level);
+    const uint8_t* payload = record + sizeof(recordHeader);
+    if (DeferredRecord == head->kind) {
+        const deferredHeader* def = (const deferredHeader*) payload;
+        const char* fmt = (const char*) uintptr_t(def->fmt);
+        const uint8_t* types = payload + sizeof(deferredHeader);
+        const uint8_t* args = types + def->numArgs;
+        if (sinkFunc) {
+            // a format string is written once, and then referenced by its id
+            const uint32_t* idPtr = sinkFormats.Find(fmt);
+            uint32_t id = 0;
+            if (idPtr) {
+                id = *idPtr;
+            }
+            else {
+                id = uint32_t(sinkFormats.Size());
+                sinkFormats.Add(fmt, id);
+                int len = int(std::strlen(fmt));
+                if (len > 0xFFFF) {
+                    len = 0xFFFF;
+                }
+                uint8_t hdr[7];
+                hdr[0] = LogDecoder::FormatTag;
+                put16(put32(&hdr[1], id), uint16_t(len));
+                writeSink(hdr, sizeof(hdr));
+                writeSink(fmt, len);
+            }
+            uint8_t hdr[9];
+            hdr[0] = LogDecoder::MessageTag;
+            hdr[1] = uint8_t(level);
+            uint8_t* p = put32(&hdr[2], id);
+            *p++ = def->numArgs;
+            put16(p, def->argsSize);
+            writeSink(hdr, sizeof(hdr));
+            writeSink(types, def->numArgs + def->argsSize);
+        }
+        else {
+            char buf[MaxMessageSize];
+            LogDecoder::Format(buf, sizeof(buf), fmt, types, def->numArgs, args, def->argsSize);
+            printFn(level, buf);
+        }
+    }
+    else {
+        const char* msg = (const char*) payload;
+        if (sinkFunc) {
+            const int len = int(std::strlen(msg));
+            uint8_t hdr[4];
+            hdr[0] = LogDecoder::TextTag;
+            hdr[1] = uint8_t(level);
+            put16(&hdr[2], uint16_t(len));
+            writeSink(hdr, sizeof(hdr));
+            writeSink(msg, len);
+        }
+        else {
+            printFn(level, msg);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::writeSink(const void* data, int numBytes) {
+    if ((sinkBufferPos + numBytes) > SinkBufferSize) {
+        flushSink();
+    }
+    if (numBytes > SinkBufferSize) {
+        sinkFunc((const uint8_t*) data, numBytes);
+    }
+    else {
+        std::memcpy(&sinkBuffer[sinkBufferPos], data, numBytes);
+        sinkBufferPos += numBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::flushSink() {
+    if (sinkFunc && (sinkBufferPos > 0)) {
+        sinkFunc(sinkBuffer, sinkBufferPos);
+    }
+    sinkBufferPos = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::setBinarySink(Log::BinarySinkFunc func) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(drainLock);
+    #endif
+    flushSink();
+    sinkFunc = func;
+    sinkFormats.Clear();
+    if (sinkFunc) {
+        // a new stream starts with the stream header
+        writeSink(LogDecoder::Magic, sizeof(LogDecoder::Magic));
+    }
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+void
+logQueue::threadFunc() {
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(wakeupLock);
+            wakeupCond.wait_for(lock, std::chrono::milliseconds(DrainIntervalMs), [] {
+                return wakeupPending.load(std::memory_order_acquire);
+            });
+        }
+        wakeupPending.store(false, std::memory_order_release);
+        drain();
+    }
+}
+#else
+//------------------------------------------------------------------------------
+void
+logQueue::threadFunc() {
+    // empty
+}
+#endif
+
+//------------------------------------------------------------------------------
+Log::AsyncStats
+logQueue::stats() {
+    Log::AsyncStats s;
+    for (ring* r = rings.load(std::memory_order_acquire); r; r = r->next) {
+        s.NumQueued += r->numQueued.load(std::memory_order_relaxed);
+        s.NumQueues++;
+    }
+    s.NumDropped = numDropped.load(std::memory_order_relaxed);
+    s.NumBlocked = numBlocked.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace _priv
+} // namespace Oryol
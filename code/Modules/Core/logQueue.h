@@ -0,0 +1,117 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::logQueue
+    @ingroup _priv
+    @brief per-thread message queues for asynchronous logging
+
+    In async mode, Log formats messages on the calling thread and pushes
+    them into a per-thread single-producer/single-consumer ring buffer
+    of preallocated memory, this is the only work done on the calling
+    thread. The rings are drained either by a background thread, or by
+    calling drain() (e.g. from the main thread's PostRunLoop), drained
+    messages are handed to a print function. Messages of one thread are
+    always printed in the order they were queued. Within one drain,
+    messages of different threads are merged by the sequence number
+    taken when the message was reserved, but a message which is
+    committed after a drain has started is printed by the next drain,
+    so it may come after newer messages from other threads.
+
+    With deferred formatting, Log::Record() reserves a record with
+    beginDeferred(), writes the format string pointer and the packed
+    arguments (see logArgs) directly into the ring, and publishes it
+    with endDeferred(). Deferred records are formatted by LogDecoder::Format()
+    on the draining thread. If a binary sink is set, all drained records
+    are instead encoded into a LogDecoder stream, format strings are
+    written once and then referenced by id.
+
+    A ring is malloc'ed when a thread logs its first message, and never
+    freed since the draining thread may still read from it. A thread
+    releases its ring with releaseThread() when it exits (or calls
+    Core::LeaveThread()), and the ring is reused by the next thread
+    which needs a ring.
+*/
+#include "Core/Log.h"
+#include <atomic>
+
+namespace Oryol {
+namespace _priv {
+
+class logQueue {
+public:
+    /// max size of a message including the terminating 0 (longer messages are truncated)
+    static const int MaxMessageSize = 4096;
+    /// size of a per-thread ring buffer in bytes
+    static const int RingSize = 64 * 1024;
+    /// the function which receives the drained messages
+    typedef void (*printFunc)(Log::Level level, const char* msg);
+    /// a per-thread ring buffer (opaque)
+    struct ring;
+
+    /// enable async mode
+    static void setup(Log::OverflowPolicy policy, bool drainThread, printFunc func);
+    /// disable async mode, drains queued messages
+    static void discard();
+    /// return true if async mode is enabled
+    static bool isValid();
+    /// format and queue a message
+    static void push(Log::Level level, const char* msg, va_list args);
+    /// enable or disable deferred formatting
+    static void setDeferred(bool b);
+    /// return true if deferred formatting is enabled
+    static bool isDeferred();
+    /// reserve a deferred record, return pointer to the argument types, see Log::beginDeferred()
+    static uint8_t* beginDeferred(Log::Level level, const char* fmt, int numArgs, int argsSize, bool& outDeferred);
+    /// publish the record reserved by beginDeferred()
+    static void endDeferred();
+    /// set or clear the binary sink
+    static void setBinarySink(Log::BinarySinkFunc func);
+    /// hand queued messages to the print function, return number of messages
+    static int drain();
+    /// release the calling thread's ring for reuse
+    static void releaseThread();
+    /// get statistics
+    static Log::AsyncStats stats();
+
+private:
+    /// get a released ring, or create a new one
+    static ring* claimRing();
+    /// reserve room in the calling thread's ring, return nullptr if message must be dropped
+    static uint8_t* reserve(ring* r, int recordSize, uint32_t& outNewWritePos);
+    /// get the calling thread's ring
+    static ring* localRing();
+    /// publish a reserved record
+    static void commit(ring* r, uint32_t newWritePos);
+    /// get the oldest message of a ring before its drain end, or nullptr
+    static const uint8_t* peek(ring* r);
+    /// hand a drained record to the print function or binary sink
+    static void output(const uint8_t* record);
+    /// append data to the binary sink buffer
+    static void writeSink(const void* data, int numBytes);
+    /// pass the binary sink buffer to the sink
+    static void flushSink();
+    /// return true if the calling thread is currently draining
+    static bool isDrainingThread();
+    /// wake up the drain thread
+    static void wakeup();
+    /// the drain thread function
+    static void threadFunc();
+
+    static std::atomic<bool> valid;
+    static std::atomic<bool> deferred;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+logQueue::isValid() {
+    return valid.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+logQueue::isDeferred() {
+    return deferred.load(std::memory_order_relaxed);
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -63,6 +63,8 @@ public:
     int ByteSize() const;
     /// get byte offset of a component
     int ComponentByteOffset(int componentIndex) const;
+    /// get byte offset of a vertex attribute, return InvalidIndex if layout doesn't include attr
+    int ByteOffsetByVertexAttr(VertexAttr::Code attr) const;
     /// test if the layout contains a specific vertex attribute
     bool Contains(VertexAttr::Code attr) const;
 
@@ -151,4 +153,11 @@ VertexLayout::ComponentByteOffset(int index) const {
     return this->byteOffsets[index];
 }
 
+//------------------------------------------------------------------------------
+inline int
+VertexLayout::ByteOffsetByVertexAttr(VertexAttr::Code attr) const {
+    const int compIndex = this->ComponentIndexByVertexAttr(attr);
+    return (InvalidIndex != compIndex) ? this->byteOffsets[compIndex] : InvalidIndex;
+}
+
 } // namespace Oryol
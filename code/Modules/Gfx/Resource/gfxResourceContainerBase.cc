@@ -307,7 +307,8 @@ void
 gfxResourceContainerBase::Destroy(ResourceLabel label) {
     o_assert_dbg(this->isValid());
     
-    Array<Id> ids = this->registry.Remove(label);
+    // the removed ids are only needed until the end of this method
+    Array<Id> ids = this->registry.Remove(label, Memory::Tag::Frame);
     for (const Id& id : ids) {
         switch (id.Type) {
             case GfxResourceType::Texture:
@@ -35,6 +35,9 @@ TEST(VertexLayoutTest) {
     CHECK(layout.ComponentByteOffset(0) == 0);
     CHECK(layout.ComponentByteOffset(1) == 12);
     CHECK(layout.ComponentByteOffset(2) == 16);
+    CHECK(layout.ByteOffsetByVertexAttr(VertexAttr::Normal) == 12);
+    CHECK(layout.ByteOffsetByVertexAttr(VertexAttr::TexCoord0) == 16);
+    CHECK(layout.ByteOffsetByVertexAttr(VertexAttr::TexCoord1) == InvalidIndex);
     
     CHECK(layout.ComponentIndexByVertexAttr(VertexAttr::Position) == 0);
     CHECK(layout.ComponentIndexByVertexAttr(VertexAttr::Normal) == 1);
@@ -101,7 +101,7 @@ glShaderFactory::SetupResource(shader& shd) {
     GLint logLength;
     ::glGetProgramiv(glProg, GL_INFO_LOG_LENGTH, &logLength);
     if (logLength > 0) {
-        GLchar* logBuffer = (GLchar*) Memory::Alloc(logLength);
+        GLchar* logBuffer = (GLchar*) Memory::Alloc(logLength, Memory::Tag::Gfx);
         ::glGetProgramInfoLog(glProg, logLength, &logLength, logBuffer);
         Log::Info("%s\n", logBuffer);
         Memory::Free(logBuffer);
@@ -209,7 +209,7 @@ glShaderFactory::compileShader(ShaderStage::Code stage, const char* sourceString
         Log::Info("SHADER SOURCE:\n%s\n\n", sourceString);
         
         // now print the info log
-        GLchar* shdLogBuf = (GLchar*) Memory::Alloc(logLength);
+        GLchar* shdLogBuf = (GLchar*) Memory::Alloc(logLength, Memory::Tag::Gfx);
         ::glGetShaderInfoLog(glShader, logLength, &logLength, shdLogBuf);
         ORYOL_GL_CHECK_ERROR();
         Log::Info("SHADER LOG: %s\n\n", shdLogBuf);
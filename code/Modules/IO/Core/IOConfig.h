@@ -11,8 +11,12 @@ namespace Oryol {
 
 class IOConfig {
 public:
-    /// number of IO workers (== number of HTTP connections)
+    /// default number of IO workers (== number of HTTP connections)
     static const int NumWorkers = 4;
+    /// max number of IO workers (see IOSetup::NumWorkers)
+    static const int MaxNumWorkers = 16;
+    /// estimated size of requests with unknown size, used for load-balancing
+    static const int DefaultRequestSize = 64 * 1024;
 };
 
 } // namespace Oryol
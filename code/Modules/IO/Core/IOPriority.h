@@ -0,0 +1,42 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOPriority
+    @ingroup IO
+    @brief IO request priorities
+
+    IO workers always handle queued requests of a higher priority first.
+    Use Critical for data which is needed right away (e.g. streaming
+    data for the next frames), and Background for prefetching.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class IOPriority {
+public:
+    /// priority enum
+    enum Code {
+        Critical = 0,
+        Normal,
+        Background,
+
+        NumPriorities,
+        InvalidPriority
+    };
+    /// convert to string
+    static const char* ToString(Code c);
+};
+
+//------------------------------------------------------------------------------
+inline const char*
+IOPriority::ToString(Code c) {
+    switch (c) {
+        case Critical:      return "Critical";
+        case Normal:        return "Normal";
+        case Background:    return "Background";
+        default:            return "InvalidPriority";
+    }
+}
+
+} // namespace Oryol
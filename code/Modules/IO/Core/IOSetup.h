@@ -4,10 +4,24 @@
     @class Oryol::IOSetup
     @ingroup IO
     @brief configure the IO system
+
+    Set MemoryMapLoads to true to memory-map files loaded through
+    IO::Load(), IO::LoadGroup() and IO::LoadFile() instead of reading
+    them into an allocated buffer, if the filesystem supports it
+    (see IORead::MemoryMapEnabled).
+
+    QueueDepth is the max number of requests an IO worker hands to a
+    filesystem at once, filesystems with an async IO API (e.g. the
+    LocalFileSystem with io_uring on Linux) keep all of them in flight
+    at the same time. A QueueDepth of 1 handles one request after another.
+
+    NumWorkers is the number of IO worker threads (1..IOConfig::MaxNumWorkers),
+    the per-worker load can be inspected with IO::WorkerStats().
 */
 #include "Core/String/String.h"
 #include "Core/Containers/Map.h"
 #include "Core/Containers/KeyValuePair.h"
+#include "IO/Core/IOConfig.h"
 #include "IO/FS/FileSystem.h"
 #include <functional>
 
@@ -19,6 +33,12 @@ public:
     Map<String, String> Assigns;
     /// initial file systems
     Map<StringAtom, std::function<Ptr<FileSystem>()>> FileSystems;
+    /// memory-map loaded files if supported by the filesystem
+    bool MemoryMapLoads = false;
+    /// max number of requests handed to a filesystem at once per IO worker
+    int QueueDepth = 32;
+    /// number of IO worker threads
+    int NumWorkers = IOConfig::NumWorkers;
 };
     
 } // namespace Oryol
@@ -0,0 +1,32 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOWorkerStats
+    @ingroup IO
+    @brief statistics of an IO worker thread
+
+    Returned by IO::WorkerStats(). The latency of a request is the time
+    from IO::Put() until the request has been handled by the filesystem.
+*/
+#include "Core/Types.h"
+#include "Core/Time/Duration.h"
+
+namespace Oryol {
+
+class IOWorkerStats {
+public:
+    /// number of queued and in-flight messages
+    int QueueLength = 0;
+    /// estimated number of queued and in-flight bytes
+    int64_t QueuedBytes = 0;
+    /// number of handled requests
+    int NumHandled = 0;
+    /// number of handled requests which were stolen from other workers
+    int NumStolen = 0;
+    /// average latency of handled requests
+    Duration AvgLatency;
+    /// max latency of handled requests
+    Duration MaxLatency;
+};
+
+} // namespace Oryol
@@ -161,13 +161,14 @@ URL::crack(String urlString) {
     }
     if (urlString.IsValid()) {
     
-        StringBuilder builder;
-        builder.Set(urlString);
+        // NOTE: parse through a view, this doesn't allocate
+        const StringView urlView(urlString);
+        const int len = urlView.Length();
         this->content = urlString;
         
-        // extract scheme
+        // extract scheme (must start within the first 8 characters)
         this->indices[schemeStart] = 0;
-        this->indices[schemeEnd] = builder.FindSubString(0, 8, "://");
+        this->indices[schemeEnd] = urlView.FindSubString(0, len < 10 ? len : 10, "://");
         if (EndOfString == this->indices[schemeEnd]) {
             o_warn("URL::crack(): '%s' is not a valid URL!\n", this->content.AsCStr());
             this->clearIndices();
@@ -176,16 +177,16 @@ URL::crack(String urlString) {
         
         // extract host fields
         int leftStartIndex = this->indices[schemeEnd] + 3;
-        int leftEndIndex = builder.FindFirstOf(leftStartIndex, EndOfString, "/");
+        int leftEndIndex = urlView.FindFirstOf(leftStartIndex, EndOfString, "/");
         if (EndOfString == leftEndIndex) {
-            leftEndIndex = builder.Length();
+            leftEndIndex = len;
         }
         if (leftStartIndex != leftEndIndex) {
             // extract user and password
-            int userAndPwdEndIndex = builder.FindFirstOf(leftStartIndex, leftEndIndex, "@");
+            int userAndPwdEndIndex = urlView.FindFirstOf(leftStartIndex, leftEndIndex, "@");
             if (EndOfString != userAndPwdEndIndex) {
                 // only user, or user:pwd?
-                int userEndIndex = builder.FindFirstOf(leftStartIndex, userAndPwdEndIndex, ":");
+                int userEndIndex = urlView.FindFirstOf(leftStartIndex, userAndPwdEndIndex, ":");
                 if (EndOfString != userEndIndex) {
                     // user and password
                     this->indices[userStart] = leftStartIndex;
@@ -202,7 +203,7 @@ URL::crack(String urlString) {
             }
             
             // extract host and port
-            int hostEndIndex = builder.FindFirstOf(leftStartIndex, leftEndIndex, ":");
+            int hostEndIndex = urlView.FindFirstOf(leftStartIndex, leftEndIndex, ":");
             if (EndOfString != hostEndIndex) {
                 // host and port
                 this->indices[hostStart] = leftStartIndex;
@@ -218,13 +219,13 @@ URL::crack(String urlString) {
         }
         
         // is there any path component?
-        if (leftEndIndex != builder.Length()) {
+        if (leftEndIndex != len) {
             // extract right-hand-side (path, fragment, query)
             int rightStartIndex = leftEndIndex + 1;
-            int rightEndIndex = builder.Length();
+            int rightEndIndex = len;
             
             int pathStartIndex = rightStartIndex;
-            int pathEndIndex = builder.FindFirstOf(rightStartIndex, rightEndIndex, "#?");
+            int pathEndIndex = urlView.FindFirstOf(rightStartIndex, rightEndIndex, "#?");
             if (EndOfString == pathEndIndex) {
                 pathEndIndex = rightEndIndex;
             }
@@ -234,9 +235,9 @@ URL::crack(String urlString) {
             }
 
             // extract query
-            if ((pathEndIndex != rightEndIndex) && (builder.At(pathEndIndex) == '?')) {
+            if ((pathEndIndex != rightEndIndex) && (urlView[pathEndIndex] == '?')) {
                 int queryStartIndex = pathEndIndex + 1;
-                int queryEndIndex = builder.FindFirstOf(queryStartIndex, rightEndIndex, "#");
+                int queryEndIndex = urlView.FindFirstOf(queryStartIndex, rightEndIndex, "#");
                 if (EndOfString == queryEndIndex) {
                     queryEndIndex = rightEndIndex;
                 }
@@ -248,9 +249,9 @@ URL::crack(String urlString) {
             }
             
             // extract fragment
-            if ((pathEndIndex != rightEndIndex) && (builder.At(pathEndIndex) == '#')) {
+            if ((pathEndIndex != rightEndIndex) && (urlView[pathEndIndex] == '#')) {
                 int fragStartIndex = pathEndIndex + 1;
-                int fragEndIndex = builder.FindFirstOf(fragStartIndex, rightEndIndex, "?");
+                int fragEndIndex = urlView.FindFirstOf(fragStartIndex, rightEndIndex, "?");
                 if (EndOfString == fragEndIndex) {
                     fragEndIndex = rightEndIndex;
                 }
@@ -265,21 +266,33 @@ URL::crack(String urlString) {
     // fallthrough if valid or empty URL
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::view(int startIndex, int endIndex) const {
+    if (InvalidIndex != this->indices[startIndex]) {
+        return StringView(this->content).SubView(this->indices[startIndex], this->indices[endIndex]);
+    }
+    else {
+        return StringView();
+    }
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasScheme() const {
     return InvalidIndex != this->indices[schemeStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::SchemeView() const {
+    return this->view(schemeStart, schemeEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Scheme() const {
-    if (this->HasScheme()) {
-        return String(this->content.AsCStr(), this->indices[schemeStart], this->indices[schemeEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->SchemeView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -288,15 +301,16 @@ URL::HasUser() const {
     return InvalidIndex != this->indices[userStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::UserView() const {
+    return this->view(userStart, userEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::User() const {
-    if (this->HasUser()) {
-        return String(this->content.AsCStr(), this->indices[userStart], this->indices[userEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->UserView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -305,15 +319,16 @@ URL::HasPassword() const {
     return InvalidIndex != this->indices[pwdStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::PasswordView() const {
+    return this->view(pwdStart, pwdEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Password() const {
-    if (this->HasPassword()) {
-        return String(this->content.AsCStr(), this->indices[pwdStart], this->indices[pwdEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->PasswordView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -322,15 +337,16 @@ URL::HasHost() const {
     return InvalidIndex != this->indices[hostStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::HostView() const {
+    return this->view(hostStart, hostEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Host() const {
-    if (this->HasHost()) {
-        return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->HostView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -339,51 +355,59 @@ URL::HasPort() const {
     return InvalidIndex != this->indices[portStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::PortView() const {
+    return this->view(portStart, portEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Port() const {
-    if (this->HasPort()) {
-        return String(this->content.AsCStr(), this->indices[portStart], this->indices[portEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->PortView().MakeString();
 }
 
 //------------------------------------------------------------------------------
-String
-URL::HostAndPort() const  {
+StringView
+URL::HostAndPortView() const {
     if (this->HasHost()) {
         if (this->HasPort()) {
             // URL has host and port definition
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[portEnd]);
+            return this->view(hostStart, portEnd);
         }
         else {
             // URL only has host
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+            return this->view(hostStart, hostEnd);
         }
     }
     else {
         // no host in URL
-        return String();
+        return StringView();
     }
 }
 
+//------------------------------------------------------------------------------
+String
+URL::HostAndPort() const  {
+    return this->HostAndPortView().MakeString();
+}
+
 //------------------------------------------------------------------------------
 bool
 URL::HasPath() const {
     return InvalidIndex != this->indices[pathStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::PathView() const {
+    return this->view(pathStart, pathEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Path() const {
-    if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], this->indices[pathEnd]);
-    }
-    else {
-        return String();
-    }
+    return this->PathView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -392,26 +416,33 @@ URL::HasFragment() const {
     return InvalidIndex != this->indices[fragStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::FragmentView() const {
+    return this->view(fragStart, fragEnd);
+}
+
 //------------------------------------------------------------------------------
 String
 URL::Fragment() const {
-    if (this->HasFragment()) {
-        return String(this->content.AsCStr(), this->indices[fragStart], this->indices[fragEnd]);
+    return this->FragmentView().MakeString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PathToEndView() const {
+    if (this->HasPath()) {
+        return StringView(this->content).SubView(this->indices[pathStart], EndOfString);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
 String
 URL::PathToEnd() const {
-    if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], EndOfString);
-    }
-    else {
-        return String();
-    }
+    return this->PathToEndView().MakeString();
 }
 
 //------------------------------------------------------------------------------
@@ -420,37 +451,30 @@ URL::HasQuery() const {
     return InvalidIndex != this->indices[queryStart];
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::QueryView() const {
+    return this->view(queryStart, queryEnd);
+}
+
 //------------------------------------------------------------------------------
 Map<String, String>
 URL::Query() const {
-    if (this->HasQuery()) {
-        Map<String, String> query;
-        StringBuilder builder;
-        builder.Set(this->content.AsCStr(), this->indices[queryStart], this->indices[queryEnd]);
-        int kvpStartIndex = 0;
-        int kvpEndIndex = 0;
-        do {
-            kvpEndIndex = builder.FindFirstOf(kvpStartIndex, EndOfString, "&");
-            int keyEndIndex = builder.FindFirstOf(kvpStartIndex, kvpEndIndex, "=");
-            if (EndOfString != keyEndIndex) {
-                // key and value
-                String key(builder.GetSubString(kvpStartIndex, keyEndIndex));
-                String value(builder.GetSubString(keyEndIndex + 1, kvpEndIndex));
-                query.Add(key, value);
-            }
-            else {
-                // only key
-                String key(builder.GetSubString(kvpStartIndex, kvpEndIndex));
-                query.Add(key, String());
-            }
-            kvpStartIndex = kvpEndIndex + 1;
+    Map<String, String> query;
+    Array<StringView> kvps;
+    StringBuilder::Tokenize(this->QueryView(), "&", kvps);
+    for (const StringView& kvp : kvps) {
+        const int keyEndIndex = kvp.FindFirstOf(0, EndOfString, "=");
+        if (EndOfString != keyEndIndex) {
+            // key and value
+            query.Add(kvp.SubView(0, keyEndIndex).MakeString(), kvp.SubView(keyEndIndex + 1, EndOfString).MakeString());
+        }
+        else {
+            // only key
+            query.Add(kvp.MakeString(), String());
         }
-        while (EndOfString != kvpEndIndex);
-        return query;
-    }
-    else {
-        return Map<String, String>();
     }
+    return query;
 }
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
@@ -10,7 +10,8 @@
     parsed and indices to its parts will be stored internally, this
     is quite fast. The actual URL string will be stored as a StringAtom.
     Expensive String construction only happens when actually getting
-    the URL parts. 
+    the URL parts, the ...View() methods return non-owning StringViews
+    into the URL string instead and never allocate.
     
     @see URLBuilder
 */
@@ -18,6 +19,7 @@
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
 
 namespace Oryol {
 
@@ -98,6 +100,27 @@ public:
     Map<String, String> Query() const;
     /// get everything right of the server
     String PathToEnd() const;
+
+    /// get the scheme as view (doesn't allocate)
+    StringView SchemeView() const;
+    /// get the user as view (doesn't allocate)
+    StringView UserView() const;
+    /// get the password as view (doesn't allocate)
+    StringView PasswordView() const;
+    /// get the host as view (doesn't allocate)
+    StringView HostView() const;
+    /// get the port as view (doesn't allocate)
+    StringView PortView() const;
+    /// get host and port as view (doesn't allocate)
+    StringView HostAndPortView() const;
+    /// get the path as view (doesn't allocate)
+    StringView PathView() const;
+    /// get the fragment as view (doesn't allocate)
+    StringView FragmentView() const;
+    /// get the raw query component as view (doesn't allocate)
+    StringView QueryView() const;
+    /// get everything right of the server as view (doesn't allocate)
+    StringView PathToEndView() const;
     
 private:
     /// crack URL, populates string indices
@@ -106,6 +129,8 @@ private:
     void clearIndices();
     /// copy string indices
     void copyIndices(const URL& rhs);
+    /// get view on a part of the URL, empty view if part doesn't exist
+    StringView view(int startIndex, int endIndex) const;
     
     enum {
         schemeStart = 0,
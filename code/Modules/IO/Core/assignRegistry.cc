@@ -50,32 +50,56 @@ assignRegistry::LookupAssign(const String& assign) const {
     return result;
 }
 
+//------------------------------------------------------------------------------
+int
+assignRegistry::findAssign(const StringView& str) const {
+    const int index = str.FindFirstOf(0, EndOfString, ":");
+    // ignore DOS drive letters
+    if ((InvalidIndex == index) || (index <= 1)) {
+        return InvalidIndex;
+    }
+    // binary search in the sorted assigns, compares views to
+    // avoid creating a String for the assign name
+    const StringView assign = str.SubView(0, index + 1);
+    int lo = 0;
+    int hi = this->assigns.Size() - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        const int cmp = assign.Compare(this->assigns.KeyAtIndex(mid));
+        if (0 == cmp) {
+            return mid;
+        }
+        else if (cmp < 0) {
+            hi = mid - 1;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+    return InvalidIndex;
+}
+
 //------------------------------------------------------------------------------
 String
 assignRegistry::ResolveAssigns(const String& str) const {
 
     this->rwLock.LockRead();
     
-    StringBuilder builder;
-    builder.Set(str);
+    // early out if there are no assigns (e.g. URL schemes), this
+    // returns a copy of str and doesn't allocate
+    int index = this->findAssign(str);
+    if (InvalidIndex == index) {
+        this->rwLock.UnlockRead();
+        return str;
+    }
     
     // while there are assigns to replace...
-    int index;
-    while ((index = builder.FindFirstOf(0, EndOfString, ":")) != EndOfString) {
-        // ignore DOS drive letters
-        if (index > 1) {
-            String assignString = builder.GetSubString(0, index + 1);
-
-            // lookup the assign, ignore unknown assigns, may be URL schemes
-            if (this->assigns.Contains(assignString)) {
-                
-                // replace assign string
-                builder.SubstituteFirst(assignString, this->assigns[assignString]);
-            }
-            else break;
-        }
-        else break;
+    StringBuilder builder(str);
+    do {
+        const String& assign = this->assigns.KeyAtIndex(index);
+        builder.SubstituteRange(0, assign.Length(), this->assigns.ValueAtIndex(index).AsCStr());
     }
+    while (InvalidIndex != (index = this->findAssign(builder.AsView())));
     String result = builder.GetString();
     this->rwLock.UnlockRead();
     return result;
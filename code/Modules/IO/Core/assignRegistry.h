@@ -10,6 +10,7 @@
 */
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
 #include "Core/Threading/RWLock.h"
 
 namespace Oryol {
@@ -23,10 +24,12 @@ public:
     bool HasAssign(const String& assign) const;
     /// lookup an assign (return empty string if not exists)
     String LookupAssign(const String& assign) const;
-    /// resolve assigns in the provided string
+    /// resolve assigns in the provided string (doesn't allocate if there are no assigns in str)
     String ResolveAssigns(const String& str) const;
     
 private:
+    /// find the index of the assign str starts with, or InvalidIndex (rwLock must be held)
+    int findAssign(const StringView& str) const;
     /// setup the standard assigns
     void setStandardAssigns();
     
@@ -6,8 +6,11 @@
     @brief grant access to central IO module objects
 */
 #include "Core/Types.h"
+#include "Core/Ptr.h"
+#include "Core/Threading/mpscQueue.h"
 
 namespace Oryol {
+class IORequest;
 namespace _priv {
 
 class assignRegistry;
@@ -16,6 +19,8 @@ class schemeRegistry;
 struct ioPointers {
     class assignRegistry* assignRegistry;
     class schemeRegistry* schemeRegistry;
+    /// handled requests are pushed here by the IO workers
+    mpscQueue<Ptr<IORequest>>* completedRequests;
 };
 
 } // namespace _priv
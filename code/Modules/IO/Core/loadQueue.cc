@@ -15,8 +15,11 @@ loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    ioReq->MemoryMapEnabled = this->memoryMap;
+    const int id = ++this->curId;
+    this->items.Add(id, item{ ioReq, onSuccess, onFail });
+    this->pending.Add(ioReq.get(), id);
     IO::Put(ioReq);
-    this->items.Add(item{ ioReq, onSuccess, onFail });
 }
 
 //------------------------------------------------------------------------------
@@ -24,17 +27,23 @@ void
 loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
     
+    const int id = ++this->curId;
     groupItem item;
     item.ioRequests.Reserve(urls.Size());
+    item.onSuccess = onSuccess;
+    item.onFail = onFail;
+    item.numPending = urls.Size();
     for (const URL& url : urls) {
         Ptr<IORead> ioReq = IORead::Create();
         ioReq->Url = url;
-        IO::Put(ioReq);
+        ioReq->MemoryMapEnabled = this->memoryMap;
         item.ioRequests.Add(ioReq);
-        item.onSuccess = onSuccess;
-        item.onFail = onFail;
+        this->pending.Add(ioReq.get(), id);
+    }
+    this->groupItems.Add(id, item);
+    for (const auto& ioReq : this->groupItems[id].ioRequests) {
+        IO::Put(ioReq);
     }
-    this->groupItems.Add(item);
 }
 
 //------------------------------------------------------------------------------
@@ -45,73 +54,79 @@ loadQueue::numPending() const {
 
 //------------------------------------------------------------------------------
 void
-loadQueue::update() {
+loadQueue::warnFailed(const Ptr<IORead>& ioReq) {
+    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
+        ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the item is removed before the callbacks are invoked, so that
+ callbacks can start new load actions.
+*/
+void
+loadQueue::complete(const Ptr<IORequest>& ioReq) {
+    o_assert_dbg(ioReq->Handled);
+    const int* idPtr = this->pending.Find(ioReq.get());
+    if (nullptr == idPtr) {
+        // not a Load() or LoadGroup() request
+        return;
+    }
+    const int id = *idPtr;
+    this->pending.Erase(ioReq.get());
 
-    // check single items
-    for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
-        const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled) {
-            // io request has been handled
-            if (IOStatus::OK == ioReq->Status) {
-                // io request was successful
-                curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
+    // single items
+    item* itemPtr = this->items.Find(id);
+    if (itemPtr) {
+        item curItem = std::move(*itemPtr);
+        this->items.Erase(id);
+        const auto& req = curItem.ioRequest;
+        if (IOStatus::OK == req->Status) {
+            // io request was successful
+            curItem.onSuccess(result(req->Url, std::move(req->Data)));
+        }
+        else {
+            // io request failed
+            if (curItem.onFail) {
+                curItem.onFail(req->Url, req->Status);
             }
             else {
-                // io request failed
-                if (curItem.onFail) {
-                    curItem.onFail(ioReq->Url, ioReq->Status);
-                }
-                else {
-                    // no fail handler was set, just print a warning
-                    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                        ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                }
+                // no fail handler was set, just print a warning
+                warnFailed(req);
             }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
         }
+        return;
     }
-    
-    // check group items
-    for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
-        bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled) {
-                if (IOStatus::OK != ioReq->Status) {
-                    anyFailed = true;
-                    if (curItem.onFail) {
-                        curItem.onFail(ioReq->Url, ioReq->Status);
-                    }
-                    else {
-                        o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                            ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                    }
-                }
+
+    // group items, if all requests in the group have been handled,
+    // remove the item, and if all were successful, call the success-callback
+    groupItem* groupPtr = this->groupItems.Find(id);
+    o_assert_dbg(groupPtr);
+    if (--groupPtr->numPending > 0) {
+        return;
+    }
+    groupItem curItem = std::move(*groupPtr);
+    this->groupItems.Erase(id);
+    bool anyFailed = false;
+    for (const auto& req : curItem.ioRequests) {
+        if (IOStatus::OK != req->Status) {
+            anyFailed = true;
+            if (curItem.onFail) {
+                curItem.onFail(req->Url, req->Status);
             }
             else {
-                allHandled = false;
-                break;
+                warnFailed(req);
             }
         }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the success-callback
-        if (allHandled) {
-            if (!anyFailed) {
-                Array<result> result;
-                result.Reserve(curItem.ioRequests.Size());
-                for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->Url, std::move(ioReq->Data));
-                }
-                curItem.onSuccess(std::move(result));
-            }
-            this->groupItems.Erase(i);
+    }
+    if (!anyFailed) {
+        Array<result> result;
+        result.Reserve(curItem.ioRequests.Size());
+        for (const auto& req : curItem.ioRequests) {
+            result.Add(req->Url, std::move(req->Data));
         }
+        curItem.onSuccess(std::move(result));
     }
 }
 
 } // namespace Oryol
-
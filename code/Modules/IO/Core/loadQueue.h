@@ -6,10 +6,17 @@
     @brief asynchronously load multiple files, invoke callbacks with result
 
     This is the class behind the IO::Load() and LoadGroup() functions.
+
+    Pending requests are tracked in a hash map, and IO::ProcessCompleted()
+    calls complete() for each request from the completion queue, so the
+    cost per frame is proportional to the number of completed requests,
+    not to the number of pending requests.
 */
 #include "Core/Types.h"
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/InlineArray.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/Containers/Buffer.h"
 #include "IO/Core/URL.h"
 #include "IO/Core/IOStatus.h"
@@ -46,24 +53,51 @@ public:
     void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc());
     /// add a file group request to the queue
     void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc());
-    /// update the queue, called per frame from runloop
-    void update();
+    /// called for each completed IO request, invokes callbacks if it belongs to a load action
+    void complete(const Ptr<IORequest>& ioReq);
     /// get number of pending load actions
     int numPending() const;
+    /// memory-map loaded files if supported by the filesystem
+    void setMemoryMap(bool enabled);
 
 private:
+    /// print a warning for a failed request without fail handler
+    static void warnFailed(const Ptr<IORead>& ioReq);
+
+    bool memoryMap = false;
     struct item {
         Ptr<IORead> ioRequest;
         successFunc onSuccess;
         failFunc onFail;
     };
-    Array<item> items;
     struct groupItem {
-        Array<Ptr<IORead>> ioRequests;
+        InlineArray<Ptr<IORead>, 4> ioRequests;
         groupSuccessFunc onSuccess;
         failFunc onFail;
+        int numPending = 0;
+    };
+    struct idHasher {
+        uint32_t operator()(int id) const {
+            return uint32_t(id);
+        };
     };
-    Array<groupItem> groupItems;
+    struct requestHasher {
+        uint32_t operator()(const IORequest* req) const {
+            const uint64_t p = uint64_t(uintptr_t(req));
+            return uint32_t(p >> 4) ^ uint32_t(p >> 32);
+        };
+    };
+    int curId = 0;
+    HashMap<int, item, idHasher> items;
+    HashMap<int, groupItem, idHasher> groupItems;
+    /// maps pending requests to the id of their item or group item
+    HashMap<const IORequest*, int, requestHasher> pending;
 };
 
+//------------------------------------------------------------------------------
+inline void
+loadQueue::setMemoryMap(bool enabled) {
+    this->memoryMap = enabled;
+}
+
 } // namespace Oryol
@@ -35,4 +35,17 @@ FileSystem::onMsg(const Ptr<IORequest>& ioReq) {
     o_warn("FileSystem::onMsg(): message not handled by FileSystem!\n");
 }
 
+//------------------------------------------------------------------------------
+/**
+ Subclasses which can have several requests in flight at once (e.g. through
+ an async IO API) override this method, the default handles one request
+ after another.
+*/
+void
+FileSystem::onMsgs(const Array<Ptr<IORequest>>& ioReqs) {
+    for (const auto& ioReq : ioReqs) {
+        this->onMsg(ioReq);
+    }
+}
+
 } // namespace Oryol
\ No newline at end of file
@@ -10,6 +10,7 @@
 */
 #include "Core/String/StringAtom.h"
 #include "Core/RefCounted.h"
+#include "Core/Containers/Array.h"
 #include "IO/FS/ioRequests.h"
 
 namespace Oryol {
@@ -28,6 +29,8 @@ public:
     virtual void initLane();
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq);
+    /// called with a batch of IO requests (default calls onMsg for each)
+    virtual void onMsgs(const Array<Ptr<IORequest>>& ioReqs);
 
     StringAtom scheme;
 };
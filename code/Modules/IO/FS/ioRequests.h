@@ -12,6 +12,7 @@
 #include "Core/Containers/Buffer.h"
 #include "IO/Core/URL.h"
 #include "IO/Core/IOStatus.h"
+#include "IO/Core/IOPriority.h"
 
 namespace Oryol {
 namespace _priv {
@@ -36,12 +37,15 @@ class IORequest : public _priv::ioMsg {
     OryolClassDecl(IORequest);
     OryolTypeDecl(IORequest, _priv::ioMsg);
 public:
+    IORequest() { this->Data.SetAllocTag(Memory::Tag::IO); };
     URL Url;
     int StartOffset = 0;
     int EndOffset = EndOfFile;
     Buffer Data;
     IOStatus::Code Status = IOStatus::InvalidIOStatus;
     String ErrorDesc;
+    /// queued requests with a higher priority are handled first
+    IOPriority::Code Priority = IOPriority::Normal;
 };
 
 //------------------------------------------------------------------------------
@@ -51,6 +55,8 @@ class IORead : public IORequest {
 public:
     bool CacheReadEnabled = false;
     bool CacheWriteEnabled = false;
+    /// memory-map the file instead of reading it into Data if supported (Data becomes a view)
+    bool MemoryMapEnabled = false;
 };
 
 //------------------------------------------------------------------------------
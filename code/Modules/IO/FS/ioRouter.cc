@@ -9,26 +9,67 @@ namespace _priv {
 
 //------------------------------------------------------------------------------
 void
-ioRouter::setup(const ioPointers& ptrs) {
-    for (auto& worker : this->workers) {
-        worker.start(ptrs);
+ioRouter::setup(const ioPointers& ptrs, int numWorkers_, int queueDepth) {
+    o_assert((numWorkers_ > 0) && (numWorkers_ <= IOConfig::MaxNumWorkers));
+    this->numWorkers = numWorkers_;
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].start(ptrs, queueDepth, &this->workers[0], this->numWorkers);
     }
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::discard() {
-    for (auto& worker : this->workers) {
-        worker.stop();
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].stop();
     }
+    this->numWorkers = 0;
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::doWork() {
-    for (auto& worker : this->workers) {
-        worker.doWork();
+    bool hasBacklog = false;
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].doWork();
+        hasBacklog |= this->workers[i].queueLength() > 1;
     }
+    // wake up idle workers so they can steal from the busy ones
+    if (hasBacklog) {
+        for (int i = 0; i < this->numWorkers; i++) {
+            if (0 == this->workers[i].queueLength()) {
+                this->workers[i].wakeIdle();
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+ioRouter::getNumWorkers() const {
+    return this->numWorkers;
+}
+
+//------------------------------------------------------------------------------
+IOWorkerStats
+ioRouter::workerStats(int index) {
+    o_assert_range(index, this->numWorkers);
+    return this->workers[index].stats();
+}
+
+//------------------------------------------------------------------------------
+int64_t
+ioRouter::estimateBytes(const Ptr<ioMsg>& msg) {
+    if (msg->IsA<IORequest>()) {
+        const IORequest* req = (const IORequest*) msg.get();
+        if (req->EndOffset != EndOfFile) {
+            return req->EndOffset - req->StartOffset;
+        }
+        else if (msg->IsA<IOWrite>()) {
+            return req->Data.Size();
+        }
+    }
+    return IOConfig::DefaultRequestSize;
 }
 
 //------------------------------------------------------------------------------
@@ -36,18 +77,32 @@ void
 ioRouter::put(const Ptr<ioMsg>& msg) {
     if (msg->IsA<notifyWorkers>()) {
         // notifyWorker messages must be distributed to all workers
-        for (auto& worker : this->workers) {
-            worker.put(msg);
+        for (int i = 0; i < this->numWorkers; i++) {
+            this->workers[i].put(msg, 0);
         }
     }
     else {
-        // for all other messages, use a round-robin dispatch
-        this->curWorker = (this->curWorker + 1) % IOConfig::NumWorkers;
-        this->workers[this->curWorker].put(msg);
+        // for all other messages, pick the least loaded worker, start
+        // searching after the last used worker to spread requests
+        // evenly over workers with the same load
+        const int startWorker = this->curWorker;
+        int best = -1;
+        int64_t bestBytes = 0;
+        int bestLength = 0;
+        for (int i = 1; i <= this->numWorkers; i++) {
+            const int index = (startWorker + i) % this->numWorkers;
+            const int64_t bytes = this->workers[index].queuedBytes();
+            const int length = this->workers[index].queueLength();
+            if ((best < 0) || (bytes < bestBytes) || ((bytes == bestBytes) && (length < bestLength))) {
+                best = index;
+                bestBytes = bytes;
+                bestLength = length;
+            }
+        }
+        this->curWorker = best;
+        this->workers[best].put(msg, estimateBytes(msg));
     }
 }
 
 } // namespace _priv
 } // namespace Oryol
-
-
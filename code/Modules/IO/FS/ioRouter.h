@@ -4,6 +4,12 @@
     @class Oryol::_priv::ioRouter
     @ingroup IO
     @brief route IO requests to ioWorkers
+
+    IO requests are routed to the worker with the fewest estimated
+    queued bytes (the requested range, the size of written data, or
+    IOConfig::DefaultRequestSize if the size isn't known), and with
+    the shortest queue if this is equal. Idle workers are woken up
+    once per frame to steal work if other workers have a backlog.
 */
 #include "Core/Containers/StaticArray.h"
 #include "IO/Core/IOConfig.h"
@@ -16,17 +22,29 @@ namespace _priv {
 class ioRouter {
 public:
     /// setup the router
-    void setup(const ioPointers& ptrs);
+    void setup(const ioPointers& ptrs, int numWorkers, int queueDepth);
     /// discard the router
     void discard();
-    /// route a ioMsg to one or more workers
+    /// route a ioMsg to one or more workers (IO requests may be put from any thread)
     void put(const Ptr<ioMsg>& msg);
     /// perform per-frame work
     void doWork();
+    /// get number of workers
+    int getNumWorkers() const;
+    /// get statistics of a worker
+    IOWorkerStats workerStats(int index);
 
 private:
+    /// estimate the number of bytes a request will read or write
+    static int64_t estimateBytes(const Ptr<ioMsg>& msg);
+
+    #if ORYOL_HAS_ATOMIC
+    std::atomic<int> curWorker{0};
+    #else
     int curWorker = 0;
-    StaticArray<ioWorker, IOConfig::NumWorkers> workers;
+    #endif
+    int numWorkers = 0;
+    StaticArray<ioWorker, IOConfig::MaxNumWorkers> workers;
 };
 
 } // namespace _priv
@@ -4,21 +4,29 @@
 #include "Pre.h"
 #include "ioWorker.h"
 #include "IO/Core/schemeRegistry.h"
+#include "Core/Time/Clock.h"
 
 namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
 ioWorker::ioWorker() :
-threadStopRequested(false) {
+threadStopRequested(false),
+numQueued(0),
+numQueuedBytes(0) {
     // empty
 }
 
 //------------------------------------------------------------------------------
 void
-ioWorker::start(const ioPointers& ptrs) {
+ioWorker::start(const ioPointers& ptrs, int queueDepth_, ioWorker* workers_, int numWorkers_) {
     o_assert(!this->threadStartRequested);
+    o_assert(queueDepth_ > 0);
+    o_assert(workers_ && (numWorkers_ > 0));
     this->pointers = ptrs;
+    this->queueDepth = queueDepth_;
+    this->workers = workers_;
+    this->numWorkers = numWorkers_;
     #if ORYOL_HAS_THREADS
         this->sendThreadId = std::this_thread::get_id();
         this->thread = std::thread(threadFunc, this);
@@ -30,52 +38,92 @@ ioWorker::start(const ioPointers& ptrs) {
 void
 ioWorker::stop() {
     o_assert(this->threadStartRequested);
-    this->threadStopRequested = true;
     #if ORYOL_HAS_THREADS
+        {
+            std::lock_guard<std::mutex> lock(this->transferMutex);
+            this->threadStopRequested = true;
+        }
         this->transferCondVar.notify_one();
         this->thread.join();
+    #else
+        this->threadStopRequested = true;
     #endif
     this->threadStopped = true;
 }
 
 //------------------------------------------------------------------------------
 void
-ioWorker::put(const Ptr<ioMsg>& msg) {
-    o_assert(this->isSendThread());
-    o_assert(this->threadStartRequested);
-    o_assert(!this->threadStopped);
-    this->writeQueue.Enqueue(msg);
+ioWorker::put(const Ptr<ioMsg>& msg, int64_t numBytes) {
+    o_assert_dbg(this->threadStartRequested);
+    o_assert_dbg(!this->threadStopped);
+
+    entry e;
+    e.msg = msg;
+    e.putTime = Clock::Now();
+    e.numBytes = numBytes;
+    this->numQueued++;
+    this->numQueuedBytes += numBytes;
+    this->inbox.Enqueue(std::move(e));
+
+    #if ORYOL_HAS_THREADS
+    // wake up the worker thread if it is sleeping, the fences make sure that
+    // either the worker sees the new message, or this thread sees the sleeping flag
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->sleeping.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(this->transferMutex);
+        }
+        this->transferCondVar.notify_one();
+    }
+    #endif
 }
 
 //------------------------------------------------------------------------------
 void
 ioWorker::doWork() {
-    // move messages to transfer queue and wake up thread if work needs to be done
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
-    if (!this->writeQueue.Empty()) {
-        this->moveWriteToTransferQueue();
-    }
-    o_assert_dbg(this->writeQueue.Empty());
 
+    #if !ORYOL_HAS_THREADS
+        // if platform has no threads, pump the message queue right here
+        this->moveInboxToTransferQueues();
+        this->checkUnfinished();
+        while (this->takeBatch(this)) {
+            this->processBatch();
+        }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::wakeIdle() {
     #if ORYOL_HAS_THREADS
     {
         std::lock_guard<std::mutex> lock(this->transferMutex);
-        if (!this->transferQueue.Empty()) {
-            this->transferCondVar.notify_one();
-        }
+        this->wakeRequested = true;
     }
+    this->transferCondVar.notify_one();
     #endif
+}
 
-    #if !ORYOL_HAS_THREADS
-        // if platform has no threads, pump the message queue right
-        // FIXME: we could do without all those queue transfers here!
-        this->moveTransferToReadQueue();
-        while (!this->readQueue.Empty()) {
-            this->onMsg(std::move(this->readQueue.Dequeue()));
-        }
+//------------------------------------------------------------------------------
+IOWorkerStats
+ioWorker::stats() {
+    IOWorkerStats stats;
+    stats.QueueLength = this->numQueued;
+    stats.QueuedBytes = this->numQueuedBytes;
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->transferMutex);
     #endif
+    stats.NumHandled = this->numHandled;
+    stats.NumStolen = this->numStolen;
+    stats.MaxLatency = this->latencyMax;
+    if (this->numHandled > 0) {
+        stats.AvgLatency = this->latencySum;
+        stats.AvgLatency *= 1.0 / this->numHandled;
+    }
+    return stats;
 }
 
 //------------------------------------------------------------------------------
@@ -84,21 +132,41 @@ void
 ioWorker::threadFunc(ioWorker* self) {
     self->workThreadId = std::this_thread::get_id();
 
-    // the message processing loop waits for messages to arrive,
-    // moves them from the transfer queue, processes them then goes back to sleep
+    // the message processing loop takes batches of messages from the
+    // transfer queues and processes them, if there's nothing to do it
+    // tries to steal work from other workers, and then goes to sleep
     while (!self->threadStopRequested) {
-
-        // wait for messages to arrive, and if so, transfer to read queue
+        self->checkUnfinished();
+        bool hasBatch = false;
         {
-            std::unique_lock<std::mutex> lock(self->transferMutex);
-            self->transferCondVar.wait(lock);
-            self->moveTransferToReadQueue();
-            lock.unlock();
+            std::lock_guard<std::mutex> lock(self->transferMutex);
+            self->moveInboxToTransferQueues();
+            hasBatch = self->takeBatch(self);
         }
-
-        // now process the messages, this happens without locking
-        while (!self->readQueue.Empty()) {
-            self->onMsg(std::move(self->readQueue.Dequeue()));
+        if (!hasBatch) {
+            hasBatch = self->steal();
+        }
+        if (hasBatch) {
+            // process the messages, this happens without locking
+            self->processBatch();
+        }
+        else {
+            // go to sleep until a message arrives, and poll requests which
+            // are completed asynchronously by their filesystem
+            std::unique_lock<std::mutex> lock(self->transferMutex);
+            self->sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto wakeup = [self] {
+                return self->threadStopRequested || self->wakeRequested || self->hasMessages();
+            };
+            if (self->unfinished.Empty()) {
+                self->transferCondVar.wait(lock, wakeup);
+            }
+            else {
+                self->transferCondVar.wait_for(lock, std::chrono::milliseconds(1), wakeup);
+            }
+            self->sleeping.store(false, std::memory_order_relaxed);
+            self->wakeRequested = false;
         }
     }
 }
@@ -124,46 +192,213 @@ ioWorker::isWorkerThread() {
     #endif
 }
 
+//------------------------------------------------------------------------------
+bool
+ioWorker::hasMessages() const {
+    // NOTE: a thief may have moved the inbox into the transfer queues
+    if (!this->inbox.Empty()) {
+        return true;
+    }
+    for (const auto& queue : this->transferQueues) {
+        if (!queue.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 //------------------------------------------------------------------------------
 void
-ioWorker::moveWriteToTransferQueue() {
-    o_assert(this->isSendThread());
-    // if the transfer queue is empty, we can do a very fast complete move
+ioWorker::moveInboxToTransferQueues() {
+    // NOTE: the inbox has a single consumer at a time because this
+    // is only called with the transferMutex locked, either by the
+    // worker itself or by a worker which steals from it
+    entry e;
+    while (this->inbox.Dequeue(e)) {
+        // notifications are handled before any queued requests
+        IOPriority::Code prio = IOPriority::Critical;
+        if (e.msg->IsA<IORequest>()) {
+            prio = e.msg->DynamicCast<IORequest>()->Priority;
+            o_assert_range_dbg(prio, IOPriority::NumPriorities);
+        }
+        this->transferQueues[prio].Enqueue(std::move(e));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::checkUnfinished() {
+    for (int i = this->unfinished.Size() - 1; i >= 0; i--) {
+        if (this->unfinished[i]->Handled) {
+            this->pointers.completedRequests->Enqueue(this->unfinished[i]);
+            this->unfinished.Erase(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Takes the next batch from the highest-priority transfer queue of a
+ worker: either a single notification message, or consecutive IO
+ requests for the same filesystem. Notifications are never stolen
+ since each worker must handle its own, and IO requests are only
+ stolen if the thief has a filesystem for them.
+*/
+bool
+ioWorker::takeBatch(ioWorker* from) {
+    o_assert_dbg(this->batch.Empty());
+    const bool stealing = from != this;
+    for (auto& queue : from->transferQueues) {
+        if (queue.Empty()) {
+            continue;
+        }
+        if (!queue.Front().msg->IsA<IORequest>()) {
+            if (stealing) {
+                return false;
+            }
+            this->batch.Add(queue.Dequeue());
+            this->batchStolen = false;
+            return true;
+        }
+        const StringView scheme = queue.Front().msg->DynamicCast<IORequest>()->Url.SchemeView();
+        if (stealing && !this->findFileSystem(scheme)) {
+            return false;
+        }
+        int64_t numBytes = 0;
+        do {
+            numBytes += queue.Front().numBytes;
+            this->batch.Add(queue.Dequeue());
+        }
+        while ((this->batch.Size() < this->queueDepth) &&
+               !queue.Empty() &&
+               queue.Front().msg->IsA<IORequest>() &&
+               (queue.Front().msg->DynamicCast<IORequest>()->Url.SchemeView() == scheme));
+        if (stealing) {
+            from->numQueued -= this->batch.Size();
+            from->numQueuedBytes -= numBytes;
+            this->numQueued += this->batch.Size();
+            this->numQueuedBytes += numBytes;
+        }
+        this->batchStolen = stealing;
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioWorker::steal() {
+    #if ORYOL_HAS_THREADS
+    o_assert_dbg(this->isWorkerThread());
+    // a worker with a queue length of 1 only has a message in flight
+    const int selfIndex = int(this - this->workers);
+    for (int i = 1; i < this->numWorkers; i++) {
+        ioWorker* victim = &this->workers[(selfIndex + i) % this->numWorkers];
+        if (victim->queueLength() > 1) {
+            std::lock_guard<std::mutex> lock(victim->transferMutex);
+            victim->moveInboxToTransferQueues();
+            if (this->takeBatch(victim)) {
+                return true;
+            }
+        }
+    }
+    #endif
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::processBatch() {
+    o_assert_dbg(!this->batch.Empty());
+    if (!this->batch[0].msg->IsA<IORequest>()) {
+        o_assert_dbg(1 == this->batch.Size());
+        this->onMsg(this->batch[0].msg);
+    }
+    else {
+        // find filesystem and forward requests, NOTE:
+        // the filesystem is responsible to set the
+        // requests to 'handled'!
+        for (const entry& e : this->batch) {
+            Ptr<IORequest> ioReq = e.msg->DynamicCast<IORequest>();
+            if (!this->checkCancelled(ioReq)) {
+                this->batchRequests.Add(ioReq);
+            }
+        }
+        if (!this->batchRequests.Empty()) {
+            Ptr<FileSystem> fs = this->fileSystemForURL(this->batchRequests[0]->Url);
+            if (fs) {
+                if (1 == this->batchRequests.Size()) {
+                    fs->onMsg(this->batchRequests[0]);
+                }
+                else {
+                    fs->onMsgs(this->batchRequests);
+                }
+            }
+        }
+        this->batchRequests.Clear();
+
+        // push handled requests to the completion queue
+        for (const entry& e : this->batch) {
+            Ptr<IORequest> ioReq = e.msg->DynamicCast<IORequest>();
+            if (ioReq->Handled) {
+                this->pointers.completedRequests->Enqueue(std::move(ioReq));
+            }
+            else {
+                this->unfinished.Add(std::move(ioReq));
+            }
+        }
+    }
+
+    // update statistics
+    const TimePoint now = Clock::Now();
+    int64_t numBytes = 0;
     {
         #if ORYOL_HAS_THREADS
         std::lock_guard<std::mutex> lock(this->transferMutex);
         #endif
-        if (this->transferQueue.Empty()) {
-            this->transferQueue = std::move(this->writeQueue);
-        }
-        else {
-            // otherwise move messages one by one
-            while (!this->writeQueue.Empty()) {
-                this->transferQueue.Enqueue(this->writeQueue.Dequeue());
+        for (const entry& e : this->batch) {
+            numBytes += e.numBytes;
+            if (e.msg->IsA<IORequest>()) {
+                const Duration latency = now.Since(e.putTime);
+                this->latencySum += latency;
+                if (latency > this->latencyMax) {
+                    this->latencyMax = latency;
+                }
+                this->numHandled++;
+                if (this->batchStolen) {
+                    this->numStolen++;
+                }
             }
         }
     }
+    this->numQueued -= this->batch.Size();
+    this->numQueuedBytes -= numBytes;
+    this->batch.Clear();
 }
 
 //------------------------------------------------------------------------------
-void
-ioWorker::moveTransferToReadQueue() {
-    o_assert(this->isWorkerThread());
-    o_assert(this->readQueue.Empty());
-    this->readQueue = std::move(this->transferQueue);
+Ptr<FileSystem>
+ioWorker::findFileSystem(const StringView& scheme) {
+    // NOTE: linear search with a view on the scheme, there are only a
+    // handful of filesystems, and this avoids creating a String and
+    // StringAtom for each request
+    for (int i = 0; i < this->fileSystems.Size(); i++) {
+        if (scheme == StringView(this->fileSystems.KeyAtIndex(i))) {
+            return this->fileSystems.ValueAtIndex(i);
+        }
+    }
+    return Ptr<FileSystem>();
 }
 
 //------------------------------------------------------------------------------
 Ptr<FileSystem>
 ioWorker::fileSystemForURL(const URL& url) {
-    StringAtom scheme = url.Scheme();
-    if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
-    }
-    else {
-        o_warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
-        return Ptr<FileSystem>();
+    const StringView scheme = url.SchemeView();
+    Ptr<FileSystem> fs = this->findFileSystem(scheme);
+    if (!fs) {
+        o_warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.MakeString().AsCStr());
     }
+    return fs;
 }
 
 //------------------------------------------------------------------------------
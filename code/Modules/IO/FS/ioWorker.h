@@ -4,18 +4,39 @@
     @class Oryol::_priv::ioWorker
     @ingroup IO
     @brief worker thread to forward IO requests to filesystem implementations
-    
-    An ioWorker is basically a message queue with a thread behind it. To
-    remove granular locking it is pumped by the runloop. Once per
-    runloop-frame, messages from the main thread will be moved to a
-    'transfer queue', and the worker thread will be signaled. The 
-    worker thread wakes up, moves the messages from the transfer queue
-    to a read-queue, processes them and goes back to sleep.
+
+    An ioWorker is basically a message queue with a thread behind it.
+    Messages are put into a lock-free inbox (from any thread), and the
+    worker thread is woken up right away if it is sleeping (the only
+    case where put() takes a lock). The worker thread moves messages
+    from the inbox into a 'transfer queue' per priority, takes messages
+    from the transfer queues (highest priority first), processes them
+    and goes back to sleep once the inbox and transfer queues are empty.
+    Handled requests are pushed into the completion queue
+    (ioPointers::completedRequests) which the main thread drains.
+    Requests which a filesystem completes asynchronously are pushed
+    once their Handled flag is set.
+
+    Consecutive IO requests of the same priority for the same filesystem
+    are taken as a batch of up to queueDepth requests and handed to the
+    filesystem at once (see FileSystem::onMsgs()), so that filesystems
+    with an async API can have all of them in flight at once.
+
+    A worker without work steals batches of IO requests from the transfer
+    queues of the busiest other worker, so that a worker which is blocked
+    by a big file doesn't block the requests queued behind it. The
+    queue length and the estimated number of queued bytes are used by
+    the ioRouter to pick the least loaded worker for new requests.
 */
 #include "Core/Containers/Queue.h"
 #include "Core/Containers/Map.h"
+#include "Core/Containers/Array.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Time/TimePoint.h"
+#include "Core/Threading/mpscQueue.h"
 #include "IO/Core/ioPointers.h"
+#include "IO/Core/IOPriority.h"
+#include "IO/Core/IOWorkerStats.h"
 #include "IO/FS/ioRequests.h"
 #include "IO/FS/FileSystem.h"
 #if ORYOL_HAS_THREADS
@@ -32,22 +53,47 @@ class ioWorker {
 public:
     /// constructor
     ioWorker();
-    /// setup and start the worker thread
-    void start(const ioPointers& ptrs);
+    /// setup and start the worker thread, workers is the array of all workers (for stealing)
+    void start(const ioPointers& ptrs, int queueDepth, ioWorker* workers, int numWorkers);
     /// stop the worker thread, wait for join
     void stop();
-    /// put an io message into the internal message queue
-    void put(const Ptr<ioMsg>& msg);
-    /// do work on the main thread, this moves queued messages to transfer queue
+    /// put an io message into the inbox, with estimated size in bytes (any thread)
+    void put(const Ptr<ioMsg>& msg, int64_t numBytes);
+    /// do work on the main thread, only processes messages if platform has no threads
     void doWork();
+    /// wake up the worker thread if it is idle, so that it tries to steal work
+    void wakeIdle();
+    /// get number of queued and in-flight messages (may be called from any thread)
+    int queueLength() const;
+    /// get estimated number of queued and in-flight bytes (may be called from any thread)
+    int64_t queuedBytes() const;
+    /// get current statistics
+    IOWorkerStats stats();
 
 private:
+    /// a queued message
+    struct entry {
+        Ptr<ioMsg> msg;
+        TimePoint putTime;
+        int64_t numBytes = 0;
+    };
+
     /// lookup filesystem for URL
     Ptr<FileSystem> fileSystemForURL(const URL& url);
+    /// lookup filesystem by scheme, return invalid ptr if not registered
+    Ptr<FileSystem> findFileSystem(const StringView& scheme);
     /// check for and handle cancelled message
     bool checkCancelled(const Ptr<IORequest>& msg);
     /// called from thread to handle a generic message
     void onMsg(const Ptr<ioMsg>& msg);
+    /// take next batch from the transfer queues of a worker (transferMutex of 'from' must be locked)
+    bool takeBatch(ioWorker* from);
+    /// try to steal a batch of IO requests from the busiest other worker
+    bool steal();
+    /// process the current batch
+    void processBatch();
+    /// test if the inbox or transfer queues contain messages (transferMutex must be locked)
+    bool hasMessages() const;
     /// the thread worker func
     #if ORYOL_HAS_THREADS
     static void threadFunc(ioWorker* self);
@@ -56,17 +102,29 @@ private:
     bool isSendThread();
     /// test if we are on the worker-thread
     bool isWorkerThread();
-    /// move messages from the write queue to the transfer queue
-    void moveWriteToTransferQueue();
-    /// move messages from transfer queue to read queue
-    void moveTransferToReadQueue();
+    /// move messages from the inbox to the transfer queues (transferMutex must be locked)
+    void moveInboxToTransferQueues();
+    /// push requests which have been completed asynchronously to the completion queue
+    void checkUnfinished();
 
     ioPointers pointers;
     Map<StringAtom, Ptr<FileSystem>> fileSystems;
+    int queueDepth = 1;
+    ioWorker* workers = nullptr;
+    int numWorkers = 0;
+
+    mpscQueue<entry> inbox;                                 // written by sender threads, read by worker threads (locked)
+    Queue<entry> transferQueues[IOPriority::NumPriorities];  // written and read by worker threads (locked)
+    Array<entry> batch;                 // the messages currently processed by the worker thread
+    Array<Ptr<IORequest>> batchRequests;
+    Array<Ptr<IORequest>> unfinished;   // requests which haven't been handled by their filesystem yet
+    bool batchStolen = false;
 
-    Queue<Ptr<ioMsg>> writeQueue;     // written by sender thread
-    Queue<Ptr<ioMsg>> transferQueue;  // written by sender, read by worker thread (locked)
-    Queue<Ptr<ioMsg>> readQueue;      // read by worker thread
+    // statistics, written by worker thread (locked)
+    int numHandled = 0;
+    int numStolen = 0;
+    Duration latencySum;
+    Duration latencyMax;
 
     #if ORYOL_HAS_THREADS
     std::thread::id sendThreadId;
@@ -74,18 +132,33 @@ private:
     std::thread thread;
     std::mutex transferMutex;
     std::condition_variable transferCondVar;
+    bool wakeRequested = false;
+    std::atomic<bool> sleeping{false};
     #endif
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> threadStopRequested;
+    std::atomic<int> numQueued;
+    std::atomic<int64_t> numQueuedBytes;
     #else
     bool threadStopRequested;
+    int numQueued;
+    int64_t numQueuedBytes;
     #endif
     bool threadStartRequested = false;
     bool threadStopped = false;
 };
 
+//------------------------------------------------------------------------------
+inline int
+ioWorker::queueLength() const {
+    return this->numQueued;
+}
+
+//------------------------------------------------------------------------------
+inline int64_t
+ioWorker::queuedBytes() const {
+    return this->numQueuedBytes;
+}
 
 } // namespace _priv
 } // namespace Oryol
-
-    
@@ -22,7 +22,10 @@ IO::Setup(const IOSetup& setup) {
     ioPointers ptrs;
     ptrs.schemeRegistry = &state->schemeReg;
     ptrs.assignRegistry = &state->assignReg;
-    state->router.setup(ptrs);
+    ptrs.completedRequests = &state->completedRequests;
+    state->router.setup(ptrs, setup.NumWorkers, setup.QueueDepth);
+    state->memoryMapLoads = setup.MemoryMapLoads;
+    state->loadQueue.setMemoryMap(setup.MemoryMapLoads);
 
     // setup initial assigns
     for (const auto& assign : setup.Assigns) {
@@ -53,7 +56,27 @@ IO::doWork() {
     o_assert_dbg(IsValid());
     o_assert_dbg(Core::IsMainThread());
     state->router.doWork();
-    state->loadQueue.update();
+    ProcessCompleted();
+}
+
+//------------------------------------------------------------------------------
+/**
+ IO requests are handled by the worker threads as soon as they are put,
+ and pushed into a completion queue when they are done. This is called
+ once per frame from the runloop, call it more often to get the results
+ of IO::Load() and LoadGroup() with less latency.
+*/
+int
+IO::ProcessCompleted() {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(Core::IsMainThread());
+    int numCompleted = 0;
+    Ptr<IORequest> ioReq;
+    while (state->completedRequests.Dequeue(ioReq)) {
+        state->loadQueue.complete(ioReq);
+        numCompleted++;
+    }
+    return numCompleted;
 }
 
 //------------------------------------------------------------------------------
@@ -151,6 +174,7 @@ IO::LoadFile(const URL& url) {
     o_assert_dbg(IsValid());
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    ioReq->MemoryMapEnabled = state->memoryMapLoads;
     state->router.put(ioReq);
     return ioReq;
 }
@@ -173,4 +197,18 @@ IO::Put(const Ptr<IORequest>& ioReq) {
     state->router.put(ioReq);
 }
 
+//------------------------------------------------------------------------------
+int
+IO::NumWorkers() {
+    o_assert_dbg(IsValid());
+    return state->router.getNumWorkers();
+}
+
+//------------------------------------------------------------------------------
+IOWorkerStats
+IO::WorkerStats(int workerIndex) {
+    o_assert_dbg(IsValid());
+    return state->router.workerStats(workerIndex);
+}
+
 } // namespace Oryol
@@ -11,6 +11,7 @@
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
 #include "IO/Core/IOSetup.h"
+#include "IO/Core/IOWorkerStats.h"
 #include "IO/FS/ioRouter.h"
 #include "IO/Core/assignRegistry.h"
 #include "IO/Core/schemeRegistry.h"
@@ -59,13 +60,20 @@ public:
     static void LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc());
     /// get number of pending Load() and LoadGroup() actions
     static int NumPendingLoads();
+    /// drain the completion queue and invoke callbacks of finished loads, return number of completed requests
+    static int ProcessCompleted();
 
     /// low-level: start async loading of file from URL, return message for polling result
     static Ptr<IORead> LoadFile(const URL& url);
     /// low-level: start async writing of file via URL, return message for polling result
     static Ptr<IOWrite> WriteFile(const URL& url, const Buffer& data);
-    /// low-level: push a generic asynchronous IO request
+    /// low-level: push a generic asynchronous IO request (may be called from any thread)
     static void Put(const Ptr<IORequest>& ioReq);
+
+    /// get number of IO worker threads
+    static int NumWorkers();
+    /// get statistics of an IO worker thread
+    static IOWorkerStats WorkerStats(int workerIndex);
     
 private:
     /// pump the ioRequestRouter
@@ -74,9 +82,11 @@ private:
     struct _state {
         _priv::assignRegistry assignReg;
         _priv::schemeRegistry schemeReg;
+        _priv::mpscQueue<Ptr<IORequest>> completedRequests;
         _priv::ioRouter router;
         RunLoop::Id runLoopId = RunLoop::InvalidId;
         class loadQueue loadQueue;
+        bool memoryMapLoads = false;
     };
     static _state* state;
 };
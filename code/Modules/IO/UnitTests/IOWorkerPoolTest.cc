@@ -0,0 +1,381 @@
+//------------------------------------------------------------------------------
+//  IOWorkerPoolTest.cc
+//  Test IO worker routing, priorities, work stealing and stats.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace Oryol;
+
+static std::atomic<int> handledCounter{0};
+static std::atomic<bool> gateOpen{true};
+
+// a filesystem where 'slow' files take a long time, 'gated' files
+// wait until the gate is opened, 'missing' files fail, and each request
+// gets the order in which it was handled as payload
+class PoolTestFileSystem : public FileSystem {
+    OryolClassDecl(PoolTestFileSystem);
+    OryolClassCreator(PoolTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        if (msg->Url.Path() == "slow") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        }
+        else if (msg->Url.Path() == "gated") {
+            while (!gateOpen) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        else if (msg->Url.Path() == "missing") {
+            msg->Status = IOStatus::NotFound;
+            msg->Handled = true;
+            return;
+        }
+        const int order = handledCounter++;
+        msg->Data.Add((const uint8_t*)&order, sizeof(order));
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+//------------------------------------------------------------------------------
+static int
+handledOrder(const Ptr<IORead>& msg) {
+    int order = 0;
+    Memory::Copy(msg->Data.Data(), &order, sizeof(order));
+    return order;
+}
+
+//------------------------------------------------------------------------------
+static bool
+allHandled(const Array<Ptr<IORead>>& msgs) {
+    for (const auto& msg : msgs) {
+        if (!msg->Handled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static void
+waitForIdleWorkers() {
+    // stats are updated right after requests are set to handled
+    for (int i = 0; i < IO::NumWorkers(); i++) {
+        while (IO::WorkerStats(i).QueueLength > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(IOWorkerPoolTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 2;
+    ioSetup.QueueDepth = 1;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    CHECK(2 == IO::NumWorkers());
+
+    // a slow request must not block the requests queued behind it
+    handledCounter = 0;
+    Ptr<IORead> slow = IO::LoadFile("pool://host/slow");
+    Array<Ptr<IORead>> fast;
+    for (int i = 0; i < 20; i++) {
+        fast.Add(IO::LoadFile("pool://host/fast"));
+    }
+    while (!allHandled(fast)) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(!slow->Handled);
+    while (!slow->Handled) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(20 == handledOrder(slow));
+    waitForIdleWorkers();
+
+    int numHandled = 0;
+    int numStolen = 0;
+    Duration maxLatency;
+    for (int i = 0; i < IO::NumWorkers(); i++) {
+        const IOWorkerStats stats = IO::WorkerStats(i);
+        CHECK(0 == stats.QueueLength);
+        CHECK(0 == stats.QueuedBytes);
+        CHECK(stats.AvgLatency <= stats.MaxLatency);
+        numHandled += stats.NumHandled;
+        numStolen += stats.NumStolen;
+        if (stats.MaxLatency > maxLatency) {
+            maxLatency = stats.MaxLatency;
+        }
+    }
+    CHECK(21 == numHandled);
+    CHECK(numStolen > 0);
+    CHECK(maxLatency.AsMilliSeconds() >= 300.0);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOPriorityTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 1;
+    ioSetup.QueueDepth = 1;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    CHECK(1 == IO::NumWorkers());
+
+    // requests queued behind a slow request are handled highest priority first
+    handledCounter = 0;
+    auto slow = IORead::Create();
+    slow->Url = "pool://host/slow";
+    slow->Priority = IOPriority::Critical;
+    IO::Put(slow);
+    Array<Ptr<IORead>> msgs;
+    const IOPriority::Code prios[] = { IOPriority::Background, IOPriority::Normal, IOPriority::Critical };
+    for (int i = 0; i < 12; i++) {
+        auto msg = IORead::Create();
+        msg->Url = "pool://host/file";
+        msg->Priority = prios[i % 3];
+        IO::Put(msg);
+        msgs.Add(msg);
+    }
+    while (!allHandled(msgs)) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int numBad = 0;
+    for (const auto& msg : msgs) {
+        const int order = handledOrder(msg) - 1;
+        if ((order / 4) != int(msg->Priority)) {
+            numBad++;
+        }
+    }
+    CHECK(0 == numBad);
+    CHECK(0 == handledOrder(slow));
+    waitForIdleWorkers();
+    CHECK(13 == IO::WorkerStats(0).NumHandled);
+    CHECK(0 == IO::WorkerStats(0).NumStolen);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCompletionTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    // register the filesystem in the workers
+    Core::PreRunLoop()->Run();
+
+    // requests are handled without pumping the runloop, and may be put from any thread
+    Array<Ptr<IORead>> msgs;
+    for (int i = 0; i < 16; i++) {
+        auto msg = IORead::Create();
+        msg->Url = "pool://host/file";
+        msgs.Add(msg);
+    }
+    std::thread thread([&msgs] {
+        for (int i = 0; i < 8; i++) {
+            IO::Put(msgs[i]);
+        }
+    });
+    for (int i = 8; i < 16; i++) {
+        IO::Put(msgs[i]);
+    }
+    thread.join();
+    while (!allHandled(msgs)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    int numCompleted = 0;
+    while (numCompleted < 16) {
+        numCompleted += IO::ProcessCompleted();
+    }
+    CHECK(16 == numCompleted);
+    CHECK(0 == IO::ProcessCompleted());
+
+    // Load() callbacks are invoked from ProcessCompleted()
+    bool loaded = false;
+    IO::Load("pool://host/file", [&loaded](IO::LoadResult res) {
+        loaded = true;
+    });
+    while (!loaded) {
+        IO::ProcessCompleted();
+    }
+    CHECK(0 == IO::NumPendingLoads());
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOLoadQueueTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // single loads, with and without failure
+    int numLoaded = 0;
+    int numFailed = 0;
+    for (int i = 0; i < 8; i++) {
+        IO::Load(i & 1 ? "pool://host/missing" : "pool://host/file",
+            [&numLoaded](IO::LoadResult res) {
+                numLoaded++;
+            },
+            [&numFailed](const URL& url, IOStatus::Code status) {
+                CHECK(IOStatus::NotFound == status);
+                numFailed++;
+            });
+    }
+    CHECK(8 == IO::NumPendingLoads());
+    while (IO::NumPendingLoads() > 0) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(4 == numLoaded);
+    CHECK(4 == numFailed);
+
+    // load groups, the success callback is only called if all succeeded,
+    // and callbacks may start new loads
+    int numGroupsLoaded = 0;
+    int numGroupsFailed = 0;
+    IO::LoadGroup(Array<URL>({ "pool://host/file", "pool://host/file", "pool://host/file" }),
+        [&numGroupsLoaded](Array<IO::LoadResult> res) {
+            CHECK(3 == res.Size());
+            numGroupsLoaded++;
+            IO::Load("pool://host/file", [&numGroupsLoaded](IO::LoadResult res) {
+                numGroupsLoaded++;
+            });
+        });
+    IO::LoadGroup(Array<URL>({ "pool://host/file", "pool://host/missing" }),
+        [](Array<IO::LoadResult> res) {
+            CHECK(false);
+        },
+        [&numGroupsFailed](const URL& url, IOStatus::Code status) {
+            CHECK(url.Path() == "missing");
+            numGroupsFailed++;
+        });
+    CHECK(2 == IO::NumPendingLoads());
+    while (IO::NumPendingLoads() > 0) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(2 == numGroupsLoaded);
+    CHECK(1 == numGroupsFailed);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOPendingLoadsBenchmark) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    Core::PreRunLoop()->Run();
+
+    // per-frame cost of the IO runloop callback while many loads
+    // are pending and none of them completes, and while they trickle in
+    const int numLoads = 10000;
+    const int numFrames = 100;
+    gateOpen = false;
+    int numLoaded = 0;
+    for (int i = 0; i < numLoads; i++) {
+        IO::Load("pool://host/gated", [&numLoaded](IO::LoadResult res) {
+            numLoaded++;
+        });
+    }
+    double sumMs = 0.0;
+    double maxMs = 0.0;
+    for (int i = 0; i < numFrames; i++) {
+        auto start = std::chrono::steady_clock::now();
+        Core::PreRunLoop()->Run();
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        sumMs += ms.count();
+        maxMs = ms.count() > maxMs ? ms.count() : maxMs;
+    }
+    CHECK(0 == numLoaded);
+    CHECK(numLoads == IO::NumPendingLoads());
+    Log::Info("%d pending loads: avg %.4f ms, max %.4f ms per frame\n",
+        numLoads, sumMs / numFrames, maxMs);
+
+    gateOpen = true;
+    sumMs = 0.0;
+    int numDrainFrames = 0;
+    while (IO::NumPendingLoads() > 0) {
+        auto start = std::chrono::steady_clock::now();
+        Core::PreRunLoop()->Run();
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        sumMs += ms.count();
+        numDrainFrames++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    CHECK(numLoads == numLoaded);
+    Log::Info("%d completed loads: %.3f ms in %d frames\n", numLoads, sumMs, numDrainFrames);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOLatencyBenchmark) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("pool", PoolTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    Core::PreRunLoop()->Run();
+
+    // request-to-callback latency with 16 ms frames, when completions
+    // are only processed once per frame by the runloop, and when
+    // the main thread calls IO::ProcessCompleted() right away
+    const int numLoads = 20;
+    const auto frameTime = std::chrono::milliseconds(16);
+    for (int mode = 0; mode < 2; mode++) {
+        double sumMs = 0.0;
+        double maxMs = 0.0;
+        int sumFrames = 0;
+        for (int i = 0; i < numLoads; i++) {
+            bool loaded = false;
+            auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point end;
+            IO::Load("pool://host/file", [&loaded, &end](IO::LoadResult res) {
+                end = std::chrono::steady_clock::now();
+                loaded = true;
+            });
+            int numFrames = 0;
+            while (!loaded) {
+                if (0 == mode) {
+                    std::this_thread::sleep_for(frameTime);
+                    Core::PreRunLoop()->Run();
+                    numFrames++;
+                }
+                else {
+                    IO::ProcessCompleted();
+                }
+            }
+            std::chrono::duration<double, std::milli> ms = end - start;
+            sumMs += ms.count();
+            maxMs = ms.count() > maxMs ? ms.count() : maxMs;
+            sumFrames += numFrames;
+        }
+        Log::Info("%s: avg %.3f ms, max %.3f ms, avg %.2f frames request-to-callback\n",
+            0 == mode ? "per-frame processing" : "immediate processing",
+            sumMs / numLoads, maxMs, double(sumFrames) / numLoads);
+    }
+    IO::Discard();
+    Core::Discard();
+}
@@ -5,6 +5,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "IO/Core/URL.h"
+#include "Core/Memory/Memory.h"
 #include <cstring>
 
 using namespace Oryol;
@@ -97,4 +98,25 @@ TEST(URLTest) {
     CHECK(query["key1"] == "val1");
     CHECK(url3.Fragment() == "frag");
     CHECK(url3.PathToEnd() == "bla.txt?key0=val0&key1=val1#frag");
+
+    // the view accessors don't allocate
+    const int64_t allocs = Memory::QueryStats(Memory::Tag::String).TotalAllocs;
+    CHECK(url3.SchemeView() == "http");
+    CHECK(url3.UserView() == "user");
+    CHECK(url3.PasswordView() == "pwd");
+    CHECK(url3.HostView() == "www.flohofwoe.net");
+    CHECK(url3.PortView().Empty());
+    CHECK(url3.HostAndPortView() == "www.flohofwoe.net");
+    CHECK(url3.PathView() == "bla.txt");
+    CHECK(url3.QueryView() == "key0=val0&key1=val1");
+    CHECK(url3.FragmentView() == "frag");
+    CHECK(url3.PathToEndView() == "bla.txt?key0=val0&key1=val1#frag");
+    CHECK(url3.PathView().Ptr() == url3.AsCStr() + 34);
+    CHECK(Memory::QueryStats(Memory::Tag::String).TotalAllocs == allocs);
+
+    // a scheme longer than 5 characters
+    URL url4("custom://host/path");
+    CHECK(url4.IsValid());
+    CHECK(url4.SchemeView() == "custom");
+    CHECK(url4.PathView() == "path");
 }
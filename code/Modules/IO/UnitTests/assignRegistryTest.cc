@@ -6,6 +6,7 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "IO/Core/assignRegistry.h"
 #include "Core/Ptr.h"
+#include "Core/Memory/Memory.h"
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -32,4 +33,15 @@ TEST(assignRegistryTest) {
     reg.SetAssign("home:", "http://www.flohofwoe.net/");
     res = reg.ResolveAssigns("blub:");
     CHECK(res == "http://www.flohofwoe.net/blub/");
+    res = reg.ResolveAssigns("bla:blob.txt");
+    CHECK(res == "http://www.flohofwoe.net/blob.txt");
+    
+    // strings without assigns are returned without allocation
+    const String url("http://www.flohofwoe.net/a/long/path/file.txt");
+    const int64_t allocs = Memory::QueryStats(Memory::Tag::String).TotalAllocs;
+    res = reg.ResolveAssigns(url);
+    CHECK(res == url);
+    res = reg.ResolveAssigns("c:/a/long/path/on/a/windows/drive.txt");
+    CHECK(res == "c:/a/long/path/on/a/windows/drive.txt");
+    CHECK(Memory::QueryStats(Memory::Tag::String).TotalAllocs == (allocs + 1));
 }
@@ -38,6 +38,68 @@ LocalFileSystem::onMsg(const Ptr<IORequest>& req) {
     req->Handled = true;
 }
 
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::onMsgs(const Array<Ptr<IORequest>>& reqs) {
+    #if ORYOL_LINUX
+    // plain reads are batched through io_uring, everything else is handled one by one
+    this->uringReqs.Clear();
+    for (const auto& req : reqs) {
+        if (req->IsA<IORead>() && req->Url.HasPath() && req->Data.Empty() && !req->DynamicCast<IORead>()->MemoryMapEnabled) {
+            this->uringReqs.Add(req);
+        }
+        else {
+            this->onMsg(req);
+        }
+    }
+    if (this->uringReqs.Empty()) {
+        return;
+    }
+    this->uringPaths.Clear();
+    this->uringReads.Clear();
+    for (const auto& req : this->uringReqs) {
+        this->uringPaths.Add(req->Url.Path());
+    }
+    for (int i = 0; i < this->uringReqs.Size(); i++) {
+        const Ptr<IORequest>& req = this->uringReqs[i];
+        _priv::uringFSWrapper::readRequest read;
+        read.path = this->uringPaths[i].AsCStr();
+        read.startOffset = req->StartOffset;
+        read.endOffset = req->EndOffset;
+        read.data = &req->Data;
+        this->uringReads.Add(read);
+    }
+    if (this->uring.read(this->uringReads.begin(), this->uringReads.Size())) {
+        for (int i = 0; i < this->uringReqs.Size(); i++) {
+            const Ptr<IORequest>& req = this->uringReqs[i];
+            const _priv::uringFSWrapper::readRequest& read = this->uringReads[i];
+            if (!read.opened) {
+                req->Status = IOStatus::NotFound;
+                req->ErrorDesc = "Failed to open file";
+            }
+            else if (read.size > 0) {
+                if (read.bytesRead != read.size) {
+                    req->Status = IOStatus::DownloadError;
+                    req->ErrorDesc = "Fewer bytes read then expected";
+                }
+                else {
+                    req->Status = IOStatus::OK;
+                }
+            }
+            req->Handled = true;
+        }
+    }
+    else {
+        for (const auto& req : this->uringReqs) {
+            this->onMsg(req);
+        }
+    }
+    this->uringReqs.Clear();
+    #else
+    FileSystem::onMsgs(reqs);
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::onRead(const Ptr<IORead>& msg) {
@@ -46,25 +108,37 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
         if (fsWrapper::invalidHandle != h) {
             const int startOffset = msg->StartOffset;
             const int endOffset = msg->EndOffset;
-            if (startOffset > 0) {
-                fsWrapper::seek(h, startOffset);
-            }
+            const int fileSize = fsWrapper::size(h);
             int size;
             if (endOffset == EndOfFile) {
-                size = fsWrapper::size(h) - startOffset;
+                size = fileSize - startOffset;
             }
             else {
                 size = endOffset - startOffset;
             }
             if (size > 0) {
-                uint8_t* ptr = msg->Data.Add(size);
-                int bytesRead = fsWrapper::read(h, ptr, size);
-                if (bytesRead != size) {
-                    msg->Status = IOStatus::DownloadError;
-                    msg->ErrorDesc = "Fewer bytes read then expected";
+                // map the file region if requested (falls back to reading)
+                if (msg->MemoryMapEnabled && msg->Data.Empty() && ((startOffset + size) <= fileSize)) {
+                    uint8_t* ptr = nullptr;
+                    Ptr<RefCounted> mapping = fsWrapper::map(h, startOffset, size, ptr);
+                    if (mapping) {
+                        msg->Data.SetView(ptr, size, mapping);
+                        msg->Status = IOStatus::OK;
+                    }
                 }
-                else {
-                    msg->Status = IOStatus::OK;
+                if (!msg->Data.IsView()) {
+                    if (startOffset > 0) {
+                        fsWrapper::seek(h, startOffset);
+                    }
+                    uint8_t* ptr = msg->Data.Add(size);
+                    int bytesRead = fsWrapper::read(h, ptr, size);
+                    if (bytesRead != size) {
+                        msg->Status = IOStatus::DownloadError;
+                        msg->ErrorDesc = "Fewer bytes read then expected";
+                    }
+                    else {
+                        msg->Status = IOStatus::OK;
+                    }
                 }
             }
             fsWrapper::close(h);
@@ -7,9 +7,17 @@
     @class Oryol::LocalFileSystem
     @ingroup LocalFS
     @brief FileSystem subclass to access the local host file system
+
+    On Linux, batches of read requests are read asynchronously through
+    io_uring (see IOSetup::QueueDepth), with a fallback to blocking reads
+    if io_uring isn't available.
 */
 #include "IO/FS/FileSystem.h"
 #include "Core/Creator.h"
+#include "Core/Containers/Array.h"
+#if ORYOL_LINUX
+#include "LocalFS/linux/uringFSWrapper.h"
+#endif
 
 namespace Oryol {
 
@@ -21,12 +29,21 @@ public:
     virtual void init(const StringAtom& scheme) override;
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq) override;
+    /// called with a batch of IO requests
+    virtual void onMsgs(const Array<Ptr<IORequest>>& ioReqs) override;
 
 private:
     /// handle IORead msg
     void onRead(const Ptr<IORead>& ioRead);
     /// handle IOWrite msg
     void onWrite(const Ptr<IOWrite>& ioWrite);
+
+    #if ORYOL_LINUX
+    _priv::uringFSWrapper uring;
+    Array<Ptr<IORequest>> uringReqs;
+    Array<String> uringPaths;
+    Array<_priv::uringFSWrapper::readRequest> uringReads;
+    #endif
 };
 
 } // namespace Oryol
@@ -5,7 +5,11 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "LocalFS/Core/fsWrapper.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/Log.h"
 #include <string.h>
+#include <stdio.h>
+#include <chrono>
 
 using namespace Oryol;
 using namespace _priv;
@@ -63,3 +67,85 @@ TEST(FSWrapperTest) {
     CHECK(readStr == "World\n");
     fsWrapper::close(hs);
 }
+
+//------------------------------------------------------------------------------
+static uint64_t
+touchPages(const uint8_t* ptr, int numBytes) {
+    // read one byte per page, like a parser would touch all data
+    uint64_t sum = 0;
+    for (int i = 0; i < numBytes; i += 4096) {
+        sum += ptr[i];
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+TEST(FSWrapperMapBenchmark) {
+    StringBuilder strBuilder;
+    strBuilder.Format(4096, "%s/mapbench.bin", fsWrapper::getCwd().AsCStr());
+    const String path = strBuilder.GetString();
+
+    uint8_t chunk[64 * 1024];
+    for (int i = 0; i < int(sizeof(chunk)); i++) {
+        chunk[i] = uint8_t(i * 7);
+    }
+    // the full benchmark runs 1 KB .. 1 GB files, the default
+    // unit test only checks 1 KB .. 4 MB files with few iterations
+    #if ORYOL_LOCALFS_BENCHMARKS
+    const int maxShift = 30;
+    const int maxIters = 1000;
+    #else
+    const int maxShift = 22;
+    const int maxIters = 4;
+    #endif
+    for (int shift = 10; shift <= maxShift; shift += 4) {
+        const int size = 1<<shift;
+        // write the test file
+        const fsWrapper::handle hw = fsWrapper::openWrite(path.AsCStr());
+        CHECK(hw != fsWrapper::invalidHandle);
+        int written = 0;
+        while (written < size) {
+            const int n = (size - written) < int(sizeof(chunk)) ? (size - written) : int(sizeof(chunk));
+            written += fsWrapper::write(hw, chunk, n);
+        }
+        fsWrapper::close(hw);
+        if (written != size) {
+            Log::Warn("failed to write %d bytes, skipping\n", size);
+            break;
+        }
+
+        int numIters = (64 * 1024 * 1024) / size;
+        numIters = numIters < 1 ? 1 : (numIters > maxIters ? maxIters : numIters);
+        uint64_t readSum = 0, mapSum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numIters; i++) {
+            const fsWrapper::handle h = fsWrapper::openRead(path.AsCStr());
+            const int fileSize = fsWrapper::size(h);
+            Buffer buf;
+            const int bytesRead = fsWrapper::read(h, buf.Add(fileSize), fileSize);
+            fsWrapper::close(h);
+            CHECK(bytesRead == size);
+            readSum += touchPages(buf.Data(), buf.Size());
+        }
+        std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numIters; i++) {
+            const fsWrapper::handle h = fsWrapper::openRead(path.AsCStr());
+            const int fileSize = fsWrapper::size(h);
+            Buffer buf;
+            uint8_t* ptr = nullptr;
+            Ptr<RefCounted> mapping = fsWrapper::map(h, 0, fileSize, ptr);
+            fsWrapper::close(h);
+            CHECK(mapping.isValid());
+            buf.SetView(ptr, fileSize, mapping);
+            mapSum += touchPages(buf.Data(), buf.Size());
+        }
+        std::chrono::duration<double> mapTime = std::chrono::steady_clock::now() - start;
+        CHECK(readSum == mapSum);
+
+        Log::Info("%10d bytes x %4d: fread %f ms, mmap %f ms per file\n", size, numIters,
+            (readTime.count() * 1000.0) / numIters, (mapTime.count() * 1000.0) / numIters);
+    }
+    remove(path.AsCStr());
+}
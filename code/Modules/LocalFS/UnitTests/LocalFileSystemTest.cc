@@ -192,3 +192,128 @@ TEST(SameExtensionTest) {
 
 
 
+
+TEST(MemoryMapTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    ioSetup.MemoryMapLoads = true;
+    IO::Setup(ioSetup);
+
+    auto write = IOWrite::Create();
+    write->Url = "root:mapped.txt";
+    const String hello("Hello Mapped World!");
+    write->Data.Add((const uint8_t*)hello.AsCStr(), hello.Length());
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // the whole file
+    auto read = IO::LoadFile("root:mapped.txt");
+    CHECK(read->MemoryMapEnabled);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.IsView());
+    CHECK(read->Data.Size() == hello.Length());
+    String readStr((const char*)read->Data.Data(), 0, read->Data.Size());
+    CHECK(readStr == hello);
+
+    // a region with an unaligned offset, modifying the copy-on-write view
+    read = IORead::Create();
+    read->Url = "root:mapped.txt";
+    read->MemoryMapEnabled = true;
+    read->StartOffset = 6;
+    read->EndOffset = 12;
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.IsView());
+    readStr.Assign((const char*)read->Data.Data(), 0, read->Data.Size());
+    CHECK(readStr == "Mapped");
+    read->Data.Data()[0] = 'Z';
+
+    // a region beyond the end of the file is read (and fails)
+    auto badRead = IORead::Create();
+    badRead->Url = "root:mapped.txt";
+    badRead->MemoryMapEnabled = true;
+    badRead->StartOffset = 6;
+    badRead->EndOffset = 100;
+    IO::Put(badRead);
+    wait(badRead);
+    CHECK(badRead->Status == IOStatus::DownloadError);
+    CHECK(!badRead->Data.IsView());
+
+    // the file itself is unchanged, IO::Load() moves the view into the result
+    bool done = false;
+    IO::Load("root:mapped.txt", [&done, &hello](IO::LoadResult res) {
+        CHECK(res.Data.IsView());
+        String payload((const char*)res.Data.Data(), 0, res.Data.Size());
+        CHECK(payload == hello);
+        done = true;
+    });
+    while (!done) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        Core::PostRunLoop()->Run();
+    }
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(BatchReadTest) {
+    // many requests in the same frame are handed to the filesystem as batches
+    for (int queueDepth : { 32, 1 }) {
+        Core::Setup();
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+        ioSetup.QueueDepth = queueDepth;
+        IO::Setup(ioSetup);
+
+        auto write = IOWrite::Create();
+        write->Url = "root:batch.txt";
+        const String hello("Hello Batched World!");
+        write->Data.Add((const uint8_t*)hello.AsCStr(), hello.Length());
+        IO::Put(write);
+        wait(write);
+        CHECK(write->Status == IOStatus::OK);
+
+        const int numReads = 40;
+        Array<Ptr<IORead>> reads;
+        for (int i = 0; i < numReads; i++) {
+            auto read = IORead::Create();
+            if (0 == (i % 10)) {
+                read->Url = "root:batch_missing.txt";
+            }
+            else if (0 == (i % 3)) {
+                read->Url = "root:batch.txt";
+                read->StartOffset = 6;
+                read->EndOffset = 13;
+            }
+            else {
+                read->Url = "root:batch.txt";
+            }
+            IO::Put(read);
+            reads.Add(read);
+        }
+        for (const auto& read : reads) {
+            wait(read);
+        }
+        for (int i = 0; i < numReads; i++) {
+            const auto& read = reads[i];
+            if (0 == (i % 10)) {
+                CHECK(read->Status == IOStatus::NotFound);
+                CHECK(read->Data.Empty());
+                continue;
+            }
+            CHECK(read->Status == IOStatus::OK);
+            CHECK(!read->Data.Empty());
+            if (!read->Data.Empty()) {
+                String readStr((const char*)read->Data.Data(), 0, read->Data.Size());
+                CHECK(readStr == ((0 == (i % 3)) ? String("Batched") : hello));
+            }
+        }
+        IO::Discard();
+        Core::Discard();
+    }
+}
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+//  UringFSWrapperTest.cc
+//  Test batched io_uring reads (Linux only).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "LocalFS/linux/uringFSWrapper.h"
+#include "LocalFS/Core/fsWrapper.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <stdio.h>
+#include <chrono>
+
+using namespace Oryol;
+using namespace _priv;
+
+//------------------------------------------------------------------------------
+static String
+writeTestFile(int index, int size) {
+    StringBuilder strBuilder;
+    strBuilder.Format(4096, "%s/uring_%d.bin", fsWrapper::getCwd().AsCStr(), index);
+    Buffer data;
+    uint8_t* ptr = data.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = uint8_t(i + index);
+    }
+    const fsWrapper::handle h = fsWrapper::openWrite(strBuilder.AsCStr());
+    fsWrapper::write(h, data.Data(), data.Size());
+    fsWrapper::close(h);
+    return strBuilder.GetString();
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkContent(const Buffer& data, int index, int startOffset) {
+    for (int i = 0; i < data.Size(); i++) {
+        if (data.Data()[i] != uint8_t(i + startOffset + index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+TEST(UringFSWrapperTest) {
+    uringFSWrapper uring;
+    const int numFiles = 8;
+    Array<String> paths;
+    for (int i = 0; i < numFiles; i++) {
+        paths.Add(writeTestFile(i, 1000 + i * 10000));
+    }
+    StringBuilder strBuilder;
+    strBuilder.Format(4096, "%s/uring_missing.bin", fsWrapper::getCwd().AsCStr());
+    const String missing = strBuilder.GetString();
+
+    Buffer buffers[numFiles + 2];
+    uringFSWrapper::readRequest reqs[numFiles + 2];
+    for (int i = 0; i < numFiles; i++) {
+        reqs[i].path = paths[i].AsCStr();
+        reqs[i].data = &buffers[i];
+    }
+    // a region and a missing file
+    reqs[numFiles].path = paths[3].AsCStr();
+    reqs[numFiles].startOffset = 100;
+    reqs[numFiles].endOffset = 200;
+    reqs[numFiles].data = &buffers[numFiles];
+    reqs[numFiles + 1].path = missing.AsCStr();
+    reqs[numFiles + 1].data = &buffers[numFiles + 1];
+
+    if (!uring.read(reqs, numFiles + 2)) {
+        CHECK(uring.isUnavailable());
+        Log::Warn("io_uring not available, skipping test\n");
+        for (const String& path : paths) {
+            remove(path.AsCStr());
+        }
+        return;
+    }
+    for (int i = 0; i < numFiles; i++) {
+        CHECK(reqs[i].opened);
+        CHECK(reqs[i].size == 1000 + i * 10000);
+        CHECK(reqs[i].bytesRead == reqs[i].size);
+        CHECK(buffers[i].Size() == reqs[i].size);
+        CHECK(checkContent(buffers[i], i, 0));
+    }
+    CHECK(reqs[numFiles].opened);
+    CHECK(reqs[numFiles].size == 100);
+    CHECK(reqs[numFiles].bytesRead == 100);
+    CHECK(checkContent(buffers[numFiles], 3, 100));
+    CHECK(!reqs[numFiles + 1].opened);
+    CHECK(buffers[numFiles + 1].Empty());
+
+    // a region beyond the end of the file reads what's there
+    Buffer buf;
+    uringFSWrapper::readRequest req;
+    req.path = paths[0].AsCStr();
+    req.startOffset = 900;
+    req.endOffset = 1100;
+    req.data = &buf;
+    CHECK(uring.read(&req, 1));
+    CHECK(req.opened);
+    CHECK(req.size == 200);
+    CHECK(req.bytesRead == 100);
+
+    // a batch bigger than the ring
+    const int numBig = 600;
+    Array<uringFSWrapper::readRequest> bigReqs;
+    Array<Buffer> bigBuffers;
+    bigBuffers.Reserve(numBig);
+    for (int i = 0; i < numBig; i++) {
+        bigBuffers.Add();
+        uringFSWrapper::readRequest r;
+        r.path = paths[i % numFiles].AsCStr();
+        bigReqs.Add(r);
+    }
+    for (int i = 0; i < numBig; i++) {
+        bigReqs[i].data = &bigBuffers[i];
+    }
+    CHECK(uring.read(bigReqs.begin(), numBig));
+    int numBad = 0;
+    for (int i = 0; i < numBig; i++) {
+        const int index = i % numFiles;
+        if ((bigReqs[i].bytesRead != (1000 + index * 10000)) || !checkContent(bigBuffers[i], index, 0)) {
+            numBad++;
+        }
+    }
+    CHECK(0 == numBad);
+
+    for (const String& path : paths) {
+        remove(path.AsCStr());
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(UringFSWrapperBenchmark) {
+    uringFSWrapper uring;
+    const int numFiles = 256;
+    Array<String> paths;
+    for (int i = 0; i < numFiles; i++) {
+        paths.Add(writeTestFile(i, 4096));
+    }
+    const int numIters = 20;
+
+    // sequential blocking reads
+    int64_t readBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int iter = 0; iter < numIters; iter++) {
+        for (const String& path : paths) {
+            const fsWrapper::handle h = fsWrapper::openRead(path.AsCStr());
+            const int size = fsWrapper::size(h);
+            Buffer buf;
+            readBytes += fsWrapper::read(h, buf.Add(size), size);
+            fsWrapper::close(h);
+        }
+    }
+    std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - start;
+
+    // batched io_uring reads
+    int64_t uringBytes = 0;
+    bool available = true;
+    start = std::chrono::steady_clock::now();
+    for (int iter = 0; (iter < numIters) && available; iter++) {
+        Array<Buffer> buffers;
+        buffers.Reserve(numFiles);
+        Array<uringFSWrapper::readRequest> reqs;
+        for (int i = 0; i < numFiles; i++) {
+            buffers.Add();
+            uringFSWrapper::readRequest r;
+            r.path = paths[i].AsCStr();
+            reqs.Add(r);
+        }
+        for (int i = 0; i < numFiles; i++) {
+            reqs[i].data = &buffers[i];
+        }
+        available = uring.read(reqs.begin(), numFiles);
+        for (const auto& r : reqs) {
+            uringBytes += r.bytesRead;
+        }
+    }
+    std::chrono::duration<double> uringTime = std::chrono::steady_clock::now() - start;
+    if (available) {
+        CHECK(readBytes == uringBytes);
+        Log::Info("%d x 4 KB files: sequential %f ms, io_uring batch %f ms per batch\n", numFiles,
+            (readTime.count() * 1000.0) / numIters, (uringTime.count() * 1000.0) / numIters);
+    }
+    else {
+        Log::Warn("io_uring not available, skipping benchmark\n");
+    }
+    for (const String& path : paths) {
+        remove(path.AsCStr());
+    }
+}
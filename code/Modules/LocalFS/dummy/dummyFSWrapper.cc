@@ -37,6 +37,12 @@ dummyFSWrapper::seek(handle f, int offset) {
     return true;
 }
 
+//------------------------------------------------------------------------------
+Ptr<RefCounted>
+dummyFSWrapper::map(handle f, int offset, int numBytes, uint8_t*& outPtr) {
+    return Ptr<RefCounted>();
+}
+
 //------------------------------------------------------------------------------
 int
 dummyFSWrapper::size(handle f) {
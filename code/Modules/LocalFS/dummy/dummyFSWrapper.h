@@ -7,6 +7,7 @@
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
+#include "Core/RefCounted.h"
 
 namespace Oryol {
 namespace _priv {
@@ -30,6 +31,8 @@ public:
     static bool seek(handle f, int offset);
     /// get file size
     static int size(handle f);
+    /// memory-map a file region (private, copy-on-write), the region is unmapped when the returned object is destroyed
+    static Ptr<RefCounted> map(handle f, int offset, int numBytes, uint8_t*& outPtr);
     /// close file
     static void close(handle f);
     
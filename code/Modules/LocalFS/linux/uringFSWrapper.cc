@@ -0,0 +1,379 @@
+//------------------------------------------------------------------------------
+//  uringFSWrapper.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "uringFSWrapper.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+// operation ids in the low bits of the user data
+enum op {
+    OpOpen = 0,
+    OpStatx,
+    OpRead,
+    OpClose,
+
+    NumOpBits = 2
+};
+
+// max number of files in flight per submission
+const int MaxBatchSize = 256;
+
+//------------------------------------------------------------------------------
+inline uint64_t
+userData(int index, op o) {
+    return (uint64_t(index) << NumOpBits) | uint64_t(o);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+uringFSWrapper::uringFSWrapper() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+uringFSWrapper::~uringFSWrapper() {
+    this->discard();
+    if (this->states) {
+        Memory::Free(this->states);
+        Memory::Free(this->statxBufs);
+        this->states = nullptr;
+        this->statxBufs = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+uringFSWrapper::setup(int num) {
+    o_assert_dbg(-1 == this->ringFd);
+
+    io_uring_params params;
+    Memory::Clear(&params, sizeof(params));
+    const int fd = (int) syscall(__NR_io_uring_setup, num, &params);
+    if (fd < 0) {
+        return false;
+    }
+    this->ringFd = fd;
+
+    // check that all required operations are supported
+    const int probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe* probe = (io_uring_probe*) Memory::Alloc(probeSize);
+    Memory::Clear(probe, probeSize);
+    bool supported = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) >= 0;
+    const int ops[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE };
+    for (int opcode : ops) {
+        supported &= (opcode <= probe->last_op) && (0 != (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED));
+    }
+    Memory::Free(probe);
+    if (!supported) {
+        this->discard();
+        return false;
+    }
+
+    // map the submission and completion rings
+    this->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    this->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = 0 != (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (singleMmap) {
+        if (this->cqRingSize > this->sqRingSize) {
+            this->sqRingSize = this->cqRingSize;
+        }
+        this->cqRingSize = 0;
+    }
+    void* ptr = mmap(nullptr, this->sqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == ptr) {
+        this->discard();
+        return false;
+    }
+    this->sqRing = ptr;
+    if (singleMmap) {
+        ptr = this->sqRing;
+    }
+    else {
+        ptr = mmap(nullptr, this->cqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == ptr) {
+            this->discard();
+            return false;
+        }
+        this->cqRing = ptr;
+    }
+    uint8_t* cq = (uint8_t*) ptr;
+    this->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ptr = mmap(nullptr, this->sqesSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (MAP_FAILED == ptr) {
+        this->discard();
+        return false;
+    }
+    this->sqes = ptr;
+
+    uint8_t* sq = (uint8_t*) this->sqRing;
+    this->sqHead = (unsigned*) (sq + params.sq_off.head);
+    this->sqTail = (unsigned*) (sq + params.sq_off.tail);
+    this->sqMask = *(unsigned*) (sq + params.sq_off.ring_mask);
+    this->sqArray = (unsigned*) (sq + params.sq_off.array);
+    this->cqHead = (unsigned*) (cq + params.cq_off.head);
+    this->cqTail = (unsigned*) (cq + params.cq_off.tail);
+    this->cqMask = *(unsigned*) (cq + params.cq_off.ring_mask);
+    this->cqes = cq + params.cq_off.cqes;
+    this->numEntries = int(params.sq_entries);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+uringFSWrapper::discard() {
+    if (this->sqes) {
+        munmap(this->sqes, this->sqesSize);
+        this->sqes = nullptr;
+    }
+    if (this->cqRing) {
+        munmap(this->cqRing, this->cqRingSize);
+        this->cqRing = nullptr;
+    }
+    if (this->sqRing) {
+        munmap(this->sqRing, this->sqRingSize);
+        this->sqRing = nullptr;
+    }
+    if (-1 != this->ringFd) {
+        ::close(this->ringFd);
+        this->ringFd = -1;
+    }
+    this->numEntries = 0;
+}
+
+//------------------------------------------------------------------------------
+void*
+uringFSWrapper::nextEntry() {
+    // only called by the owning thread, and the ring is always
+    // drained before new entries are queued, so it can't be full
+    const unsigned tail = *this->sqTail;
+    const unsigned index = tail & this->sqMask;
+    io_uring_sqe* sqe = ((io_uring_sqe*)this->sqes) + index;
+    Memory::Clear(sqe, sizeof(io_uring_sqe));
+    this->sqArray[index] = index;
+    __atomic_store_n(this->sqTail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+//------------------------------------------------------------------------------
+bool
+uringFSWrapper::submitAndWait(int numSubmit, int numCompletions, readRequest* reqs) {
+    int completed = 0;
+    while (completed < numCompletions) {
+        const int ret = (int) syscall(__NR_io_uring_enter, this->ringFd, numSubmit, numCompletions - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0) {
+            if ((EINTR != errno) && (EAGAIN != errno) && (EBUSY != errno)) {
+                o_warn("uringFSWrapper: io_uring_enter() failed with errno %d\n", errno);
+                return false;
+            }
+        }
+        else {
+            numSubmit -= ret;
+        }
+        unsigned head = *this->cqHead;
+        const unsigned tail = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe* cqe = ((const io_uring_cqe*)this->cqes) + (head & this->cqMask);
+            this->complete(reqs, cqe->user_data, cqe->res);
+            head++;
+            completed++;
+        }
+        __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+uringFSWrapper::complete(readRequest* reqs, uint64_t userData, int res) {
+    const int index = int(userData >> NumOpBits);
+    readRequest& req = reqs[index];
+    state& st = this->states[index];
+    switch (op(userData & ((1<<NumOpBits) - 1))) {
+        case OpOpen:
+            if (res >= 0) {
+                st.fd = res;
+                req.opened = true;
+            }
+            break;
+        case OpStatx:
+            if (0 == res) {
+                st.fileSize = ((const struct statx*)this->statxBufs)[index].stx_size;
+                st.statOk = true;
+            }
+            break;
+        case OpRead:
+            if (res > 0) {
+                req.bytesRead += res;
+                st.done = req.bytesRead >= req.size;
+            }
+            else {
+                // error or unexpected end of file
+                st.done = true;
+            }
+            break;
+        case OpClose:
+            // cancelled if the linked read came up short
+            if (-ECANCELED != res) {
+                st.closePending = false;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+uringFSWrapper::read(readRequest* reqs, int num) {
+    if (this->unavailable) {
+        return false;
+    }
+    o_assert_dbg(reqs && (num >= 0));
+
+    // setup or grow the ring, each file needs 2 entries per submission
+    const int batchSize = num < MaxBatchSize ? num : MaxBatchSize;
+    if ((2 * batchSize) > this->numEntries) {
+        this->discard();
+        if (!this->setup(2 * batchSize)) {
+            Log::Info("uringFSWrapper: io_uring not available, using blocking reads\n");
+            this->unavailable = true;
+            return false;
+        }
+    }
+    if (batchSize > this->statesCapacity) {
+        if (this->states) {
+            Memory::Free(this->states);
+            Memory::Free(this->statxBufs);
+        }
+        this->states = (state*) Memory::Alloc(batchSize * sizeof(state));
+        this->statxBufs = (uint8_t*) Memory::Alloc(batchSize * sizeof(struct statx));
+        this->statesCapacity = batchSize;
+    }
+
+    for (int base = 0; base < num; base += batchSize) {
+        readRequest* batch = reqs + base;
+        const int n = (num - base) < batchSize ? (num - base) : batchSize;
+
+        // open and stat all files
+        for (int i = 0; i < n; i++) {
+            readRequest& req = batch[i];
+            o_assert_dbg(req.path && req.data);
+            req.opened = false;
+            req.size = 0;
+            req.bytesRead = 0;
+            this->states[i] = state();
+
+            io_uring_sqe* sqe = (io_uring_sqe*) this->nextEntry();
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) req.path;
+            sqe->open_flags = O_RDONLY|O_CLOEXEC;
+            sqe->user_data = userData(i, OpOpen);
+
+            sqe = (io_uring_sqe*) this->nextEntry();
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) req.path;
+            sqe->len = STATX_SIZE;
+            sqe->off = (uint64_t) (((struct statx*)this->statxBufs) + i);
+            sqe->user_data = userData(i, OpStatx);
+        }
+        bool ok = this->submitAndWait(2 * n, 2 * n, batch);
+
+        // read the files, each read is linked to the close of its file
+        for (int i = 0; i < n; i++) {
+            readRequest& req = batch[i];
+            state& st = this->states[i];
+            if (req.opened) {
+                if (EndOfFile == req.endOffset) {
+                    req.size = st.statOk ? int(st.fileSize) - req.startOffset : 0;
+                }
+                else {
+                    req.size = req.endOffset - req.startOffset;
+                }
+                if (req.size > 0) {
+                    req.data->Add(req.size);
+                }
+                else {
+                    st.done = true;
+                    st.closePending = true;
+                }
+            }
+            else {
+                st.done = true;
+            }
+        }
+        while (ok) {
+            int numSubmit = 0;
+            for (int i = 0; i < n; i++) {
+                readRequest& req = batch[i];
+                state& st = this->states[i];
+                if (!st.done) {
+                    uint8_t* dst = req.data->Data() + req.data->Size() - req.size + req.bytesRead;
+                    io_uring_sqe* sqe = (io_uring_sqe*) this->nextEntry();
+                    sqe->opcode = IORING_OP_READ;
+                    sqe->flags = IOSQE_IO_LINK;
+                    sqe->fd = st.fd;
+                    sqe->addr = (uint64_t) dst;
+                    sqe->len = unsigned(req.size - req.bytesRead);
+                    sqe->off = uint64_t(req.startOffset + req.bytesRead);
+                    sqe->user_data = userData(i, OpRead);
+
+                    sqe = (io_uring_sqe*) this->nextEntry();
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->fd = st.fd;
+                    sqe->user_data = userData(i, OpClose);
+                    st.closePending = true;
+                    numSubmit += 2;
+                }
+            }
+            if (0 == numSubmit) {
+                break;
+            }
+            ok = this->submitAndWait(numSubmit, numSubmit, batch);
+            for (int i = 0; i < n; i++) {
+                state& st = this->states[i];
+                if (!st.done && !st.closePending) {
+                    // short read, but the file has been closed anyway
+                    st.done = true;
+                }
+            }
+        }
+
+        // close files which haven't been closed by a linked close
+        for (int i = 0; i < n; i++) {
+            state& st = this->states[i];
+            if ((st.fd >= 0) && (st.closePending || !st.done)) {
+                ::close(st.fd);
+            }
+        }
+        if (!ok) {
+            // the ring is broken, the caller must redo the whole batch
+            for (int i = 0; i < num; i++) {
+                reqs[i].data->Clear();
+            }
+            this->discard();
+            this->unavailable = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::uringFSWrapper
+    @ingroup _priv
+    @brief batched asynchronous file reads through Linux io_uring
+
+    Reads a batch of files with a few io_uring submissions: first the
+    open and statx requests of all files, then read requests which are
+    linked to their close request. All requests of a submission are in
+    flight at the same time. The ring is created on first use (and grown
+    for bigger batches), if io_uring isn't available (old kernel, disabled
+    by the system or by a seccomp filter) read() returns false and the
+    caller must fall back to posixFSWrapper. Each instance must only be
+    used by one thread.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Buffer.h"
+
+namespace Oryol {
+namespace _priv {
+
+class uringFSWrapper {
+public:
+    /// a file read request
+    struct readRequest {
+        /// path of the file to read
+        const char* path = nullptr;
+        /// start offset in file
+        int startOffset = 0;
+        /// end offset in file, or EndOfFile
+        int endOffset = EndOfFile;
+        /// the data is appended to this buffer
+        Buffer* data = nullptr;
+
+        /// result: true if the file could be opened
+        bool opened = false;
+        /// result: the number of bytes which should have been read
+        int size = 0;
+        /// result: the number of bytes actually read
+        int bytesRead = 0;
+    };
+
+    /// constructor
+    uringFSWrapper();
+    /// destructor
+    ~uringFSWrapper();
+
+    /// read a batch of files, returns false if io_uring is not available
+    bool read(readRequest* reqs, int num);
+    /// return true if io_uring is not available
+    bool isUnavailable() const;
+
+private:
+    /// setup the ring with room for at least numEntries requests
+    bool setup(int numEntries);
+    /// discard the ring
+    void discard();
+    /// get next free submission queue entry
+    void* nextEntry();
+    /// submit queued entries and wait for numCompletions completions
+    bool submitAndWait(int numSubmit, int numCompletions, readRequest* reqs);
+    /// handle a completion
+    void complete(readRequest* reqs, uint64_t userData, int res);
+
+    int ringFd = -1;
+    bool unavailable = false;
+    int numEntries = 0;
+
+    void* sqRing = nullptr;
+    size_t sqRingSize = 0;
+    void* cqRing = nullptr;
+    size_t cqRingSize = 0;
+    void* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    void* cqes = nullptr;
+
+    /// per-request state of the current batch
+    struct state {
+        int fd = -1;
+        uint64_t fileSize = 0;
+        bool statOk = false;
+        bool closePending = false;
+        bool done = false;
+    };
+    state* states = nullptr;
+    uint8_t* statxBufs = nullptr;
+    int statesCapacity = 0;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+uringFSWrapper::isUnavailable() const {
+    return this->unavailable;
+}
+
+} // namespace _priv
+} // namespace Oryol
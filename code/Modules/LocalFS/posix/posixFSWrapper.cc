@@ -10,6 +10,7 @@
 #include <direct.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 namespace Oryol {
@@ -17,6 +18,20 @@ namespace _priv {
 
 const posixFSWrapper::handle posixFSWrapper::invalidHandle = nullptr;
 
+#if !ORYOL_WINDOWS
+namespace {
+// a mapped file region, unmapped when the last reference goes away
+class posixMapping : public RefCounted {
+    OryolClassDecl(posixMapping);
+public:
+    posixMapping(void* addr_, size_t len_) : addr(addr_), len(len_) { };
+    ~posixMapping() { munmap(this->addr, this->len); };
+    void* addr;
+    size_t len;
+};
+} // anonymous namespace
+#endif
+
 //------------------------------------------------------------------------------
 posixFSWrapper::handle
 posixFSWrapper::openRead(const char* path) {
@@ -66,6 +81,35 @@ posixFSWrapper::size(handle h) {
     return (int) size;
 }
 
+//------------------------------------------------------------------------------
+/**
+    The mapping is private and writable, so that the content can be
+    modified in place like an allocated buffer (modified pages are copied
+    by the OS, the file is never changed). The caller must make sure that
+    the region doesn't extend beyond the end of the file.
+*/
+Ptr<RefCounted>
+posixFSWrapper::map(handle h, int offset, int numBytes, uint8_t*& outPtr) {
+    o_assert_dbg(invalidHandle != h);
+    o_assert_dbg((offset >= 0) && (numBytes > 0));
+    #if ORYOL_WINDOWS
+    return Ptr<RefCounted>();
+    #else
+    // the mapping offset must be page-aligned
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    const int pageOffset = int(offset % pageSize);
+    const size_t len = size_t(numBytes) + pageOffset;
+    void* addr = mmap(nullptr, len, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno((FILE*)h), off_t(offset - pageOffset));
+    if (MAP_FAILED == addr) {
+        return Ptr<RefCounted>();
+    }
+    // start reading the pages in, before the data is accessed
+    posix_madvise(addr, len, POSIX_MADV_WILLNEED);
+    outPtr = ((uint8_t*)addr) + pageOffset;
+    return posixMapping::Create(addr, len);
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 posixFSWrapper::close(handle h) {
@@ -109,9 +109,9 @@ resourceRegistry::Lookup(const Locator& loc) const {
 
 //------------------------------------------------------------------------------
 Array<Id>
-resourceRegistry::Remove(ResourceLabel label) {
+resourceRegistry::Remove(ResourceLabel label, Memory::Tag allocTag) {
     o_assert_dbg(this->isValid);
-    Array<Id> removed;
+    Array<Id> removed(allocTag);
     removed.Reserve(this->entries.Size() < 256 ? this->entries.Size() : 256);
     
     // for each entry where id.label matches label (from behind
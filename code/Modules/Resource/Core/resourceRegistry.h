@@ -33,7 +33,7 @@ public:
     /// lookup resource Id by locator
     Id Lookup(const Locator& loc) const;
     /// remove all resource matching label from registry, returns removed Ids
-    Array<Id> Remove(ResourceLabel label);
+    Array<Id> Remove(ResourceLabel label, Memory::Tag allocTag=Memory::Tag::Containers);
     
     /// check if resource is in registry
     bool Contains(Id id) const;
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "Core/Main.h"
 #include "Core/Time/Clock.h"
+#include "Core/Containers/SoAArray.h"
 #include "Gfx/Gfx.h"
 #include "Assets/Gfx/ShapeBuilder.h"
 #include "Dbg/Dbg.h"
@@ -34,14 +35,11 @@ private:
     Shader::PerParticleParams perParticleParams;
     bool updateEnabled = true;
     int frameCount = 0;
-    int curNumParticles = 0;
     TimePoint lastFrameTimePoint;
     static const int NumParticlesEmittedPerFrame = 100;
     static const int MaxNumParticles = 1024 * 1024;
-    struct {
-        glm::vec4 pos;
-        glm::vec4 vec;
-    } particles[MaxNumParticles];
+    /// particle positions (field 0) and velocities (field 1)
+    SoAArray<glm::vec4, glm::vec4> particles;
 };
 OryolMain(DrawCallPerfApp);
 
@@ -68,8 +66,9 @@ DrawCallPerfApp::OnRunning() {
     TimePoint drawStart = Clock::Now();
     Gfx::ApplyDrawState(this->drawState);
     Gfx::ApplyUniformBlock(this->perFrameParams);
-    for (int i = 0; i < this->curNumParticles; i++) {
-        this->perParticleParams.Translate = this->particles[i].pos;
+    const glm::vec4* positions = this->particles.Field<0>();
+    for (int i = 0; i < this->particles.Size(); i++) {
+        this->perParticleParams.Translate = positions[i];
         Gfx::ApplyUniformBlock(this->perParticleParams);
         Gfx::Draw(0);
     }
@@ -87,7 +86,7 @@ DrawCallPerfApp::OnRunning() {
     Dbg::TextColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
     Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r applyRt=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
                 " LMB/tap: toggle particle update",
-                this->curNumParticles,
+                this->particles.Size(),
                 updTime.AsMilliSeconds(),
                 applyRtTime.AsMilliSeconds(),
                 drawTime.AsMilliSeconds(),
@@ -111,12 +110,10 @@ DrawCallPerfApp::updateCamera() {
 void
 DrawCallPerfApp::emitParticles() {
     for (int i = 0; i < NumParticlesEmittedPerFrame; i++) {
-        if (this->curNumParticles < MaxNumParticles) {
-            this->particles[this->curNumParticles].pos = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        if (this->particles.Size() < MaxNumParticles) {
             glm::vec3 rnd = glm::ballRand(0.5f);
             rnd.y += 2.0f;
-            this->particles[this->curNumParticles].vec = glm::vec4(rnd, 0.0f);
-            this->curNumParticles++;
+            this->particles.Add(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f), glm::vec4(rnd, 0.0f));
         }
     }
 }
@@ -125,14 +122,18 @@ DrawCallPerfApp::emitParticles() {
 void
 DrawCallPerfApp::updateParticles() {
     const float frameTime = 1.0f / 60.0f;
-    for (int i = 0; i < this->curNumParticles; i++) {
-        auto& curParticle = this->particles[i];
-        curParticle.vec.y -= 1.0f * frameTime;
-        curParticle.pos += curParticle.vec * frameTime;
-        if (curParticle.pos.y < -2.0f) {
-            curParticle.pos.y = -1.8f;
-            curParticle.vec.y = -curParticle.vec.y;
-            curParticle.vec *= 0.8f;
+    glm::vec4* positions = this->particles.Field<0>();
+    glm::vec4* vectors = this->particles.Field<1>();
+    const int num = this->particles.Size();
+    for (int i = 0; i < num; i++) {
+        auto& pos = positions[i];
+        auto& vec = vectors[i];
+        vec.y -= 1.0f * frameTime;
+        pos += vec * frameTime;
+        if (pos.y < -2.0f) {
+            pos.y = -1.8f;
+            vec.y = -vec.y;
+            vec *= 0.8f;
         }
     }
 }
@@ -146,6 +147,7 @@ DrawCallPerfApp::OnInit() {
     Gfx::Setup(gfxSetup);
     Dbg::Setup();
     Input::Setup();
+    this->particles.Reserve(MaxNumParticles);
 
     // create resources
     const glm::mat4 rot90 = glm::rotate(glm::mat4(), glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
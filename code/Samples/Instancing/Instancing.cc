@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "Core/Main.h"
 #include "Core/Time/Clock.h"
+#include "Core/Containers/SoAArray.h"
 #include "Gfx/Gfx.h"
 #include "Assets/Gfx/ShapeBuilder.h"
 #include "Dbg/Dbg.h"
@@ -37,12 +38,11 @@ private:
     Shader::VSParams vsParams;
     bool updateEnabled = true;
     int frameCount = 0;
-    int curNumParticles = 0;
     TimePoint lastFrameTimePoint;
     static const int MaxNumParticles = 1024 * 1024;
     const int NumParticlesEmittedPerFrame = 100;
-    glm::vec4 positions[MaxNumParticles];
-    glm::vec4 vectors[MaxNumParticles];
+    /// particle positions (field 0) and velocities (field 1)
+    SoAArray<glm::vec4, glm::vec4> particles;
 };
 OryolMain(InstancingApp);
 
@@ -62,7 +62,7 @@ InstancingApp::OnRunning() {
         updTime = Clock::Since(updStart);
 
         TimePoint bufStart = Clock::Now();
-        Gfx::UpdateVertices(this->drawState.Mesh[instMeshSlot], this->positions, this->curNumParticles * sizeof(glm::vec4));
+        Gfx::UpdateVertices(this->drawState.Mesh[instMeshSlot], this->particles.Field<0>(), this->particles.Size() * sizeof(glm::vec4));
         bufTime = Clock::Since(bufStart);
     }
     
@@ -71,7 +71,7 @@ InstancingApp::OnRunning() {
     Gfx::ApplyDefaultRenderTarget();
     Gfx::ApplyDrawState(this->drawState);
     Gfx::ApplyUniformBlock(this->vsParams);
-    Gfx::DrawInstanced(0, this->curNumParticles);
+    Gfx::DrawInstanced(0, this->particles.Size());
     drawTime = Clock::Since(drawStart);
     
     Dbg::DrawTextBuffer();
@@ -86,7 +86,7 @@ InstancingApp::OnRunning() {
     Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
     Dbg::PrintF("\n %d instances\n\r upd=%.3fms\n\r bufUpd=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
                 " LMB/Tap: toggle particle updates",
-                this->curNumParticles,
+                this->particles.Size(),
                 updTime.AsMilliSeconds(),
                 bufTime.AsMilliSeconds(),
                 drawTime.AsMilliSeconds(),
@@ -108,12 +108,10 @@ InstancingApp::updateCamera() {
 void
 InstancingApp::emitParticles() {
     for (int i = 0; i < NumParticlesEmittedPerFrame; i++) {
-        if (this->curNumParticles < MaxNumParticles) {
-            this->positions[this->curNumParticles] = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+        if (this->particles.Size() < MaxNumParticles) {
             glm::vec3 rnd = glm::ballRand(0.5f);
             rnd.y += 2.0f;
-            this->vectors[this->curNumParticles] = glm::vec4(rnd, 0.0f);
-            this->curNumParticles++;
+            this->particles.Add(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f), glm::vec4(rnd, 0.0f));
         }
     }
 }
@@ -122,9 +120,12 @@ InstancingApp::emitParticles() {
 void
 InstancingApp::updateParticles() {
     const float frameTime = 1.0f / 60.0f;
-    for (int i = 0; i < this->curNumParticles; i++) {
-        auto& pos = this->positions[i];
-        auto& vec = this->vectors[i];
+    glm::vec4* positions = this->particles.Field<0>();
+    glm::vec4* vectors = this->particles.Field<1>();
+    const int num = this->particles.Size();
+    for (int i = 0; i < num; i++) {
+        auto& pos = positions[i];
+        auto& vec = vectors[i];
         vec.y -= 1.0f * frameTime;
         pos += vec * frameTime;
         if (pos.y < -2.0f) {
@@ -142,6 +143,7 @@ InstancingApp::OnInit() {
     Gfx::Setup(GfxSetup::Window(800, 500, "Oryol Instancing Sample"));
     Dbg::Setup();
     Input::Setup();
+    this->particles.Reserve(MaxNumParticles);
     
     // check instancing extension
     if (!Gfx::QueryFeature(GfxFeature::Instancing)) {
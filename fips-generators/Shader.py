@@ -2,7 +2,7 @@
 Code generator for shader libraries.
 '''
 
-Version = 58
+Version = 59
 
 import os
 import sys
@@ -1794,10 +1794,10 @@ def writeProgramSource(f, shdLib, prog) :
         for type in ub.uniformsByType :
             for uniform in ub.uniformsByType[type] :
                 if uniform.num == 1 :
-                    f.write('    {}.Add("{}", {});\n'.format(layoutName, uniform.name, uniformOryolType[uniform.type]))
+                    f.write('    {}.Add("{}"_atom, {});\n'.format(layoutName, uniform.name, uniformOryolType[uniform.type]))
                 else :
-                    f.write('    {}.Add("{}", {}, {});\n'.format(layoutName, uniform.name, uniformOryolType[uniform.type], uniform.num))
-        f.write('    setup.AddUniformBlock("{}", {}, {}::_bindShaderStage, {}::_bindSlotIndex);\n'.format(
+                    f.write('    {}.Add("{}"_atom, {}, {});\n'.format(layoutName, uniform.name, uniformOryolType[uniform.type], uniform.num))
+        f.write('    setup.AddUniformBlock("{}"_atom, {}, {}::_bindShaderStage, {}::_bindSlotIndex);\n'.format(
             ub.name, layoutName, ub.bindName, ub.bindName))
 
     # add texture layouts to setup objects
@@ -1809,12 +1809,12 @@ def writeProgramSource(f, shdLib, prog) :
                 texType = 'Texture2D'
             else :
                 texType = 'TextureCube'
-            f.write('    {}.Add("{}", TextureType::{}, {});\n'.format(layoutName, tex.name, texType, tex.bindSlot))
+            f.write('    {}.Add("{}"_atom, TextureType::{}, {});\n'.format(layoutName, tex.name, texType, tex.bindSlot))
         if tb.bindStage == 'vs' :
             stageName = 'VS'
         else :
             stageName = 'FS'
-        f.write('    setup.AddTextureBlock("{}", {}, ShaderStage::{});\n'.format(
+        f.write('    setup.AddTextureBlock("{}"_atom, {}, ShaderStage::{});\n'.format(
             tb.name, layoutName, stageName))
                 
     f.write('    return setup;\n')
@@ -0,0 +1,167 @@
+#!/usr/bin/env python
+'''
+Decode a binary Oryol log stream (see Log::SetBinarySink() and
+Core/LogDecoder.h) into text.
+
+Usage: logdecode.py <file> [-levels]
+'''
+import sys
+import re
+import struct
+
+Magic = b'OLOG\x01'
+FormatTag = 1
+TextTag = 2
+MessageTag = 3
+
+LevelNames = ['None', 'Error', 'Warn', 'Info', 'Dbg']
+
+# packed argument type codes (Core/logArgs.h)
+I32, U32, I64, U64, F64, Str, Ptr = range(1, 8)
+NullStr = 0xFFFF
+
+SpecRegex = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?([hljztLq]*)([diuoxXcfFeEgGaAspn%])')
+
+#-------------------------------------------------------------------------------
+def error(msg) :
+    print("ERROR: {}".format(msg))
+    sys.exit(10)
+
+#-------------------------------------------------------------------------------
+def unpackArgs(types, data) :
+    '''
+    Unpack a packed argument list into a list of (type, value) tuples
+    '''
+    args = []
+    pos = 0
+    for t in types :
+        if t == I32 :
+            args.append((t, struct.unpack_from('<i', data, pos)[0]))
+            pos += 4
+        elif t == U32 :
+            args.append((t, struct.unpack_from('<I', data, pos)[0]))
+            pos += 4
+        elif t == I64 :
+            args.append((t, struct.unpack_from('<q', data, pos)[0]))
+            pos += 8
+        elif t in (U64, Ptr) :
+            args.append((t, struct.unpack_from('<Q', data, pos)[0]))
+            pos += 8
+        elif t == F64 :
+            args.append((t, struct.unpack_from('<d', data, pos)[0]))
+            pos += 8
+        elif t == Str :
+            length = struct.unpack_from('<H', data, pos)[0]
+            if length == NullStr :
+                args.append((t, None))
+                length = 0
+            else :
+                args.append((t, data[pos+2:pos+2+length].decode('utf-8', 'replace')))
+            pos += 2 + length + 1
+        else :
+            error("invalid argument type {}".format(t))
+    return args
+
+#-------------------------------------------------------------------------------
+def formatMessage(fmt, args) :
+    '''
+    Format a message like LogDecoder::Format() does
+    '''
+    args = list(args)
+    def nextArg() :
+        return args.pop(0) if args else None
+    def convert(m) :
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%' :
+            return '%'
+        if width == '*' :
+            a = nextArg()
+            width = str(int(a[1])) if a else ''
+        if prec == '*' :
+            a = nextArg()
+            prec = str(int(a[1])) if a else ''
+        a = nextArg()
+        if a is None :
+            return m.group(0)
+        t, val = a
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        if conv in 'di' :
+            val = int(val) if t != Str else 0
+            bits = 8 if length == 'hh' else 16 if length == 'h' else 32 if (not length or t in (I32, U32)) else 64
+            val &= (1 << bits) - 1
+            if val >= (1 << (bits - 1)) :
+                val -= 1 << bits
+            return (spec + 'd') % val
+        elif conv in 'uoxX' :
+            val = int(val) if t != Str else 0
+            bits = 8 if length == 'hh' else 16 if length == 'h' else 32 if (not length or t in (I32, U32)) else 64
+            return (spec + ('d' if conv == 'u' else conv)) % (val & ((1 << bits) - 1))
+        elif conv == 'c' :
+            return (spec + 'c') % chr(int(val) & 0xFF)
+        elif conv == 's' :
+            if t != Str :
+                val = '(?)'
+            elif val is None :
+                val = '(null)'
+            return (spec + 's') % val
+        elif conv == 'p' :
+            return (spec + 's') % hex(int(val))
+        elif conv == 'n' :
+            return ''
+        elif conv in 'aA' :
+            return float(val).hex()
+        else :
+            return (spec + conv) % float(val)
+    return SpecRegex.sub(convert, fmt)
+
+#-------------------------------------------------------------------------------
+def decode(data) :
+    '''
+    Decode a complete binary log stream, returns list of (level, message)
+    '''
+    if data[:len(Magic)] != Magic :
+        error("not an Oryol binary log stream")
+    formats = []
+    messages = []
+    pos = len(Magic)
+    while pos < len(data) :
+        tag = ord(data[pos:pos+1])
+        if tag == FormatTag :
+            fmtId, length = struct.unpack_from('<IH', data, pos + 1)
+            fmt = data[pos+7:pos+7+length].decode('utf-8', 'replace')
+            if fmtId == len(formats) :
+                formats.append(fmt)
+            elif fmtId < len(formats) :
+                formats[fmtId] = fmt
+            else :
+                error("invalid format id {}".format(fmtId))
+            pos += 7 + length
+        elif tag == TextTag :
+            level, length = struct.unpack_from('<BH', data, pos + 1)
+            messages.append((level, data[pos+4:pos+4+length].decode('utf-8', 'replace')))
+            pos += 4 + length
+        elif tag == MessageTag :
+            level, fmtId, numArgs, argsSize = struct.unpack_from('<BIBH', data, pos + 1)
+            types = bytearray(data[pos+9:pos+9+numArgs])
+            args = unpackArgs(types, data[pos+9+numArgs:pos+9+numArgs+argsSize])
+            if fmtId >= len(formats) :
+                error("invalid format id {}".format(fmtId))
+            messages.append((level, formatMessage(formats[fmtId], args)))
+            pos += 9 + numArgs + argsSize
+        else :
+            error("invalid record tag {} at offset {}".format(tag, pos))
+    return messages
+
+#-------------------------------------------------------------------------------
+if __name__ == '__main__' :
+    if len(sys.argv) < 2 :
+        print(__doc__)
+        sys.exit(0)
+    withLevels = '-levels' in sys.argv[2:]
+    with open(sys.argv[1], 'rb') as f :
+        data = f.read()
+    for level, msg in decode(data) :
+        if withLevels :
+            name = LevelNames[level] if level < len(LevelNames) else str(level)
+            sys.stdout.write('[{}] '.format(name))
+        sys.stdout.write(msg)